@@ -0,0 +1,90 @@
+# Checks that a server started with --concurrent-requests answers a directory
+# listing while it updates a pipeline. The listing is requested from a
+# progress observer, i.e. while the client waits for the end of the update,
+# and the update is held until the listing is answered. A listing deferred to
+# the end of the update is only answered once the update gave up waiting.
+import os
+import shutil
+import tempfile
+import textwrap
+
+from paraview import servermanager
+import paraview.simple as smp
+from vtk.vtkPVClientServerCoreCore import vtkPVFileInformationHelper
+from vtk.vtkPVClientServerCoreDefault import vtkPVFileInformation
+
+
+# Make sure the test driver know that process has properly started
+print ("Process started")
+
+
+def getHost(url):
+   return url.split(':')[1][2:]
+
+
+def getPort(url):
+   return int(url.split(':')[2])
+
+
+def runTest():
+
+    options = servermanager.vtkProcessModule.GetProcessModule().GetOptions()
+    url = options.GetServerURL()
+
+    smp.Connect(getHost(url), getPort(url))
+
+    # a source that reports progress until the test releases it, and records
+    # whether it was released or gave up waiting.
+    tempDir = tempfile.mkdtemp()
+    release = os.path.join(tempDir, "release")
+    source = smp.ProgrammableSource()
+    source.Script = textwrap.dedent('''
+        import os
+        import time
+        from vtk.vtkCommonCore import vtkIntArray
+        released = 0
+        for i in range(600):
+            if os.path.exists(%r):
+                released = 1
+                break
+            time.sleep(0.1)
+            self.UpdateProgress(i / 600.0)
+        array = vtkIntArray()
+        array.SetName("Released")
+        array.InsertNextValue(released)
+        self.GetOutput().GetFieldData().AddArray(array)''' % release)
+
+    pxm = servermanager.ProxyManager().SMProxyManager
+    helper = pxm.NewProxy("misc", "FileInformationHelper")
+    helper.UnRegister(None)
+    helper.UpdateVTKObjects()
+
+    query = vtkPVFileInformationHelper()
+    query.SetPath(".")
+    query.SetDirectoryListing(1)
+
+    listings = []
+    def gatherListing(caller, event):
+        if listings:
+            return
+        info = vtkPVFileInformation()
+        info.SetQuery(query)
+        helper.GatherInformation(info)
+        listings.append(info.GetContents().GetNumberOfItems())
+        open(release, "w").close()
+
+    handler = servermanager.ActiveConnection.Session.GetProgressHandler()
+    tag = handler.AddObserver("ProgressEvent", gatherListing)
+    source.UpdatePipeline()
+    handler.RemoveObserver(tag)
+    shutil.rmtree(tempDir)
+
+    assert listings, "No progress was reported during the update."
+    assert listings[0] > 0, "The listing of the working directory is empty."
+    assert source.FieldData["Released"].GetRange() == (1, 1), \
+        "The listing was only answered at the end of the update."
+
+    smp.Disconnect()
+
+
+runTest()
@@ -15,6 +15,7 @@
 #include "vtkPVCompositeDataInformation.h"
 
 #include "vtkClientServerStream.h"
+#include "vtkCommand.h"
 #include "vtkDataObjectTreeIterator.h"
 #include "vtkInformation.h"
 #include "vtkMultiPieceDataSet.h"
@@ -26,10 +27,37 @@
 #include "vtkUniformGrid.h"
 #include "vtkUniformGridAMR.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Returns the number of nodes below cds, empty nodes and pieces included, i.e.
+// the number of flat indices spanned by its subtree.
+unsigned int vtkCountNodes(vtkCompositeDataSet* cds)
+{
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(cds->NewIterator());
+  if (vtkDataObjectTreeIterator* treeIter = vtkDataObjectTreeIterator::SafeDownCast(iter))
+  {
+    treeIter->VisitOnlyLeavesOff();
+    treeIter->TraverseSubTreeOn();
+  }
+  iter->SkipEmptyNodesOff();
+
+  unsigned int count = 0;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    count++;
+  }
+  return count;
+}
+}
+
 vtkStandardNewMacro(vtkPVCompositeDataInformation);
+vtkCxxSetObjectMacro(vtkPVCompositeDataInformation, SubtreeLoader, vtkCommand);
 
 struct vtkPVCompositeDataInformationInternals
 {
@@ -50,12 +78,20 @@ vtkPVCompositeDataInformation::vtkPVCompositeDataInformation()
   this->DataIsComposite = 0;
   this->DataIsMultiPiece = 0;
   this->NumberOfPieces = 0;
+  this->Summary = false;
+  this->NumberOfDescendants = 0;
   // DON'T FORGET TO UPDATE Initialize().
+
+  this->FlatIndex = 0;
+  this->SubtreeLoader = NULL;
+  this->SummaryThreshold = -1;
+  this->ExpandChildren = false;
 }
 
 //----------------------------------------------------------------------------
 vtkPVCompositeDataInformation::~vtkPVCompositeDataInformation()
 {
+  this->SetSubtreeLoader(NULL);
   delete this->Internal;
 }
 
@@ -65,6 +101,81 @@ void vtkPVCompositeDataInformation::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "DataIsMultiPiece: " << this->DataIsMultiPiece << endl;
   os << indent << "DataIsComposite: " << this->DataIsComposite << endl;
+  os << indent << "Summary: " << this->Summary << endl;
+  os << indent << "NumberOfDescendants: " << this->NumberOfDescendants << endl;
+  os << indent << "FlatIndex: " << this->FlatIndex << endl;
+  os << indent << "SubtreeLoader: " << this->SubtreeLoader << endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCompositeDataInformation::LoadChildren()
+{
+  if (this->Summary && this->SubtreeLoader)
+  {
+    // cleared first so that the loader can access this node without
+    // executing it again.
+    this->Summary = false;
+    this->SubtreeLoader->Execute(this, vtkCommand::UpdateInformationEvent, NULL);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCompositeDataInformation::ExpandSubtree()
+{
+  if (this->SubtreeLoader && this->HasSummarizedNodes())
+  {
+    // cleared first, as in LoadChildren().
+    this->Summary = false;
+    int wholeSubtree = 1;
+    this->SubtreeLoader->Execute(this, vtkCommand::UpdateInformationEvent, &wholeSubtree);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVCompositeDataInformation::HasSummarizedNodes()
+{
+  if (this->Summary)
+  {
+    return true;
+  }
+  // not using GetDataInformation(), which would load the children.
+  vtkPVCompositeDataInformationInternals::VectorOfDataInformation::iterator iter =
+    this->Internal->ChildrenInformation.begin();
+  for (; iter != this->Internal->ChildrenInformation.end(); ++iter)
+  {
+    if (iter->Info && iter->Info->GetCompositeDataInformation()->HasSummarizedNodes())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCompositeDataInformation::CopyChildrenFrom(vtkPVCompositeDataInformation* info)
+{
+  if (!info || info == this)
+  {
+    return;
+  }
+
+  this->Summary = false;
+  this->Internal->ChildrenInformation = info->Internal->ChildrenInformation;
+
+  unsigned int flatIndex = this->FlatIndex + 1;
+  vtkPVCompositeDataInformationInternals::VectorOfDataInformation::iterator iter =
+    this->Internal->ChildrenInformation.begin();
+  for (; iter != this->Internal->ChildrenInformation.end(); ++iter)
+  {
+    if (iter->Info)
+    {
+      vtkPVCompositeDataInformation* childInfo = iter->Info->GetCompositeDataInformation();
+      childInfo->SetFlatIndex(flatIndex);
+      childInfo->SetSubtreeLoader(this->SubtreeLoader);
+      flatIndex += childInfo->NumberOfDescendants;
+    }
+    flatIndex++;
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -86,6 +197,17 @@ vtkPVDataInformation* vtkPVCompositeDataInformation::GetDataInformationForCompos
     (*index) -= this->NumberOfPieces;
   }
 
+  if (this->Summary)
+  {
+    // don't gather the children of summarized nodes that are skipped anyway.
+    if ((*index) >= static_cast<int>(this->NumberOfDescendants))
+    {
+      (*index) -= this->NumberOfDescendants;
+      return NULL;
+    }
+    this->LoadChildren();
+  }
+
   vtkPVCompositeDataInformationInternals::VectorOfDataInformation::iterator iter =
     this->Internal->ChildrenInformation.begin();
   for (; iter != this->Internal->ChildrenInformation.end(); ++iter)
@@ -116,12 +238,18 @@ void vtkPVCompositeDataInformation::Initialize()
   this->DataIsMultiPiece = 0;
   this->NumberOfPieces = 0;
   this->DataIsComposite = 0;
+  this->Summary = false;
+  this->NumberOfDescendants = 0;
   this->Internal->ChildrenInformation.clear();
 }
 
 //----------------------------------------------------------------------------
 unsigned int vtkPVCompositeDataInformation::GetNumberOfChildren()
 {
+  if (!this->DataIsMultiPiece)
+  {
+    this->LoadChildren();
+  }
   return this->DataIsMultiPiece ? this->NumberOfPieces
                                 : static_cast<int>(this->Internal->ChildrenInformation.size());
 }
@@ -134,6 +262,7 @@ vtkPVDataInformation* vtkPVCompositeDataInformation::GetDataInformation(unsigned
     return NULL;
   }
 
+  this->LoadChildren();
   if (idx >= this->Internal->ChildrenInformation.size())
   {
     return NULL;
@@ -150,6 +279,7 @@ const char* vtkPVCompositeDataInformation::GetName(unsigned int idx)
     return NULL;
   }
 
+  this->LoadChildren();
   if (idx >= this->Internal->ChildrenInformation.size())
   {
     return NULL;
@@ -176,6 +306,7 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
   {
     this->DataIsMultiPiece = 1;
     this->SetNumberOfPieces(mpDS->GetNumberOfPieces());
+    this->NumberOfDescendants = this->NumberOfPieces;
     return;
   }
 
@@ -186,6 +317,18 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
     return;
   }
 
+  if (this->SummaryThreshold >= 0)
+  {
+    this->NumberOfDescendants = vtkCountNodes(cds);
+    if (!this->ExpandChildren &&
+      this->NumberOfDescendants > static_cast<unsigned int>(this->SummaryThreshold))
+    {
+      // vtkPVDataInformation aggregates the leaves directly.
+      this->Summary = true;
+      return;
+    }
+  }
+
   // This is generic composite dataset.
   vtkSmartPointer<vtkCompositeDataIterator> iter;
   iter.TakeReference(cds->NewIterator());
@@ -206,6 +349,7 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
     if (curDO)
     {
       childInfo = vtkSmartPointer<vtkPVDataInformation>::New();
+      childInfo->SetCompositeSummaryThreshold(this->SummaryThreshold);
       childInfo->CopyFromObject(curDO);
     }
     this->Internal->ChildrenInformation.resize(index + 1);
@@ -295,6 +439,21 @@ void vtkPVCompositeDataInformation::AddInformation(vtkPVInformation* pvi)
     return;
   }
 
+  this->NumberOfDescendants = std::max(this->NumberOfDescendants, info->NumberOfDescendants);
+  if (this->Summary || info->Summary)
+  {
+    // nodes summarized on any process are summarized after merging, the
+    // children are gathered from all processes when the node is expanded.
+    this->Summary = true;
+    this->Internal->ChildrenInformation.clear();
+    if (!this->SubtreeLoader && info->SubtreeLoader)
+    {
+      this->SetFlatIndex(info->FlatIndex);
+      this->SetSubtreeLoader(info->SubtreeLoader);
+    }
+    return;
+  }
+
   size_t otherNumChildren = info->Internal->ChildrenInformation.size();
   size_t numChildren = this->Internal->ChildrenInformation.size();
   if (otherNumChildren > numChildren)
@@ -342,7 +501,7 @@ void vtkPVCompositeDataInformation::CopyToStream(vtkClientServerStream* css)
   //  vtkTimerLog::MarkStartEvent("Copying composite information to stream");
   css->Reset();
   *css << vtkClientServerStream::Reply << this->DataIsComposite << this->DataIsMultiPiece
-       << this->NumberOfPieces;
+       << this->NumberOfPieces << this->Summary << this->NumberOfDescendants;
 
   unsigned int numChildren = static_cast<unsigned int>(this->Internal->ChildrenInformation.size());
   *css << numChildren;
@@ -390,13 +549,25 @@ void vtkPVCompositeDataInformation::CopyFromStream(const vtkClientServerStream*
     return;
   }
 
+  if (!css->GetArgument(0, 3, &this->Summary))
+  {
+    vtkErrorMacro("Error parsing summary flag.");
+    return;
+  }
+
+  if (!css->GetArgument(0, 4, &this->NumberOfDescendants))
+  {
+    vtkErrorMacro("Error parsing number of descendants.");
+    return;
+  }
+
   unsigned int numChildren;
-  if (!css->GetArgument(0, 3, &numChildren))
+  if (!css->GetArgument(0, 5, &numChildren))
   {
     vtkErrorMacro("Error parsing number of children.");
     return;
   }
-  int msgIdx = 3;
+  int msgIdx = 5;
   this->Internal->ChildrenInformation.resize(numChildren);
 
   while (1)
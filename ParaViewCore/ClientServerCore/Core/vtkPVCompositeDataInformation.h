@@ -19,6 +19,13 @@
  * vtkPVCompositeDataInformation is used to copy the meta information of
  * a composite dataset from server to client. It holds a vtkPVDataInformation
  * for each block of the composite dataset.
+ *
+ * For large trees, the nodes with large subtrees may only be summarized (see
+ * GetSummary()). Their children are then gathered on demand by the
+ * SubtreeLoader, which GetNumberOfChildren(), GetDataInformation() and
+ * GetName() do transparently. Each such access may thus cost a round-trip to
+ * the server: code that walks the tree should call ExpandSubtree() first,
+ * which gathers the whole subtree at once.
  * @sa
  * vtkHierarchicalBoxDataSet vtkPVDataInformation
 */
@@ -29,6 +36,7 @@
 #include "vtkPVClientServerCoreCoreModule.h" //needed for exports
 #include "vtkPVInformation.h"
 
+class vtkCommand;
 class vtkPVDataInformation;
 class vtkUniformGridAMR;
 
@@ -100,8 +108,66 @@ public:
   vtkGetMacro(DataIsComposite, int);
   //@}
 
-  // TODO:
-  // Add API to obtain meta data information for each of the children.
+  //@{
+  /**
+   * Returns true if the information for the children of this node has not
+   * been gathered yet, see vtkPVDataInformation::SetCompositeSummaryThreshold().
+   * The vtkPVDataInformation owning this node still holds the information
+   * aggregated over all of its leaves. When a SubtreeLoader is set, the
+   * children are gathered the first time they are accessed.
+   */
+  vtkGetMacro(Summary, bool);
+  //@}
+
+  //@{
+  /**
+   * Returns the number of nodes in the subtree of this node, empty nodes and
+   * pieces included, i.e. the number of flat indices it spans. Only
+   * computed for vtkDataObjectTree nodes gathered with a non-negative
+   * vtkPVDataInformation::CompositeSummaryThreshold.
+   */
+  vtkGetMacro(NumberOfDescendants, unsigned int);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the flat index of this node in the composite data object the
+   * information was gathered for. This is not gathered but set by
+   * CopyChildrenFrom() on the children of expanded nodes, and is used to
+   * locate summarized nodes.
+   */
+  vtkSetMacro(FlatIndex, unsigned int);
+  vtkGetMacro(FlatIndex, unsigned int);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the command used to gather the children of summarized nodes. It
+   * is executed with this node as the caller the first time the children of
+   * a summarized node are accessed, and is expected to call
+   * CopyChildrenFrom() with the information gathered for the node at
+   * GetFlatIndex(). The command is passed on to the expanded children.
+   */
+  void SetSubtreeLoader(vtkCommand*);
+  vtkGetObjectMacro(SubtreeLoader, vtkCommand);
+  //@}
+
+  /**
+   * Replaces the children of this node with the ones of info, typically the
+   * information gathered for the node using
+   * vtkPVDataInformation::SetSubtreeCompositeIndex(). The flat indices and
+   * the SubtreeLoader are passed on to the children.
+   */
+  void CopyChildrenFrom(vtkPVCompositeDataInformation* info);
+
+  /**
+   * Gathers the information for all the summarized nodes in the subtree of
+   * this node with a single execution of the SubtreeLoader, instead of one
+   * per node as they are accessed. The command is then passed a pointer to
+   * an int set to 1 as call data. Does nothing if no node of the subtree is
+   * summarized.
+   */
+  void ExpandSubtree();
 
 protected:
   vtkPVCompositeDataInformation();
@@ -112,6 +178,16 @@ protected:
    */
   void CopyFromAMR(vtkUniformGridAMR* amr);
 
+  /**
+   * Executes the SubtreeLoader if this node is summarized.
+   */
+  void LoadChildren();
+
+  /**
+   * Returns true if this node or any node in its subtree is summarized.
+   */
+  bool HasSummarizedNodes();
+
   int DataIsMultiPiece;
   int DataIsComposite;
   unsigned int FlatIndexMax;
@@ -119,6 +195,17 @@ protected:
   unsigned int NumberOfPieces;
   vtkSetMacro(NumberOfPieces, unsigned int);
 
+  bool Summary;
+  unsigned int NumberOfDescendants;
+  unsigned int FlatIndex;
+  vtkCommand* SubtreeLoader;
+
+  // Parameters set by vtkPVDataInformation before CopyFromObject(), see
+  // vtkPVDataInformation::SetCompositeSummaryThreshold() and
+  // vtkPVDataInformation::SetSubtreeCompositeIndex().
+  int SummaryThreshold;
+  bool ExpandChildren;
+
   friend class vtkPVDataInformation;
   vtkPVDataInformation* GetDataInformationForCompositeIndex(int* index);
 
@@ -24,6 +24,8 @@
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataArray.h"
+#include "vtkDataObjectTree.h"
+#include "vtkDataObjectTreeIterator.h"
 #include "vtkDataObjectTypes.h"
 #include "vtkDataSet.h"
 #include "vtkExecutive.h"
@@ -43,9 +45,11 @@
 #include "vtkPVDataSetAttributesInformation.h"
 #include "vtkPVInformationKeys.h"
 #include "vtkPVInstantiator.h"
+#include "vtkPVTemporalDataInformation.h"
 #include "vtkPointData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkSelection.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkTable.h"
@@ -61,6 +65,39 @@ vtkStandardNewMacro(vtkPVDataInformation);
 
 std::map<std::string, std::string> helpers;
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Returns the node with the given flat index in dobj, NULL if there is none.
+vtkDataObject* vtkGetCompositeNode(vtkDataObject* dobj, int flatIndex)
+{
+  if (flatIndex == 0)
+  {
+    return dobj;
+  }
+
+  vtkDataObjectTree* tree = vtkDataObjectTree::SafeDownCast(dobj);
+  if (!tree)
+  {
+    return NULL;
+  }
+
+  vtkSmartPointer<vtkDataObjectTreeIterator> iter;
+  iter.TakeReference(tree->NewTreeIterator());
+  iter->VisitOnlyLeavesOff();
+  iter->TraverseSubTreeOn();
+  iter->SkipEmptyNodesOff();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    if (iter->GetCurrentFlatIndex() == static_cast<unsigned int>(flatIndex))
+    {
+      return iter->GetCurrentDataObject();
+    }
+  }
+  return NULL;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkPVDataInformation::vtkPVDataInformation()
 {
@@ -96,6 +133,8 @@ vtkPVDataInformation::vtkPVDataInformation()
   this->TimeLabel = NULL;
 
   this->PortNumber = -1;
+  this->CompositeSummaryThreshold = -1;
+  this->SubtreeCompositeIndex = -1;
 
   // Update field association information on the all the
   // vtkPVDataSetAttributesInformation instances.
@@ -136,14 +175,16 @@ vtkPVDataInformation::~vtkPVDataInformation()
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersToStream(vtkMultiProcessStream& str)
 {
-  str << 828792 << this->PortNumber;
+  str << 828792 << this->PortNumber << this->CompositeSummaryThreshold
+      << this->SubtreeCompositeIndex;
 }
 
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersFromStream(vtkMultiProcessStream& str)
 {
   int magic_number;
-  str >> magic_number >> this->PortNumber;
+  str >> magic_number >> this->PortNumber >> this->CompositeSummaryThreshold >>
+    this->SubtreeCompositeIndex;
   if (magic_number != 828792)
   {
     vtkErrorMacro("Magic number mismatch.");
@@ -157,6 +198,8 @@ void vtkPVDataInformation::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "PortNumber: " << this->PortNumber << endl;
+  os << indent << "CompositeSummaryThreshold: " << this->CompositeSummaryThreshold << endl;
+  os << indent << "SubtreeCompositeIndex: " << this->SubtreeCompositeIndex << endl;
   os << indent << "DataSetType: " << this->DataSetType << endl;
   os << indent << "CompositeDataSetType: " << this->CompositeDataSetType << endl;
   os << indent << "NumberOfPoints: " << this->NumberOfPoints << endl;
@@ -345,6 +388,8 @@ void vtkPVDataInformation::AddFromMultiPieceDataSet(vtkCompositeDataSet* data)
 void vtkPVDataInformation::CopyFromCompositeDataSetInitialize(vtkCompositeDataSet* data)
 {
   this->Initialize();
+  this->CompositeDataInformation->SummaryThreshold = this->CompositeSummaryThreshold;
+  this->CompositeDataInformation->ExpandChildren = this->SubtreeCompositeIndex >= 0;
   this->CompositeDataInformation->CopyFromObject(data);
 }
 
@@ -404,15 +449,17 @@ void vtkPVDataInformation::CopyFromCompositeDataSet(vtkCompositeDataSet* data)
 {
   this->CopyFromCompositeDataSetInitialize(data);
 
-  unsigned int numDataSets = this->CompositeDataInformation->GetNumberOfChildren();
-  if (this->CompositeDataInformation->GetDataIsMultiPiece())
+  if (this->CompositeDataInformation->GetDataIsMultiPiece() ||
+    this->CompositeDataInformation->GetSummary())
   {
-    // For vtkMultiPieceDataSet, the vtkPVCompositeDataInformation does not
-    // give us individual piece information, we collect that explicitly.
+    // For vtkMultiPieceDataSet and summarized nodes, the
+    // vtkPVCompositeDataInformation does not give us individual piece
+    // information, we collect that explicitly from all the leaves.
     this->AddFromMultiPieceDataSet(data);
   }
   else
   {
+    unsigned int numDataSets = this->CompositeDataInformation->GetNumberOfChildren();
     for (unsigned int cc = 0; cc < numDataSets; cc++)
     {
       vtkPVDataInformation* childInfo = this->CompositeDataInformation->GetDataInformation(cc);
@@ -459,6 +506,12 @@ void vtkPVDataInformation::CopyCommonMetaData(vtkDataObject* data, vtkInformatio
     this->Time = time;
     this->HasTime = 1;
   }
+
+  if (pinfo && this->SubtreeCompositeIndex < 0)
+  {
+    // spares vtkPVTemporalDataInformation from executing this timestep again.
+    vtkPVTemporalDataInformation::CacheTimeStep(pinfo, this);
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -733,6 +786,16 @@ void vtkPVDataInformation::CopyFromObject(vtkObject* object)
     return;
   }
 
+  if (this->SubtreeCompositeIndex >= 0)
+  {
+    dobj = vtkGetCompositeNode(dobj, this->SubtreeCompositeIndex);
+    if (!dobj)
+    {
+      // the node is empty or missing on this process.
+      return;
+    }
+  }
+
   vtkCompositeDataSet* cds = vtkCompositeDataSet::SafeDownCast(dobj);
   if (cds)
   {
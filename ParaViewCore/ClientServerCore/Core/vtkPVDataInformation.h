@@ -75,6 +75,31 @@ public:
   vtkGetMacro(PortNumber, int);
   //@}
 
+  //@{
+  /**
+   * When non-negative, composite nodes with more than this number of nodes
+   * in their subtree are only summarized: the aggregated information for all
+   * of their leaves is gathered, but not the information for each of their
+   * children, which is gathered on demand instead (see
+   * vtkPVCompositeDataInformation::GetSummary()). Negative by default, i.e.
+   * the information for the whole composite tree is gathered.
+   */
+  vtkSetMacro(CompositeSummaryThreshold, int);
+  vtkGetMacro(CompositeSummaryThreshold, int);
+  //@}
+
+  //@{
+  /**
+   * When non-negative, the information is gathered for the node with this
+   * flat index in the composite data object rather than for the whole data
+   * object, and the information for the children of that node is always
+   * gathered, even if the node is larger than CompositeSummaryThreshold. This
+   * is used to expand summarized nodes. Default is -1.
+   */
+  vtkSetMacro(SubtreeCompositeIndex, int);
+  vtkGetMacro(SubtreeCompositeIndex, int);
+  //@}
+
   /**
    * Transfer information about a single object into this object.
    */
@@ -344,6 +369,8 @@ private:
   void operator=(const vtkPVDataInformation&) = delete;
 
   int PortNumber;
+  int CompositeSummaryThreshold;
+  int SubtreeCompositeIndex;
 };
 
 #endif
@@ -30,6 +30,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPVConfig.h"
 #include "vtkPointData.h"
+#include "vtkQueryExtractSelection.h"
 #include "vtkSelection.h"
 #include "vtkSelectionNode.h"
 #include "vtkSmartPointer.h"
@@ -129,27 +130,47 @@ int vtkPVExtractSelection::RequestData(
 
   if (sel->GetNumberOfNodes() >= 1 && sel->GetNode(0)->GetContentType() == vtkSelectionNode::QUERY)
   {
-#ifdef PARAVIEW_ENABLE_PYTHON
-    vtkPythonExtractSelection* pythonExtractSelection = vtkPythonExtractSelection::New();
-
     vtkDataObject* localInputDO = inputDO->NewInstance();
     localInputDO->ShallowCopy(inputDO);
 
     vtkSelection* localSel = sel->NewInstance();
     localSel->ShallowCopy(sel);
 
-    pythonExtractSelection->SetInputData(0, localInputDO);
-    pythonExtractSelection->SetInputData(1, localSel);
-    pythonExtractSelection->SetPreserveTopology(this->PreserveTopology);
+    // Evaluate the query natively when possible, the Python path is only
+    // needed for expressions vtkPVExpressionEvaluator does not support.
+    vtkQueryExtractSelection* queryExtractSelection = vtkQueryExtractSelection::New();
+    queryExtractSelection->SetInputData(0, localInputDO);
+    queryExtractSelection->SetInputData(1, localSel);
+    queryExtractSelection->SetPreserveTopology(this->PreserveTopology);
+    queryExtractSelection->Update();
 
-    pythonExtractSelection->Update();
+    if (queryExtractSelection->GetQueryEvaluated())
+    {
+      outputDO->ShallowCopy(queryExtractSelection->GetOutputDataObject(0));
+    }
+    else
+    {
+#ifdef PARAVIEW_ENABLE_PYTHON
+      vtkPythonExtractSelection* pythonExtractSelection = vtkPythonExtractSelection::New();
+      pythonExtractSelection->SetInputData(0, localInputDO);
+      pythonExtractSelection->SetInputData(1, localSel);
+      pythonExtractSelection->SetPreserveTopology(this->PreserveTopology);
 
-    outputDO->ShallowCopy(pythonExtractSelection->GetOutputDataObject(0));
+      pythonExtractSelection->Update();
 
-    pythonExtractSelection->Delete();
+      outputDO->ShallowCopy(pythonExtractSelection->GetOutputDataObject(0));
+
+      pythonExtractSelection->Delete();
+#else
+      vtkErrorMacro("Failed to evaluate query '"
+        << (sel->GetNode(0)->GetQueryString() ? sel->GetNode(0)->GetQueryString() : "")
+        << "': " << queryExtractSelection->GetEvaluationError());
+#endif // PARAVIEW_ENABLE_PYTHON
+    }
+
+    queryExtractSelection->Delete();
     localSel->Delete();
     localInputDO->Delete();
-#endif // PARAVIEW_ENABLE_PYTHON
   }
   else
   {
@@ -139,6 +139,21 @@ public:
   vtkSetMacro(ReadDetailedFileInformation, bool);
   //@}
 
+  //@{
+  /**
+   * Get/Set the range of directory entries to return when listing a
+   * directory. Entries are sorted by name and file sequences are grouped
+   * before the range is applied, so a client can fetch a large directory
+   * page by page. The total number of entries is reported by
+   * vtkPVFileInformation::GetTotalNumberOfEntries(). A PageSize of 0
+   * (default) returns all entries starting at PageOffset.
+   */
+  vtkGetMacro(PageOffset, int);
+  vtkSetClampMacro(PageOffset, int, 0, VTK_INT_MAX);
+  vtkGetMacro(PageSize, int);
+  vtkSetClampMacro(PageSize, int, 0, VTK_INT_MAX);
+  //@}
+
 protected:
   vtkPVFileInformationHelper();
   ~vtkPVFileInformationHelper() override;
@@ -150,6 +165,8 @@ protected:
   int FastFileTypeDetection;
 
   bool ReadDetailedFileInformation;
+  int PageOffset;
+  int PageSize;
   char* PathSeparator;
   vtkSetStringMacro(PathSeparator);
 
@@ -18,6 +18,7 @@
 vtkPVInformation::vtkPVInformation()
 {
   this->RootOnly = 0;
+  this->GatherConcurrently = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -30,6 +31,7 @@ void vtkPVInformation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "RootOnly: " << this->RootOnly << endl;
+  os << indent << "GatherConcurrently: " << this->GatherConcurrently << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -70,6 +70,17 @@ public:
   vtkGetMacro(RootOnly, int);
   //@}
 
+  //@{
+  /**
+   * Get whether the information can be gathered on a separate thread while
+   * the pipeline executes, i.e. it is gathered from the root only and never
+   * touches pipeline objects nor the client-server interpreter. Servers may
+   * then answer such requests while a pipeline update is in progress (see
+   * vtkPVSessionServer::SetConcurrentRequests).
+   */
+  vtkGetMacro(GatherConcurrently, int);
+  //@}
+
 protected:
   vtkPVInformation();
   ~vtkPVInformation() override;
@@ -77,6 +88,9 @@ protected:
   int RootOnly;
   vtkSetMacro(RootOnly, int);
 
+  int GatherConcurrently;
+  vtkSetMacro(GatherConcurrently, int);
+
   vtkPVInformation(const vtkPVInformation&) = delete;
   void operator=(const vtkPVInformation&) = delete;
 };
@@ -55,6 +55,8 @@ vtkPVOptions::vtkPVOptions()
   this->ServerMode = 0;
   this->MultiClientMode = 0;
   this->DisableFurtherConnections = 0;
+  this->ConcurrentRequests = 0;
+  this->PartialOutputInterval = 0;
   this->MultiClientModeWithErrorMacro = 0;
   this->MultiServerMode = 0;
   this->RenderServerMode = 0;
@@ -160,6 +162,18 @@ void vtkPVOptions::Initialize()
     "Does nothing without --multi-clients enabled.",
     vtkPVOptions::PVDATA_SERVER | vtkPVOptions::PVSERVER);
 
+  this->AddBooleanArgument("--concurrent-requests", 0, &this->ConcurrentRequests,
+    "Answer the client requests that do not touch the pipeline, e.g. file "
+    "listings, on a separate thread while a pipeline update is in progress. "
+    "Does nothing with --multi-clients enabled.",
+    vtkPVOptions::PVDATA_SERVER | vtkPVOptions::PVSERVER);
+
+  this->AddArgument("--partial-output-interval", 0, &this->PartialOutputInterval,
+    "EXPERIMENTAL: Interval, in seconds, at which long-running filters and "
+    "readers that support it emit partial outputs. Partial outputs are shown "
+    "when --enable-streaming is specified as well.",
+    vtkPVOptions::ALLPROCESS);
+
   this->AddBooleanArgument("--multi-servers", 0, &this->MultiServerMode,
     "Allow client to connect to several pvserver", vtkPVOptions::PVCLIENT);
 
@@ -475,6 +489,16 @@ void vtkPVOptions::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "Disable further connections after the first client connects to a server..\n";
   }
 
+  if (this->ConcurrentRequests)
+  {
+    os << indent << "Answer requests that do not touch the pipeline concurrently.\n";
+  }
+
+  if (this->PartialOutputInterval > 0)
+  {
+    os << indent << "Emit partial outputs every " << this->PartialOutputInterval << " seconds.\n";
+  }
+
   if (this->MultiServerMode)
   {
     os << indent << "Allow a client to connect to multiple servers at the same time.\n";
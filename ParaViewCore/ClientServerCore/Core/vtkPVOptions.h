@@ -142,6 +142,23 @@ public:
   vtkGetMacro(DisableFurtherConnections, int);
   //@}
 
+  //@{
+  /**
+   * Returns if this server answers the requests that do not touch the
+   * pipeline on a separate thread while a pipeline update is in progress.
+   */
+  vtkGetMacro(ConcurrentRequests, int);
+  //@}
+
+  //@{
+  /**
+   * Returns the interval, in seconds, at which long-running algorithms
+   * supporting it emit partial outputs (see vtkPVProgressiveExecution).
+   * 0 (default) disables partial outputs.
+   */
+  vtkGetMacro(PartialOutputInterval, int);
+  //@}
+
   //@{
   /**
    * Is this client allow multiple server connection in parallel
@@ -321,6 +338,8 @@ protected:
   int RenderServerMode;
   int MultiClientMode;
   int DisableFurtherConnections;
+  int ConcurrentRequests;
+  int PartialOutputInterval;
   int MultiClientModeWithErrorMacro;
   int MultiServerMode;
   int SymmetricMPIMode;
@@ -22,13 +22,21 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutputWindow.h"
+#include "vtkPVConfig.h"
 #include "vtkPVOptions.h"
+#include "vtkPVProgressiveExecution.h"
 #include "vtkPVSession.h"
 #include "vtkProcessModule.h"
 #include "vtkTimerLog.h"
 
+#ifdef PARAVIEW_USE_MPI
+#include "vtkMPICommunicator.h"
+#include "vtkMPIController.h"
+#endif
+
 #include <map>
 #include <string>
+#include <vector>
 
 // define this variable to disable progress all together. This may be useful to
 // doing really large runs.
@@ -66,10 +74,23 @@ public:
   bool EnableProgress;
 
   vtkNew<vtkTimerLog> ProgressTimer;
+
+  // Set once the root sent the abort request to the other ranks, or once a
+  // satellite received it, during the current execution.
+  bool AbortForwarded;
+#ifdef PARAVIEW_USE_MPI
+  int AbortMessage;
+  std::vector<vtkMPICommunicator::Request> AbortRequests;
+#endif
+
   vtkInternals()
   {
     this->EnableProgress = false;
     this->DisableProgressHandling = false;
+    this->AbortForwarded = false;
+#ifdef PARAVIEW_USE_MPI
+    this->AbortMessage = 1;
+#endif
 
 #ifdef PV_DISABLE_PROGRESS_HANDLING
     this->DisableProgressHandling = true;
@@ -153,6 +174,9 @@ void vtkPVProgressHandler::SetSession(vtkPVSession* conn)
 //----------------------------------------------------------------------------
 void vtkPVProgressHandler::PrepareProgress()
 {
+  // Forget about aborts requested before this execution.
+  vtkPVProgressiveExecution::BeginExecution();
+
   if (this->AddedHandlers == false)
   {
     vtkMultiProcessController* ds_controller =
@@ -186,6 +210,9 @@ void vtkPVProgressHandler::PrepareProgress()
 //----------------------------------------------------------------------------
 void vtkPVProgressHandler::CleanupPendingProgress()
 {
+  // Roll back the algorithms aborted during the execution, on all ranks.
+  vtkPVProgressiveExecution::EndExecution();
+
   SKIP_IF_DISABLED();
 
   if (!this->Internals->EnableProgress)
@@ -198,6 +225,8 @@ void vtkPVProgressHandler::CleanupPendingProgress()
     return;
   }
 
+  this->CleanupAbortForwarding();
+
   vtkMultiProcessController* mpiController = vtkMultiProcessController::GetGlobalController();
   if (mpiController && mpiController->GetNumberOfProcesses() > 1)
   {
@@ -211,7 +240,9 @@ void vtkPVProgressHandler::CleanupPendingProgress()
   if (client_controller != NULL)
   {
     char temp = 0;
+    this->Session->LockClientCommunication();
     client_controller->Send(&temp, 1, 1, CLEANUP_TAG);
+    this->Session->UnlockClientCommunication();
   }
 
   // On client-node (or builtin client) mode, we wait till the server-root-nodes
@@ -239,12 +270,18 @@ void vtkPVProgressHandler::CleanupPendingProgress()
 //----------------------------------------------------------------------------
 void vtkPVProgressHandler::OnProgressEvent(vtkObject* caller, unsigned long eventid, void* calldata)
 {
+  // Algorithms executing after an abort work on truncated data, they are
+  // rolled back along with the aborted one.
+  vtkPVProgressiveExecution::ReportExecution(vtkAlgorithm::SafeDownCast(caller));
+
   SKIP_IF_DISABLED();
   if (!this->Internals->EnableProgress || eventid != vtkCommand::ProgressEvent)
   {
     return;
   }
 
+  this->ForwardAbortRequest();
+
   // Try to clamp frequent progress events.
   this->Internals->ProgressTimer->StopTimer();
   // cout <<"Elapsed: " << this->Internals->ProgressTimer->GetElapsedTime() <<
@@ -272,6 +309,83 @@ void vtkPVProgressHandler::OnProgressEvent(vtkObject* caller, unsigned long even
   this->RefreshProgress(text.c_str(), progress);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVProgressHandler::ForwardAbortRequest()
+{
+#ifdef PARAVIEW_USE_MPI
+  vtkMPIController* controller =
+    vtkMPIController::SafeDownCast(vtkMultiProcessController::GetGlobalController());
+  vtkInternals& internals = *this->Internals;
+  if (!controller || controller->GetNumberOfProcesses() <= 1 || internals.AbortForwarded)
+  {
+    return;
+  }
+
+  if (controller->GetLocalProcessId() == 0)
+  {
+    // The root sends the request to the other ranks once, without waiting for
+    // them to pick it up.
+    if (vtkPVProgressiveExecution::GetAbortRequested())
+    {
+      internals.AbortForwarded = true;
+      const int numProcs = controller->GetNumberOfProcesses();
+      internals.AbortRequests.resize(numProcs - 1);
+      for (int cc = 1; cc < numProcs; ++cc)
+      {
+        controller->NoBlockSend(&internals.AbortMessage, 1, cc,
+          vtkPVProgressHandler::ABORT_EXECUTION_TAG, internals.AbortRequests[cc - 1]);
+      }
+    }
+    return;
+  }
+
+  vtkMPICommunicator* communicator =
+    vtkMPICommunicator::SafeDownCast(controller->GetCommunicator());
+  int pending = 0;
+  int source = 0;
+  if (communicator &&
+    communicator->Iprobe(0, vtkPVProgressHandler::ABORT_EXECUTION_TAG, &pending, &source) &&
+    pending)
+  {
+    controller->Receive(&internals.AbortMessage, 1, 0, vtkPVProgressHandler::ABORT_EXECUTION_TAG);
+    internals.AbortForwarded = true;
+    vtkPVProgressiveExecution::RequestAbort();
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProgressHandler::CleanupAbortForwarding()
+{
+  vtkInternals& internals = *this->Internals;
+#ifdef PARAVIEW_USE_MPI
+  vtkMPIController* controller =
+    vtkMPIController::SafeDownCast(vtkMultiProcessController::GetGlobalController());
+  if (controller && controller->GetNumberOfProcesses() > 1)
+  {
+    // Satellites that had no progress event since the root forwarded the
+    // request still have to receive it, so that it does not abort the next
+    // execution.
+    int forwarded = internals.AbortForwarded ? 1 : 0;
+    controller->Broadcast(&forwarded, 1, 0);
+    if (controller->GetLocalProcessId() == 0)
+    {
+      for (size_t cc = 0; cc < internals.AbortRequests.size(); ++cc)
+      {
+        internals.AbortRequests[cc].Wait();
+      }
+      internals.AbortRequests.clear();
+    }
+    else if (forwarded && !internals.AbortForwarded)
+    {
+      controller->Receive(
+        &internals.AbortMessage, 1, 0, vtkPVProgressHandler::ABORT_EXECUTION_TAG);
+    }
+  }
+#endif
+  internals.AbortForwarded = false;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVProgressHandler::RefreshProgress(const char* progress_text, double progress)
 {
@@ -291,7 +405,9 @@ void vtkPVProgressHandler::RefreshProgress(const char* progress_text, double pro
     memcpy(buffer + sizeof(double), progress_text, progress_text_len);
     buffer[progress_text_len + sizeof(double)] = 0;
 
+    this->Session->LockClientCommunication();
     client_controller->Send(buffer, message_size, 1, vtkPVProgressHandler::PROGRESS_EVENT_TAG);
+    this->Session->UnlockClientCommunication();
     delete[] buffer;
   }
 
@@ -381,8 +497,10 @@ void vtkPVProgressHandler::RefreshMessage(const char* message)
   if (client_controller != NULL && message != NULL)
   {
     // only true of server-nodes.
+    this->Session->LockClientCommunication();
     client_controller->Send(
       message, strlen(message) + 1, 1, vtkPVProgressHandler::MESSAGE_EVENT_TAG);
+    this->Session->UnlockClientCommunication();
   }
 
   this->SetLastMessage(message);
@@ -112,7 +112,8 @@ protected:
   {
     CLEANUP_TAG = 188969,
     PROGRESS_EVENT_TAG = 188970,
-    MESSAGE_EVENT_TAG = 188971
+    MESSAGE_EVENT_TAG = 188971,
+    ABORT_EXECUTION_TAG = 188972
   };
 
   //@{
@@ -142,6 +143,17 @@ private:
    */
   bool OnWrongTagEvent(vtkObject* caller, unsigned long eventid, void* calldata);
 
+  //@{
+  /**
+   * The root forwards abort requests (see vtkPVProgressiveExecution) to the
+   * other ranks with point-to-point messages, which they pick up on their
+   * progress events. CleanupAbortForwarding() is called on all ranks at the
+   * end of the execution to receive the messages they missed.
+   */
+  void ForwardAbortRequest();
+  void CleanupAbortForwarding();
+  //@}
+
   bool AddedHandlers;
   class vtkInternals;
   vtkInternals* Internals;
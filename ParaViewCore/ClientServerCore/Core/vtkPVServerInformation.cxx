@@ -68,6 +68,7 @@ vtkPVServerInformation::vtkPVServerInformation()
   this->NumberOfProcesses = controller ? controller->GetNumberOfProcesses() : 1;
   this->MPIInitialized = controller ? controller->IsA("vtkMPIController") != 0 : false;
   this->RootOnly = 1;
+  this->GatherConcurrently = 1;
   this->RemoteRendering = 1;
   this->TileDimensions[0] = this->TileDimensions[1] = 0;
   this->TileMullions[0] = this->TileMullions[1] = 0;
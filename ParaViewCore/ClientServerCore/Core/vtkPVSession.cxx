@@ -16,11 +16,19 @@
 
 #include "vtkObjectFactory.h"
 #include "vtkPVProgressHandler.h"
+#include "vtkPVProgressiveExecution.h"
 #include "vtkPVServerInformation.h"
 
+#include <mutex>
+
+class vtkPVSession::vtkClientCommunicationMutex : public std::recursive_mutex
+{
+};
+
 //----------------------------------------------------------------------------
 vtkPVSession::vtkPVSession()
 {
+  this->ClientCommunicationMutex = new vtkClientCommunicationMutex();
   this->ProgressHandler = vtkPVProgressHandler::New();
   this->ProgressHandler->SetSession(this); // not reference counted.
   this->ProgressCount = 0;
@@ -33,6 +41,20 @@ vtkPVSession::~vtkPVSession()
   this->ProgressHandler->SetSession(NULL);
   this->ProgressHandler->Delete();
   this->ProgressHandler = NULL;
+  delete this->ClientCommunicationMutex;
+  this->ClientCommunicationMutex = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSession::LockClientCommunication()
+{
+  this->ClientCommunicationMutex->lock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSession::UnlockClientCommunication()
+{
+  this->ClientCommunicationMutex->unlock();
 }
 
 //----------------------------------------------------------------------------
@@ -53,6 +75,12 @@ bool vtkPVSession::GetPendingProgress()
   return (this->InCleanupPendingProgress || this->ProgressCount > 0);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSession::RequestAbort()
+{
+  vtkPVProgressiveExecution::RequestAbort();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSession::PrepareProgress()
 {
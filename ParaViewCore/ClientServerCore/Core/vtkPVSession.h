@@ -117,6 +117,27 @@ public:
    */
   bool GetPendingProgress();
 
+  /**
+   * Requests the execution in progress to be aborted. Algorithms polling
+   * vtkPVProgressiveExecution::CheckAbort() stop on all ranks. This is meant
+   * to be called while waiting for the execution, e.g. from a progress
+   * observer. The default implementation requests the abort in this process,
+   * clients forward the request to the servers.
+   */
+  virtual void RequestAbort();
+
+  //@{
+  /**
+   * Lock/unlock the communication with the client. On servers that answer
+   * some client requests on a separate thread (see
+   * vtkPVSessionServer::SetConcurrentRequests), messages sent to the client,
+   * e.g. progress, must be sent while holding this lock so that they are not
+   * interleaved with the replies sent by that thread. The lock is recursive.
+   */
+  void LockClientCommunication();
+  void UnlockClientCommunication();
+  //@}
+
 protected:
   vtkPVSession();
   ~vtkPVSession() override;
@@ -150,6 +171,9 @@ private:
   // This flags ensures that while we are waiting for an previous progress-pair
   // to finish, we don't start new progress-pairs.
   bool InCleanupPendingProgress;
+
+  class vtkClientCommunicationMutex;
+  vtkClientCommunicationMutex* ClientCommunicationMutex;
 };
 
 #endif
@@ -18,16 +18,71 @@
 #include "vtkAlgorithmOutput.h"
 #include "vtkClientServerStream.h"
 #include "vtkDataObject.h"
+#include "vtkExecutive.h"
 #include "vtkInformation.h"
+#include "vtkInformationExecutivePortKey.h"
+#include "vtkInformationObjectBaseKey.h"
+#include "vtkInformationVector.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVArrayInformation.h"
 #include "vtkPVDataInformation.h"
 #include "vtkPVDataSetAttributesInformation.h"
+#include "vtkPVInformationKeys.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
+// Information gathered for the timesteps produced by an output port, stored in
+// its output information until the pipeline is modified.
+class vtkPVTemporalDataInformationCache : public vtkObject
+{
+public:
+  static vtkPVTemporalDataInformationCache* New();
+  vtkTypeMacro(vtkPVTemporalDataInformationCache, vtkObject);
+
+  static vtkInformationObjectBaseKey* CACHE();
+
+  /**
+   * Returns the cache for the output with the given information, emptied if
+   * the pipeline was modified since it was filled.
+   */
+  static vtkPVTemporalDataInformationCache* GetCache(vtkInformation* outInfo);
+
+  /**
+   * Returns the information for the given timestep, gathered from dobj if
+   * it is not cached yet.
+   */
+  vtkPVTemporalDataInformation* GetTimeStep(vtkDataObject* dobj, double time);
+
+  vtkPVTemporalDataInformation* AddTimeStep(double time, vtkPVDataInformation* dinfo);
+
+  vtkMTimeType PipelineMTime;
+  typedef std::map<double, vtkSmartPointer<vtkPVTemporalDataInformation> > TimeStepsType;
+  TimeStepsType TimeSteps;
+
+protected:
+  vtkPVTemporalDataInformationCache()
+    : PipelineMTime(0)
+  {
+  }
+  ~vtkPVTemporalDataInformationCache() override {}
+
+private:
+  vtkPVTemporalDataInformationCache(const vtkPVTemporalDataInformationCache&) = delete;
+  void operator=(const vtkPVTemporalDataInformationCache&) = delete;
+};
+
+vtkStandardNewMacro(vtkPVTemporalDataInformationCache);
+vtkInformationKeyMacro(vtkPVTemporalDataInformationCache, CACHE, ObjectBase);
+
 vtkStandardNewMacro(vtkPVTemporalDataInformation);
 //----------------------------------------------------------------------------
 vtkPVTemporalDataInformation::vtkPVTemporalDataInformation()
@@ -130,6 +185,161 @@ void vtkPVTemporalDataInformation::CopyParametersFromStream(vtkMultiProcessStrea
   }
 }
 
+//----------------------------------------------------------------------------
+vtkPVTemporalDataInformationCache* vtkPVTemporalDataInformationCache::GetCache(
+  vtkInformation* outInfo)
+{
+  vtkDemandDrivenPipeline* ddp =
+    vtkDemandDrivenPipeline::SafeDownCast(vtkExecutive::PRODUCER()->GetExecutive(outInfo));
+  if (!ddp)
+  {
+    return NULL;
+  }
+
+  vtkPVTemporalDataInformationCache* cache =
+    vtkPVTemporalDataInformationCache::SafeDownCast(outInfo->Get(CACHE()));
+  if (!cache)
+  {
+    cache = vtkPVTemporalDataInformationCache::New();
+    outInfo->Set(CACHE(), cache);
+    cache->FastDelete();
+  }
+  if (cache->PipelineMTime != ddp->GetPipelineMTime())
+  {
+    cache->TimeSteps.clear();
+    cache->PipelineMTime = ddp->GetPipelineMTime();
+  }
+  return cache;
+}
+
+//----------------------------------------------------------------------------
+vtkPVTemporalDataInformation* vtkPVTemporalDataInformationCache::GetTimeStep(
+  vtkDataObject* dobj, double time)
+{
+  TimeStepsType::iterator iter = this->TimeSteps.find(time);
+  if (iter != this->TimeSteps.end())
+  {
+    return iter->second;
+  }
+
+  vtkNew<vtkPVDataInformation> dinfo;
+  dinfo->CopyFromObject(dobj);
+  return this->AddTimeStep(time, dinfo.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+vtkPVTemporalDataInformation* vtkPVTemporalDataInformationCache::AddTimeStep(
+  double time, vtkPVDataInformation* dinfo)
+{
+  vtkSmartPointer<vtkPVTemporalDataInformation>& info = this->TimeSteps[time];
+  info = vtkSmartPointer<vtkPVTemporalDataInformation>::New();
+  info->AddInformation(dinfo);
+  return info;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTemporalDataInformation::CacheTimeStep(
+  vtkInformation* outInfo, vtkPVDataInformation* dinfo)
+{
+  vtkDataObject* dobj = outInfo ? vtkDataObject::GetData(outInfo) : NULL;
+  if (!dobj || !dinfo->GetHasTime() ||
+    !(outInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()) ||
+      outInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_RANGE())))
+  {
+    return;
+  }
+
+  vtkPVTemporalDataInformationCache* cache = vtkPVTemporalDataInformationCache::GetCache(outInfo);
+  // the pipeline may have been modified since the data was produced, in which
+  // case the information does not describe the data for that timestep anymore.
+  if (cache && dobj->GetUpdateTime() > cache->PipelineMTime)
+  {
+    cache->AddTimeStep(dinfo->GetTime(), dinfo);
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVTemporalDataInformation::AddTemporalArrayRanges(
+  vtkInformation* outInfo, vtkPVTemporalDataInformation* current)
+{
+  vtkInformationVector* ranges = outInfo->Get(vtkPVInformationKeys::TEMPORAL_ARRAY_RANGES());
+  if (!ranges || !outInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+  {
+    return false;
+  }
+
+  const int numTimeSteps = outInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  const int numRanges = ranges->GetNumberOfInformationObjects();
+
+  // the ranges can only be used when they cover all the arrays.
+  std::set<std::pair<int, std::string> > described;
+  for (int cc = 0; cc < numRanges; ++cc)
+  {
+    vtkInformation* arrayInfo = ranges->GetInformationObject(cc);
+    if (arrayInfo->Has(vtkDataObject::FIELD_NAME()) &&
+      arrayInfo->Has(vtkDataObject::FIELD_ASSOCIATION()))
+    {
+      described.insert(std::make_pair(arrayInfo->Get(vtkDataObject::FIELD_ASSOCIATION()),
+        std::string(arrayInfo->Get(vtkDataObject::FIELD_NAME()))));
+    }
+  }
+  for (int attr = 0; attr < vtkDataObject::NUMBER_OF_ASSOCIATIONS; ++attr)
+  {
+    vtkPVDataSetAttributesInformation* dsa = current->GetAttributeInformation(attr);
+    for (int cc = 0, max = dsa ? dsa->GetNumberOfArrays() : 0; cc < max; ++cc)
+    {
+      const char* name = dsa->GetArrayInformation(cc)->GetName();
+      if (!name || described.find(std::make_pair(attr, std::string(name))) == described.end())
+      {
+        return false;
+      }
+    }
+  }
+
+  for (int cc = 0; cc < numRanges; ++cc)
+  {
+    vtkInformation* arrayInfo = ranges->GetInformationObject(cc);
+    if (!arrayInfo->Has(vtkDataObject::FIELD_NAME()) ||
+      !arrayInfo->Has(vtkDataObject::FIELD_ASSOCIATION()) ||
+      !arrayInfo->Has(vtkDataObject::FIELD_NUMBER_OF_COMPONENTS()) ||
+      !arrayInfo->Has(vtkPVInformationKeys::TEMPORAL_RANGES()))
+    {
+      continue;
+    }
+    vtkPVArrayInformation* ainfo =
+      this->GetArrayInformation(arrayInfo->Get(vtkDataObject::FIELD_NAME()),
+        arrayInfo->Get(vtkDataObject::FIELD_ASSOCIATION()));
+    const int numComps = arrayInfo->Get(vtkDataObject::FIELD_NUMBER_OF_COMPONENTS());
+    const int numSlots = numComps > 1 ? numComps + 1 : numComps;
+    if (!ainfo || ainfo->GetNumberOfComponents() != numComps ||
+      arrayInfo->Length(vtkPVInformationKeys::TEMPORAL_RANGES()) != 2 * numSlots * numTimeSteps)
+    {
+      continue;
+    }
+
+    const double* values = arrayInfo->Get(vtkPVInformationKeys::TEMPORAL_RANGES());
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+      // the last slot of multi-component arrays is the magnitude.
+      const int comp = slot == numComps ? -1 : slot;
+      double range[2], finiteRange[2];
+      ainfo->GetComponentRange(comp, range);
+      ainfo->GetComponentFiniteRange(comp, finiteRange);
+      for (int ts = 0; ts < numTimeSteps; ++ts)
+      {
+        const double* tsRange = values + 2 * (ts * numSlots + slot);
+        range[0] = std::min(range[0], tsRange[0]);
+        range[1] = std::max(range[1], tsRange[1]);
+        finiteRange[0] = std::min(finiteRange[0], tsRange[0]);
+        finiteRange[1] = std::max(finiteRange[1], tsRange[1]);
+      }
+      ainfo->SetComponentRange(comp, range);
+      ainfo->SetComponentFiniteRange(comp, finiteRange);
+    }
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVTemporalDataInformation::CopyFromObject(vtkObject* object)
 {
@@ -149,23 +359,39 @@ void vtkPVTemporalDataInformation::CopyFromObject(vtkObject* object)
 
   port->GetProducer()->Update();
   vtkDataObject* dobj = port->GetProducer()->GetOutputDataObject(port->GetIndex());
+  vtkInformation* pipelineInfo = port->GetProducer()->GetOutputInformation(port->GetIndex());
 
   // Collect current information.
-  vtkSmartPointer<vtkPVDataInformation> dinfo = vtkSmartPointer<vtkPVDataInformation>::New();
-  dinfo->CopyFromObject(dobj);
-  this->AddInformation(dinfo);
-
-  if (!dinfo->GetHasTime() || dinfo->GetTimeSpan()[0] == dinfo->GetTimeSpan()[1])
+  const bool hasTime = dobj->GetInformation()->Has(vtkDataObject::DATA_TIME_STEP()) != 0;
+  const bool hasTimeSteps = pipelineInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()) != 0;
+  const double* timeRange = pipelineInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+  if (!hasTime || (timeRange && timeRange[0] == timeRange[1]) || (!timeRange && !hasTimeSteps))
   {
     // nothing temporal about this data! Nothing to do.
+    vtkNew<vtkPVDataInformation> dinfo;
+    dinfo->CopyFromObject(dobj);
+    this->AddInformation(dinfo.GetPointer());
+    return;
+  }
+
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(port->GetProducer()->GetExecutive());
+  vtkPVTemporalDataInformationCache* cache =
+    vtkPVTemporalDataInformationCache::GetCache(pipelineInfo);
+  if (!sddp || !cache)
+  {
+    vtkErrorMacro("This class expects vtkStreamingDemandDrivenPipeline.");
     return;
   }
 
+  const double current_time = dobj->GetInformation()->Get(vtkDataObject::DATA_TIME_STEP());
+  vtkPVTemporalDataInformation* current = cache->GetTimeStep(dobj, current_time);
+  this->AddInformation(current);
+
   // We are not assured that this data has time. We currently only handle
   // timesteps properly, for contiguous time-range, we simply use the first and
   // last time value as the 2 timesteps.
 
-  vtkInformation* pipelineInfo = port->GetProducer()->GetOutputInformation(port->GetIndex());
   std::vector<double> timesteps;
   if (pipelineInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
   {
@@ -186,16 +412,17 @@ void vtkPVTemporalDataInformation::CopyFromObject(vtkObject* object)
     this->NumberOfTimeSteps = 0;
   }
 
-  std::vector<double>::iterator iter;
-  vtkStreamingDemandDrivenPipeline* sddp =
-    vtkStreamingDemandDrivenPipeline::SafeDownCast(port->GetProducer()->GetExecutive());
-  if (!sddp)
+  // Readers may know the ranges from the file metadata, in which case the
+  // other timesteps don't need to be read.
+  if (this->AddTemporalArrayRanges(pipelineInfo, current))
   {
-    vtkErrorMacro("This class expects vtkStreamingDemandDrivenPipeline.");
     return;
   }
 
-  double current_time = dinfo->GetTime();
+  // Timesteps seen before, by this class or by vtkPVDataInformation, are
+  // cached until the pipeline is modified. All processes take part in the same
+  // gathers, hence they execute the same timesteps.
+  std::vector<double>::iterator iter;
   for (iter = timesteps.begin(); iter != timesteps.end(); ++iter)
   {
     if (*iter == current_time)
@@ -203,13 +430,19 @@ void vtkPVTemporalDataInformation::CopyFromObject(vtkObject* object)
       // skip the timestep already seen.
       continue;
     }
+    vtkPVTemporalDataInformationCache::TimeStepsType::iterator cached =
+      cache->TimeSteps.find(*iter);
+    if (cached != cache->TimeSteps.end())
+    {
+      this->AddInformation(cached->second);
+      continue;
+    }
+
     pipelineInfo->Set(sddp->UPDATE_TIME_STEP(), *iter);
     sddp->Update(port->GetIndex());
 
     dobj = port->GetProducer()->GetOutputDataObject(port->GetIndex());
-    dinfo->Initialize();
-    dinfo->CopyFromObject(dobj);
-    this->AddInformation(dinfo);
+    this->AddInformation(cache->GetTimeStep(dobj, *iter));
   }
 }
 
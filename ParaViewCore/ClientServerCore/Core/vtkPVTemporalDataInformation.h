@@ -20,6 +20,13 @@
  * and hence this is not directly a subclass of vtkPVDataInformation. It
  * internally uses vtkPVDataInformation to collect information about each
  * timestep.
+ *
+ * The information for each timestep is cached on the server, in the output
+ * information of the port, until the pipeline is modified. The cache is also
+ * filled by vtkPVDataInformation as timesteps are visited, hence repeated
+ * gathers only execute the pipeline for timesteps never seen before. When the
+ * producer provides vtkPVInformationKeys::TEMPORAL_ARRAY_RANGES() for all of
+ * its arrays, the pipeline is not executed for other timesteps at all.
 */
 
 #ifndef vtkPVTemporalDataInformation_h
@@ -28,7 +35,9 @@
 #include "vtkPVClientServerCoreCoreModule.h" //needed for exports
 #include "vtkPVInformation.h"
 
+class vtkInformation;
 class vtkPVArrayInformation;
+class vtkPVDataInformation;
 class vtkPVDataSetAttributesInformation;
 
 class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVTemporalDataInformation : public vtkPVInformation
@@ -135,10 +144,24 @@ public:
    */
   vtkPVArrayInformation* GetArrayInformation(const char* arrayname, int fieldAssociation);
 
+  /**
+   * Caches dinfo, the information gathered for the data produced for the
+   * output with the given pipeline information, for use by later temporal
+   * gathers. Called by vtkPVDataInformation.
+   */
+  static void CacheTimeStep(vtkInformation* outInfo, vtkPVDataInformation* dinfo);
+
 protected:
   vtkPVTemporalDataInformation();
   ~vtkPVTemporalDataInformation() override;
 
+  /**
+   * Merges the ranges provided with vtkPVInformationKeys::TEMPORAL_ARRAY_RANGES()
+   * in outInfo. Returns false, without merging anything, unless they cover
+   * all the arrays of current, the information for the current timestep.
+   */
+  bool AddTemporalArrayRanges(vtkInformation* outInfo, vtkPVTemporalDataInformation* current);
+
   vtkPVDataSetAttributesInformation* PointDataInformation;
   vtkPVDataSetAttributesInformation* CellDataInformation;
   vtkPVDataSetAttributesInformation* FieldDataInformation;
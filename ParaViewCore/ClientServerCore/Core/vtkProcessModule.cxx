@@ -29,6 +29,7 @@
 #include "vtkPVConfig.h"
 #include "vtkPVConfig.h"
 #include "vtkPVOptions.h"
+#include "vtkPVProgressiveExecution.h"
 #include "vtkSessionIterator.h"
 #include "vtkStdString.h"
 #include "vtkTCPNetworkAccessManager.h"
@@ -530,6 +531,7 @@ void vtkProcessModule::SetOptions(vtkPVOptions* options)
   if (options)
   {
     this->SetSymmetricMPIMode(options->GetSymmetricMPIMode() != 0);
+    vtkPVProgressiveExecution::SetPartialOutputInterval(options->GetPartialOutputInterval());
   }
 }
 
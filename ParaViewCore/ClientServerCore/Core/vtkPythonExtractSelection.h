@@ -17,48 +17,32 @@
  *
  * vtkPythonExtractSelection is a used to extra cells/points using numpy. This
  * enables creation of arbitrary queries to be used as the selection criteria.
+ * Queries that vtkQueryExtractSelection can evaluate natively should be
+ * evaluated with it instead, as vtkPVExtractSelection does.
 */
 
 #ifndef vtkPythonExtractSelection_h
 #define vtkPythonExtractSelection_h
 
-#include "vtkExtractSelectionBase.h"
 #include "vtkPVClientServerCoreCoreModule.h" //needed for exports
+#include "vtkQueryExtractSelection.h"
 
-class vtkCompositeDataSet;
-
-class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPythonExtractSelection : public vtkExtractSelectionBase
+class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPythonExtractSelection : public vtkQueryExtractSelection
 {
 public:
   static vtkPythonExtractSelection* New();
-  vtkTypeMacro(vtkPythonExtractSelection, vtkExtractSelectionBase);
+  vtkTypeMacro(vtkPythonExtractSelection, vtkQueryExtractSelection);
   void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
 
-  //@{
-  /**
-   * Method called by Python code to handle the extraction logic.
-   * \c attributeType is vtkDataObject::AttributeTypes and not to be confused with
-   * vtkSelectionNode::SelectionField
-   */
-  bool ExtractElements(int attributeType, vtkDataObject* input, vtkDataObject* output);
-  bool ExtractElements(int attributeType, vtkCompositeDataSet* input, vtkCompositeDataSet* output);
-  //@}
-
 protected:
   vtkPythonExtractSelection();
   ~vtkPythonExtractSelection() override;
 
-  int FillInputPortInformation(int port, vtkInformation* info) VTK_OVERRIDE;
-  int RequestDataObject(vtkInformation* request, vtkInformationVector** inputVector,
-    vtkInformationVector* outputVector) VTK_OVERRIDE;
-  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) VTK_OVERRIDE;
-
   /**
-   * Method used to initialize the output data object in request data.
-   * The output data is initialized based on the state of
-   * this->PreserveTopology.
+   * Evaluates the query with numpy. The Python code calls ExtractElements()
+   * to handle the extraction logic.
    */
-  void InitializeOutput(vtkDataObject* output, vtkDataObject* input);
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) VTK_OVERRIDE;
 
 private:
   vtkPythonExtractSelection(const vtkPythonExtractSelection&) = delete;
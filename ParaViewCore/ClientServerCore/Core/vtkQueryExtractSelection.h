@@ -0,0 +1,94 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkQueryExtractSelection.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkQueryExtractSelection
+ * @brief   extracts elements matching a query selection without Python.
+ *
+ * vtkQueryExtractSelection evaluates the query string of a
+ * vtkSelectionNode::QUERY selection with vtkPVExpressionEvaluator and
+ * extracts (or, with PreserveTopology, marks) the matching points, cells or
+ * rows. Reductions such as `max(Temp)` are computed over all blocks and all
+ * processes of the global controller.
+ *
+ * Queries using constructs the evaluator does not support are left
+ * unevaluated, GetQueryEvaluated() then returns false and the caller is
+ * expected to fall back to vtkPythonExtractSelection.
+ * @sa
+ * vtkPVExpressionEvaluator vtkPythonExtractSelection
+*/
+
+#ifndef vtkQueryExtractSelection_h
+#define vtkQueryExtractSelection_h
+
+#include "vtkExtractSelectionBase.h"
+#include "vtkPVClientServerCoreCoreModule.h" //needed for exports
+
+class vtkCompositeDataSet;
+class vtkPVExpressionEvaluator;
+
+class VTKPVCLIENTSERVERCORECORE_EXPORT vtkQueryExtractSelection : public vtkExtractSelectionBase
+{
+public:
+  static vtkQueryExtractSelection* New();
+  vtkTypeMacro(vtkQueryExtractSelection, vtkExtractSelectionBase);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Extracts the elements listed in the "vtkSelectedIds" field data array of
+   * \c output (or of its leaves).
+   * \c attributeType is vtkDataObject::AttributeTypes and not to be confused with
+   * vtkSelectionNode::SelectionField
+   */
+  bool ExtractElements(int attributeType, vtkDataObject* input, vtkDataObject* output);
+  bool ExtractElements(int attributeType, vtkCompositeDataSet* input, vtkCompositeDataSet* output);
+  //@}
+
+  /**
+   * Returns true if the last execution evaluated the query. When false,
+   * GetEvaluationError() tells why.
+   */
+  vtkGetMacro(QueryEvaluated, bool);
+
+  /**
+   * Returns the reason the query could not be evaluated.
+   */
+  const char* GetEvaluationError();
+
+protected:
+  vtkQueryExtractSelection();
+  ~vtkQueryExtractSelection() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) VTK_OVERRIDE;
+  int RequestDataObject(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) VTK_OVERRIDE;
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) VTK_OVERRIDE;
+
+  /**
+   * Method used to initialize the output data object in request data.
+   * The output data is initialized based on the state of
+   * this->PreserveTopology.
+   */
+  void InitializeOutput(vtkDataObject* output, vtkDataObject* input);
+
+  bool QueryEvaluated;
+  vtkPVExpressionEvaluator* Evaluator;
+
+private:
+  vtkQueryExtractSelection(const vtkQueryExtractSelection&) = delete;
+  void operator=(const vtkQueryExtractSelection&) = delete;
+};
+
+#endif
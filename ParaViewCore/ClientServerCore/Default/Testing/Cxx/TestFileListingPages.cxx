@@ -0,0 +1,235 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestFileListingPages.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCollection.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkPVFileInformation.h"
+#include "vtkPVFileInformationHelper.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#if !defined(_WIN32)
+#include <time.h>  // time
+#include <utime.h> // utime
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const int NumberOfGroups = 300;
+const int NumberOfGroupFiles = 5;
+const int NumberOfSingleFiles = 200;
+const int NumberOfDirectories = 10;
+const int PageSize = 37;
+const int NumberOfThreads = 4;
+
+// Returns a name made of letters only, so that it isn't parsed as a sequence.
+std::string Letters(int index)
+{
+  std::string letters;
+  letters += static_cast<char>('a' + index / 26 / 26 % 26);
+  letters += static_cast<char>('a' + index / 26 % 26);
+  letters += static_cast<char>('a' + index % 26);
+  return letters;
+}
+
+void Touch(const std::string& path)
+{
+  ofstream file(path.c_str());
+  file << "\n";
+}
+
+void CreateListedDirectory(const std::string& directory)
+{
+  vtksys::SystemTools::RemoveADirectory(directory);
+  vtksys::SystemTools::MakeDirectory(directory);
+  for (int cc = 0; cc < NumberOfGroups; ++cc)
+  {
+    for (int kk = 0; kk < NumberOfGroupFiles; ++kk)
+    {
+      std::ostringstream name;
+      name << directory << "/group" << Letters(cc) << "_" << kk << ".vtk";
+      Touch(name.str());
+    }
+  }
+  for (int cc = 0; cc < NumberOfSingleFiles; ++cc)
+  {
+    Touch(directory + "/single" + Letters(cc) + ".txt");
+  }
+  for (int cc = 0; cc < NumberOfDirectories; ++cc)
+  {
+    vtksys::SystemTools::MakeDirectory(directory + "/dir" + Letters(cc));
+  }
+}
+
+// Lists the directory page by page and returns the entries as
+// "<type>:<name>:<number of children>", in listing order.
+bool ListPages(const std::string& directory, std::vector<std::string>& entries)
+{
+  vtkNew<vtkPVFileInformationHelper> helper;
+  helper->SetDirectoryListing(1);
+  helper->SetPath(directory.c_str());
+  helper->SetPageSize(PageSize);
+  vtkNew<vtkPVFileInformation> info;
+  int total = -1;
+  for (int offset = 0; total == -1 || offset < total; offset += PageSize)
+  {
+    helper->SetPageOffset(offset);
+    info->Initialize();
+    info->CopyFromObject(helper.GetPointer());
+    if (total != -1 && info->GetTotalNumberOfEntries() != total)
+    {
+      std::cerr << "Total number of entries changed between pages." << std::endl;
+      return false;
+    }
+    total = info->GetTotalNumberOfEntries();
+    vtkCollection* contents = info->GetContents();
+    const int expected = std::min(PageSize, total - offset);
+    if (contents->GetNumberOfItems() != expected)
+    {
+      std::cerr << "Page at " << offset << " has " << contents->GetNumberOfItems()
+                << " entries instead of " << expected << "." << std::endl;
+      return false;
+    }
+    for (int cc = 0; cc < contents->GetNumberOfItems(); ++cc)
+    {
+      vtkPVFileInformation* entry =
+        vtkPVFileInformation::SafeDownCast(contents->GetItemAsObject(cc));
+      std::ostringstream str;
+      str << entry->GetType() << ":" << entry->GetName() << ":"
+          << entry->GetContents()->GetNumberOfItems();
+      entries.push_back(str.str());
+    }
+  }
+  return true;
+}
+
+struct ThreadData
+{
+  std::string Directory;
+  std::vector<std::string> Entries[NumberOfThreads];
+  bool Success[NumberOfThreads];
+};
+
+VTK_THREAD_RETURN_TYPE ListPagesThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* threadInfo = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  ThreadData* data = static_cast<ThreadData*>(threadInfo->UserData);
+  const int id = threadInfo->ThreadID;
+  data->Success[id] = ListPages(data->Directory, data->Entries[id]);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+bool CheckEntries(const std::vector<std::string>& entries)
+{
+  if (entries.size() !=
+    static_cast<size_t>(NumberOfGroups + NumberOfSingleFiles + NumberOfDirectories))
+  {
+    std::cerr << "Listing has " << entries.size() << " entries." << std::endl;
+    return false;
+  }
+  int groups = 0, singles = 0, directories = 0;
+  for (size_t cc = 0; cc < entries.size(); ++cc)
+  {
+    const std::string& entry = entries[cc];
+    const std::string name = entry.substr(entry.find(':') + 1);
+    if (cc > 0 && entries[cc - 1].substr(entries[cc - 1].find(':') + 1) >= name)
+    {
+      std::cerr << "Entries are not sorted by name across pages: " << entry << std::endl;
+      return false;
+    }
+    std::ostringstream group, single, directory;
+    group << vtkPVFileInformation::FILE_GROUP << ":group" << Letters(groups) << "_..vtk:"
+          << NumberOfGroupFiles;
+    single << vtkPVFileInformation::SINGLE_FILE << ":single" << Letters(singles) << ".txt:0";
+    directory << vtkPVFileInformation::DIRECTORY << ":dir" << Letters(directories) << ":0";
+    if (entry == group.str())
+    {
+      ++groups;
+    }
+    else if (entry == single.str())
+    {
+      ++singles;
+    }
+    else if (entry == directory.str())
+    {
+      ++directories;
+    }
+    else
+    {
+      std::cerr << "Unexpected entry: " << entry << std::endl;
+      return false;
+    }
+  }
+  return groups == NumberOfGroups && singles == NumberOfSingleFiles &&
+    directories == NumberOfDirectories;
+}
+}
+
+int TestFileListingPages(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+  {
+    std::cerr << "Could not determine temporary directory." << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = std::string(tempDir) + "/TestFileListingPages";
+  delete[] tempDir;
+  CreateListedDirectory(directory);
+
+  // The directory was just modified, so its listing is read for every page.
+  std::vector<std::string> entries;
+  if (!ListPages(directory, entries) || !CheckEntries(entries))
+  {
+    std::cerr << "ERROR: Wrong listing of a directory being modified." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+#if !defined(_WIN32)
+  // Once the directory is old enough its listing is cached, and shared by
+  // listings gathered concurrently.
+  struct utimbuf times;
+  times.actime = times.modtime = time(NULL) - 3600;
+  utime(directory.c_str(), &times);
+
+  ThreadData data;
+  data.Directory = directory;
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(NumberOfThreads);
+  threader->SetSingleMethod(ListPagesThread, &data);
+  threader->SingleMethodExecute();
+  for (int cc = 0; cc < NumberOfThreads; ++cc)
+  {
+    if (!data.Success[cc] || data.Entries[cc] != entries)
+    {
+      std::cerr << "ERROR: Wrong listing of a cached directory in thread " << cc << "."
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+#endif
+
+  vtksys::SystemTools::RemoveADirectory(directory);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTemporalDataInformationCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkArrayCalculator.h"
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVArrayInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVTemporalDataInformation.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+// The information gathered for each timestep is cached on the output port
+// until the pipeline is modified. This checks that the cache spares the
+// executions of the timesteps already seen, and that modifying the pipeline,
+// upstream or at the port, invalidates it.
+
+// Produces two points whose "value" is Scale * t and Scale * t + 1 at time t,
+// and counts its executions.
+class vtkTestTemporalSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestTemporalSource* New();
+  vtkTypeMacro(vtkTestTemporalSource, vtkPolyDataAlgorithm);
+
+  vtkSetMacro(Scale, double);
+  int NumberOfExecutions;
+
+protected:
+  vtkTestTemporalSource()
+    : NumberOfExecutions(0)
+    , Scale(1.0)
+  {
+    this->SetNumberOfInputPorts(0);
+  }
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector) override
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    const double timeSteps[4] = { 0, 1, 2, 3 };
+    const double timeRange[2] = { 0, 3 };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), timeSteps, 4);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), timeRange, 2);
+    return 1;
+  }
+
+  int RequestData(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector) override
+  {
+    ++this->NumberOfExecutions;
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    const double time = outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP())
+      ? outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP())
+      : 0.0;
+
+    vtkNew<vtkPoints> points;
+    points->InsertNextPoint(0, 0, 0);
+    points->InsertNextPoint(1, 0, 0);
+    vtkNew<vtkDoubleArray> values;
+    values->SetName("value");
+    values->InsertNextValue(this->Scale * time);
+    values->InsertNextValue(this->Scale * time + 1);
+
+    vtkPolyData* output = vtkPolyData::GetData(outInfo);
+    output->SetPoints(points.GetPointer());
+    output->GetPointData()->AddArray(values.GetPointer());
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+    return 1;
+  }
+
+  double Scale;
+
+private:
+  vtkTestTemporalSource(const vtkTestTemporalSource&) = delete;
+  void operator=(const vtkTestTemporalSource&) = delete;
+};
+
+vtkStandardNewMacro(vtkTestTemporalSource);
+
+namespace
+{
+// Gathers the temporal information of the calculator, and checks the range of
+// its result over all timesteps and the number of executions of the source.
+bool CheckTemporalRange(vtkArrayCalculator* calculator, vtkTestTemporalSource* source,
+  double expectedMax, int expectedExecutions, const char* label)
+{
+  const int executions = source->NumberOfExecutions;
+  vtkNew<vtkPVTemporalDataInformation> info;
+  info->CopyFromObject(calculator);
+
+  vtkPVArrayInformation* arrayInfo = info->GetArrayInformation("result", vtkDataObject::POINT);
+  double range[2] = { 0, 0 };
+  if (arrayInfo)
+  {
+    arrayInfo->GetComponentRange(0, range);
+  }
+  if (!arrayInfo || range[0] != 0.0 || range[1] != expectedMax)
+  {
+    cerr << "ERROR: " << label << ": range is [" << range[0] << ", " << range[1]
+         << "] instead of [0, " << expectedMax << "]." << endl;
+    return false;
+  }
+  if (expectedExecutions >= 0 && source->NumberOfExecutions - executions != expectedExecutions)
+  {
+    cerr << "ERROR: " << label << ": the source executed "
+         << source->NumberOfExecutions - executions << " times instead of "
+         << expectedExecutions << "." << endl;
+    return false;
+  }
+  return true;
+}
+
+void UpdateTimeStep(vtkAlgorithm* algorithm, double time)
+{
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(algorithm->GetExecutive());
+  algorithm->GetOutputInformation(0)->Set(sddp->UPDATE_TIME_STEP(), time);
+  sddp->Update(0);
+}
+}
+
+int TestTemporalDataInformationCache(int, char* [])
+{
+  vtkNew<vtkTestTemporalSource> source;
+  vtkNew<vtkArrayCalculator> calculator;
+  calculator->SetInputConnection(source->GetOutputPort());
+  calculator->SetAttributeTypeToPointData();
+  calculator->AddScalarArrayName("value");
+  calculator->SetFunction("value * 2");
+  calculator->SetResultArrayName("result");
+
+  bool success = true;
+  // the first gather executes every timestep, the next ones none.
+  success &= CheckTemporalRange(calculator.GetPointer(), source.GetPointer(), 8, 4, "first");
+  success &= CheckTemporalRange(calculator.GetPointer(), source.GetPointer(), 8, 0, "cached");
+
+  // modifying the source changes the pipeline MTime of the calculator.
+  source->SetScale(2.0);
+  success &= CheckTemporalRange(calculator.GetPointer(), source.GetPointer(), 14, 4, "source");
+  success &= CheckTemporalRange(calculator.GetPointer(), source.GetPointer(), 14, 0, "cached");
+
+  // so does modifying the producer of the port.
+  calculator->SetFunction("value * 3");
+  success &= CheckTemporalRange(calculator.GetPointer(), source.GetPointer(), 21, -1, "filter");
+  success &= CheckTemporalRange(calculator.GetPointer(), source.GetPointer(), 21, 0, "cached");
+
+  // information gathered for the current timestep fills the cache, once the
+  // data is up to date with the modified pipeline.
+  source->SetScale(3.0);
+  UpdateTimeStep(calculator.GetPointer(), 1.0);
+  vtkNew<vtkPVDataInformation> dataInfo;
+  dataInfo->CopyFromObject(calculator.GetPointer());
+  success &= CheckTemporalRange(calculator.GetPointer(), source.GetPointer(), 30, 3, "visited");
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -25,6 +25,7 @@ vtkStandardNewMacro(vtkPVEnvironmentInformation);
 vtkPVEnvironmentInformation::vtkPVEnvironmentInformation()
 {
   this->RootOnly = 1;
+  this->GatherConcurrently = 1;
   this->Variable = NULL;
 }
 
@@ -19,6 +19,7 @@
 #include "vtkCollection.h"
 #include "vtkCollectionIterator.h"
 #include "vtkFileSequenceParser.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVFileInformationHelper.h"
@@ -48,9 +49,13 @@
 #endif
 
 #include <algorithm>
+#include <list>
+#include <map>
+#include <mutex>
 #include <set>
 #include <string>
 #include <time.h>
+#include <vector>
 #include <vtksys/RegularExpression.hxx>
 #include <vtksys/SystemTools.hxx>
 
@@ -287,6 +292,12 @@ static int vtkPVFileInformationGetType(const char* path)
 }
 
 #if defined(_WIN32)
+static bool vtkPVFileInformationNameCompare(
+  const vtkSmartPointer<vtkPVFileInformation>& a, const vtkSmartPointer<vtkPVFileInformation>& b)
+{
+  return strcmp(a->GetName(), b->GetName()) < 0;
+}
+
 static std::string vtkPVFileInformationResolveLink(const std::string& fname, WIN32_FIND_DATA& wfd)
 {
   IShellLink* shellLink;
@@ -349,10 +360,71 @@ class vtkPVFileInformationSet : public std::set<vtkSmartPointer<vtkPVFileInforma
 {
 };
 
+//-----------------------------------------------------------------------------
+// Computes the [begin, end) range of entries in the requested page.
+static void vtkPVFileInformationGetPageRange(
+  size_t total, int offset, int size, size_t& begin, size_t& end)
+{
+  begin = std::min(total, static_cast<size_t>(offset));
+  end = size > 0 ? std::min(total, begin + static_cast<size_t>(size)) : total;
+}
+
+//-----------------------------------------------------------------------------
+// Plain description of a directory entry, once its type is known and file
+// sequences have been grouped. Only the entries of the requested page are
+// turned into vtkPVFileInformation objects.
+struct vtkPVFileInformation::vtkEntry
+{
+  std::string Name;
+  int Type;
+  bool Hidden;
+  std::vector<std::string> Children; // file names of a FILE_GROUP, in sequence order.
+
+  bool operator<(const vtkEntry& other) const { return this->Name < other.Name; }
+};
+
+//-----------------------------------------------------------------------------
+// Listing of a directory, valid as long as the directory modification time
+// does not change.
+struct vtkPVFileInformation::vtkListing
+{
+  std::string FullPath;
+  time_t ModificationTime;
+  int FastFileTypeDetection;
+  std::vector<vtkEntry> Entries;
+};
+
+#if !defined(_WIN32)
+namespace
+{
+// Number of directory listings kept by GetDirectoryListing().
+const size_t VTK_PV_FILE_INFORMATION_MAX_CACHED_LISTINGS = 4;
+
+// Resolves the type of an entry the directory did not report a type for.
+// Returns false if the entry does not exist anymore.
+bool vtkPVFileInformationResolveType(const std::string& fullpath, int& type)
+{
+  if (type != vtkPVFileInformation::INVALID)
+  {
+    return true;
+  }
+  if (!vtksys::SystemTools::FileExists(fullpath.c_str()))
+  {
+    return false;
+  }
+  type = vtksys::SystemTools::FileIsDirectory(fullpath.c_str())
+    ? vtkPVFileInformation::DIRECTORY
+    : vtkPVFileInformation::SINGLE_FILE;
+  return true;
+}
+}
+#endif
+
 //-----------------------------------------------------------------------------
 vtkPVFileInformation::vtkPVFileInformation()
 {
   this->RootOnly = 1;
+  this->GatherConcurrently = 1;
   this->Contents = vtkCollection::New();
   this->SequenceParser = vtkFileSequenceParser::New();
   this->Type = INVALID;
@@ -360,6 +432,10 @@ vtkPVFileInformation::vtkPVFileInformation()
   this->FullPath = NULL;
   this->FastFileTypeDetection = 0;
   this->ReadDetailedFileInformation = false;
+  this->PageOffset = 0;
+  this->PageSize = 0;
+  this->TotalNumberOfEntries = 0;
+  this->Query = NULL;
   this->Hidden = false;
   this->Extension = NULL;
   this->Size = 0;
@@ -375,6 +451,7 @@ vtkPVFileInformation::~vtkPVFileInformation()
 {
   this->Contents->Delete();
   this->SequenceParser->Delete();
+  this->SetQuery(NULL);
   this->SetName(NULL);
   this->SetFullPath(NULL);
   this->SetExtension(NULL);
@@ -403,6 +480,10 @@ void vtkPVFileInformation::CopyFromObject(vtkObject* object)
     vtkErrorMacro("Can collect information only from a vtkPVFileInformationHelper.");
     return;
   }
+  if (this->Query)
+  {
+    helper = this->Query;
+  }
 
   if (helper->GetSpecialDirectories())
   {
@@ -412,6 +493,8 @@ void vtkPVFileInformation::CopyFromObject(vtkObject* object)
 
   this->FastFileTypeDetection = helper->GetFastFileTypeDetection();
   this->ReadDetailedFileInformation = helper->GetReadDetailedFileInformation();
+  this->PageOffset = helper->GetPageOffset();
+  this->PageSize = helper->GetPageSize();
 
   std::string working_directory = vtksys::SystemTools::GetCurrentWorkingDirectory().c_str();
   if (helper->GetWorkingDirectory() && helper->GetWorkingDirectory()[0])
@@ -819,9 +902,15 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
 
   this->OrganizeCollection(info_set);
 
-  for (vtkPVFileInformationSet::iterator iter = info_set.begin(); iter != info_set.end(); ++iter)
+  // Sort by name so that pages are consistent from one request to the next.
+  std::vector<vtkSmartPointer<vtkPVFileInformation> > entries(info_set.begin(), info_set.end());
+  std::sort(entries.begin(), entries.end(), vtkPVFileInformationNameCompare);
+  size_t begin, end;
+  vtkPVFileInformationGetPageRange(entries.size(), this->PageOffset, this->PageSize, begin, end);
+  this->TotalNumberOfEntries = static_cast<int>(entries.size());
+  for (size_t cc = begin; cc < end; ++cc)
   {
-    this->Contents->AddItem(*iter);
+    this->Contents->AddItem(entries[cc]);
   }
 
 #else
@@ -848,19 +937,91 @@ void vtkPVFileInformation::GetDirectoryListing()
 
 #else
 
-  vtkPVFileInformationSet info_set;
   std::string prefix = this->FullPath;
   vtkPVFileInformationAddTerminatingSlash(prefix);
 
+  vtksys::SystemTools::Stat_t status;
+  if (vtksys::SystemTools::Stat(this->FullPath, &status) == -1)
+  {
+    return;
+  }
+
+  // Listings of the most recently visited directories, most recent first.
+  // This lets a client page through a large directory without the directory
+  // being read again for every page. Listings are gathered concurrently with
+  // other requests (see GatherConcurrently), so the cache is only accessed
+  // with its lock held and pages are listed from a copy of the entries.
+  static std::mutex cacheMutex;
+  static std::list<vtkListing> cache;
+
+  // Reuse the listing from a previous request if the directory did not change.
+  std::vector<vtkEntry> entries;
+  bool cached = false;
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::list<vtkListing>::iterator listing = cache.begin();
+    for (; listing != cache.end(); ++listing)
+    {
+      if (listing->FullPath == this->FullPath && listing->ModificationTime == status.st_mtime &&
+        listing->FastFileTypeDetection == this->FastFileTypeDetection)
+      {
+        break;
+      }
+    }
+    if (listing != cache.end())
+    {
+      cache.splice(cache.begin(), cache, listing);
+      entries = listing->Entries;
+      cached = true;
+    }
+  }
+
+  if (!cached)
+  {
+    if (!this->ReadDirectory(prefix, entries))
+    {
+      return;
+    }
+
+    // A directory modified within the last second may still change without
+    // its modification time changing; don't keep its listing around.
+    if (time(NULL) - status.st_mtime > 1)
+    {
+      std::lock_guard<std::mutex> lock(cacheMutex);
+      cache.push_front(vtkListing());
+      vtkListing& newListing = cache.front();
+      newListing.FullPath = this->FullPath;
+      newListing.ModificationTime = status.st_mtime;
+      newListing.FastFileTypeDetection = this->FastFileTypeDetection;
+      newListing.Entries = entries;
+      if (cache.size() > VTK_PV_FILE_INFORMATION_MAX_CACHED_LISTINGS)
+      {
+        cache.pop_back();
+      }
+    }
+  }
+  this->ListPage(prefix, entries);
+#endif
+}
+
+#if !defined(_WIN32)
+//-----------------------------------------------------------------------------
+bool vtkPVFileInformation::ReadDirectory(const std::string& prefix, std::vector<vtkEntry>& entries)
+{
   // Open the directory and make sure it exists.
   DIR* dir = opendir(this->FullPath);
   if (!dir)
   {
     // Could add check of errno here.
-    return;
+    return false;
   }
 
-  // Loop through the directory listing.
+  // Group file sequences while reading the directory. Entries whose type the
+  // directory does not report are only stat'ed once grouping is done, and
+  // only the first file of a group is checked with FastFileTypeDetection.
+  typedef std::map<int, std::pair<std::string, int> > GroupType;
+  std::map<std::string, GroupType> groups;
+  std::vector<std::pair<std::string, int> > files;
   while (const dirent* d = readdir(dir))
   {
     // Skip the special directory entries.
@@ -868,85 +1029,146 @@ void vtkPVFileInformation::GetDirectoryListing()
     {
       continue;
     }
-    vtkPVFileInformation* info = vtkPVFileInformation::New();
-    info->SetName(d->d_name);
-    info->SetFullPath((prefix + d->d_name).c_str());
-    info->Type = INVALID;
-    info->SetHiddenFlag();
-
-    vtksys::SystemTools::Stat_t status;
-    int res;
-    if (this->ReadDetailedFileInformation)
+    int type = INVALID;
+// fix to bug #09452 such that directories with trailing names can be
+// shown in the file dialog: d_type is not available on Solaris, the type of
+// every entry is resolved with a stat instead.
+#if !(defined(__SVR4) && defined(__sun))
+    if (d->d_type == DT_DIR)
     {
-      // Recover status info
-      res = vtksys::SystemTools::Stat(info->FullPath, &status);
-      if (res != -1)
-      {
-        if (!S_ISDIR(status.st_mode))
-        {
-          std::string::size_type pos = std::string(d->d_name).rfind('.');
-          if (pos != std::string::npos)
-          {
-            std::string ext = std::string(d->d_name).substr(pos + 1);
-            info->SetExtension(ext.c_str());
-          }
-        }
-        info->Size = status.st_size;
-        info->ModificationTime = status.st_mtime;
-      }
+      type = DIRECTORY;
     }
-// fix to bug #09452 such that directories with trailing names can be
-// shown in the file dialog
-#if defined(__SVR4) && defined(__sun)
-    if (!this->ReadDetailedFileInformation)
+    else if (d->d_type == DT_REG)
     {
-      res = vtksys::SystemTools::Stat(info->FullPath, &status);
+      type = SINGLE_FILE;
     }
-    if (res != -1 && status.st_mode & S_IFDIR)
+#endif
+    if (type != DIRECTORY && this->SequenceParser->ParseFileSequence(d->d_name))
     {
-      info->Type = DIRECTORY;
+      groups[this->SequenceParser->GetSequenceName()][this->SequenceParser->GetSequenceIndex()] =
+        std::make_pair(std::string(d->d_name), type);
     }
-#else
-    if (d->d_type & DT_DIR)
+    else
     {
-      info->Type = DIRECTORY;
+      files.push_back(std::make_pair(std::string(d->d_name), type));
     }
-#endif
-
-    info->FastFileTypeDetection = this->FastFileTypeDetection;
-    info_set.insert(info);
-    info->Delete();
   }
   closedir(dir);
 
-  this->OrganizeCollection(info_set);
+  // Groups with a single entry, or with entries that are not files, are
+  // dissolved.
+  for (std::map<std::string, GroupType>::iterator giter = groups.begin(); giter != groups.end();
+       ++giter)
+  {
+    GroupType& children = giter->second;
+    bool isGroup = children.size() > 1;
+    for (GroupType::iterator citer = children.begin(); isGroup && citer != children.end(); ++citer)
+    {
+      std::pair<std::string, int>& child = citer->second;
+      isGroup = vtkPVFileInformationResolveType(prefix + child.first, child.second) &&
+        child.second == SINGLE_FILE;
+      if (this->FastFileTypeDetection)
+      {
+        // Assume all children are same as this child.
+        break;
+      }
+    }
+    if (isGroup)
+    {
+      vtkEntry entry;
+      entry.Name = giter->first;
+      entry.Type = FILE_GROUP;
+      // the group inherits the hidden flag of the first item in the group
+      entry.Hidden = children.begin()->second.first[0] == '.';
+      for (GroupType::iterator citer = children.begin(); citer != children.end(); ++citer)
+      {
+        entry.Children.push_back(citer->second.first);
+      }
+      entries.push_back(entry);
+    }
+    else
+    {
+      for (GroupType::iterator citer = children.begin(); citer != children.end(); ++citer)
+      {
+        files.push_back(citer->second);
+      }
+    }
+  }
+
+  for (size_t cc = 0; cc < files.size(); ++cc)
+  {
+    vtkEntry entry;
+    entry.Name = files[cc].first;
+    entry.Type = files[cc].second;
+    if (vtkPVFileInformationResolveType(prefix + entry.Name, entry.Type))
+    {
+      entry.Hidden = entry.Name[0] == '.';
+      entries.push_back(entry);
+    }
+  }
 
-  // Now we detect the file types for items.
-  // We dissolve any groups that contain non-file items.
+  std::sort(entries.begin(), entries.end());
+  return true;
+}
 
-  for (vtkPVFileInformationSet::iterator iter = info_set.begin(); iter != info_set.end(); ++iter)
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::ListPage(const std::string& prefix, const std::vector<vtkEntry>& entries)
+{
+  size_t begin, end;
+  vtkPVFileInformationGetPageRange(entries.size(), this->PageOffset, this->PageSize, begin, end);
+  this->TotalNumberOfEntries = static_cast<int>(entries.size());
+  for (size_t cc = begin; cc < end; ++cc)
   {
-    vtkPVFileInformation* obj = (*iter);
-    if (obj->DetectType())
+    const vtkEntry& entry = entries[cc];
+    vtkNew<vtkPVFileInformation> info;
+    info->SetName(entry.Name.c_str());
+    info->SetFullPath((prefix + entry.Name).c_str());
+    info->Type = entry.Type;
+    info->Hidden = entry.Hidden;
+    info->FastFileTypeDetection = this->FastFileTypeDetection;
+    for (size_t kk = 0; kk < entry.Children.size(); ++kk)
     {
-      this->Contents->AddItem(obj);
+      vtkNew<vtkPVFileInformation> child;
+      child->SetName(entry.Children[kk].c_str());
+      child->SetFullPath((prefix + entry.Children[kk]).c_str());
+      child->Type = SINGLE_FILE;
+      child->SetHiddenFlag();
+      child->FastFileTypeDetection = this->FastFileTypeDetection;
+      if (this->ReadDetailedFileInformation)
+      {
+        child->ReadDetailedInformation();
+      }
+      info->Contents->AddItem(child.GetPointer());
     }
-    else
+    if (this->ReadDetailedFileInformation && entry.Type != FILE_GROUP)
     {
-      // Add children to contents.
-      for (int cc = 0; cc < obj->Contents->GetNumberOfItems(); cc++)
+      info->ReadDetailedInformation();
+    }
+    this->Contents->AddItem(info.GetPointer());
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::ReadDetailedInformation()
+{
+  // Recover status info
+  vtksys::SystemTools::Stat_t status;
+  if (vtksys::SystemTools::Stat(this->FullPath, &status) != -1)
+  {
+    if (!S_ISDIR(status.st_mode))
+    {
+      std::string name = this->Name;
+      std::string::size_type pos = name.rfind('.');
+      if (pos != std::string::npos)
       {
-        vtkPVFileInformation* child =
-          vtkPVFileInformation::SafeDownCast(obj->Contents->GetItemAsObject(cc));
-        if (child->DetectType())
-        {
-          this->Contents->AddItem(child);
-        }
+        this->SetExtension(name.substr(pos + 1).c_str());
       }
     }
+    this->Size = status.st_size;
+    this->ModificationTime = status.st_mtime;
   }
-#endif
 }
+#endif
 
 //-----------------------------------------------------------------------------
 void vtkPVFileInformation::SetHiddenFlag()
@@ -1104,7 +1326,7 @@ void vtkPVFileInformation::CopyToStream(vtkClientServerStream* stream)
 {
   *stream << vtkClientServerStream::Reply << this->Name << this->FullPath << this->Type
           << this->Hidden << this->Contents->GetNumberOfItems() << this->Extension << this->Size
-          << this->ModificationTime;
+          << this->ModificationTime << this->TotalNumberOfEntries;
 
   vtkSmartPointer<vtkCollectionIterator> iter;
   iter.TakeReference(this->Contents->NewIterator());
@@ -1171,11 +1393,16 @@ void vtkPVFileInformation::CopyFromStream(const vtkClientServerStream* css)
     vtkErrorMacro("Error parsing File extension.");
     return;
   }
+  if (!css->GetArgument(0, 8, &this->TotalNumberOfEntries))
+  {
+    vtkErrorMacro("Error parsing Total number of entries.");
+    return;
+  }
   for (int cc = 0; cc < num_of_children; cc++)
   {
     vtkPVFileInformation* child = vtkPVFileInformation::New();
     vtkClientServerStream childStream;
-    if (!css->GetArgument(0, 8 + cc, &childStream))
+    if (!css->GetArgument(0, 9 + cc, &childStream))
     {
       vtkErrorMacro("Error parsing child #" << cc);
       return;
@@ -1186,6 +1413,79 @@ void vtkPVFileInformation::CopyFromStream(const vtkClientServerStream* css)
   }
 }
 
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::SetQuery(vtkPVFileInformationHelper* query)
+{
+  if (!query)
+  {
+    if (this->Query)
+    {
+      this->Query->Delete();
+      this->Query = NULL;
+    }
+    return;
+  }
+  if (!this->Query)
+  {
+    this->Query = vtkPVFileInformationHelper::New();
+  }
+  this->Query->SetPath(query->GetPath());
+  this->Query->SetWorkingDirectory(query->GetWorkingDirectory());
+  this->Query->SetDirectoryListing(query->GetDirectoryListing());
+  this->Query->SetSpecialDirectories(query->GetSpecialDirectories());
+  this->Query->SetFastFileTypeDetection(query->GetFastFileTypeDetection());
+  this->Query->SetReadDetailedFileInformation(query->GetReadDetailedFileInformation());
+  this->Query->SetPageOffset(query->GetPageOffset());
+  this->Query->SetPageSize(query->GetPageSize());
+}
+
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::CopyParametersToStream(vtkMultiProcessStream& str)
+{
+  vtkPVFileInformationHelper* query = this->Query;
+  str << 838221 << (query ? 1 : 0);
+  if (query)
+  {
+    str << std::string(query->GetPath() ? query->GetPath() : "")
+        << std::string(query->GetWorkingDirectory() ? query->GetWorkingDirectory() : "")
+        << query->GetDirectoryListing() << query->GetSpecialDirectories()
+        << query->GetFastFileTypeDetection()
+        << (query->GetReadDetailedFileInformation() ? 1 : 0) << query->GetPageOffset()
+        << query->GetPageSize();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::CopyParametersFromStream(vtkMultiProcessStream& str)
+{
+  int magic_number, has_query;
+  str >> magic_number >> has_query;
+  if (magic_number != 838221)
+  {
+    vtkErrorMacro("Magic number mismatch.");
+    return;
+  }
+  if (!has_query)
+  {
+    this->SetQuery(NULL);
+    return;
+  }
+
+  std::string path, working_directory;
+  int listing, special, fast, detailed, offset, size;
+  str >> path >> working_directory >> listing >> special >> fast >> detailed >> offset >> size;
+  vtkNew<vtkPVFileInformationHelper> query;
+  query->SetPath(path.c_str());
+  query->SetWorkingDirectory(working_directory.c_str());
+  query->SetDirectoryListing(listing);
+  query->SetSpecialDirectories(special);
+  query->SetFastFileTypeDetection(fast);
+  query->SetReadDetailedFileInformation(detailed != 0);
+  query->SetPageOffset(offset);
+  query->SetPageSize(size);
+  this->SetQuery(query.Get());
+}
+
 //-----------------------------------------------------------------------------
 void vtkPVFileInformation::Initialize()
 {
@@ -1196,6 +1496,7 @@ void vtkPVFileInformation::Initialize()
   this->Contents->RemoveAllItems();
   this->SetExtension(0);
   this->Size = 0;
+  this->TotalNumberOfEntries = 0;
 #ifdef _WIN32
   this->ModificationTime = _time64(NULL);
 #else
@@ -1229,6 +1530,7 @@ void vtkPVFileInformation::PrintSelf(ostream& os, vtkIndent indent)
   }
   os << indent << "Hidden: " << this->Hidden << endl;
   os << indent << "FastFileTypeDetection: " << this->FastFileTypeDetection << endl;
+  os << indent << "TotalNumberOfEntries: " << this->TotalNumberOfEntries << endl;
 
   for (int cc = 0; cc < this->Contents->GetNumberOfItems(); cc++)
   {
@@ -31,8 +31,10 @@
 #include "vtkPVInformation.h"
 
 #include <string> // Needed for std::string
+#include <vector> // Needed for std::vector
 
 class vtkCollection;
+class vtkPVFileInformationHelper;
 class vtkPVFileInformationSet;
 class vtkFileSequenceParser;
 
@@ -55,8 +57,21 @@ public:
    */
   void CopyToStream(vtkClientServerStream*) VTK_OVERRIDE;
   void CopyFromStream(const vtkClientServerStream*) VTK_OVERRIDE;
+  void CopyParametersToStream(vtkMultiProcessStream&) VTK_OVERRIDE;
+  void CopyParametersFromStream(vtkMultiProcessStream&) VTK_OVERRIDE;
   //@}
 
+  /**
+   * Set the query (path, working directory, listing and paging parameters)
+   * on the information itself instead of on the vtkPVFileInformationHelper the
+   * information is gathered from. The query is sent along with the gather
+   * request, so the helper needs no update beforehand and the request can be
+   * answered while the server updates a pipeline (see
+   * vtkPVSessionServer::SetConcurrentRequests()). The parameters of the query
+   * are copied. NULL (default) uses the parameters of the helper.
+   */
+  void SetQuery(vtkPVFileInformationHelper* query);
+
   enum FileTypes
   {
     INVALID = 0,
@@ -127,6 +142,13 @@ public:
   vtkGetMacro(ModificationTime, time_t);
   //@}
 
+  /**
+   * Get the total number of entries in the listed directory. When only a page
+   * of the listing was requested (see vtkPVFileInformationHelper::SetPageSize)
+   * this is larger than the number of items in Contents.
+   */
+  vtkGetMacro(TotalNumberOfEntries, int);
+
 protected:
   vtkPVFileInformation();
   ~vtkPVFileInformation() override;
@@ -134,13 +156,14 @@ protected:
   vtkCollection* Contents;
   vtkFileSequenceParser* SequenceParser;
 
-  char* Name;              // Name of this file/directory.
-  char* FullPath;          // Full path for this file/directory.
-  int Type;                // Type i.e. File/Directory/FileGroup.
-  bool Hidden;             // If file/directory is hidden
-  char* Extension;         // File extension
-  long long Size;          // File size
-  time_t ModificationTime; // File modification time
+  char* Name;               // Name of this file/directory.
+  char* FullPath;           // Full path for this file/directory.
+  int Type;                 // Type i.e. File/Directory/FileGroup.
+  bool Hidden;              // If file/directory is hidden
+  char* Extension;          // File extension
+  long long Size;           // File size
+  time_t ModificationTime;  // File modification time
+  int TotalNumberOfEntries; // Number of entries in the directory listing
 
   vtkSetStringMacro(Extension);
   vtkSetStringMacro(Name);
@@ -158,12 +181,26 @@ protected:
   void SetHiddenFlag();
   int FastFileTypeDetection;
   bool ReadDetailedFileInformation;
+  int PageOffset;
+  int PageSize;
+  vtkPVFileInformationHelper* Query;
 
 private:
   vtkPVFileInformation(const vtkPVFileInformation&) = delete;
   void operator=(const vtkPVFileInformation&) = delete;
 
   struct vtkInfo;
+  struct vtkEntry;
+  struct vtkListing;
+
+  // Reads the directory, types its entries and groups file sequences.
+  bool ReadDirectory(const std::string& prefix, std::vector<vtkEntry>& entries);
+
+  // Adds the requested page of entries to Contents.
+  void ListPage(const std::string& prefix, const std::vector<vtkEntry>& entries);
+
+  // Fills Extension, Size and ModificationTime.
+  void ReadDetailedInformation();
 };
 
 #endif
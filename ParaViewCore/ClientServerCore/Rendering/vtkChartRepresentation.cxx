@@ -233,7 +233,9 @@ int vtkChartRepresentation::RequestData(
       // first, reduce it to root node.
       vtkNew<vtkReductionFilter> reductionFilter;
       vtkNew<vtkPVMergeTablesMultiBlock> algo;
+      algo->GetInformation()->Set(vtkReductionFilter::POST_GATHER_HELPER_IS_ASSOCIATIVE(), 1);
       reductionFilter->SetPostGatherHelper(algo.GetPointer());
+      reductionFilter->SetTreeFanIn(4);
       reductionFilter->SetController(pm->GetGlobalController());
       reductionFilter->SetInputData(data);
       reductionFilter->Update();
@@ -17,27 +17,36 @@
 #include "vtkAlgorithmOutput.h"
 #include "vtkBoundingBox.h"
 #include "vtkCallbackCommand.h"
+#include "vtkCellData.h"
 #include "vtkCommand.h"
 #include "vtkCompositeDataDisplayAttributes.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositePolyDataMapper2.h"
+#include "vtkDataArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkMatrix4x4.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkMultiPieceDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVBVHCellLocator.h"
 #include "vtkPVCacheKeeper.h"
 #include "vtkPVConfig.h"
 #include "vtkPVGeometryFilter.h"
 #include "vtkPVLODActor.h"
+#include "vtkPVProgressiveExecution.h"
 #include "vtkPVRenderView.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPVUpdateSuppressor.h"
+#include "vtkPlaneCollection.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
 #include "vtkProperty.h"
 #include "vtkQuadricClustering.h"
 #include "vtkRenderer.h"
@@ -54,6 +63,8 @@
 
 #include <vtksys/SystemTools.hxx>
 
+#include <utility>
+
 //*****************************************************************************
 // This is used to convert a vtkPolyData to a vtkMultiBlockDataSet. If input is
 // vtkMultiBlockDataSet, then this is simply a pass-through filter. This makes
@@ -94,6 +105,70 @@ protected:
 };
 vtkStandardNewMacro(vtkGeometryRepresentationMultiBlockMaker);
 
+//*****************************************************************************
+namespace
+{
+//----------------------------------------------------------------------------
+// Collects the non-empty leaves of dataObject that are visible, given the
+// block visibilities keyed by flat index. Like the mapper, blocks inherit the
+// visibility of their parent unless it is set explicitly.
+void vtkCollectVisibleBlocks(vtkDataObject* dataObject, unsigned int& flatIndex, bool visible,
+  const std::unordered_map<unsigned int, bool>& visibilities,
+  std::vector<std::pair<vtkDataSet*, unsigned int> >& blocks)
+{
+  const unsigned int index = flatIndex++;
+  auto iter = visibilities.find(index);
+  if (iter != visibilities.end())
+  {
+    visible = iter->second;
+  }
+
+  if (vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(dataObject))
+  {
+    for (unsigned int cc = 0; cc < mb->GetNumberOfBlocks(); ++cc)
+    {
+      vtkCollectVisibleBlocks(mb->GetBlock(cc), flatIndex, visible, visibilities, blocks);
+    }
+  }
+  else if (vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(dataObject))
+  {
+    for (unsigned int cc = 0; cc < mp->GetNumberOfPieces(); ++cc)
+    {
+      vtkCollectVisibleBlocks(
+        mp->GetPieceAsDataObject(cc), flatIndex, visible, visibilities, blocks);
+    }
+  }
+  else if (vtkDataSet* ds = vtkDataSet::SafeDownCast(dataObject))
+  {
+    if (visible && ds->GetNumberOfCells() > 0)
+    {
+      blocks.push_back(std::make_pair(ds, index));
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkTransformPosition(vtkMatrix4x4* matrix, const double in[3], double out[3])
+{
+  double point[4] = { in[0], in[1], in[2], 1.0 };
+  matrix->MultiplyPoint(point, point);
+  for (int i = 0; i < 3; ++i)
+  {
+    out[i] = point[i] / point[3];
+  }
+}
+
+//----------------------------------------------------------------------------
+// Returns the value of the named array for the given tuple, or defaultValue
+// when there is no such array, the same way the mapper resolves ids.
+vtkIdType vtkGetIdFromArray(
+  vtkDataSetAttributes* attributes, const char* name, vtkIdType tuple, vtkIdType defaultValue)
+{
+  vtkDataArray* array = name ? attributes->GetArray(name) : NULL;
+  return array ? static_cast<vtkIdType>(array->GetTuple1(tuple)) : defaultValue;
+}
+}
+
 //*****************************************************************************
 
 vtkStandardNewMacro(vtkGeometryRepresentation);
@@ -330,6 +405,37 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     vtkNew<vtkMatrix4x4> matrix;
     this->Actor->GetMatrix(matrix.GetPointer());
     vtkPVRenderView::SetGeometryBounds(inInfo, this->DataBounds, matrix.GetPointer());
+
+    // The partial output of a long-running algorithm is refined during the
+    // streaming passes.
+    vtkPVRenderView::SetStreamable(
+      inInfo, this, vtkPVProgressiveExecution::IsPartialOutput(this->GetPartialInput()));
+  }
+  else if (request_type == vtkPVRenderView::REQUEST_STREAMING_UPDATE())
+  {
+    // Let the algorithm carry on from its partial output, and stream the
+    // refined geometry to the rendering nodes.
+    if (vtkPVProgressiveExecution::ResumePartialOutput(this->GetPartialInput()))
+    {
+      this->MarkModified();
+      this->Update();
+      vtkPVRenderView::SetNextStreamedPiece(
+        inInfo, this, this->CacheKeeper->GetOutputDataObject(0));
+    }
+  }
+  else if (request_type == vtkPVRenderView::REQUEST_PROCESS_STREAMED_PIECE())
+  {
+    // The refined geometry replaces the one being rendered.
+    vtkDataObject* piece = vtkPVRenderView::GetCurrentStreamedPiece(inInfo, this);
+    vtkAlgorithmOutput* producerPort =
+      piece ? vtkPVRenderView::GetPieceProducer(inInfo, this) : NULL;
+    vtkDataObject* rendered = producerPort
+      ? producerPort->GetProducer()->GetOutputDataObject(producerPort->GetIndex())
+      : NULL;
+    if (rendered && rendered != piece)
+    {
+      rendered->ShallowCopy(piece);
+    }
   }
   else if (request_type == vtkPVView::REQUEST_UPDATE_LOD())
   {
@@ -355,18 +461,13 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         // new geometry.
         this->LODOutlineFilter->Modified();
 
-        if (inInfo->Has(vtkPVRenderView::LOD_RESOLUTION()))
-        {
-          int division =
-            static_cast<int>(150 * inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())) + 10;
-          this->Decimator->SetNumberOfDivisions(division, division, division);
-        }
-
-        this->Decimator->Update();
+        double resolution = inInfo->Has(vtkPVRenderView::LOD_RESOLUTION())
+          ? inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())
+          : 0.0;
 
         // Pass along the LOD geometry to the view so that it can deliver it to
         // the rendering node as and when needed.
-        vtkPVRenderView::SetPieceLOD(inInfo, this, this->Decimator->GetOutputDataObject(0));
+        vtkPVRenderView::SetPieceLOD(inInfo, this, this->GetLODLevel(resolution));
       }
     }
   }
@@ -406,6 +507,48 @@ int vtkGeometryRepresentation::ProcessViewRequest(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+vtkDataObject* vtkGeometryRepresentation::GetLODLevel(double resolution)
+{
+  const int minDivisions = 10;
+  const int divisions = static_cast<int>(150 * resolution) + minDivisions;
+
+  if (this->LODLevels.empty() || divisions > this->LODLevelDivisions[0])
+  {
+    // (re)build the hierarchy with the requested resolution as finest level.
+    this->LODLevels.clear();
+    this->LODLevelDivisions.clear();
+
+    this->Decimator->SetNumberOfDivisions(divisions, divisions, divisions);
+    this->LODLevels.push_back(this->Decimator);
+    this->LODLevelDivisions.push_back(divisions);
+    for (int levelDivisions = divisions / 2; levelDivisions >= minDivisions;
+         levelDivisions /= 2)
+    {
+      vtkNew<vtkQuadricClustering> level;
+      level->SetUseInputPoints(1);
+      level->SetCopyCellData(1);
+      level->SetUseInternalTriangles(0);
+      level->SetNumberOfDivisions(levelDivisions, levelDivisions, levelDivisions);
+      level->SetInputConnection(this->LODLevels.back()->GetOutputPort());
+      this->LODLevels.push_back(level.GetPointer());
+      this->LODLevelDivisions.push_back(levelDivisions);
+    }
+  }
+
+  // Updating the coarsest level brings all the levels up to date at once.
+  // It is a no-op unless the data changed since the hierarchy was built.
+  this->LODLevels.back()->Update();
+
+  // pick the coarsest level that is at least as fine as requested.
+  size_t index = 0;
+  while (index + 1 < this->LODLevels.size() && this->LODLevelDivisions[index + 1] >= divisions)
+  {
+    index++;
+  }
+  return this->LODLevels[index]->GetOutputDataObject(0);
+}
+
 //----------------------------------------------------------------------------
 bool vtkGeometryRepresentation::DoRequestGhostCells(vtkInformation* info)
 {
@@ -491,6 +634,9 @@ int vtkGeometryRepresentation::RequestData(
   }
   this->CacheKeeper->Update();
 
+  // the geometry may have changed, RayCast() will build new locators as needed.
+  this->RayCastLocators.clear();
+
   // HACK: To overcome issue with PolyDataMapper (OpenGL2). It doesn't recreate
   // VBO/IBOs when using data from cache. I suspect it's because the blocks in
   // the MB dataset have older MTime.
@@ -543,6 +689,14 @@ vtkDataObject* vtkGeometryRepresentation::GetRenderedDataObject(int port)
   return NULL;
 }
 
+//----------------------------------------------------------------------------
+vtkDataObject* vtkGeometryRepresentation::GetPartialInput()
+{
+  vtkDataObject* input =
+    this->GetNumberOfInputConnections(0) > 0 ? this->GetInputDataObject(0, 0) : NULL;
+  return vtkPVProgressiveExecution::IsPartialOutput(input) ? input : NULL;
+}
+
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::MarkModified()
 {
@@ -1067,6 +1221,119 @@ void vtkGeometryRepresentation::UpdateBlockAttributes(vtkMapper* mapper)
   }
 }
 
+//----------------------------------------------------------------------------
+int vtkGeometryRepresentation::RayCast(
+  const double p0[3], const double p1[3], bool renderedGeometry, RayCastResult& result)
+{
+  if (!this->GetVisibility() || !this->Actor->GetVisibility() || !this->Actor->GetPickable())
+  {
+    return RAY_CAST_MISS;
+  }
+
+  // The surfaces only tell what the hardware selector would see when they are
+  // what gets rendered, as is.
+  vtkCompositePolyDataMapper2* cpm = vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper);
+  vtkPlaneCollection* clippingPlanes = this->Mapper->GetClippingPlanes();
+  if (cpm == NULL || this->GetRenderedProp() != this->Actor ||
+    (this->Representation != SURFACE && this->Representation != SURFACE_WITH_EDGES) ||
+    (clippingPlanes && clippingPlanes->GetNumberOfItems() > 0))
+  {
+    return RAY_CAST_UNSUPPORTED;
+  }
+
+  vtkDataObject* data =
+    renderedGeometry ? this->Mapper->GetInputDataObject(0, 0) : this->GetRenderedDataObject(0);
+  std::vector<std::pair<vtkDataSet*, unsigned int> > blocks;
+  unsigned int flatIndex = 0;
+  vtkCollectVisibleBlocks(data, flatIndex, true, this->BlockVisibilities, blocks);
+  for (size_t cc = 0; cc < blocks.size(); ++cc)
+  {
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(blocks[cc].first);
+    if (pd == NULL || pd->GetNumberOfVerts() > 0 || pd->GetNumberOfLines() > 0)
+    {
+      // vertices and lines are rendered wider than they are.
+      return RAY_CAST_UNSUPPORTED;
+    }
+  }
+
+  // drop the locators of blocks nobody but the locator refers to anymore.
+  for (auto iter = this->RayCastLocators.begin(); iter != this->RayCastLocators.end();)
+  {
+    if (iter->first->GetReferenceCount() == 1)
+    {
+      iter = this->RayCastLocators.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+
+  // cast in the coordinates of the data, parametric coordinates along the
+  // segment are preserved by the transformation.
+  vtkNew<vtkMatrix4x4> matrix;
+  this->Actor->GetMatrix(matrix.GetPointer());
+  vtkNew<vtkMatrix4x4> inverse;
+  vtkMatrix4x4::Invert(matrix.GetPointer(), inverse.GetPointer());
+  double a0[3], a1[3];
+  vtkTransformPosition(inverse.GetPointer(), p0, a0);
+  vtkTransformPosition(inverse.GetPointer(), p1, a1);
+
+  int status = RAY_CAST_MISS;
+  vtkNew<vtkGenericCell> cell;
+  for (size_t cc = 0; cc < blocks.size(); ++cc)
+  {
+    vtkDataSet* ds = blocks[cc].first;
+    vtkSmartPointer<vtkPVBVHCellLocator>& locator = this->RayCastLocators[ds];
+    if (!locator)
+    {
+      locator = vtkSmartPointer<vtkPVBVHCellLocator>::New();
+      locator->SetDataSet(ds);
+    }
+    locator->Update();
+
+    double t, x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    if (!locator->IntersectWithLine(a0, a1, 1e-6 * ds->GetLength(), t, x, pcoords, subId, cellId,
+          cell.GetPointer()) ||
+      (status == RAY_CAST_HIT && t >= result.T))
+    {
+      continue;
+    }
+
+    vtkIdType pointId = -1;
+    double closestDistance2 = VTK_DOUBLE_MAX;
+    vtkIdList* cellPoints = cell->GetPointIds();
+    for (vtkIdType pt = 0; pt < cellPoints->GetNumberOfIds(); ++pt)
+    {
+      double point[3];
+      ds->GetPoint(cellPoints->GetId(pt), point);
+      const double distance2 = vtkMath::Distance2BetweenPoints(point, x);
+      if (distance2 < closestDistance2)
+      {
+        closestDistance2 = distance2;
+        pointId = cellPoints->GetId(pt);
+        vtkTransformPosition(matrix.GetPointer(), point, result.PointPosition);
+      }
+    }
+
+    status = RAY_CAST_HIT;
+    result.T = t;
+    vtkTransformPosition(matrix.GetPointer(), x, result.Position);
+    vtkCellData* cd = ds->GetCellData();
+    vtkPointData* pd = ds->GetPointData();
+    vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
+    result.CellId = vtkGetIdFromArray(cd, cpm->GetCellIdArrayName(), cellId, cellId);
+    result.PointId = vtkGetIdFromArray(pd, cpm->GetPointIdArrayName(), pointId, pointId);
+    result.CompositeIndex = static_cast<unsigned int>(
+      vtkGetIdFromArray(cd, cpm->GetCompositeIdArrayName(), cellId, blocks[cc].second));
+    result.ProcessId = vtkGetIdFromArray(pd, cpm->GetProcessIdArrayName(), pointId,
+      controller ? controller->GetLocalProcessId() : 0);
+  }
+  return status;
+}
+
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::SetEnableScaling(int val)
 {
@@ -29,17 +29,21 @@
 #define vtkGeometryRepresentation_h
 #include <array>         // needed for array
 #include <unordered_map> // needed for unordered_map
+#include <vector>        // needed for vector
 
 #include "vtkPVClientServerCoreRenderingModule.h" // needed for exports
 #include "vtkPVDataRepresentation.h"
-#include "vtkProperty.h" // needed for VTK_POINTS etc.
+#include "vtkProperty.h"     // needed for VTK_POINTS etc.
+#include "vtkSmartPointer.h" // needed for vtkSmartPointer
 
 class vtkCallbackCommand;
 class vtkCompositeDataDisplayAttributes;
 class vtkCompositePolyDataMapper2;
+class vtkDataSet;
 class vtkMapper;
 class vtkPiecewiseFunction;
 class vtkPVCacheKeeper;
+class vtkPVBVHCellLocator;
 class vtkPVGeometryFilter;
 class vtkPVLODActor;
 class vtkQuadricClustering;
@@ -276,6 +280,42 @@ public:
   vtkGetMacro(UseDataPartitions, bool);
   //@}
 
+  enum RayCastStatus
+  {
+    RAY_CAST_UNSUPPORTED = -1,
+    RAY_CAST_MISS = 0,
+    RAY_CAST_HIT = 1
+  };
+
+  /**
+   * Closest hit found by RayCast(). CellId, PointId, CompositeIndex and
+   * ProcessId are the ids the hardware selector would report for the hit
+   * cell, and for its point closest to Position.
+   */
+  struct RayCastResult
+  {
+    double T;
+    double Position[3];
+    double PointPosition[3];
+    unsigned int CompositeIndex;
+    vtkIdType CellId;
+    vtkIdType PointId;
+    vtkIdType ProcessId;
+  };
+
+  /**
+   * Casts the segment p0-p1, in world coordinates, against the surfaces of the
+   * visible blocks this representation has on the local process: the geometry
+   * delivered for rendering when \c renderedGeometry is true, the geometry
+   * returned by GetRenderedDataObject() otherwise. Each block is searched with
+   * a vtkPVBVHCellLocator built on first use and kept until the block changes.
+   * Returns RAY_CAST_UNSUPPORTED when the surfaces do not tell what is rendered,
+   * e.g. for points, wireframes, lines or glyphs, in which case callers must
+   * fall back to hardware selection.
+   */
+  virtual int RayCast(
+    const double p0[3], const double p1[3], bool renderedGeometry, RayCastResult& result);
+
 protected:
   vtkGeometryRepresentation();
   ~vtkGeometryRepresentation() override;
@@ -335,6 +375,12 @@ protected:
    */
   virtual vtkPVLODActor* GetRenderedProp() { return this->Actor; }
 
+  /**
+   * Returns the input when it is the partial output of a long-running
+   * algorithm (see vtkPVProgressiveExecution), NULL otherwise.
+   */
+  vtkDataObject* GetPartialInput();
+
   /**
    * Overridden to check with the vtkPVCacheKeeper to see if the key is cached.
    */
@@ -352,10 +398,24 @@ protected:
    */
   void UpdateBlockAttributes(vtkMapper* mapper);
 
+  /**
+   * Returns the decimated geometry to use as LOD for the given
+   * vtkPVRenderView::LOD_RESOLUTION(). The decimation is done by a hierarchy
+   * of nested clusterings, the finest one being the Decimator and each
+   * following one clustering the output of the previous one at half its
+   * resolution. All the levels are built together once per data change, so
+   * that switching to a coarser LOD only picks a different level. The
+   * hierarchy is only rebuilt when a finer resolution than its finest level
+   * is requested.
+   */
+  vtkDataObject* GetLODLevel(double resolution);
+
   vtkAlgorithm* GeometryFilter;
   vtkAlgorithm* MultiBlockMaker;
   vtkPVCacheKeeper* CacheKeeper;
   vtkQuadricClustering* Decimator;
+  std::vector<vtkSmartPointer<vtkQuadricClustering> > LODLevels;
+  std::vector<int> LODLevelDivisions;
   vtkPVGeometryFilter* LODOutlineFilter;
 
   vtkMapper* Mapper;
@@ -382,6 +442,9 @@ protected:
   std::unordered_map<unsigned int, double> BlockOpacities;
   std::unordered_map<unsigned int, std::array<double, 3> > BlockColors;
 
+  // Locators used by RayCast(), per block of geometry.
+  std::unordered_map<vtkDataSet*, vtkSmartPointer<vtkPVBVHCellLocator> > RayCastLocators;
+
 private:
   vtkGeometryRepresentation(const vtkGeometryRepresentation&) = delete;
   void operator=(const vtkGeometryRepresentation&) = delete;
@@ -234,6 +234,7 @@ vtkStandardNewMacro(vtkPVDataDeliveryManager);
 vtkPVDataDeliveryManager::vtkPVDataDeliveryManager()
   : Internals(new vtkInternals())
 {
+  this->LoadImbalanceTolerance = 0.1;
 }
 
 //----------------------------------------------------------------------------
@@ -574,7 +575,15 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(bool use_lo
     // need to re-generate the kd-tree.
     this->RedistributionTimeStamp.Modified();
 
-    vtkNew<vtkKdTreeManager> cutsGenerator;
+    // the manager is kept so that the cuts can be reused while the data remains
+    // balanced, in which case the kd-tree is not modified.
+    if (!this->KdTreeManager)
+    {
+      this->KdTreeManager = vtkSmartPointer<vtkKdTreeManager>::New();
+    }
+    vtkKdTreeManager* cutsGenerator = this->KdTreeManager;
+    cutsGenerator->RemoveAllDataObjects();
+    cutsGenerator->SetLoadImbalanceTolerance(this->LoadImbalanceTolerance);
     vtkInternals::ItemsMapType::iterator iter;
     for (iter = this->Internals->ItemsMap.begin(); iter != this->Internals->ItemsMap.end(); ++iter)
     {
@@ -625,13 +634,13 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(bool use_lo
       continue;
     }
 
-    if (item.GetRedistributedDataObject() &&
-
-      // input-data didn't change
-      (item.GetDeliveredDataObject()->GetMTime() < item.GetRedistributedDataObject()->GetMTime()) &&
+    vtkSmartPointer<vtkDataObject> redistributed = item.GetRedistributedDataObject();
+    const bool inputChanged = !redistributed ||
+      item.GetDeliveredDataObject()->GetMTime() >= redistributed->GetMTime();
+    if (!inputChanged &&
 
       // kd-tree didn't change
-      (item.GetRedistributedDataObject()->GetMTime() > this->KdTree->GetMTime()))
+      (redistributed->GetMTime() > this->KdTree->GetMTime()))
     {
       // skip redistribution.
       continue;
@@ -640,13 +649,19 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(bool use_lo
     // release old memory (not necessarily, but try).
     item.SetRedistributedDataObject(NULL);
 
+    // when only the kd-tree changed, redistribute the data already
+    // redistributed for the previous kd-tree: only the cells whose region is
+    // now assigned to another process are moved.
+    const char* event = inputChanged ? "Migrate Data" : "Migrate Data Delta";
+    vtkTimerLog::MarkStartEvent(event);
     vtkNew<vtkOrderedCompositeDistributor> redistributor;
     redistributor->SetController(vtkMultiProcessController::GetGlobalController());
-    redistributor->SetInputData(item.GetDeliveredDataObject());
+    redistributor->SetInputData(inputChanged ? item.GetDeliveredDataObject() : redistributed);
     redistributor->SetPKdTree(this->KdTree);
     redistributor->SetPassThrough(0);
     redistributor->Update();
     item.SetRedistributedDataObject(redistributor->GetOutputDataObject(0));
+    vtkTimerLog::MarkEndEvent(event);
   }
   vtkTimerLog::MarkEndEvent("Redistributing Data for Ordered Compositing");
 }
@@ -774,6 +789,12 @@ void vtkPVDataDeliveryManager::DeliverStreamedPieces(unsigned int size, unsigned
     // specify the data type.
     vtkDataObject* data = item->GetDataObject();
     vtkDataObject* piece = item->GetStreamedPiece();
+    if (!piece)
+    {
+      // Other ranks have a piece to stream, this one doesn't. Since moving the
+      // data is collective, it sends the data it already delivered instead.
+      piece = data;
+    }
 
     vtkNew<vtkMPIMoveData> dataMover;
     dataMover->InitializeForCommunicationForParaView();
@@ -796,6 +817,7 @@ void vtkPVDataDeliveryManager::DeliverStreamedPieces(unsigned int size, unsigned
 void vtkPVDataDeliveryManager::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "LoadImbalanceTolerance: " << this->LoadImbalanceTolerance << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -35,6 +35,7 @@
 class vtkAlgorithmOutput;
 class vtkDataObject;
 class vtkExtentTranslator;
+class vtkKdTreeManager;
 class vtkPKdTree;
 class vtkPVDataRepresentation;
 class vtkPVRenderView;
@@ -136,6 +137,16 @@ public:
    */
   vtkPKdTree* GetKdTree();
 
+  //@{
+  /**
+   * Get/Set the load imbalance tolerance below which the kd-tree is kept when
+   * the data changes rather than regenerated, see
+   * vtkKdTreeManager::SetLoadImbalanceTolerance(). Default is 0.1.
+   */
+  vtkSetMacro(LoadImbalanceTolerance, double);
+  vtkGetMacro(LoadImbalanceTolerance, double);
+  //@}
+
   //@{
   /**
    * Get/Set the render-view. The view is not reference counted.
@@ -220,6 +231,8 @@ protected:
 
   vtkWeakPointer<vtkPVRenderView> RenderView;
   vtkSmartPointer<vtkPKdTree> KdTree;
+  vtkSmartPointer<vtkKdTreeManager> KdTreeManager;
+  double LoadImbalanceTolerance;
 
   vtkTimeStamp RedistributionTimeStamp;
 
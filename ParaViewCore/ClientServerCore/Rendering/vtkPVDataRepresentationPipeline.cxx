@@ -16,10 +16,12 @@
 
 #include "vtkAlgorithm.h"
 #include "vtkAlgorithmOutput.h"
+#include "vtkDataObject.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVDataRepresentation.h"
+#include "vtkPVProgressiveExecution.h"
 
 vtkStandardNewMacro(vtkPVDataRepresentationPipeline);
 //----------------------------------------------------------------------------
@@ -97,6 +99,28 @@ int vtkPVDataRepresentationPipeline::ProcessRequest(
   return this->Superclass::ProcessRequest(request, inInfo, outInfo);
 }
 
+//----------------------------------------------------------------------------
+int vtkPVDataRepresentationPipeline::ExecuteData(
+  vtkInformation* request, vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
+{
+  bool aborted = vtkPVProgressiveExecution::GetExecutionAborted();
+  for (int cc = 0; !aborted && cc < this->GetNumberOfInputPorts(); ++cc)
+  {
+    for (int kk = 0; !aborted && kk < inInfoVec[cc]->GetNumberOfInformationObjects(); ++kk)
+    {
+      aborted = vtkPVProgressiveExecution::IsAbortedOutput(
+        vtkDataObject::GetData(inInfoVec[cc]->GetInformationObject(kk)));
+    }
+  }
+  if (aborted)
+  {
+    // The representation still needs to execute on the regenerated data.
+    vtkPVProgressiveExecution::ReportExecution(this->Algorithm);
+    return 1;
+  }
+  return this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVDataRepresentationPipeline::ExecuteDataEnd(
   vtkInformation* request, vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
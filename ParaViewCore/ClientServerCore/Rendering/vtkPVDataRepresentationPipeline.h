@@ -44,6 +44,11 @@ protected:
   int ForwardUpstream(int i, int j, vtkInformation* request) VTK_OVERRIDE;
   int ForwardUpstream(vtkInformation* request) VTK_OVERRIDE;
 
+  // Skip the execution on data truncated by an aborted execution, so that the
+  // representation keeps showing the data it had before.
+  int ExecuteData(vtkInformation* request, vtkInformationVector** inInfoVec,
+    vtkInformationVector* outInfoVec) VTK_OVERRIDE;
+
   void ExecuteDataEnd(vtkInformation* request, vtkInformationVector** inInfoVec,
     vtkInformationVector* outInfoVec) VTK_OVERRIDE;
 
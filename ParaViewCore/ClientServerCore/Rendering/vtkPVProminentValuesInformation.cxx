@@ -40,6 +40,8 @@
 #include "vtkVariant.h"
 #include "vtkVariantArray.h"
 
+#include <cmath>
+#include <cstring>
 #include <map>
 #include <set>
 #include <sstream>
@@ -50,11 +52,210 @@
 namespace
 {
 typedef std::map<int, std::set<std::vector<vtkVariant> > > vtkInternalDistinctValuesBase;
+
+// Hash sets below use 2^VTK_DISTINCT_SLOTS_BITS slots, that is always more
+// than twice the number of distinct values they may hold.
+const int VTK_DISTINCT_SLOTS_BITS = 7;
+const int VTK_DISTINCT_SLOTS = 1 << VTK_DISTINCT_SLOTS_BITS;
+
+template <typename T>
+struct vtkDistinctValueTraits
+{
+  static bool Equal(T a, T b) { return a == b; }
+  static vtkTypeUInt64 Hash(T a) { return static_cast<vtkTypeUInt64>(a); }
+};
+
+// NaNs are considered equal to each other and -0 equal to 0, they must hash
+// to the same value.
+template <typename T>
+struct vtkDistinctRealTraits
+{
+  static bool Equal(T a, T b) { return a == b || (a != a && b != b); }
+  static vtkTypeUInt64 Hash(T a)
+  {
+    if (a != a)
+    {
+      return 0x7ff8000000000000ULL;
+    }
+    double value = (a == 0) ? 0. : static_cast<double>(a);
+    vtkTypeUInt64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+};
+
+template <>
+struct vtkDistinctValueTraits<float> : public vtkDistinctRealTraits<float>
+{
+};
+
+template <>
+struct vtkDistinctValueTraits<double> : public vtkDistinctRealTraits<double>
+{
+};
+
+// Open addressing set holding at most vtkAbstractArray::MAX_DISCRETE_VALUES
+// distinct tuples. It stops accepting tuples once one more is seen.
+template <typename T>
+class vtkDistinctTupleSet
+{
+public:
+  vtkDistinctTupleSet(int tupleSize = 1)
+    : TupleSize(tupleSize)
+    , NumberOfTuples(0)
+    , Overflowed(false)
+    , Slots(VTK_DISTINCT_SLOTS, -1)
+  {
+    this->Values.reserve(tupleSize * vtkAbstractArray::MAX_DISCRETE_VALUES);
+  }
+
+  /**
+   * Returns false if the set has overflowed.
+   */
+  bool Insert(const T* tuple)
+  {
+    if (this->Overflowed)
+    {
+      return false;
+    }
+    vtkTypeUInt64 hash = 0;
+    for (int cc = 0; cc < this->TupleSize; ++cc)
+    {
+      hash = hash * 31 + vtkDistinctValueTraits<T>::Hash(tuple[cc]);
+    }
+    int slot = static_cast<int>((hash * 0x9E3779B97F4A7C15ULL) >> (64 - VTK_DISTINCT_SLOTS_BITS));
+    while (this->Slots[slot] >= 0)
+    {
+      if (this->Equal(&this->Values[this->Slots[slot] * this->TupleSize], tuple))
+      {
+        return true;
+      }
+      slot = (slot + 1) & (VTK_DISTINCT_SLOTS - 1);
+    }
+    if (this->NumberOfTuples == vtkAbstractArray::MAX_DISCRETE_VALUES)
+    {
+      this->Overflowed = true;
+      return false;
+    }
+    this->Slots[slot] = this->NumberOfTuples++;
+    this->Values.insert(this->Values.end(), tuple, tuple + this->TupleSize);
+    return true;
+  }
+
+  bool GetOverflowed() const { return this->Overflowed; }
+
+  void CopyTo(std::set<std::vector<vtkVariant> >& distincts) const
+  {
+    std::vector<vtkVariant> tuple(this->TupleSize);
+    for (int tt = 0; tt < this->NumberOfTuples; ++tt)
+    {
+      for (int cc = 0; cc < this->TupleSize; ++cc)
+      {
+        tuple[cc] = vtkVariant(this->Values[tt * this->TupleSize + cc]);
+      }
+      distincts.insert(tuple);
+    }
+  }
+
+private:
+  bool Equal(const T* a, const T* b) const
+  {
+    for (int cc = 0; cc < this->TupleSize; ++cc)
+    {
+      if (!vtkDistinctValueTraits<T>::Equal(a[cc], b[cc]))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  int TupleSize;
+  int NumberOfTuples;
+  bool Overflowed;
+  std::vector<int> Slots;
+  std::vector<T> Values;
+};
+
+// Scan every stride-th tuple, stopping as soon as all components (and
+// tuples) have too many distinct values.
+template <typename T>
+void vtkCopyDistinctValues(const T* data, vtkIdType numTuples, int numComps, vtkIdType stride,
+  vtkInternalDistinctValuesBase& distincts, std::set<int>& overflowed)
+{
+  std::vector<vtkDistinctTupleSet<T> > componentSets(numComps);
+  vtkDistinctTupleSet<T> tupleSet(numComps);
+  bool scanTuples = numComps > 1;
+  int active = numComps + (scanTuples ? 1 : 0);
+  for (vtkIdType tt = 0; tt < numTuples && active > 0; tt += stride)
+  {
+    const T* tuple = data + tt * numComps;
+    for (int cc = 0; cc < numComps; ++cc)
+    {
+      if (!componentSets[cc].GetOverflowed() && !componentSets[cc].Insert(tuple + cc))
+      {
+        --active;
+      }
+    }
+    if (scanTuples && !tupleSet.GetOverflowed() && !tupleSet.Insert(tuple))
+    {
+      --active;
+    }
+  }
+
+  for (int cc = 0; cc < numComps; ++cc)
+  {
+    if (componentSets[cc].GetOverflowed())
+    {
+      overflowed.insert(cc);
+    }
+    else
+    {
+      componentSets[cc].CopyTo(distincts[cc]);
+    }
+  }
+  if (scanTuples)
+  {
+    if (tupleSet.GetOverflowed())
+    {
+      overflowed.insert(-1);
+    }
+    else
+    {
+      tupleSet.CopyTo(distincts[-1]);
+    }
+  }
+}
+
+// Stride of a uniform sample large enough for a value making up fraction of
+// the array to go undetected with a probability below uncertainty.
+vtkIdType vtkSamplingStride(vtkIdType numTuples, double fraction, double uncertainty)
+{
+  if (fraction <= 0. || fraction >= 1. || uncertainty <= 0. || uncertainty >= 1.)
+  {
+    return 1;
+  }
+  double sampleSize = std::ceil(std::log(uncertainty) / std::log(1. - fraction));
+  if (sampleSize >= static_cast<double>(numTuples))
+  {
+    return 1;
+  }
+  return static_cast<vtkIdType>(numTuples / sampleSize);
+}
 }
 
 class vtkPVProminentValuesInformation::vtkInternalDistinctValues
   : public vtkInternalDistinctValuesBase
 {
+public:
+  // Components that take on too many distinct values to be discrete.
+  std::set<int> Overflowed;
+
+  void Reset()
+  {
+    this->clear();
+    this->Overflowed.clear();
+  }
 };
 
 vtkStandardNewMacro(vtkPVProminentValuesInformation);
@@ -86,6 +287,7 @@ void vtkPVProminentValuesInformation::InitializeParameters()
   this->NumberOfComponents = -2;
   this->Uncertainty = -1.;
   this->Fraction = -1.;
+  this->Sampling = false;
 }
 
 //----------------------------------------------------------------------------
@@ -138,8 +340,19 @@ void vtkPVProminentValuesInformation::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << i2 << "None" << endl;
   }
+  if (this->DistinctValues && !this->DistinctValues->Overflowed.empty())
+  {
+    os << indent << "Continuous components:";
+    for (std::set<int>::const_iterator oit = this->DistinctValues->Overflowed.begin();
+         oit != this->DistinctValues->Overflowed.end(); ++oit)
+    {
+      os << " " << *oit;
+    }
+    os << endl;
+  }
   os << "Fraction: " << this->Fraction << endl;
   os << "Uncertainty: " << this->Uncertainty << endl;
+  os << "Sampling: " << this->Sampling << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -152,7 +365,7 @@ void vtkPVProminentValuesInformation::SetNumberOfComponents(int numComps)
   this->NumberOfComponents = numComps;
   if (this->DistinctValues)
   {
-    this->DistinctValues->clear();
+    this->DistinctValues->Reset();
   }
   if (numComps <= 0)
   {
@@ -271,6 +484,7 @@ void vtkPVProminentValuesInformation::DeepCopyParameters(vtkPVProminentValuesInf
   this->SetNumberOfComponents(other->GetNumberOfComponents());
   this->Fraction = other->Fraction;
   this->Uncertainty = other->Uncertainty;
+  this->Sampling = other->Sampling;
 }
 
 //----------------------------------------------------------------------------
@@ -366,42 +580,55 @@ void vtkPVProminentValuesInformation::CopyDistinctValuesFromObject(vtkAbstractAr
   // tuples themselves behave discretely.
   if (this->DistinctValues)
   {
-    this->DistinctValues->clear();
+    this->DistinctValues->Reset();
   }
   else
   {
     this->DistinctValues = new vtkInternalDistinctValues;
   }
   int nc = this->GetNumberOfComponents();
+
+  // Numeric arrays are scanned directly.
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  if (dataArray && dataArray->HasStandardMemoryLayout() &&
+    dataArray->GetNumberOfComponents() == nc)
+  {
+    vtkIdType numTuples = dataArray->GetNumberOfTuples();
+    vtkIdType stride =
+      this->Sampling ? vtkSamplingStride(numTuples, this->Fraction, this->Uncertainty) : 1;
+    switch (dataArray->GetDataType())
+    {
+      vtkTemplateMacro(vtkCopyDistinctValues(static_cast<VTK_TT*>(dataArray->GetVoidPointer(0)),
+        numTuples, nc, stride, *this->DistinctValues, this->DistinctValues->Overflowed);
+        return;);
+    }
+  }
+
   vtkNew<vtkVariantArray> cvalues;
   std::vector<vtkVariant> tuple;
-  // bool tooManyValues;
   for (int c = (nc > 1 ? -1 : 0); c < nc; ++c)
   {
     int tupleSize = c < 0 ? nc : 1;
     tuple.resize(tupleSize);
     std::set<std::vector<vtkVariant> >& compDistincts((*this->DistinctValues)[c]);
     cvalues->Initialize();
-    array->GetProminentComponentValues(c, cvalues.GetPointer(), 0., 0.);
+    if (this->Sampling)
+    {
+      array->GetProminentComponentValues(
+        c, cvalues.GetPointer(), this->Uncertainty, this->Fraction);
+    }
+    else
+    {
+      array->GetProminentComponentValues(c, cvalues.GetPointer(), 0., 0.);
+    }
     vtkIdType nt = cvalues->GetNumberOfTuples();
-    if (nt > 0)
+    for (vtkIdType t = 0; t < nt; ++t)
     {
-      for (vtkIdType t = 0; t < nt; ++t)
+      for (int i = 0; i < tupleSize; ++i)
       {
-        for (int i = 0; i < tupleSize; ++i)
-        {
-          tuple[i] = cvalues->GetValue(i + t * tupleSize);
-        }
-        compDistincts.insert(tuple);
-        /*
-        if (compDistincts.insert(tuple).second)
-          {
-          if ((tooManyValues =
-            compDistincts.size() > vtkAbstractArray::MAX_DISCRETE_VALUES))
-            break;
-          }
-          */
+        tuple[i] = cvalues->GetValue(i + t * tupleSize);
       }
+      compDistincts.insert(tuple);
     }
   }
 }
@@ -440,7 +667,8 @@ void vtkPVProminentValuesInformation::CopyToStream(vtkClientServerStream* css)
 
   // Copy parameter values to stream.
   *css << this->PortNumber << std::string(this->FieldAssociation) << std::string(this->FieldName)
-       << this->NumberOfComponents << this->Fraction << this->Uncertainty;
+       << this->NumberOfComponents << this->Fraction << this->Uncertainty
+       << static_cast<int>(this->Sampling);
 
   // Now copy results to stream.
   int numberOfDistinctValueComponents =
@@ -466,6 +694,19 @@ void vtkPVProminentValuesInformation::CopyToStream(vtkClientServerStream* css)
     }
   }
 
+  // Components known to be continuous.
+  int numberOfOverflowedComponents =
+    static_cast<int>(this->DistinctValues ? this->DistinctValues->Overflowed.size() : 0);
+  *css << numberOfOverflowedComponents;
+  if (numberOfOverflowedComponents)
+  {
+    for (std::set<int>::const_iterator oit = this->DistinctValues->Overflowed.begin();
+         oit != this->DistinctValues->Overflowed.end(); ++oit)
+    {
+      *css << *oit;
+    }
+  }
+
   *css << vtkClientServerStream::End;
 }
 
@@ -513,26 +754,30 @@ void vtkPVProminentValuesInformation::CopyFromStream(const vtkClientServerStream
     return;
   }
 
+  int sampling;
+  if (!css->GetArgument(0, pos++, &sampling))
+  {
+    vtkErrorMacro("Error parsing sampling from message.");
+    return;
+  }
+  this->Sampling = sampling != 0;
+
   int numberOfDistinctValueComponents;
   if (!css->GetArgument(0, pos++, &numberOfDistinctValueComponents))
   {
     vtkErrorMacro("Error parsing unique value existence from message.");
     return;
   }
-  if (!numberOfDistinctValueComponents && this->DistinctValues)
+  if (!this->DistinctValues)
   {
-    this->DistinctValues->clear();
+    this->DistinctValues = new vtkInternalDistinctValues;
   }
-  else if (numberOfDistinctValueComponents)
+  else
+  {
+    this->DistinctValues->Reset();
+  }
+  if (numberOfDistinctValueComponents)
   {
-    if (!this->DistinctValues)
-    {
-      this->DistinctValues = new vtkInternalDistinctValues;
-    }
-    else
-    {
-      this->DistinctValues->clear();
-    }
     for (int i = 0; i < numberOfDistinctValueComponents; ++i)
     {
       int component;
@@ -554,7 +799,7 @@ void vtkPVProminentValuesInformation::CopyFromStream(const vtkClientServerStream
       {
         for (int k = 0; k < tupleSize; ++k)
         {
-          if (!css->GetArgument(0, pos, &tuple[k]))
+          if (!css->GetArgument(0, pos++, &tuple[k]))
           {
             vtkErrorMacro("Error decoding the " << k << "-th entry of the " << j
                                                 << "-th unique tuple for component " << i);
@@ -565,6 +810,23 @@ void vtkPVProminentValuesInformation::CopyFromStream(const vtkClientServerStream
       }
     }
   }
+
+  int numberOfOverflowedComponents;
+  if (!css->GetArgument(0, pos++, &numberOfOverflowedComponents))
+  {
+    vtkErrorMacro("Error parsing the number of continuous components from message.");
+    return;
+  }
+  for (int i = 0; i < numberOfOverflowedComponents; ++i)
+  {
+    int component;
+    if (!css->GetArgument(0, pos++, &component))
+    {
+      vtkErrorMacro("Error decoding the " << i << "-th continuous component ID.");
+      return;
+    }
+    this->DistinctValues->Overflowed.insert(component);
+  }
 }
 
 #define VTK_PROMINENT_MAGIC_NUMBER 573167
@@ -575,7 +837,7 @@ void vtkPVProminentValuesInformation::CopyParametersToStream(vtkMultiProcessStre
   vtkTypeUInt32 magic_number = VTK_PROMINENT_MAGIC_NUMBER;
   mps << magic_number << this->PortNumber << std::string(this->FieldAssociation)
       << std::string(this->FieldName) << this->NumberOfComponents << this->Fraction
-      << this->Uncertainty;
+      << this->Uncertainty << static_cast<int>(this->Sampling);
 }
 
 //-----------------------------------------------------------------------------
@@ -585,8 +847,10 @@ void vtkPVProminentValuesInformation::CopyParametersFromStream(vtkMultiProcessSt
   vtkTypeUInt32 magic_number;
   std::string fieldAssoc;
   std::string fieldName;
+  int sampling;
   mps >> magic_number >> this->PortNumber >> fieldAssoc >> fieldName >> this->NumberOfComponents >>
-    this->Fraction >> this->Uncertainty;
+    this->Fraction >> this->Uncertainty >> sampling;
+  this->Sampling = sampling != 0;
   if (magic_number != VTK_PROMINENT_MAGIC_NUMBER)
   {
     vtkErrorMacro("Magic number mismatch.");
@@ -603,22 +867,22 @@ void vtkPVProminentValuesInformation::AddDistinctValues(vtkPVProminentValuesInfo
     return;
   }
 
-  for (int i = 0; i <= this->NumberOfComponents; ++i)
+  int nc = this->NumberOfComponents;
+  for (int i = (nc > 1 ? -1 : 0); i < nc; ++i)
   {
+    // Once a component is known to be continuous, it stays so.
+    bool tooManyValues = this->DistinctValues->Overflowed.count(i) > 0 ||
+      info->DistinctValues->Overflowed.count(i) > 0;
+
     vtkInternalDistinctValues::iterator bit = info->DistinctValues->find(i);
-    vtkInternalDistinctValues::mapped_type::iterator
-      eit; // iterator over entries of component [ab]it->second.
-    bool tooManyValues = false;
-    if (bit != info->DistinctValues->end())
+    if (!tooManyValues && bit != info->DistinctValues->end())
     { // Add info's values to our list of unique keys
-      for (eit = bit->second.begin(); eit != bit->second.end(); ++eit)
+      vtkInternalDistinctValues::mapped_type& distincts = (*this->DistinctValues)[i];
+      vtkInternalDistinctValues::mapped_type::iterator eit;
+      for (eit = bit->second.begin(); eit != bit->second.end() && !tooManyValues; ++eit)
       {
-        if ((*this->DistinctValues)[i].insert(*eit).second &&
-          (*this->DistinctValues)[i].size() > vtkAbstractArray::MAX_DISCRETE_VALUES)
-        {
-          tooManyValues = true;
-          break;
-        }
+        tooManyValues = distincts.insert(*eit).second &&
+          distincts.size() > vtkAbstractArray::MAX_DISCRETE_VALUES;
       }
     }
 
@@ -626,6 +890,7 @@ void vtkPVProminentValuesInformation::AddDistinctValues(vtkPVProminentValuesInfo
     if (tooManyValues)
     {
       this->DistinctValues->erase(i);
+      this->DistinctValues->Overflowed.insert(i);
     }
   }
 }
@@ -26,7 +26,10 @@
  * given confidence that dictates the number of samples required), then
  * the prominent values are also made available.
  *
- * This class uses vtkAbstractArray::GetProminentComponentValues().
+ * Numeric arrays are scanned with small typed hash sets, one per component
+ * (plus one for whole tuples). Scanning a component stops as soon as it has
+ * more than vtkAbstractArray::MAX_DISCRETE_VALUES distinct values. Other
+ * arrays use vtkAbstractArray::GetProminentComponentValues().
 */
 
 #ifndef vtkPVProminentValuesInformation_h
@@ -104,6 +107,18 @@ public:
   vtkGetMacro(Uncertainty, double);
   //@}
 
+  //@{
+  /**
+   * Set/get whether only a uniform sample of the tuples is inspected. The
+   * sample size is the smallest one for which a value making up Fraction of
+   * the array goes undetected with a probability below Uncertainty.
+   * Off by default: every tuple is inspected.
+   */
+  vtkSetMacro(Sampling, bool);
+  vtkGetMacro(Sampling, bool);
+  vtkBooleanMacro(Sampling, bool);
+  //@}
+
   /**
    * Returns 1 if the array can be combined.
    * It must have the same name and number of components.
@@ -193,6 +208,7 @@ protected:
   char* FieldAssociation;
   double Fraction;
   double Uncertainty;
+  bool Sampling;
   //@}
 
   /// Information results
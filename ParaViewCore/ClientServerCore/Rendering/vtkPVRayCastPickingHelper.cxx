@@ -20,8 +20,10 @@
 #include "vtkCell.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkCompositeRepresentation.h"
 #include "vtkDataObject.h"
 #include "vtkDataSet.h"
+#include "vtkGeometryRepresentation.h"
 #include "vtkMath.h"
 #include "vtkMultiProcessController.h"
 #include "vtkNew.h"
@@ -32,16 +34,19 @@
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
 #include <assert.h>
 
 vtkStandardNewMacro(vtkPVRayCastPickingHelper);
 vtkCxxSetObjectMacro(vtkPVRayCastPickingHelper, Input, vtkAlgorithm);
 vtkCxxSetObjectMacro(vtkPVRayCastPickingHelper, Selection, vtkAlgorithm);
+vtkCxxSetObjectMacro(vtkPVRayCastPickingHelper, Representation, vtkPVDataRepresentation);
 //----------------------------------------------------------------------------
 vtkPVRayCastPickingHelper::vtkPVRayCastPickingHelper()
 {
   this->Selection = NULL;
   this->Input = NULL;
+  this->Representation = NULL;
   this->SnapOnMeshPoint = false;
   this->PointA[0] = this->PointA[1] = this->PointA[2] = 0.0;
   this->PointB[0] = this->PointB[1] = this->PointB[2] = 0.0;
@@ -52,6 +57,7 @@ vtkPVRayCastPickingHelper::~vtkPVRayCastPickingHelper()
 {
   this->SetSelection(NULL);
   this->SetInput(NULL);
+  this->SetRepresentation(NULL);
 }
 
 //----------------------------------------------------------------------------
@@ -68,17 +74,26 @@ void vtkPVRayCastPickingHelper::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Input: " << (this->Input ? this->Input->GetClassName() : "NULL") << endl;
   os << indent << "Selection: " << (this->Selection ? this->Selection->GetClassName() : "NULL")
      << endl;
+  os << indent
+     << "Representation: " << (this->Representation ? this->Representation->GetClassName() : "NULL")
+     << endl;
 }
 
 //----------------------------------------------------------------------------
 void vtkPVRayCastPickingHelper::ComputeIntersection()
 {
-  assert("Need valid input" && this->Input && this->Selection);
   assert("Need valid ray" && vtkMath::Distance2BetweenPoints(this->PointA, this->PointB));
 
   // Reset the intersection value
   this->Intersection[0] = this->Intersection[1] = this->Intersection[2] = 0.0;
 
+  if (this->ComputeIntersectionFromRepresentation())
+  {
+    return;
+  }
+
+  assert("Need valid input" && this->Input && this->Selection);
+
   // Manage multi-process distribution
   vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
   int pid = controller->GetLocalProcessId();
@@ -139,3 +154,67 @@ void vtkPVRayCastPickingHelper::ComputeIntersectionFromDataSet(vtkDataSet* ds)
     }
   }
 }
+
+//----------------------------------------------------------------------------
+bool vtkPVRayCastPickingHelper::ComputeIntersectionFromRepresentation()
+{
+  vtkPVDataRepresentation* repr = this->Representation;
+  if (vtkCompositeRepresentation* compositeRepr = vtkCompositeRepresentation::SafeDownCast(repr))
+  {
+    repr = compositeRepr->GetActiveRepresentation();
+  }
+  vtkGeometryRepresentation* geometryRepr = vtkGeometryRepresentation::SafeDownCast(repr);
+  if (!geometryRepr)
+  {
+    return false;
+  }
+
+  vtkGeometryRepresentation::RayCastResult result;
+  const int status = geometryRepr->RayCast(this->PointA, this->PointB, false, result);
+  double closestT = status == vtkGeometryRepresentation::RAY_CAST_HIT ? result.T : VTK_DOUBLE_MAX;
+
+  // Fall back to the selection when any process cannot tell or when the ray
+  // misses everywhere, e.g. when it passes right next to the silhouette of the
+  // selected cell.
+  vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
+  int numberOfProcesses = controller->GetNumberOfProcesses();
+  int unsupported = status == vtkGeometryRepresentation::RAY_CAST_UNSUPPORTED ? 1 : 0;
+  if (numberOfProcesses > 1)
+  {
+    int anyUnsupported;
+    controller->AllReduce(&unsupported, &anyUnsupported, 1, vtkCommunicator::MAX_OP);
+    unsupported = anyUnsupported;
+    double globalT;
+    controller->AllReduce(&closestT, &globalT, 1, vtkCommunicator::MIN_OP);
+    closestT = globalT;
+  }
+  if (unsupported || closestT == VTK_DOUBLE_MAX)
+  {
+    return false;
+  }
+
+  // Only the first process with the closest hit provides the intersection.
+  int pid = controller->GetLocalProcessId();
+  int first = (status == vtkGeometryRepresentation::RAY_CAST_HIT && result.T == closestT)
+    ? pid
+    : numberOfProcesses;
+  if (numberOfProcesses > 1)
+  {
+    int globalFirst;
+    controller->AllReduce(&first, &globalFirst, 1, vtkCommunicator::MIN_OP);
+    first = globalFirst;
+  }
+  if (pid == first)
+  {
+    const double* intersection = this->SnapOnMeshPoint ? result.PointPosition : result.Position;
+    std::copy(intersection, intersection + 3, this->Intersection);
+  }
+
+  if (numberOfProcesses > 1)
+  {
+    double sum[3];
+    controller->Reduce(this->Intersection, sum, 3, vtkCommunicator::SUM_OP, 0);
+    std::copy(sum, sum + 3, this->Intersection);
+  }
+  return true;
+}
@@ -17,6 +17,12 @@
  * @brief   helper class that used selection and ray
  * casting to find the intersection point between the user picking point
  * and the concreate cell underneath.
+ *
+ * When a geometry representation is set, the ray is cast against the
+ * surfaces of the representation using its cached cell locators (see
+ * vtkGeometryRepresentation::RayCast()), which avoids extracting the
+ * selection from the input. The selection is only used when the
+ * representation cannot be ray cast or the ray misses it.
 */
 
 #ifndef vtkPVRayCastPickingHelper_h
@@ -26,6 +32,7 @@
 #include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
 class vtkAlgorithm;
 class vtkDataSet;
+class vtkPVDataRepresentation;
 
 class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVRayCastPickingHelper : public vtkObject
 {
@@ -44,6 +51,12 @@ public:
    */
   void SetSelection(vtkAlgorithm*);
 
+  /**
+   * Set the representation of the input that the ray is cast against, if
+   * any.
+   */
+  void SetRepresentation(vtkPVDataRepresentation*);
+
   //@{
   /**
    * Set the point 1 that compose the ray
@@ -86,12 +99,19 @@ protected:
    */
   void ComputeIntersectionFromDataSet(vtkDataSet* ds);
 
+  /**
+   * Compute the intersection using the representation. Returns false, on all
+   * processes, when the selection must be used instead.
+   */
+  bool ComputeIntersectionFromRepresentation();
+
   double Intersection[3];
   double PointA[3];
   double PointB[3];
   bool SnapOnMeshPoint;
   vtkAlgorithm* Input;
   vtkAlgorithm* Selection;
+  vtkPVDataRepresentation* Representation;
 
 private:
   vtkPVRayCastPickingHelper(const vtkPVRayCastPickingHelper&) = delete;
@@ -28,6 +28,8 @@
 #include "vtkDataRepresentation.h"
 #include "vtkFXAAOptions.h"
 #include "vtkFloatArray.h"
+#include "vtkGeometryRepresentation.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationDoubleKey.h"
 #include "vtkInformationDoubleVectorKey.h"
@@ -158,6 +160,44 @@ public:
     return (iter != this->PropMap.end() ? iter->second : NULL);
   }
 
+  // Casts p0-p1 against the rendered geometry of the visible representations
+  // of the view, returning the closest hit and the id of its prop.
+  int RayCast(vtkPVRenderView* self, const double p0[3], const double p1[3], int& propId,
+    vtkGeometryRepresentation::RayCastResult& result)
+  {
+    int status = vtkGeometryRepresentation::RAY_CAST_MISS;
+    std::map<int, vtkWeakPointer<vtkPVDataRepresentation> >::iterator iter;
+    for (iter = this->PropMap.begin(); iter != this->PropMap.end(); ++iter)
+    {
+      vtkPVDataRepresentation* repr = iter->second;
+      if (repr == NULL || !repr->GetVisibility() || !self->IsRepresentationPresent(repr))
+      {
+        continue;
+      }
+      vtkGeometryRepresentation* geometry = vtkGeometryRepresentation::SafeDownCast(repr);
+      if (geometry == NULL)
+      {
+        return vtkGeometryRepresentation::RAY_CAST_UNSUPPORTED;
+      }
+      vtkGeometryRepresentation::RayCastResult reprResult;
+      switch (geometry->RayCast(p0, p1, /*renderedGeometry=*/true, reprResult))
+      {
+        case vtkGeometryRepresentation::RAY_CAST_UNSUPPORTED:
+          return vtkGeometryRepresentation::RAY_CAST_UNSUPPORTED;
+
+        case vtkGeometryRepresentation::RAY_CAST_HIT:
+          if (status == vtkGeometryRepresentation::RAY_CAST_MISS || reprResult.T < result.T)
+          {
+            status = vtkGeometryRepresentation::RAY_CAST_HIT;
+            result = reprResult;
+            propId = iter->first;
+          }
+          break;
+      }
+    }
+    return status;
+  }
+
   void PreRender(vtkRenderViewBase* vtkNotUsed(renderView)) {}
 };
 
@@ -883,6 +923,14 @@ bool vtkPVRenderView::PrepareSelect(int fieldAssociation)
 //----------------------------------------------------------------------------
 void vtkPVRenderView::Select(int fieldAssociation, int region[4])
 {
+  // Single pixel selections, as done for preselection and tooltips on every
+  // mouse move, are answered without rendering when possible.
+  if (region[0] == region[2] && region[1] == region[3] &&
+    this->SelectByRayCasting(fieldAssociation, region[0], region[1]))
+  {
+    return;
+  }
+
   if (!this->PrepareSelect(fieldAssociation))
   {
     return;
@@ -899,6 +947,119 @@ void vtkPVRenderView::Select(int fieldAssociation, int region[4])
   this->PostSelect(sel);
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVRenderView::SelectByRayCasting(int fieldAssociation, int x, int y)
+{
+  if (this->MakingSelection || this->InTileDisplayMode() || this->InCaveDisplayMode())
+  {
+    return false;
+  }
+
+  this->MakingSelection = true;
+  // Make sure that the representations are up-to-date, see PrepareSelect().
+  // Nothing needs to be drawn though.
+  this->Render(/*interactive*/ false, /*skip-rendering*/ true);
+  this->SetLastSelection(NULL);
+
+  // When the client renders locally, Select() is not called on the servers.
+  const bool use_distributed_rendering = this->GetUseDistributedRenderingForStillRender();
+  const bool collective =
+    this->SynchronizedWindows->GetMode() != vtkPVSynchronizedRenderWindows::CLIENT ||
+    use_distributed_rendering;
+
+  int status = vtkGeometryRepresentation::RAY_CAST_MISS;
+  int propId = -1;
+  vtkGeometryRepresentation::RayCastResult result;
+  if (this->IsProcessRenderingGeometriesForCompositing(use_distributed_rendering))
+  {
+    // cast through the center of the pixel, from the near to the far plane.
+    vtkRenderer* renderer = this->GetRenderer();
+    const int* size = renderer->GetSize();
+    double p0[3] = { 2.0 * (x + 0.5) / size[0] - 1.0, 2.0 * (y + 0.5) / size[1] - 1.0, 0.0 };
+    double p1[3] = { p0[0], p0[1], 1.0 };
+    renderer->ViewToWorld(p0[0], p0[1], p0[2]);
+    renderer->ViewToWorld(p1[0], p1[1], p1[2]);
+    status = this->Internals->RayCast(this, p0, p1, propId, result);
+  }
+
+  // All processes agree on the closest hit, or on falling back to the
+  // hardware selector if any of them cannot tell.
+  double closestT = status == vtkGeometryRepresentation::RAY_CAST_UNSUPPORTED
+    ? -1.0
+    : (status == vtkGeometryRepresentation::RAY_CAST_HIT ? result.T : VTK_DOUBLE_MAX);
+  if (collective)
+  {
+    this->SynchronizedWindows->Reduce(closestT, vtkPVSynchronizedRenderWindows::MIN_OP);
+  }
+  if (closestT < 0.0)
+  {
+    this->MakingSelection = false;
+    return false;
+  }
+
+  vtkNew<vtkSelection> sel;
+  if (closestT < VTK_DOUBLE_MAX)
+  {
+    vtkIdType values[4] = { -1, -1, -1, -1 };
+    if (status == vtkGeometryRepresentation::RAY_CAST_HIT && result.T == closestT)
+    {
+      values[0] = propId;
+      values[1] = result.CompositeIndex;
+      values[2] = result.ProcessId;
+      values[3] = (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS) ? result.PointId
+                                                                                 : result.CellId;
+    }
+    if (collective)
+    {
+      // several processes may hit at the same distance, keep the first one.
+      vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
+      const int mode = this->SynchronizedWindows->GetMode();
+      vtkIdType process = VTK_ID_MAX;
+      if (values[0] >= 0)
+      {
+        process = 3 * (controller ? controller->GetLocalProcessId() : 0) +
+          (mode == vtkPVSynchronizedRenderWindows::CLIENT
+              ? 0
+              : (mode == vtkPVSynchronizedRenderWindows::DATA_SERVER ? 1 : 2));
+      }
+      vtkIdType first = process;
+      this->SynchronizedWindows->Reduce(first, vtkPVSynchronizedRenderWindows::MIN_OP);
+      for (int cc = 0; cc < 4; ++cc)
+      {
+        if (process != first)
+        {
+          values[cc] = -1;
+        }
+        this->SynchronizedWindows->Reduce(values[cc], vtkPVSynchronizedRenderWindows::MAX_OP);
+      }
+    }
+
+    // same content as the selection made by the hardware selector.
+    vtkNew<vtkSelectionNode> node;
+    node->SetContentType(vtkSelectionNode::INDICES);
+    node->SetFieldType(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS
+        ? vtkSelectionNode::POINT
+        : vtkSelectionNode::CELL);
+    vtkInformation* properties = node->GetProperties();
+    properties->Set(vtkSelectionNode::PROP_ID(), static_cast<int>(values[0]));
+    properties->Set(vtkSelectionNode::COMPOSITE_INDEX(), static_cast<int>(values[1]));
+    properties->Set(vtkSelectionNode::PROCESS_ID(), static_cast<int>(values[2]));
+    properties->Set(vtkSelectionNode::PIXEL_COUNT(), 1);
+    vtkNew<vtkIdTypeArray> ids;
+    ids->SetName("SelectedIds");
+    ids->InsertNextValue(values[3]);
+    node->SetSelectionList(ids.GetPointer());
+    sel->AddNode(node.GetPointer());
+  }
+
+  if (this->SynchronizedWindows->GetLocalProcessIsDriver())
+  {
+    this->FinishSelection(sel.GetPointer());
+  }
+  this->MakingSelection = false;
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::PostSelect(vtkSelection* sel)
 {
@@ -1002,7 +1163,7 @@ void vtkPVRenderView::ResetCameraClippingRange()
 }
 
 //----------------------------------------------------------------------------
-void vtkPVRenderView::SynchronizeGeometryBounds()
+void vtkPVRenderView::SynchronizeGeometryBounds(double* size)
 {
   vtkBoundingBox bbox;
   bbox.AddBox(this->GeometryBounds);
@@ -1035,7 +1196,14 @@ void vtkPVRenderView::SynchronizeGeometryBounds()
   // sync up bounds across all processes when doing distributed rendering.
   double bounds[6];
   bbox.GetBounds(bounds);
-  this->SynchronizedWindows->SynchronizeBounds(bounds);
+  if (size)
+  {
+    this->SynchronizedWindows->SynchronizeBoundsAndSize(bounds, *size);
+  }
+  else
+  {
+    this->SynchronizedWindows->SynchronizeBounds(bounds);
+  }
 
   if (!vtkMath::AreBoundsInitialized(bounds))
   {
@@ -1249,9 +1417,10 @@ void vtkPVRenderView::Update()
     }
   }
 
-  // Gather information about geometry sizes from all representations.
+  // Gather information about geometry sizes from all representations and
+  // synchronize data bounds, together to save a round-trip to the servers.
   double local_size = this->GetDeliveryManager()->GetVisibleDataSize(false) / 1024.0;
-  this->SynchronizedWindows->SynchronizeSize(local_size);
+  this->SynchronizeGeometryBounds(&local_size);
   // cout << "Full Geometry size: " << local_size << endl;
 
   // Update decisions about lod-rendering and remote-rendering.
@@ -1275,9 +1444,6 @@ void vtkPVRenderView::Update()
     this->InteractiveRenderProcesses = vtkPVSession::CLIENT_AND_SERVERS;
   }
 
-  // Synchronize data bounds.
-  this->SynchronizeGeometryBounds();
-
   vtkTimerLog::MarkEndEvent("RenderView::Update");
 
   this->UpdateTimeStamp.Modified();
@@ -2172,6 +2338,18 @@ void vtkPVRenderView::ConfigureCompressor(const char* configuration)
   this->SynchronizedRenderers->ConfigureCompressor(configuration);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetSkipEndRenderBarrier(bool val)
+{
+  this->SynchronizedWindows->SetSkipEndRenderBarrier(val);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVRenderView::GetSkipEndRenderBarrier()
+{
+  return this->SynchronizedWindows->GetSkipEndRenderBarrier();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::InvalidateCachedSelection()
 {
@@ -278,6 +278,17 @@ public:
    */
   void ConfigureCompressor(const char* configuration);
 
+  //@{
+  /**
+   * Enable/Disable skipping the barrier at the end of each render in
+   * client-server mode, see
+   * vtkPVSynchronizedRenderWindows::SetSkipEndRenderBarrier().
+   * \note CallOnAllProcesses
+   */
+  void SetSkipEndRenderBarrier(bool);
+  bool GetSkipEndRenderBarrier();
+  //@}
+
   /**
    * Resets the clipping range. One does not need to call this directly ever. It
    * is called periodically by the vtkRenderer to reset the camera range.
@@ -974,10 +985,11 @@ protected:
   bool IsProcessRenderingGeometriesForCompositing(bool using_distributed_rendering);
 
   /**
-   * Synchronizes bounds information on all nodes.
+   * Synchronizes bounds information on all nodes. When size is non-null, the
+   * geometry size is summed up across all nodes in the same exchange.
    * \note CallOnAllProcesses
    */
-  void SynchronizeGeometryBounds();
+  void SynchronizeGeometryBounds(double* size = NULL);
 
   /**
    * Set the last selection object.
@@ -1040,6 +1052,16 @@ protected:
    */
   void PostSelect(vtkSelection* sel);
 
+  /**
+   * Makes the selection for the pixel (x, y) by casting a ray against the
+   * surfaces of the visible representations, see
+   * vtkGeometryRepresentation::RayCast(), instead of rendering selection
+   * passes. Returns false on all processes, without making any selection,
+   * when some visible representation cannot be ray cast.
+   * \note CallOnAllProcesses
+   */
+  bool SelectByRayCasting(int fieldAssociation, int x, int y);
+
   vtkLightKit* LightKit;
   vtkRenderViewBase* RenderView;
   vtkRenderer* NonCompositedRenderer;
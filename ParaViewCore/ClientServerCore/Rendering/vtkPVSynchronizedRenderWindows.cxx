@@ -34,6 +34,7 @@
 #include "vtkTilesHelper.h"
 #include "vtkTuple.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <map>
 #include <set>
@@ -410,6 +411,7 @@ vtkPVSynchronizedRenderWindows::vtkPVSynchronizedRenderWindows(vtkPVSession* act
   // servers.
   this->RenderEventPropagation = false;
   this->RenderOneViewAtATime = false;
+  this->SkipEndRenderBarrier = false;
 
   vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
   int processtype = pm->GetProcessType();
@@ -979,11 +981,15 @@ void vtkPVSynchronizedRenderWindows::HandleEndRender(vtkRenderWindow*)
   switch (this->Mode)
   {
     case CLIENT:
-      this->ClientServerController->Barrier();
+      if (!this->SkipEndRenderBarrier)
+      {
+        this->ClientServerController->Barrier();
+      }
       break;
 
     case RENDER_SERVER:
-      if (this->ParallelController->GetLocalProcessId() == 0)
+      // SkipEndRenderBarrier was received from the client with the layout.
+      if (this->ParallelController->GetLocalProcessId() == 0 && !this->SkipEndRenderBarrier)
       {
         this->ClientServerController->Barrier();
       }
@@ -1152,6 +1158,9 @@ void vtkPVSynchronizedRenderWindows::SaveWindowAndLayout(
   window->GetTileViewport(tileViewport);
   stream << tileScale[0] << tileScale[1] << tileViewport[0] << tileViewport[1] << tileViewport[2]
          << tileViewport[3] << window->GetDesiredUpdateRate();
+
+  // the servers follow the driver's choice of skipping the end render barrier.
+  stream << (this->SkipEndRenderBarrier ? 1 : 0);
 }
 
 //----------------------------------------------------------------------------
@@ -1205,6 +1214,10 @@ void vtkPVSynchronizedRenderWindows::LoadWindowAndLayout(
   window->SetTileScale(tileScale);
   window->SetTileViewport(tileViewport);
   window->SetDesiredUpdateRate(desiredUpdateRate);
+
+  int skipBarrier;
+  stream >> skipBarrier;
+  this->SkipEndRenderBarrier = (skipBarrier != 0);
 }
 
 //----------------------------------------------------------------------------
@@ -1607,8 +1620,27 @@ bool vtkPVSynchronizedRenderWindows::Reduce(
   return this->ReduceTemplate<vtkIdType>(value, operation);
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVSynchronizedRenderWindows::Reduce(
+  double& value, vtkPVSynchronizedRenderWindows::StandardOperations operation)
+{
+  return this->ReduceTemplate<double>(value, operation);
+}
+
 //----------------------------------------------------------------------------
 bool vtkPVSynchronizedRenderWindows::SynchronizeBounds(double bounds[6])
+{
+  return this->SynchronizeBoundsInternal(bounds, NULL);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSynchronizedRenderWindows::SynchronizeBoundsAndSize(double bounds[6], double& size)
+{
+  return this->SynchronizeBoundsInternal(bounds, &size);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSynchronizedRenderWindows::SynchronizeBoundsInternal(double bounds[6], double* size)
 {
   // handle trivial case.
   if (this->Mode == BUILTIN || this->Mode == INVALID)
@@ -1625,21 +1657,34 @@ bool vtkPVSynchronizedRenderWindows::SynchronizeBounds(double bounds[6])
   vtkMultiProcessController* c_ds_controller = this->GetClientDataServerController();
   assert(c_ds_controller == NULL || c_ds_controller != c_rs_controller);
 
+  // the bounds and the size, if any, travel in the same message between the
+  // client and the servers.
+  double values[7];
+  const int count = size ? 7 : 6;
+  std::copy(bounds, bounds + 6, values);
+  values[6] = size ? *size : 0.0;
+
   // The strategy is reduce the value to client then broadcast it out to
-  // render-server and data-server.
-  if (parallelController)
+  // render-server and data-server. The bounds and the size are gathered on
+  // the root in a single collective, and reduced there.
+  if (parallelController && parallelController->GetNumberOfProcesses() > 1)
   {
-    double min_bounds[3] = { bounds[0], bounds[2], bounds[4] };
-    double max_bounds[3] = { bounds[1], bounds[3], bounds[5] };
-    double min_result[3], max_result[3];
-    parallelController->Reduce(min_bounds, min_result, 3, vtkCommunicator::MIN_OP, 0);
-    parallelController->Reduce(max_bounds, max_result, 3, vtkCommunicator::MAX_OP, 0);
-    bounds[0] = min_result[0];
-    bounds[2] = min_result[1];
-    bounds[4] = min_result[2];
-    bounds[1] = max_result[0];
-    bounds[3] = max_result[1];
-    bounds[5] = max_result[2];
+    const int numProcs = parallelController->GetNumberOfProcesses();
+    const bool isRoot = parallelController->GetLocalProcessId() == 0;
+    std::vector<double> gathered(isRoot ? 7 * numProcs : 7);
+    parallelController->Gather(values, &gathered[0], 7, 0);
+    if (isRoot)
+    {
+      vtkBoundingBox bbox;
+      double total = 0.0;
+      for (int cc = 0; cc < numProcs; ++cc)
+      {
+        bbox.AddBounds(&gathered[7 * cc]);
+        total += gathered[7 * cc + 6];
+      }
+      bbox.GetBounds(values);
+      values[6] = total;
+    }
   }
 
   // on pvdataserver/pvrenderserver/pvserver/pvbatch, we now have collected the
@@ -1649,26 +1694,30 @@ bool vtkPVSynchronizedRenderWindows::SynchronizeBounds(double bounds[6])
     case CLIENT:
     {
       vtkBoundingBox bbox;
-      bbox.AddBounds(bounds);
+      bbox.AddBounds(values);
+      double total = values[6];
 
       if (c_ds_controller)
       {
-        c_ds_controller->Receive(bounds, 6, 1, 41232);
-        bbox.AddBounds(bounds);
+        c_ds_controller->Receive(values, count, 1, 41232);
+        bbox.AddBounds(values);
+        total += values[6];
       }
       if (c_rs_controller)
       {
-        c_rs_controller->Receive(bounds, 6, 1, 41232);
-        bbox.AddBounds(bounds);
+        c_rs_controller->Receive(values, count, 1, 41232);
+        bbox.AddBounds(values);
+        total += values[6];
       }
-      bbox.GetBounds(bounds);
+      bbox.GetBounds(values);
+      values[6] = total;
       if (c_ds_controller)
       {
-        c_ds_controller->Send(bounds, 6, 1, 41232);
+        c_ds_controller->Send(values, count, 1, 41232);
       }
       if (c_rs_controller)
       {
-        c_rs_controller->Send(bounds, 6, 1, 41232);
+        c_rs_controller->Send(values, count, 1, 41232);
       }
     }
     break;
@@ -1677,16 +1726,16 @@ bool vtkPVSynchronizedRenderWindows::SynchronizeBounds(double bounds[6])
       // both can't be set on a server process.
       if (c_ds_controller != NULL)
       {
-        c_ds_controller->Send(bounds, 6, 1, 41232);
-        c_ds_controller->Receive(bounds, 6, 1, 41232);
+        c_ds_controller->Send(values, count, 1, 41232);
+        c_ds_controller->Receive(values, count, 1, 41232);
       }
       break;
 
     case RENDER_SERVER:
       if (c_rs_controller != NULL)
       {
-        c_rs_controller->Send(bounds, 6, 1, 41232);
-        c_rs_controller->Receive(bounds, 6, 1, 41232);
+        c_rs_controller->Send(values, count, 1, 41232);
+        c_rs_controller->Receive(values, count, 1, 41232);
       }
       break;
 
@@ -1696,7 +1745,12 @@ bool vtkPVSynchronizedRenderWindows::SynchronizeBounds(double bounds[6])
 
   if (parallelController)
   {
-    parallelController->Broadcast(bounds, 6, 0);
+    parallelController->Broadcast(values, count, 0);
+  }
+  std::copy(values, values + 6, bounds);
+  if (size)
+  {
+    *size = values[6];
   }
   return true;
 }
@@ -1939,4 +1993,5 @@ void vtkPVSynchronizedRenderWindows::OnGetZBufferValue(unsigned int id, int x, i
 void vtkPVSynchronizedRenderWindows::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "SkipEndRenderBarrier: " << this->SkipEndRenderBarrier << endl;
 }
@@ -119,6 +119,22 @@ public:
   vtkBooleanMacro(RenderEventPropagation, bool);
   //@}
 
+  //@{
+  /**
+   * By default, the client and the server root wait for each other at the end
+   * of every render so that a frame is only over once all processes are done
+   * with it. When SkipEndRenderBarrier is enabled on the client, that barrier
+   * is skipped, saving a network round-trip per frame: the server root
+   * returns from the render once it has pushed its image. Frames are not
+   * overlapped, the server still renders one frame at a time. The server
+   * follows the client's setting, which is sent along with the window layout.
+   * Off by default.
+   */
+  vtkSetMacro(SkipEndRenderBarrier, bool);
+  vtkGetMacro(SkipEndRenderBarrier, bool);
+  vtkBooleanMacro(SkipEndRenderBarrier, bool);
+  //@}
+
   /**
    * This method returns true if the local process is the 'driver' process. In
    * client-server configurations, client is the driver. In batch
@@ -145,6 +161,12 @@ public:
   bool BroadcastToRenderServer(vtkDataObject*);
   //@}
 
+  /**
+   * Same as calling SynchronizeBounds() and SynchronizeSize(double&), but
+   * exchanges both in a single message between the client and the servers.
+   */
+  bool SynchronizeBoundsAndSize(double bounds[6], double& size);
+
   enum StandardOperations
   {
     MAX_OP = vtkCommunicator::MAX_OP,
@@ -152,6 +174,7 @@ public:
     SUM_OP = vtkCommunicator::SUM_OP
   };
   bool Reduce(vtkIdType& value, StandardOperations operation);
+  bool Reduce(double& value, StandardOperations operation);
 
   //@{
   /**
@@ -327,6 +350,7 @@ protected:
   bool Enabled;
   bool RenderEventPropagation;
   bool RenderOneViewAtATime;
+  bool SkipEndRenderBarrier;
 
   vtkWeakPointer<vtkPVSession> Session;
 
@@ -342,6 +366,7 @@ private:
 
   template <class T>
   bool ReduceTemplate(T& size, StandardOperations operation);
+  bool SynchronizeBoundsInternal(double bounds[6], double* size);
 
   static bool UseGenericOpenGLRenderWindow;
   vtkRenderWindow* NewRenderWindowInternal();
@@ -32,7 +32,10 @@ vtkSelectionDeliveryFilter::vtkSelectionDeliveryFilter()
 
   vtkAppendSelection* post_gather_algo = vtkAppendSelection::New();
   post_gather_algo->SetAppendByUnion(0);
+  post_gather_algo->GetInformation()->Set(
+    vtkReductionFilter::POST_GATHER_HELPER_IS_ASSOCIATIVE(), 1);
   this->ReductionFilter->SetPostGatherHelper(post_gather_algo);
+  this->ReductionFilter->SetTreeFanIn(4);
   post_gather_algo->FastDelete();
 
   this->DeliveryFilter = vtkClientServerMoveData::New();
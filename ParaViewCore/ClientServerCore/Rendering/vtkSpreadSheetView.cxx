@@ -21,6 +21,7 @@
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkInformation.h"
 #include "vtkMarkSelectedRows.h"
 #include "vtkMemberFunctionCommand.h"
 #include "vtkMultiProcessController.h"
@@ -38,6 +39,7 @@
 #include "vtkVariant.h"
 
 #include <algorithm>
+#include <list>
 #include <map>
 #include <string>
 #include <vector>
@@ -87,18 +89,28 @@ public:
   {
   public:
     vtkSmartPointer<vtkTable> Dataobject;
-    vtkTimeStamp RecentUseTime;
+    std::list<vtkIdType>::iterator RecentUsePosition;
   };
 
   typedef std::map<vtkIdType, CacheInfo> CacheType;
   CacheType CachedBlocks;
 
+  // Block ids from the most to the least recently used one.
+  std::list<vtkIdType> RecentUseOrder;
+
+  void ClearCache()
+  {
+    this->CachedBlocks.clear();
+    this->RecentUseOrder.clear();
+  }
+
   vtkTable* GetDataObject(vtkIdType blockId)
   {
     CacheType::iterator iter = this->CachedBlocks.find(blockId);
     if (iter != this->CachedBlocks.end())
     {
-      iter->second.RecentUseTime.Modified();
+      this->RecentUseOrder.splice(
+        this->RecentUseOrder.begin(), this->RecentUseOrder, iter->second.RecentUsePosition);
       this->MostRecentlyAccessedBlock = blockId;
       return iter->second.Dataobject.GetPointer();
     }
@@ -110,22 +122,15 @@ public:
     CacheType::iterator iter = this->CachedBlocks.find(blockId);
     if (iter != this->CachedBlocks.end())
     {
+      this->RecentUseOrder.erase(iter->second.RecentUsePosition);
       this->CachedBlocks.erase(iter);
     }
 
     if (static_cast<vtkIdType>(this->CachedBlocks.size()) == max)
     {
       // remove least-recent-used block.
-      iter = this->CachedBlocks.begin();
-      CacheType::iterator iterToRemove = this->CachedBlocks.begin();
-      for (; iter != this->CachedBlocks.end(); ++iter)
-      {
-        if (iterToRemove->second.RecentUseTime > iter->second.RecentUseTime)
-        {
-          iterToRemove = iter;
-        }
-      }
-      this->CachedBlocks.erase(iterToRemove);
+      this->CachedBlocks.erase(this->RecentUseOrder.back());
+      this->RecentUseOrder.pop_back();
     }
 
     CacheInfo info;
@@ -148,7 +153,8 @@ public:
     }
     info.Dataobject = clone;
     clone->FastDelete();
-    info.RecentUseTime.Modified();
+    this->RecentUseOrder.push_front(blockId);
+    info.RecentUsePosition = this->RecentUseOrder.begin();
     this->CachedBlocks[blockId] = info;
     this->MostRecentlyAccessedBlock = blockId;
   }
@@ -256,7 +262,10 @@ vtkSpreadSheetView::vtkSpreadSheetView()
   this->ReductionFilter->SetController(vtkMultiProcessController::GetGlobalController());
 
   vtkPVMergeTables* post_gather_algo = vtkPVMergeTables::New();
+  post_gather_algo->GetInformation()->Set(
+    vtkReductionFilter::POST_GATHER_HELPER_IS_ASSOCIATIVE(), 1);
   this->ReductionFilter->SetPostGatherHelper(post_gather_algo);
+  this->ReductionFilter->SetTreeFanIn(4);
   post_gather_algo->FastDelete();
 
   this->DeliveryFilter = vtkClientServerMoveData::New();
@@ -332,7 +341,7 @@ void vtkSpreadSheetView::ClearColumnVisibilities()
 //----------------------------------------------------------------------------
 void vtkSpreadSheetView::ClearCache()
 {
-  this->Internals->CachedBlocks.clear();
+  this->Internals->ClearCache();
 }
 
 //----------------------------------------------------------------------------
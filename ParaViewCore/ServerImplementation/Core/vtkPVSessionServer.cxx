@@ -25,6 +25,7 @@
 #include "vtkPVConfig.h"
 #include "vtkPVInformation.h"
 #include "vtkPVInstantiator.h"
+#include "vtkPVProgressiveExecution.h"
 #include "vtkPVServerOptions.h"
 #include "vtkPVSessionCore.h"
 #include "vtkProcessModule.h"
@@ -33,14 +34,21 @@
 #include "vtkSIProxyDefinitionManager.h"
 #include "vtkSMMessage.h"
 #include "vtkSmartPointer.h"
+#include "vtkSocket.h"
 #include "vtkSocketCommunicator.h"
 #include "vtkSocketController.h"
 
 #include <assert.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <string>
+#include <thread>
 #include <vector>
 #include <vtksys/RegularExpression.hxx>
 
@@ -62,6 +70,31 @@ void CloseSessionCallback(void* localArg, void* vtkNotUsed(remoteArg),
   vtkPVSessionServer* self = reinterpret_cast<vtkPVSessionServer*>(localArg);
   self->OnCloseSessionRMI();
 }
+
+void AbortExecutionCallback(void* vtkNotUsed(localArg), void* vtkNotUsed(remoteArg),
+  int vtkNotUsed(remoteArgLength), int vtkNotUsed(remoteProcessId))
+{
+  vtkPVProgressiveExecution::RequestAbort();
+}
+
+// Returns true when the stream only updates pipelines. Such streams neither
+// communicate with the client nor are needed by information requests that can
+// be gathered concurrently.
+bool IsPipelineUpdate(const vtkClientServerStream& stream)
+{
+  const int numMessages = stream.GetNumberOfMessages();
+  for (int cc = 0; cc < numMessages; ++cc)
+  {
+    const char* method = NULL;
+    if (stream.GetCommand(cc) != vtkClientServerStream::Invoke ||
+      stream.GetNumberOfArguments(cc) < 2 || !stream.GetArgument(cc, 1, &method) || !method ||
+      strcmp(method, "UpdatePipeline") != 0)
+    {
+      return false;
+    }
+  }
+  return numMessages > 0;
+}
 };
 //****************************************************************************/
 class vtkPVSessionServer::vtkInternals
@@ -71,6 +104,11 @@ public:
   {
     this->SatelliteServerSession = (vtkProcessModule::GetProcessModule()->GetPartitionId() > 0);
     this->Owner = owner;
+    this->ListenerEnabled = false;
+    this->ListenerBusy = false;
+    this->ListenerExit = false;
+    this->ReplayingRequests = false;
+    this->HasReplayedStream = false;
 
     // Attach callbacks
     this->CompositeMultiProcessController->AddRMICallback(
@@ -79,6 +117,9 @@ public:
     this->CompositeMultiProcessController->AddRMICallback(
       &CloseSessionCallback, this->Owner, vtkPVSessionServer::CLOSE_SESSION);
 
+    this->CompositeMultiProcessController->AddRMICallback(
+      &AbortExecutionCallback, this->Owner, vtkPVSessionServer::ABORT_EXECUTION_RMI);
+
     this->CompositeMultiProcessController->AddObserver(
       vtkCompositeMultiProcessController::CompositeMultiProcessControllerChanged, this,
       &vtkPVSessionServer::vtkInternals::ReleaseDeadClientSIObjects);
@@ -91,6 +132,19 @@ public:
       &vtkPVSessionServer::vtkInternals::CallBackProxyDefinitionManagerHasChanged);
   }
   //-----------------------------------------------------------------
+  ~vtkInternals()
+  {
+    if (this->Listener.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->ListenerMutex);
+        this->ListenerExit = true;
+      }
+      this->ListenerCondition.notify_all();
+      this->Listener.join();
+    }
+  }
+  //-----------------------------------------------------------------
   void CloseActiveController()
   {
     // FIXME: Maybe we want to keep listening even if no more client is
@@ -240,15 +294,19 @@ public:
   void NotifyOtherClients(const vtkSMMessage* msgToBroadcast)
   {
     std::string data = msgToBroadcast->SerializeAsString();
+    this->Owner->LockClientCommunication();
     this->CompositeMultiProcessController->TriggerRMI2All(1, (void*)data.c_str(),
       static_cast<int>(data.size()), vtkPVSessionServer::SERVER_NOTIFICATION_MESSAGE_RMI, false);
+    this->Owner->UnlockClientCommunication();
   }
   //-----------------------------------------------------------------
   void NotifyAllClients(const vtkSMMessage* msgToBroadcast)
   {
     std::string data = msgToBroadcast->SerializeAsString();
+    this->Owner->LockClientCommunication();
     this->CompositeMultiProcessController->TriggerRMI2All(1, (void*)data.c_str(),
       static_cast<int>(data.size()), vtkPVSessionServer::SERVER_NOTIFICATION_MESSAGE_RMI, true);
+    this->Owner->UnlockClientCommunication();
   }
   //-----------------------------------------------------------------
   vtkCompositeMultiProcessController* GetActiveController()
@@ -315,7 +373,286 @@ public:
     this->NotifyOtherClients(&proxyDefinitionManagerState);
   }
 
+  //-----------------------------------------------------------------
+  // Concurrent requests: while the main thread executes a pipeline update,
+  // the listener thread reads the requests of the client. The ones that can be
+  // answered concurrently are processed right away, unless a queued PUSH
+  // targets the same object. The others are queued, along with the stream of
+  // EXECUTE_STREAM requests, for the main thread to process in order at the end
+  // of the update. Abort requests are processed right away as they arrive.
+  //-----------------------------------------------------------------
+  bool CanProcessConcurrentRequests()
+  {
+    return this->Owner->ConcurrentRequests && !this->Owner->MultipleConnection &&
+      !this->SatelliteServerSession && this->CompositeMultiProcessController->GetActiveController();
+  }
+  //-----------------------------------------------------------------
+  void BeginPipelineUpdate()
+  {
+    std::lock_guard<std::mutex> lock(this->ListenerMutex);
+    this->ListenerController = this->CompositeMultiProcessController->GetActiveController();
+    this->ListenerEnabled = true;
+    if (!this->Listener.joinable())
+    {
+      this->Listener = std::thread(&vtkInternals::Listen, this);
+    }
+    this->ListenerCondition.notify_all();
+  }
+  //-----------------------------------------------------------------
+  void EndPipelineUpdate()
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->ListenerMutex);
+      this->ListenerEnabled = false;
+      this->ListenerCondition.notify_all();
+      this->ListenerCondition.wait(lock, [this]() { return !this->ListenerBusy; });
+      this->ListenerController = NULL;
+      if (this->ReplayingRequests)
+      {
+        // An outer call is processing the queue, it will get to the requests
+        // deferred during this update as well.
+        return;
+      }
+      this->ReplayingRequests = true;
+    }
+
+    for (;;)
+    {
+      vtkDeferredRequest request;
+      {
+        std::lock_guard<std::mutex> lock(this->ListenerMutex);
+        if (this->DeferredRequests.empty())
+        {
+          this->ReplayingRequests = false;
+          break;
+        }
+        std::swap(request, this->DeferredRequests.front());
+        this->DeferredRequests.pop_front();
+      }
+
+      if (request.Tag == vtkPVSessionServer::CLOSE_SESSION)
+      {
+        this->Owner->OnCloseSessionRMI();
+      }
+      else if (!request.Message.empty())
+      {
+        this->ReplayedStream.swap(request.Stream);
+        this->HasReplayedStream = request.HasStream;
+        this->Owner->OnClientServerMessageRMI(
+          &request.Message[0], static_cast<int>(request.Message.size()));
+        this->HasReplayedStream = false;
+      }
+    }
+  }
+  //-----------------------------------------------------------------
+  // Returns true, queuing the request for the main thread, when called from
+  // the listener thread for a request that cannot be processed right away.
+  bool DeferRequest(int tag, void* message, int length)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->ListenerMutex);
+      if (!this->Listener.joinable() || std::this_thread::get_id() != this->ListenerThreadId)
+      {
+        return false;
+      }
+      vtkTypeUInt32 globalid = 0;
+      if (tag == vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI &&
+        this->IsConcurrentRequest(message, length, globalid) && !this->IsPushQueued(globalid))
+      {
+        return false;
+      }
+    }
+
+    vtkDeferredRequest request;
+    request.Tag = tag;
+    request.GlobalId = this->GetPushGlobalId(tag, message, length);
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(message);
+    request.Message.assign(data, data + (data ? length : 0));
+
+    // The stream of an EXECUTE_STREAM request follows it, read it now so that
+    // the next requests can be read as well.
+    vtkMultiProcessStream stream;
+    stream.SetRawData(data, length);
+    int type = 0, ignore_errors, size;
+    if (tag == vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI && length > 0)
+    {
+      stream >> type;
+    }
+    if (type == vtkPVSessionServer::EXECUTE_STREAM)
+    {
+      stream >> ignore_errors >> size;
+      request.Stream.resize(size + 1);
+      this->ListenerController->Receive(
+        &request.Stream[0], size, 1, vtkPVSessionServer::EXECUTE_STREAM_TAG);
+      request.HasStream = true;
+    }
+
+    std::lock_guard<std::mutex> lock(this->ListenerMutex);
+    this->DeferredRequests.push_back(vtkDeferredRequest());
+    std::swap(this->DeferredRequests.back(), request);
+    return true;
+  }
+  //-----------------------------------------------------------------
+  // Reads the stream of an EXECUTE_STREAM request, unless the listener read
+  // it already when it deferred the request.
+  void ReceiveStream(int size, std::vector<unsigned char>& data)
+  {
+    if (this->HasReplayedStream)
+    {
+      data.swap(this->ReplayedStream);
+      this->HasReplayedStream = false;
+      return;
+    }
+    data.resize(size + 1);
+    this->GetActiveController()->Receive(
+      &data[0], size, 1, vtkPVSessionServer::EXECUTE_STREAM_TAG);
+  }
+
 private:
+  struct vtkDeferredRequest
+  {
+    int Tag;
+    // Object a PUSH request updates, 0 for any other request.
+    vtkTypeUInt32 GlobalId;
+    std::vector<unsigned char> Message;
+    bool HasStream;
+    std::vector<unsigned char> Stream;
+
+    vtkDeferredRequest()
+      : Tag(0)
+      , GlobalId(0)
+      , HasStream(false)
+    {
+    }
+  };
+
+  //-----------------------------------------------------------------
+  // Returns true if a queued PUSH updates the object. An information gathered
+  // from it must wait for that PUSH, like when requests are processed in order.
+  bool IsPushQueued(vtkTypeUInt32 globalid)
+  {
+    for (size_t cc = 0; globalid != 0 && cc < this->DeferredRequests.size(); ++cc)
+    {
+      if (this->DeferredRequests[cc].GlobalId == globalid)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+  //-----------------------------------------------------------------
+  vtkTypeUInt32 GetPushGlobalId(int tag, void* message, int length)
+  {
+    if (tag != vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI || length <= 0)
+    {
+      return 0;
+    }
+    vtkMultiProcessStream stream;
+    stream.SetRawData(reinterpret_cast<const unsigned char*>(message), length);
+    int type;
+    stream >> type;
+    if (type != vtkPVSessionServer::PUSH)
+    {
+      return 0;
+    }
+    std::string string;
+    stream >> string;
+    vtkSMMessage msg;
+    msg.ParseFromString(string);
+    return msg.global_id();
+  }
+  //-----------------------------------------------------------------
+  bool IsConcurrentRequest(void* message, int length, vtkTypeUInt32& globalid)
+  {
+    vtkMultiProcessStream stream;
+    stream.SetRawData(reinterpret_cast<const unsigned char*>(message), length);
+    int type;
+    stream >> type;
+    if (type != vtkPVSessionServer::GATHER_INFORMATION)
+    {
+      return false;
+    }
+
+    std::string classname;
+    vtkTypeUInt32 location;
+    stream >> location >> classname >> globalid;
+    vtkSmartPointer<vtkObject> o;
+    o.TakeReference(vtkPVInstantiator::CreateInstance(classname.c_str()));
+    vtkPVInformation* info = vtkPVInformation::SafeDownCast(o);
+    return info && info->GetRootOnly() && info->GetGatherConcurrently();
+  }
+  //-----------------------------------------------------------------
+  void Listen()
+  {
+    std::unique_lock<std::mutex> lock(this->ListenerMutex);
+    this->ListenerThreadId = std::this_thread::get_id();
+    while (!this->ListenerExit)
+    {
+      this->ListenerCondition.wait(
+        lock, [this]() { return this->ListenerExit || this->ListenerEnabled; });
+
+      // Short updates are left alone, the client gets its replies soon enough.
+      if (this->ListenerCondition.wait_for(lock, std::chrono::milliseconds(100),
+            [this]() { return this->ListenerExit || !this->ListenerEnabled; }))
+      {
+        continue;
+      }
+
+      this->ListenerBusy = true;
+      vtkSmartPointer<vtkMultiProcessController> controller = this->ListenerController;
+      bool alive = true;
+      while (alive && this->ListenerEnabled && !this->ListenerExit)
+      {
+        lock.unlock();
+        alive = this->ProcessRequest(controller);
+        lock.lock();
+      }
+      this->ListenerBusy = false;
+      this->ListenerCondition.notify_all();
+
+      // Wait for the end of this update.
+      this->ListenerCondition.wait(
+        lock, [this]() { return this->ListenerExit || !this->ListenerEnabled; });
+    }
+  }
+  //-----------------------------------------------------------------
+  // Processes the next request of the client, if any arrives soon. Returns
+  // false when the connection can no longer be read.
+  bool ProcessRequest(vtkMultiProcessController* controller)
+  {
+    vtkSocketCommunicator* comm =
+      controller ? vtkSocketCommunicator::SafeDownCast(controller->GetCommunicator()) : NULL;
+    if (!comm || !comm->GetSocket() || !comm->GetSocket()->GetConnected())
+    {
+      return false;
+    }
+    if (!comm->HasBufferredMessages())
+    {
+      int socket = comm->GetSocket()->GetSocketDescriptor();
+      int selected = -1;
+      int result = vtkSocket::SelectSockets(&socket, 1, 10, &selected);
+      if (result <= 0)
+      {
+        return result == 0;
+      }
+    }
+    return controller->ProcessRMIs(0, 1) == vtkMultiProcessController::RMI_NO_ERROR;
+  }
+
+  std::thread Listener;
+  std::thread::id ListenerThreadId;
+  std::mutex ListenerMutex;
+  std::condition_variable ListenerCondition;
+  vtkSmartPointer<vtkMultiProcessController> ListenerController;
+  bool ListenerEnabled;
+  bool ListenerBusy;
+  bool ListenerExit;
+  std::deque<vtkDeferredRequest> DeferredRequests;
+  bool ReplayingRequests;
+  // Stream of the EXECUTE_STREAM request being replayed, main thread only.
+  std::vector<unsigned char> ReplayedStream;
+  bool HasReplayedStream;
+
   vtkNew<vtkCompositeMultiProcessController> CompositeMultiProcessController;
   vtkWeakPointer<vtkPVSessionServer> Owner;
   std::string ClientURL;
@@ -334,6 +671,7 @@ vtkPVSessionServer::vtkPVSessionServer()
   // By default we act as a server for a single client
   this->MultipleConnection = false;
   this->DisableFurtherConnections = false;
+  this->ConcurrentRequests = false;
 
   // On server side only one session is available so we just set it Active()
   // forever
@@ -527,6 +865,11 @@ int vtkPVSessionServer::GetConnectID()
 //----------------------------------------------------------------------------
 void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_length)
 {
+  if (this->Internal->DeferRequest(CLIENT_SERVER_MESSAGE_RMI, message, message_length))
+  {
+    return;
+  }
+
   vtkMultiProcessStream stream;
   stream.SetRawData(reinterpret_cast<const unsigned char*>(message), message_length);
   int type;
@@ -572,7 +915,9 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
       // Send the result back to client
       vtkMultiProcessStream css;
       css << msg.SerializeAsString();
+      this->LockClientCommunication();
       this->Internal->GetActiveController()->Send(css, 1, vtkPVSessionServer::REPLY_PULL);
+      this->UnlockClientCommunication();
     }
     break;
     case vtkPVSessionServer::REGISTER_SI:
@@ -598,13 +943,24 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
     {
       int ignore_errors, size;
       stream >> ignore_errors >> size;
-      unsigned char* css_data = new unsigned char[size + 1];
-      this->Internal->GetActiveController()->Receive(
-        css_data, size, 1, vtkPVSessionServer::EXECUTE_STREAM_TAG);
+      std::vector<unsigned char> css_data;
+      this->Internal->ReceiveStream(size, css_data);
       vtkClientServerStream cssStream;
-      cssStream.SetData(css_data, size);
+      cssStream.SetData(&css_data[0], size);
+
+      // Let the listener answer the requests that do not need to wait for
+      // the end of a pipeline update.
+      const bool concurrent =
+        this->Internal->CanProcessConcurrentRequests() && IsPipelineUpdate(cssStream);
+      if (concurrent)
+      {
+        this->Internal->BeginPipelineUpdate();
+      }
       this->ExecuteStream(vtkPVSession::CLIENT_AND_SERVERS, cssStream, ignore_errors != 0);
-      delete[] css_data;
+      if (concurrent)
+      {
+        this->Internal->EndPipelineUpdate();
+      }
     }
     break;
 
@@ -637,8 +993,10 @@ void vtkPVSessionServer::SendLastResultToClient()
   reply.GetData(&data, &size_size_t);
   size = static_cast<int>(size_size_t);
 
+  this->LockClientCommunication();
   this->Internal->GetActiveController()->Send(&size, 1, 1, vtkPVSessionServer::REPLY_LAST_RESULT);
   this->Internal->GetActiveController()->Send(data, size, 1, vtkPVSessionServer::REPLY_LAST_RESULT);
+  this->UnlockClientCommunication();
 }
 
 //----------------------------------------------------------------------------
@@ -663,24 +1021,32 @@ void vtkPVSessionServer::GatherInformationInternal(vtkTypeUInt32 location, const
     const unsigned char* data;
     css.GetData(&data, &length);
     int len = static_cast<int>(length);
+    this->LockClientCommunication();
     this->Internal->GetActiveController()->Send(
       &len, 1, 1, vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
     this->Internal->GetActiveController()->Send(const_cast<unsigned char*>(data), length, 1,
       vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
+    this->UnlockClientCommunication();
   }
   else
   {
     vtkErrorMacro("Could not create information object.");
     // let client know that gather failed.
     int len = 0;
+    this->LockClientCommunication();
     this->Internal->GetActiveController()->Send(
       &len, 1, 1, vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
+    this->UnlockClientCommunication();
   }
 }
 
 //----------------------------------------------------------------------------
 void vtkPVSessionServer::OnCloseSessionRMI()
 {
+  if (this->Internal->DeferRequest(CLOSE_SESSION, NULL, 0))
+  {
+    return;
+  }
   if (this->GetIsAlive())
   {
     this->Internal->CloseActiveController();
@@ -691,6 +1057,7 @@ void vtkPVSessionServer::OnCloseSessionRMI()
 void vtkPVSessionServer::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ConcurrentRequests: " << this->ConcurrentRequests << endl;
 }
 //----------------------------------------------------------------------------
 void vtkPVSessionServer::NotifyOtherClients(const vtkSMMessage* msg)
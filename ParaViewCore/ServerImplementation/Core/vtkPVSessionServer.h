@@ -89,7 +89,8 @@ public:
     REPLY_GATHER_INFORMATION_TAG = 55627,
     REPLY_PULL = 55628,
     REPLY_LAST_RESULT = 55629,
-    EXECUTE_STREAM_TAG = 55630
+    EXECUTE_STREAM_TAG = 55630,
+    ABORT_EXECUTION_RMI = 55631
   };
 
   //@{
@@ -114,6 +115,28 @@ public:
   void SetDisableFurtherConnections(bool disable);
   //@}
 
+  //@{
+  /**
+   * Enable or Disable answering some client requests on a separate thread
+   * while a pipeline update requested by the client is executing. Only the
+   * information requests that neither touch the pipeline nor need the
+   * satellites are answered that way (see
+   * vtkPVInformation::GetGatherConcurrently()), unless they follow a PUSH to
+   * the object they are gathered from. Any other request waits for the end of
+   * the update, so that those requests are still processed in order.
+   * Abort requests (see vtkPVSession::RequestAbort()) are only read during
+   * updates when this is enabled.
+   * This is only done on the root of the server of a single client session.
+   * The clients still wait for the end of an update they request, so such
+   * requests are only sent from progress observers (e.g. the abort button of
+   * the Qt client) for now.
+   * By default, it is disabled (this->ConcurrentRequests = false)
+   */
+  vtkBooleanMacro(ConcurrentRequests, bool);
+  vtkSetMacro(ConcurrentRequests, bool);
+  vtkGetMacro(ConcurrentRequests, bool);
+  //@}
+
   //@{
   /**
    * Set/Get the server connect-id.
@@ -155,6 +178,7 @@ protected:
 
   bool MultipleConnection;
   bool DisableFurtherConnections;
+  bool ConcurrentRequests;
 
   class vtkInternals;
   vtkInternals* Internal;
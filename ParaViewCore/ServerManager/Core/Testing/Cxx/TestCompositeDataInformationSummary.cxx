@@ -0,0 +1,262 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestCompositeDataInformationSummary.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellArray.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkInformation.h"
+#include "vtkInitializationHelper.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVCompositeDataInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVTrivialProducer.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProcessModule.h"
+#include "vtkSMOutputPort.h"
+#include "vtkSMParaViewPipelineController.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSMSourceProxy.h"
+#include "vtkSmartPointer.h"
+
+#include <sstream>
+#include <string>
+
+// The data information of an output port summarizes the composite nodes with
+// large subtrees, and gathers their children when they are accessed. This
+// checks the summarized and expanded information against the information
+// gathered for the whole tree at once.
+
+namespace
+{
+// root -> 4 blocks -> 20 blocks -> 20 leaves: 1685 nodes.
+const unsigned int NumberOfBlocks[3] = { 4, 20, 20 };
+const int SummaryThreshold = 100;
+
+vtkSmartPointer<vtkPolyData> NewLeaf(unsigned int index)
+{
+  vtkSmartPointer<vtkPolyData> leaf = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> verts;
+  const int numberOfPoints = 1 + index % 5;
+  for (int cc = 0; cc < numberOfPoints; ++cc)
+  {
+    vtkIdType id = points->InsertNextPoint(index % 7, index % 11 + cc, index % 13);
+    verts->InsertNextCell(1, &id);
+  }
+  leaf->SetPoints(points.GetPointer());
+  leaf->SetVerts(verts.GetPointer());
+  return leaf;
+}
+
+vtkSmartPointer<vtkMultiBlockDataSet> NewTree(int level, unsigned int& index)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> tree = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  tree->SetNumberOfBlocks(NumberOfBlocks[level]);
+  for (unsigned int cc = 0; cc < NumberOfBlocks[level]; ++cc)
+  {
+    ++index;
+    if (level < 2)
+    {
+      tree->SetBlock(cc, NewTree(level + 1, index));
+    }
+    else if (index % 9 != 0)
+    {
+      // some leaves are left empty.
+      tree->SetBlock(cc, NewLeaf(index));
+    }
+    std::ostringstream name;
+    name << "block" << index;
+    tree->GetMetaData(cc)->Set(vtkCompositeDataSet::NAME(), name.str().c_str());
+  }
+  return tree;
+}
+
+// Compares the aggregated information of two nodes.
+void CompareNode(vtkPVDataInformation* info, vtkPVDataInformation* expected)
+{
+  if (!info != !expected)
+  {
+    throw "ERROR: Node information is missing!!!";
+  }
+  if (!info)
+  {
+    return;
+  }
+  double bounds[6], expectedBounds[6];
+  info->GetBounds(bounds);
+  expected->GetBounds(expectedBounds);
+  for (int cc = 0; cc < 6; ++cc)
+  {
+    if (bounds[cc] != expectedBounds[cc])
+    {
+      throw "ERROR: Node bounds differ!!!";
+    }
+  }
+  if (info->GetDataSetType() != expected->GetDataSetType() ||
+    info->GetNumberOfDataSets() != expected->GetNumberOfDataSets() ||
+    info->GetNumberOfPoints() != expected->GetNumberOfPoints() ||
+    info->GetNumberOfCells() != expected->GetNumberOfCells())
+  {
+    throw "ERROR: Node counts differ!!!";
+  }
+}
+
+// Compares the subtrees of two nodes. Accessing the children gathers them
+// when the node is summarized.
+void CompareTree(vtkPVDataInformation* info, vtkPVDataInformation* expected)
+{
+  CompareNode(info, expected);
+  if (!info)
+  {
+    return;
+  }
+  vtkPVCompositeDataInformation* composite = info->GetCompositeDataInformation();
+  vtkPVCompositeDataInformation* expectedComposite = expected->GetCompositeDataInformation();
+  if (composite->GetNumberOfChildren() != expectedComposite->GetNumberOfChildren())
+  {
+    throw "ERROR: Number of children differ!!!";
+  }
+  for (unsigned int cc = 0; cc < composite->GetNumberOfChildren(); ++cc)
+  {
+    const char* name = composite->GetName(cc);
+    const char* expectedName = expectedComposite->GetName(cc);
+    if (!name || !expectedName || std::string(name) != expectedName)
+    {
+      throw "ERROR: Names differ!!!";
+    }
+    CompareTree(composite->GetDataInformation(cc), expectedComposite->GetDataInformation(cc));
+  }
+}
+
+// Returns true if any node of the subtree of info is summarized, without
+// gathering anything.
+bool HasSummary(vtkPVDataInformation* info)
+{
+  if (!info)
+  {
+    return false;
+  }
+  vtkPVCompositeDataInformation* composite = info->GetCompositeDataInformation();
+  if (composite->GetSummary())
+  {
+    return true;
+  }
+  for (unsigned int cc = 0; cc < composite->GetNumberOfChildren(); ++cc)
+  {
+    if (HasSummary(composite->GetDataInformation(cc)))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+}
+
+int TestCompositeDataInformationSummary(int argc, char* argv[])
+{
+  (void)argc;
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  vtkNew<vtkSMParaViewPipelineController> controller;
+  vtkNew<vtkSMSession> session;
+  vtkProcessModule::GetProcessModule()->RegisterSession(session.Get());
+  controller->InitializeSession(session.Get());
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+
+  unsigned int index = 0;
+  vtkSmartPointer<vtkMultiBlockDataSet> tree = NewTree(0, index);
+  vtkNew<vtkPVDataInformation> expected;
+  expected->CopyFromObject(tree);
+
+  vtkSmartPointer<vtkSMSourceProxy> source;
+  source.TakeReference(
+    vtkSMSourceProxy::SafeDownCast(pxm->NewProxy("sources", "PVTrivialProducer")));
+  controller->InitializeProxy(source);
+  controller->RegisterPipelineProxy(source);
+  vtkPVTrivialProducer::SafeDownCast(source->GetClientSideObject())->SetOutput(tree);
+  source->UpdatePipeline();
+
+  int exitCode = EXIT_SUCCESS;
+  try
+  {
+    vtkSMOutputPort* port = source->GetOutputPort(0u);
+    if (port->GetCompositeSummaryThreshold() != 1024)
+    {
+      throw "ERROR: Unexpected default summary threshold!!!";
+    }
+    // summarizes the blocks of the first two levels, not the leaves' parents.
+    port->SetCompositeSummaryThreshold(SummaryThreshold);
+    vtkPVDataInformation* info = port->GetDataInformation();
+    vtkPVCompositeDataInformation* root = info->GetCompositeDataInformation();
+    if (!root->GetSummary() || root->GetNumberOfDescendants() != index)
+    {
+      throw "ERROR: Root information is not summarized!!!";
+    }
+    CompareNode(info, expected.GetPointer());
+
+    // accessing a child gathers one level.
+    vtkPVDataInformation* child = root->GetDataInformation(1);
+    if (root->GetSummary() || !child || !child->GetCompositeDataInformation()->GetSummary())
+    {
+      throw "ERROR: Accessing a child didn't gather a single level!!!";
+    }
+    CompareNode(child, expected->GetCompositeDataInformation()->GetDataInformation(1));
+
+    // locating a leaf below a summarized node only gathers the nodes on its
+    // path, the other summarized blocks are skipped.
+    const int leafIndex = static_cast<int>(
+      1 + 2 * (1 + NumberOfBlocks[1] * (1 + NumberOfBlocks[2])) + 1 + 3 * (1 + NumberOfBlocks[2]) +
+      1 + 4);
+    vtkPVDataInformation* leaf = info->GetDataInformationForCompositeIndex(leafIndex);
+    CompareNode(leaf, expected->GetDataInformationForCompositeIndex(leafIndex));
+    if (!leaf || leaf->GetNumberOfPoints() == 0)
+    {
+      throw "ERROR: Wrong leaf located in a summarized subtree!!!";
+    }
+    if (!root->GetDataInformation(0)->GetCompositeDataInformation()->GetSummary() ||
+      !root->GetDataInformation(3)->GetCompositeDataInformation()->GetSummary())
+    {
+      throw "ERROR: Locating a leaf gathered blocks off its path!!!";
+    }
+
+    // expanding a subtree gathers all of it at once.
+    child->GetCompositeDataInformation()->ExpandSubtree();
+    if (HasSummary(child))
+    {
+      throw "ERROR: Expanded subtree has summarized nodes!!!";
+    }
+    CompareTree(child, expected->GetCompositeDataInformation()->GetDataInformation(1));
+
+    // so does expanding the whole tree, which then matches the full gather.
+    root->ExpandSubtree();
+    if (HasSummary(info))
+    {
+      throw "ERROR: Expanded tree has summarized nodes!!!";
+    }
+    CompareTree(info, expected.GetPointer());
+  }
+  catch (const char* msg)
+  {
+    cerr << msg << endl;
+    exitCode = EXIT_FAILURE;
+  }
+
+  controller->UnRegisterProxy(source);
+  source = NULL;
+  vtkProcessModule::GetProcessModule()->UnRegisterSession(session.Get());
+  vtkInitializationHelper::Finalize();
+  return exitCode;
+}
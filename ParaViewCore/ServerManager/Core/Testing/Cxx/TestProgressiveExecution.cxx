@@ -0,0 +1,186 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestProgressiveExecution.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkAlgorithm.h"
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkInitializationHelper.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVProgressiveExecution.h"
+#include "vtkPolyData.h"
+#include "vtkProcessModule.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMProxy.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+#include "vtkXMLPolyDataWriter.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+const int NumberOfDataSets = 6;
+
+// Writes a collection of NumberOfDataSets spheres and returns its file name.
+std::string WriteCollection(const std::string& directory)
+{
+  std::string collection = directory + "/TestProgressiveExecution.pvd";
+  ofstream pvd(collection.c_str());
+  pvd << "<?xml version=\"1.0\"?>\n"
+      << "<VTKFile type=\"Collection\" version=\"0.1\">\n"
+      << "  <Collection>\n";
+  for (int cc = 0; cc < NumberOfDataSets; ++cc)
+  {
+    std::ostringstream name;
+    name << "TestProgressiveExecution_" << cc << ".vtp";
+
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetRadius(cc + 1);
+    vtkNew<vtkXMLPolyDataWriter> writer;
+    writer->SetInputConnection(sphere->GetOutputPort());
+    writer->SetFileName((directory + "/" + name.str()).c_str());
+    writer->Write();
+
+    pvd << "    <DataSet part=\"" << cc << "\" file=\"" << name.str() << "\"/>\n";
+  }
+  pvd << "  </Collection>\n"
+      << "</VTKFile>\n";
+  return collection;
+}
+
+int CountDataSets(vtkDataObject* output)
+{
+  vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(output);
+  int count = 0;
+  for (unsigned int cc = 0; mb && cc < mb->GetNumberOfBlocks(); ++cc)
+  {
+    vtkMultiBlockDataSet* block = vtkMultiBlockDataSet::SafeDownCast(mb->GetBlock(cc));
+    vtkPolyData* pd = block ? vtkPolyData::SafeDownCast(block->GetBlock(0)) : NULL;
+    if (pd && pd->GetNumberOfPoints() > 0)
+    {
+      ++count;
+    }
+  }
+  return count;
+}
+
+// Requests an abort while the reader reads the third data set.
+void AbortWhileReadingThirdDataSet(vtkObject* caller, unsigned long, void*, void*)
+{
+  if (vtkAlgorithm::SafeDownCast(caller)->GetProgress() >= 0.4)
+  {
+    vtkPVProgressiveExecution::RequestAbort();
+  }
+}
+}
+
+int TestProgressiveExecution(int argc, char* argv[])
+{
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+  {
+    cerr << "Could not determine temporary directory.\n";
+    vtkInitializationHelper::Finalize();
+    return EXIT_FAILURE;
+  }
+  const std::string collection = WriteCollection(tempDir);
+  delete[] tempDir;
+
+  // Create a new session.
+  vtkNew<vtkSMSession> session;
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+
+  vtkSmartPointer<vtkSMProxy> proxy;
+  proxy.TakeReference(pxm->NewProxy("sources", "PVDReader"));
+  vtkSMPropertyHelper(proxy, "FileName").Set(collection.c_str());
+  proxy->UpdateVTKObjects();
+  vtkAlgorithm* reader = vtkAlgorithm::SafeDownCast(proxy->GetClientSideObject());
+
+  int exitCode = EXIT_SUCCESS;
+  try
+  {
+    // Abort halfway: the data sets read before the abort are in the output,
+    // which is rolled back once the execution ends.
+    vtkNew<vtkCallbackCommand> abortCallback;
+    abortCallback->SetCallback(AbortWhileReadingThirdDataSet);
+    unsigned long tag = reader->AddObserver(vtkCommand::ProgressEvent, abortCallback.GetPointer());
+    session->PrepareProgress();
+    reader->Update();
+    reader->RemoveObserver(tag);
+    vtkSmartPointer<vtkDataObject> aborted = reader->GetOutputDataObject(0);
+    if (!vtkPVProgressiveExecution::GetExecutionAborted() || CountDataSets(aborted) != 2)
+    {
+      session->CleanupPendingProgress();
+      throw "ERROR: Reader didn't stop at the abort!!!";
+    }
+    session->CleanupPendingProgress();
+    if (!vtkPVProgressiveExecution::IsAbortedOutput(aborted) ||
+      vtkPVProgressiveExecution::GetAbortRequested())
+    {
+      throw "ERROR: Aborted execution wasn't rolled back!!!";
+    }
+
+    // The next update reads everything again.
+    reader->Update();
+    if (CountDataSets(reader->GetOutputDataObject(0)) != NumberOfDataSets ||
+      vtkPVProgressiveExecution::IsAbortedOutput(reader->GetOutputDataObject(0)))
+    {
+      throw "ERROR: Update after an abort didn't read all data sets!!!";
+    }
+
+    // With a tiny interval, each execution reads a single data set and emits a
+    // partial output, which is refined until all data sets are read.
+    vtkPVProgressiveExecution::SetPartialOutputInterval(1e-6);
+    reader->Modified();
+    reader->Update();
+    if (!vtkPVProgressiveExecution::IsPartialOutput(reader->GetOutputDataObject(0)) ||
+      CountDataSets(reader->GetOutputDataObject(0)) != 1)
+    {
+      throw "ERROR: Reader didn't emit a partial output!!!";
+    }
+    int resumed = 0;
+    while (vtkPVProgressiveExecution::ResumePartialOutput(reader->GetOutputDataObject(0)))
+    {
+      ++resumed;
+      if (CountDataSets(reader->GetOutputDataObject(0)) != resumed + 1)
+      {
+        throw "ERROR: Resuming a partial output didn't read the next data set!!!";
+      }
+    }
+    if (resumed != NumberOfDataSets - 1 ||
+      vtkPVProgressiveExecution::IsPartialOutput(reader->GetOutputDataObject(0)))
+    {
+      throw "ERROR: Partial output wasn't completed!!!";
+    }
+  }
+  catch (const char* msg)
+  {
+    cerr << msg << endl;
+    exitCode = EXIT_FAILURE;
+  }
+  vtkPVProgressiveExecution::SetPartialOutputInterval(0.0);
+  proxy = NULL;
+  vtkInitializationHelper::Finalize();
+  return exitCode;
+}
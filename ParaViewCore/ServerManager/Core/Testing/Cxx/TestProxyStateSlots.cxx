@@ -0,0 +1,125 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestProxyStateSlots.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkSMDoubleVectorProperty.h"
+#include "vtkSMMessage.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMProxy.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSmartPointer.h"
+
+namespace
+{
+// Sorts before every property of the sphere so that adding it shifts the
+// state slots of all of them.
+const char* ExtraPropertyName = "AAAExtraProperty";
+
+void AddExtraProperty(vtkSMProxy* proxy, double value)
+{
+  vtkNew<vtkSMDoubleVectorProperty> property;
+  property->SetNumberOfElements(1);
+  property->SetElement(0, value);
+  proxy->AddProperty(ExtraPropertyName, property.GetPointer());
+}
+
+// Returns a sphere with the same property values as proxy, whose state is
+// built from scratch when its VTK objects are created.
+vtkSmartPointer<vtkSMProxy> NewReference(vtkSMSessionProxyManager* pxm, vtkSMProxy* proxy)
+{
+  vtkSmartPointer<vtkSMProxy> reference;
+  reference.TakeReference(pxm->NewProxy("sources", "SphereSource"));
+  if (proxy->GetProperty(ExtraPropertyName))
+  {
+    AddExtraProperty(reference, 0);
+  }
+  reference->Copy(proxy);
+  reference->UpdateVTKObjects();
+  return reference;
+}
+
+bool HaveSamePropertyStates(vtkSMProxy* proxy, vtkSMProxy* reference)
+{
+  const vtkSMMessage* state = proxy->GetFullState();
+  const vtkSMMessage* referenceState = reference->GetFullState();
+  const int size = state->ExtensionSize(ProxyState::property);
+  if (size != referenceState->ExtensionSize(ProxyState::property))
+  {
+    return false;
+  }
+  for (int cc = 0; cc < size; ++cc)
+  {
+    if (state->GetExtension(ProxyState::property, cc).SerializeAsString() !=
+      referenceState->GetExtension(ProxyState::property, cc).SerializeAsString())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestProxyStateSlots(int argc, char* argv[])
+{
+  (void)argc;
+
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  // Create a new session.
+  vtkNew<vtkSMSession> session;
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+
+  vtkSmartPointer<vtkSMProxy> sphere;
+  sphere.TakeReference(pxm->NewProxy("sources", "SphereSource"));
+  sphere->UpdateVTKObjects();
+
+  int exitCode = EXIT_SUCCESS;
+  try
+  {
+    // Pushing a single property updates its slot in the state in place.
+    vtkSMPropertyHelper(sphere, "Radius").Set(3);
+    sphere->UpdateVTKObjects();
+    if (!HaveSamePropertyStates(sphere, NewReference(pxm, sphere)))
+    {
+      throw "ERROR: State differs from the rebuilt state after changing a property!!!";
+    }
+
+    // Adding a property once the state exists shifts the slots of the others.
+    AddExtraProperty(sphere, 1);
+    if (!HaveSamePropertyStates(sphere, NewReference(pxm, sphere)))
+    {
+      throw "ERROR: State differs from the rebuilt state after adding a property!!!";
+    }
+
+    vtkSMPropertyHelper(sphere, "Radius").Set(5);
+    vtkSMPropertyHelper(sphere, ExtraPropertyName).Set(2);
+    sphere->UpdateVTKObjects();
+    if (!HaveSamePropertyStates(sphere, NewReference(pxm, sphere)))
+    {
+      throw "ERROR: State differs from the rebuilt state after changing shifted properties!!!";
+    }
+  }
+  catch (const char* msg)
+  {
+    cerr << msg << endl;
+    exitCode = EXIT_FAILURE;
+  }
+  sphere = NULL;
+  vtkInitializationHelper::Finalize();
+  return exitCode;
+}
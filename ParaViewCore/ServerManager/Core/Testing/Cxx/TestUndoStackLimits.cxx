@@ -0,0 +1,174 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestUndoStackLimits.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkSMMessage.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMProxy.h"
+#include "vtkSMRemoteObjectUpdateUndoElement.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSMUndoStack.h"
+#include "vtkSmartPointer.h"
+#include "vtkUndoSet.h"
+
+namespace
+{
+// Changes a property of the sphere and pushes the change on the stack, the
+// way vtkSMUndoStackBuilder does.
+void PushProperty(vtkSMUndoStack* stack, vtkSMSession* session, vtkSMProxy* sphere,
+  const char* name, double value, const char* label)
+{
+  vtkSMMessage before;
+  before.CopyFrom(*sphere->GetFullState());
+  vtkSMPropertyHelper(sphere, name).Set(value);
+  sphere->UpdateVTKObjects();
+  vtkSMMessage after;
+  after.CopyFrom(*sphere->GetFullState());
+
+  vtkNew<vtkSMRemoteObjectUpdateUndoElement> undoElement;
+  undoElement->SetSession(session);
+  undoElement->SetUndoRedoState(&before, &after);
+  vtkNew<vtkUndoSet> undoSet;
+  undoSet->AddElement(undoElement.GetPointer());
+  stack->Push(label, undoSet.GetPointer());
+}
+
+void PushRadius(vtkSMUndoStack* stack, vtkSMSession* session, vtkSMProxy* sphere, double radius)
+{
+  PushProperty(stack, session, sphere, "Radius", radius, "Change Radius");
+}
+
+double GetRadius(vtkSMProxy* sphere)
+{
+  sphere->UpdateVTKObjects();
+  return vtkSMPropertyHelper(sphere, "Radius").GetAsDouble();
+}
+}
+
+int TestUndoStackLimits(int argc, char* argv[])
+{
+  (void)argc;
+
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  // Create a new session.
+  vtkNew<vtkSMSession> session;
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+
+  vtkSmartPointer<vtkSMProxy> sphere;
+  sphere.TakeReference(pxm->NewProxy("sources", "SphereSource"));
+  vtkSMPropertyHelper(sphere, "Radius").Set(0.5);
+  sphere->UpdateVTKObjects();
+
+  int exitCode = EXIT_SUCCESS;
+  try
+  {
+    // Coalescing is opt-in: by default, every change is undone on its own.
+    vtkNew<vtkSMUndoStack> defaultStack;
+    PushRadius(defaultStack.GetPointer(), session.GetPointer(), sphere, 1);
+    PushRadius(defaultStack.GetPointer(), session.GetPointer(), sphere, 2);
+    if (defaultStack->GetNumberOfUndoSets() != 2)
+    {
+      throw "ERROR: Changes were coalesced by default!!!";
+    }
+    vtkSMPropertyHelper(sphere, "Radius").Set(0.5);
+    sphere->UpdateVTKObjects();
+
+    // Distinct edits are never merged, however close in time they are.
+    vtkNew<vtkSMUndoStack> distinctStack;
+    distinctStack->SetCoalescingInterval(60.0);
+    PushProperty(distinctStack.GetPointer(), session.GetPointer(), sphere, "Radius", 1, "Edit");
+    PushProperty(
+      distinctStack.GetPointer(), session.GetPointer(), sphere, "ThetaResolution", 16, "Edit");
+    PushProperty(
+      distinctStack.GetPointer(), session.GetPointer(), sphere, "ThetaResolution", 20, "Other");
+    if (distinctStack->GetNumberOfUndoSets() != 3)
+    {
+      throw "ERROR: Distinct edits were coalesced!!!";
+    }
+    distinctStack->Undo();
+    distinctStack->Undo();
+    if (GetRadius(sphere) != 1 || vtkSMPropertyHelper(sphere, "ThetaResolution").GetAsInt() != 8)
+    {
+      throw "ERROR: Undoing distinct edits doesn't restore each of them!!!";
+    }
+    vtkSMPropertyHelper(sphere, "Radius").Set(0.5);
+    sphere->UpdateVTKObjects();
+
+    // Dragging a slider pushes the same change over and over: a single undo
+    // must bring back the value from before the drag.
+    vtkNew<vtkSMUndoStack> dragStack;
+    dragStack->SetCoalescingInterval(60.0);
+    for (int cc = 1; cc <= 4; ++cc)
+    {
+      PushRadius(dragStack.GetPointer(), session.GetPointer(), sphere, cc);
+    }
+    if (dragStack->GetNumberOfUndoSets() != 1)
+    {
+      throw "ERROR: Changes of the same property were not coalesced!!!";
+    }
+    dragStack->Undo();
+    if (GetRadius(sphere) != 0.5 || dragStack->CanUndo())
+    {
+      throw "ERROR: Undoing coalesced changes doesn't restore the original value!!!";
+    }
+    dragStack->Redo();
+    if (GetRadius(sphere) != 4)
+    {
+      throw "ERROR: Redoing coalesced changes doesn't restore the last value!!!";
+    }
+
+    // Once the memory limit is exceeded, the oldest undo sets are dropped.
+    vtkNew<vtkSMUndoStack> boundedStack;
+    boundedStack->SetCoalescingInterval(0.0);
+    vtkSMPropertyHelper(sphere, "Radius").Set(0.5);
+    sphere->UpdateVTKObjects();
+    PushRadius(boundedStack.GetPointer(), session.GetPointer(), sphere, 1);
+    const vtkTypeInt64 setSize = boundedStack->GetMemorySize();
+    if (setSize <= 0)
+    {
+      throw "ERROR: Undo set has no memory size!!!";
+    }
+    boundedStack->SetMemoryLimit(3 * setSize + setSize / 2);
+    for (int cc = 2; cc <= 6; ++cc)
+    {
+      PushRadius(boundedStack.GetPointer(), session.GetPointer(), sphere, cc);
+    }
+    if (boundedStack->GetNumberOfUndoSets() != 3 ||
+      boundedStack->GetMemorySize() > boundedStack->GetMemoryLimit())
+    {
+      throw "ERROR: Memory limit not enforced!!!";
+    }
+    while (boundedStack->CanUndo())
+    {
+      boundedStack->Undo();
+    }
+    if (GetRadius(sphere) != 3)
+    {
+      throw "ERROR: Memory limit didn't drop the oldest undo sets!!!";
+    }
+  }
+  catch (const char* msg)
+  {
+    cerr << msg << endl;
+    exitCode = EXIT_FAILURE;
+  }
+  sphere = NULL;
+  vtkInitializationHelper::Finalize();
+  return exitCode;
+}
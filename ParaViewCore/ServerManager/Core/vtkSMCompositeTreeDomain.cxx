@@ -200,6 +200,8 @@ int vtkSMCompositeTreeDomain::SetDefaultValues(vtkSMProperty* property, bool use
   {
     if (this->Mode == LEAVES || this->DefaultMode == NONEMPTY_LEAF)
     {
+      // gather the summarized nodes at once rather than one per node visited.
+      this->Information->GetCompositeDataInformation()->ExpandSubtree();
       vtkNew<vtkPVCompositeDataInformationIterator> iter;
       iter->SetDataInformation(this->Information);
       int index = -1;
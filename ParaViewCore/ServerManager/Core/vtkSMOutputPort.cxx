@@ -19,8 +19,10 @@
 #include "vtkCollectionIterator.h"
 #include "vtkCommand.h"
 #include "vtkDataObject.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVClassNameInformation.h"
+#include "vtkPVCompositeDataInformation.h"
 #include "vtkPVDataInformation.h"
 #include "vtkPVTemporalDataInformation.h"
 #include "vtkPVXMLElement.h"
@@ -32,6 +34,26 @@
 
 #include <sstream>
 
+//----------------------------------------------------------------------------
+// Gathers the children of summarized nodes of the data information of a port.
+class vtkSMOutputPortSubtreeLoader : public vtkCommand
+{
+public:
+  static vtkSMOutputPortSubtreeLoader* New() { return new vtkSMOutputPortSubtreeLoader(); }
+
+  void Execute(vtkObject* caller, unsigned long, void* callData) VTK_OVERRIDE
+  {
+    vtkPVCompositeDataInformation* node = vtkPVCompositeDataInformation::SafeDownCast(caller);
+    if (this->Port && node)
+    {
+      bool wholeSubtree = callData && *static_cast<int*>(callData) != 0;
+      this->Port->GatherSubtreeInformation(node, wholeSubtree);
+    }
+  }
+
+  vtkWeakPointer<vtkSMOutputPort> Port;
+};
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSMOutputPort);
 
@@ -44,10 +66,17 @@ vtkSMOutputPort::vtkSMOutputPort()
   this->ClassNameInformationValid = 0;
   this->DataInformationValid = false;
   this->TemporalDataInformationValid = false;
+  this->CompositeSummaryThreshold = 1024;
   this->PortIndex = 0;
   this->SourceProxy = 0;
   this->CompoundSourceProxy = 0;
   this->ObjectsCreated = 1;
+
+  // the loader is kept by Initialize(), so it is set up once for all.
+  vtkSMOutputPortSubtreeLoader* loader = vtkSMOutputPortSubtreeLoader::New();
+  loader->Port = this;
+  this->DataInformation->GetCompositeDataInformation()->SetSubtreeLoader(loader);
+  loader->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -119,11 +148,35 @@ void vtkSMOutputPort::GatherDataInformation()
   this->SourceProxy->GetSession()->PrepareProgress();
   this->DataInformation->Initialize();
   this->DataInformation->SetPortNumber(this->PortIndex);
+  this->DataInformation->SetCompositeSummaryThreshold(this->CompositeSummaryThreshold);
   this->SourceProxy->GatherInformation(this->DataInformation);
   this->DataInformationValid = true;
   this->SourceProxy->GetSession()->CleanupPendingProgress();
 }
 
+//----------------------------------------------------------------------------
+void vtkSMOutputPort::GatherSubtreeInformation(
+  vtkPVCompositeDataInformation* node, bool wholeSubtree)
+{
+  if (!this->SourceProxy)
+  {
+    vtkErrorMacro("Invalid vtkSMOutputPort.");
+    return;
+  }
+
+  vtkNew<vtkPVDataInformation> info;
+  info->SetPortNumber(this->PortIndex);
+  // a threshold no subtree reaches still computes the descendant counts used
+  // to locate nodes, unlike a negative one.
+  info->SetCompositeSummaryThreshold(wholeSubtree ? VTK_INT_MAX : this->CompositeSummaryThreshold);
+  info->SetSubtreeCompositeIndex(static_cast<int>(node->GetFlatIndex()));
+
+  this->SourceProxy->GetSession()->PrepareProgress();
+  this->SourceProxy->GatherInformation(info.GetPointer());
+  this->SourceProxy->GetSession()->CleanupPendingProgress();
+  node->CopyChildrenFrom(info->GetCompositeDataInformation());
+}
+
 //----------------------------------------------------------------------------
 void vtkSMOutputPort::GatherTemporalDataInformation()
 {
@@ -192,6 +245,7 @@ void vtkSMOutputPort::UpdatePipelineInternal(double time, bool doTime)
 void vtkSMOutputPort::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CompositeSummaryThreshold: " << this->CompositeSummaryThreshold << endl;
   os << indent << "PortIndex: " << this->PortIndex << endl;
   os << indent << "SourceProxy: " << this->SourceProxy << endl;
 }
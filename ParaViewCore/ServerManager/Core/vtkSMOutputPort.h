@@ -36,6 +36,7 @@
 
 class vtkCollection;
 class vtkPVClassNameInformation;
+class vtkPVCompositeDataInformation;
 class vtkPVDataInformation;
 class vtkPVTemporalDataInformation;
 class vtkSMCompoundSourceProxy;
@@ -90,6 +91,19 @@ public:
    */
   vtkSMSourceProxy* GetSourceProxy();
 
+  //@{
+  /**
+   * Composite nodes with more than this number of nodes in their subtree are
+   * only summarized when gathering the data information: the information for
+   * their children is gathered the first time it is accessed instead. Set to
+   * a negative value to always gather the whole composite tree. Default is
+   * 1024.
+   * @sa vtkPVDataInformation::SetCompositeSummaryThreshold
+   */
+  vtkSetMacro(CompositeSummaryThreshold, int);
+  vtkGetMacro(CompositeSummaryThreshold, int);
+  //@}
+
 protected:
   vtkSMOutputPort();
   ~vtkSMOutputPort() override;
@@ -105,6 +119,13 @@ protected:
    */
   virtual void GatherDataInformation();
 
+  /**
+   * Gathers the children of a summarized node of the data information, or
+   * its whole subtree when wholeSubtree is true.
+   */
+  virtual void GatherSubtreeInformation(
+    vtkPVCompositeDataInformation* node, bool wholeSubtree = false);
+
   /**
    * Get temporal information from the server.
    */
@@ -134,6 +155,7 @@ protected:
   int ClassNameInformationValid;
   vtkPVDataInformation* DataInformation;
   bool DataInformationValid;
+  int CompositeSummaryThreshold;
 
   vtkPVTemporalDataInformation* TemporalDataInformation;
   bool TemporalDataInformationValid;
@@ -144,6 +166,7 @@ private:
 
   friend class vtkSMSourceProxy;
   friend class vtkSMCompoundSourceProxy;
+  friend class vtkSMOutputPortSubtreeLoader;
   void UpdatePipeline();
 
   // Update Pipeline with the given timestep request.
@@ -82,6 +82,33 @@ protected:
   vtkSMProxy* Proxy;
 };
 
+namespace
+{
+//---------------------------------------------------------------------------
+// Writes the property to the push message and copies it over its slot in the
+// proxy state, if any. Returns false when the slot no longer holds that
+// property, i.e. when the state must be rebuilt.
+bool vtkWritePropertyState(
+  vtkSMProxyInternals::PropertyInfo& info, vtkSMMessage* state, vtkSMMessage* message)
+{
+  info.Property->WriteTo(message);
+  if (!state || info.StateIndex < 0)
+  {
+    return true;
+  }
+
+  const ProxyState_Property& written =
+    message->GetExtension(ProxyState::property, message->ExtensionSize(ProxyState::property) - 1);
+  if (info.StateIndex >= state->ExtensionSize(ProxyState::property) ||
+    state->GetExtension(ProxyState::property, info.StateIndex).name() != written.name())
+  {
+    return false;
+  }
+  state->MutableExtension(ProxyState::property, info.StateIndex)->CopyFrom(written);
+  return true;
+}
+}
+
 vtkStandardNewMacro(vtkSMProxy);
 
 vtkCxxSetObjectMacro(vtkSMProxy, XMLElement, vtkPVXMLElement);
@@ -299,6 +326,11 @@ void vtkSMProxy::AddProperty(const char* name, vtkSMProperty* prop)
   tag = prop->AddObserver(vtkCommand::ModifiedEvent, obs);
   obs->Delete();
 
+  // Properties not created from XML are known by the name they are added with.
+  if (!prop->GetXMLName())
+  {
+    prop->SetXMLName(name);
+  }
   prop->SetParent(this);
 
   vtkSMProxyInternals::PropertyInfo newEntry;
@@ -315,6 +347,13 @@ void vtkSMProxy::AddProperty(const char* name, vtkSMProperty* prop)
   // This vector keeps track of the order in which properties
   // were added.
   this->Internals->PropertyNamesInOrder.push_back(name);
+
+  // Once the state exists, the new property needs a slot in it, which shifts
+  // the slots of the properties sorted after it.
+  if (this->ObjectsCreated)
+  {
+    this->RebuildStateForProperties();
+  }
 }
 
 //---------------------------------------------------------------------------
@@ -365,29 +404,10 @@ bool vtkSMProxy::UpdateProperty(const char* name, int force)
   vtkSMMessage message;
 
   // Make sure the local state is updated as well
-  if (this->State)
+  if (!vtkWritePropertyState(it->second, this->State, &message))
   {
-    vtkSMMessage oldState;
-    oldState.CopyFrom(*this->State);
-    this->State->ClearExtension(ProxyState::property);
-    int nbProps = oldState.ExtensionSize(ProxyState::property);
-    for (int cc = 0; cc < nbProps; cc++)
-    {
-      const ProxyState_Property* oldProperty = &oldState.GetExtension(ProxyState::property, cc);
-
-      if (oldProperty->name() == it->second.Property->GetXMLName())
-      {
-        it->second.Property->WriteTo(this->State);
-      }
-      else
-      {
-        ProxyState_Property* newProperty = this->State->AddExtension(ProxyState::property);
-        newProperty->CopyFrom(oldState.GetExtension(ProxyState::property, cc));
-      }
-    }
+    this->RebuildStateForProperties();
   }
-
-  it->second.Property->WriteTo(&message);
   this->PushState(&message);
 
   // Fire event to let everyone know that a property has been updated.
@@ -612,73 +632,35 @@ void vtkSMProxy::UpdateVTKObjects()
   {
     this->InUpdateVTKObjects = 1;
 
-    // Save previous property values and clear the State properties
-    vtkSMMessage oldState;
-    oldState.CopyFrom(*this->State);
-    this->State->ClearExtension(ProxyState::property);
-
-    // iterate over all properties and push modified ones.
+    // iterate over all properties and push modified ones, updating their
+    // slots in the state in place.
     vtkSMMessage message;
+    bool stateUpToDate = true;
     vtkSMProxyInternals::PropertyInfoMap::iterator iter;
-    int cc = 0;
     for (iter = this->Internals->Properties.begin(); iter != this->Internals->Properties.end();
          ++iter)
     {
       vtkSMProperty* property = iter->second.Property;
-      if (property && !property->GetInformationOnly())
+      if (property && !property->GetInformationOnly() && iter->second.ModifiedFlag)
       {
-        if (property->GetIsInternal() || property->IsStateIgnored() ||
-          strcmp(property->GetClassName(), "vtkSMProperty") == 0)
+        if (!vtkWritePropertyState(iter->second, this->State, &message))
         {
-          // Push only modified properties
-          if (iter->second.ModifiedFlag)
-          {
-            // Write to message because vtkSMProperty do not have state
-            property->WriteTo(&message);
-
-            // the property is no longer dirty.
-            iter->second.ModifiedFlag = 0;
-
-            // Fire event to let everyone know that a property has been updated.
-            // This is currently used by vtkSMLink. Need to see if we can avoid this
-            // as firing these events ain't inexpensive.
-            this->InvokeEvent(
-              vtkCommand::UpdatePropertyEvent, const_cast<char*>(iter->first.c_str()));
-          }
+          stateUpToDate = false;
         }
-        else
-        {
-          // Push only modified properties
-          if (iter->second.ModifiedFlag)
-          {
-            // Write to state
-            property->WriteTo(this->State);
-
-            // the property is no longer dirty.
-            iter->second.ModifiedFlag = 0;
 
-            // Write to Push message
-            ProxyState_Property* prop = message.AddExtension(ProxyState::property);
-            prop->CopyFrom(this->State->GetExtension(ProxyState::property, cc));
+        // the property is no longer dirty.
+        iter->second.ModifiedFlag = 0;
 
-            // Fire event to let everyone know that a property has been updated.
-            // This is currently used by vtkSMLink. Need to see if we can avoid this
-            // as firing these events ain't inexpensive.
-            this->InvokeEvent(
-              vtkCommand::UpdatePropertyEvent, const_cast<char*>(iter->first.c_str()));
-          }
-          else
-          {
-            // Just copy the previous old value to the state
-            ProxyState_Property* prop = this->State->AddExtension(ProxyState::property);
-            prop->CopyFrom(oldState.GetExtension(ProxyState::property, cc));
-          }
-
-          // One more property
-          ++cc;
-        }
+        // Fire event to let everyone know that a property has been updated.
+        // This is currently used by vtkSMLink. Need to see if we can avoid this
+        // as firing these events ain't inexpensive.
+        this->InvokeEvent(vtkCommand::UpdatePropertyEvent, const_cast<char*>(iter->first.c_str()));
       }
     }
+    if (!stateUpToDate)
+    {
+      this->RebuildStateForProperties();
+    }
     this->InUpdateVTKObjects = 0;
     this->PropertiesModified = false;
 
@@ -791,6 +773,7 @@ void vtkSMProxy::RebuildStateForProperties()
        ++iter)
   {
     vtkSMProperty* property = iter->second.Property;
+    iter->second.StateIndex = -1;
     if (property && !property->GetInformationOnly())
     {
       if (property->GetIsInternal() || property->IsStateIgnored() ||
@@ -801,6 +784,7 @@ void vtkSMProxy::RebuildStateForProperties()
       else
       {
         // Write empty property inside state
+        iter->second.StateIndex = this->State->ExtensionSize(ProxyState::property);
         property->WriteTo(this->State);
       }
     }
@@ -44,10 +44,14 @@ struct vtkSMProxyInternals
     {
       this->ModifiedFlag = 0;
       this->ObserverTag = 0;
+      this->StateIndex = -1;
     };
     vtkSmartPointer<vtkSMProperty> Property;
     int ModifiedFlag;
     unsigned int ObserverTag;
+    // index of the property in the ProxyState::property extension of the
+    // proxy state, -1 when the property has no state.
+    int StateIndex;
   };
   // Note that the name of the property is the map key. That is the
   // only place where name is stored
@@ -26,6 +26,70 @@
 
 #include <vtkNew.h>
 
+#include <map>
+#include <string>
+
+namespace
+{
+// Maps property names to serialized properties.
+typedef std::map<std::string, std::string> vtkPropertyMap;
+
+//-----------------------------------------------------------------------------
+// Serializes everything but the properties of the state.
+std::string vtkGetStateSkeleton(const vtkSMMessage& state)
+{
+  vtkSMMessage skeleton;
+  skeleton.CopyFrom(state);
+  skeleton.ClearExtension(ProxyState::property);
+  return skeleton.SerializeAsString();
+}
+
+//-----------------------------------------------------------------------------
+void vtkGetProperties(const vtkSMMessage& state, vtkPropertyMap& properties)
+{
+  for (int i = 0; i < state.ExtensionSize(ProxyState::property); ++i)
+  {
+    const ProxyState_Property& prop = state.GetExtension(ProxyState::property, i);
+    properties[prop.name()] = prop.SerializeAsString();
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Adds to delta the properties of state that are missing or different in other.
+void vtkAddChangedProperties(
+  const vtkSMMessage& state, const vtkPropertyMap& other, vtkSMMessage* delta)
+{
+  for (int i = 0; i < state.ExtensionSize(ProxyState::property); ++i)
+  {
+    const ProxyState_Property& prop = state.GetExtension(ProxyState::property, i);
+    vtkPropertyMap::const_iterator iter = other.find(prop.name());
+    if (iter == other.end() || iter->second != prop.SerializeAsString())
+    {
+      delta->AddExtension(ProxyState::property)->CopyFrom(prop);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkHaveSamePropertyNames(const vtkSMMessage& state1, const vtkSMMessage& state2)
+{
+  const int size = state1.ExtensionSize(ProxyState::property);
+  if (size != state2.ExtensionSize(ProxyState::property))
+  {
+    return false;
+  }
+  for (int i = 0; i < size; ++i)
+  {
+    if (state1.GetExtension(ProxyState::property, i).name() !=
+      state2.GetExtension(ProxyState::property, i).name())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
 vtkStandardNewMacro(vtkSMRemoteObjectUpdateUndoElement);
 vtkSetObjectImplementationMacro(
   vtkSMRemoteObjectUpdateUndoElement, ProxyLocator, vtkSMProxyLocator);
@@ -35,6 +99,8 @@ vtkSMRemoteObjectUpdateUndoElement::vtkSMRemoteObjectUpdateUndoElement()
   this->ProxyLocator = NULL;
   this->AfterState = new vtkSMMessage();
   this->BeforeState = new vtkSMMessage();
+  this->PropertyDelta = false;
+  this->StateByteSize = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -53,6 +119,8 @@ void vtkSMRemoteObjectUpdateUndoElement::PrintSelf(ostream& os, vtkIndent indent
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "GlobalId: " << this->GetGlobalId() << endl;
+  os << indent << "PropertyDelta: " << this->PropertyDelta << endl;
+  os << indent << "StateByteSize: " << this->StateByteSize << endl;
   os << indent << "Before state: " << endl;
   if (this->BeforeState)
     this->BeforeState->PrintDebugString();
@@ -107,17 +175,87 @@ void vtkSMRemoteObjectUpdateUndoElement::SetUndoRedoState(
 {
   this->BeforeState->Clear();
   this->AfterState->Clear();
+  this->PropertyDelta = false;
   if (before && after)
   {
-    this->BeforeState->CopyFrom(*before);
-    this->AfterState->CopyFrom(*after);
+    if (before->ExtensionSize(ProxyState::property) > 0 &&
+      vtkGetStateSkeleton(*before) == vtkGetStateSkeleton(*after))
+    {
+      // Only the property values changed, keep the ones that differ.
+      vtkPropertyMap beforeProperties, afterProperties;
+      vtkGetProperties(*before, beforeProperties);
+      vtkGetProperties(*after, afterProperties);
+
+      this->BeforeState->CopyFrom(*before);
+      this->BeforeState->ClearExtension(ProxyState::property);
+      this->AfterState->CopyFrom(*this->BeforeState);
+      vtkAddChangedProperties(*before, afterProperties, this->BeforeState);
+      vtkAddChangedProperties(*after, beforeProperties, this->AfterState);
+      this->PropertyDelta = true;
+    }
+    else
+    {
+      this->BeforeState->CopyFrom(*before);
+      this->AfterState->CopyFrom(*after);
+    }
   }
   else
   {
     vtkErrorMacro("Invalid SetUndoRedoState. "
       << "At least one of the provided states is NULL.");
   }
+  this->StateByteSize = this->BeforeState->ByteSize() + this->AfterState->ByteSize();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSMRemoteObjectUpdateUndoElement::CanMerge(vtkSMRemoteObjectUpdateUndoElement* next)
+{
+  return next && next != this && this->PropertyDelta && next->PropertyDelta &&
+    this->GetSession() == next->GetSession() && this->GetGlobalId() == next->GetGlobalId() &&
+    vtkHaveSamePropertyNames(*this->BeforeState, *next->BeforeState) &&
+    vtkHaveSamePropertyNames(*this->AfterState, *next->AfterState) &&
+    vtkGetStateSkeleton(*this->AfterState) == vtkGetStateSkeleton(*next->AfterState);
+}
+
+//-----------------------------------------------------------------------------
+void vtkSMRemoteObjectUpdateUndoElement::Merge(vtkSMRemoteObjectUpdateUndoElement* next)
+{
+  if (!this->CanMerge(next))
+  {
+    vtkErrorMacro("Cannot merge an undo element that does not change the same properties.");
+    return;
+  }
+  this->AfterState->CopyFrom(*next->AfterState);
+  this->StateByteSize = this->BeforeState->ByteSize() + this->AfterState->ByteSize();
 }
+
+//-----------------------------------------------------------------------------
+void vtkSMRemoteObjectUpdateUndoElement::ApplyPropertyDelta(
+  const vtkSMMessage* delta, vtkSMMessage* state)
+{
+  if (!delta || !state)
+  {
+    return;
+  }
+  for (int i = 0; i < delta->ExtensionSize(ProxyState::property); ++i)
+  {
+    const ProxyState_Property& prop = delta->GetExtension(ProxyState::property, i);
+    ProxyState_Property* target = NULL;
+    for (int j = 0; j < state->ExtensionSize(ProxyState::property) && !target; ++j)
+    {
+      if (state->GetExtension(ProxyState::property, j).name() == prop.name())
+      {
+        target = state->MutableExtension(ProxyState::property, j);
+      }
+    }
+    if (!target)
+    {
+      target = state->AddExtension(ProxyState::property);
+    }
+    target->CopyFrom(prop);
+  }
+}
+
 //-----------------------------------------------------------------------------
 vtkTypeUInt32 vtkSMRemoteObjectUpdateUndoElement::GetGlobalId()
 {
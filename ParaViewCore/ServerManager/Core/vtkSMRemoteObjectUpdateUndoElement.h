@@ -19,6 +19,13 @@
  * This class keeps the before and after state of the RemoteObject in the
  * vtkSMMessage form. It works with any proxy and RemoteObject. It is a very
  * generic undoElement.
+ *
+ * When both states only differ by the values of some properties, only those
+ * properties are kept, along with the rest of the state (xml names, sub-proxies,
+ * annotations...). Such property deltas are enough to undo/redo the change
+ * since vtkSMProxy::LoadState() only updates the properties present in the
+ * state, but must be completed with the current state of the proxy wherever a
+ * full state is expected (see ApplyPropertyDelta()).
 */
 
 #ifndef vtkSMRemoteObjectUpdateUndoElement_h
@@ -60,12 +67,39 @@ public:
    */
   virtual void SetUndoRedoState(const vtkSMMessage* before, const vtkSMMessage* after);
 
-  // Current full state of the UndoElement
+  // Current state of the UndoElement, either full or property delta.
   vtkSMMessage* BeforeState;
   vtkSMMessage* AfterState;
 
   virtual vtkTypeUInt32 GetGlobalId();
 
+  /**
+   * Returns true when BeforeState and AfterState only hold the properties that
+   * changed rather than the full state of the remote object.
+   */
+  vtkGetMacro(PropertyDelta, bool);
+
+  /**
+   * Returns the number of bytes used by BeforeState and AfterState.
+   */
+  vtkGetMacro(StateByteSize, int);
+
+  //@{
+  /**
+   * Returns true when \c next is a later change of exactly the same properties
+   * of the same remote object, in which case Merge() keeps the before state of
+   * this element and the after state of \c next.
+   */
+  bool CanMerge(vtkSMRemoteObjectUpdateUndoElement* next);
+  void Merge(vtkSMRemoteObjectUpdateUndoElement* next);
+  //@}
+
+  /**
+   * Replaces the properties of \c state by the ones of \c delta, adding the
+   * properties that \c state does not have.
+   */
+  static void ApplyPropertyDelta(const vtkSMMessage* delta, vtkSMMessage* state);
+
 protected:
   vtkSMRemoteObjectUpdateUndoElement();
   ~vtkSMRemoteObjectUpdateUndoElement() override;
@@ -74,6 +108,8 @@ protected:
   int UpdateState(const vtkSMMessage* state);
 
   vtkSMProxyLocator* ProxyLocator;
+  bool PropertyDelta;
+  int StateByteSize;
 
 private:
   vtkSMRemoteObjectUpdateUndoElement(const vtkSMRemoteObjectUpdateUndoElement&) = delete;
@@ -451,6 +451,19 @@ void vtkSMSessionClient::CloseSession()
     this->SetRenderServerController(0);
   }
 }
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::RequestAbort()
+{
+  if (this->DataServerController)
+  {
+    this->DataServerController->TriggerRMIOnAllChildren(vtkPVSessionServer::ABORT_EXECUTION_RMI);
+  }
+  if (this->RenderServerController)
+  {
+    this->RenderServerController->TriggerRMIOnAllChildren(vtkPVSessionServer::ABORT_EXECUTION_RMI);
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PreDisconnection()
 {
@@ -121,6 +121,12 @@ public:
    */
   void CloseSession();
 
+  /**
+   * Overridden to forward the abort request to the servers. The servers read
+   * it while executing only when started with --concurrent-requests.
+   */
+  void RequestAbort() VTK_OVERRIDE;
+
   /**
    * Gather information about an object referred by the \c globalid.
    * \c location identifies the processes to gather the information from.
@@ -28,13 +28,35 @@
 #include "vtkSMSession.h"
 #include "vtkSMStateLocator.h"
 #include "vtkSMUndoElement.h"
+#include "vtkTimerLog.h"
 #include "vtkUndoSet.h"
 #include "vtkUndoStackInternal.h"
+#include "vtkWeakPointer.h"
 
 #include "vtkNew.h"
 #include <set>
+#include <string>
 #include <vtksys/RegularExpression.hxx>
 
+namespace
+{
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkGetUndoSetByteSize(vtkUndoSet* undoSet)
+{
+  vtkTypeInt64 size = 0;
+  for (int cc = 0; cc < undoSet->GetNumberOfElements(); ++cc)
+  {
+    vtkSMRemoteObjectUpdateUndoElement* elem =
+      vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(undoSet->GetElement(cc));
+    if (elem)
+    {
+      size += elem->GetStateByteSize();
+    }
+  }
+  return size;
+}
+}
+
 //*****************************************************************************
 class vtkSMUndoStack::vtkInternal
 {
@@ -45,11 +67,17 @@ public:
   vtkNew<vtkSMDeserializerProtobuf> UndoSetProxyDeserializer;
   vtkNew<vtkSMStateLocator> UndoSetStateLocator;
 
+  // Last undo set pushed on the undo stack, used to coalesce the next ones.
+  vtkWeakPointer<vtkUndoSet> LastPushedSet;
+  std::string LastPushedLabel;
+  double LastPushTime;
+
   vtkInternal()
   {
     this->UndoSetProxyDeserializer->SetStateLocator(this->UndoSetStateLocator.GetPointer());
     this->UndoSetProxyLocator->SetDeserializer(this->UndoSetProxyDeserializer.GetPointer());
     this->UndoSetProxyLocator->UseSessionToLocateProxy(true);
+    this->LastPushTime = 0.0;
   }
 
   void FillLocatorWithUndoStates(vtkUndoSet* undoSet, bool useBeforeState)
@@ -64,13 +92,20 @@ public:
       if (elem)
       {
         elem->SetProxyLocator(this->UndoSetProxyLocator.GetPointer());
-        if (useBeforeState)
+        vtkSMMessage* state = useBeforeState ? elem->BeforeState : elem->AfterState;
+
+        // Property deltas are completed with the state known so far, which is
+        // the one of the previous elements or the current one of the session.
+        vtkSMMessage fullState;
+        if (elem->GetPropertyDelta() &&
+          this->UndoSetStateLocator->FindState(state->global_id(), &fullState))
         {
-          this->UndoSetStateLocator->RegisterState(elem->BeforeState);
+          vtkSMRemoteObjectUpdateUndoElement::ApplyPropertyDelta(state, &fullState);
+          this->UndoSetStateLocator->RegisterState(&fullState);
         }
         else
         {
-          this->UndoSetStateLocator->RegisterState(elem->AfterState);
+          this->UndoSetStateLocator->RegisterState(state);
         }
       }
     }
@@ -130,6 +165,8 @@ vtkStandardNewMacro(vtkSMUndoStack);
 vtkSMUndoStack::vtkSMUndoStack()
 {
   this->Internal = new vtkInternal();
+  this->CoalescingInterval = 0.0;
+  this->MemoryLimit = 64 * 1024 * 1024;
 }
 
 //-----------------------------------------------------------------------------
@@ -142,8 +179,89 @@ vtkSMUndoStack::~vtkSMUndoStack()
 //-----------------------------------------------------------------------------
 void vtkSMUndoStack::Push(const char* label, vtkUndoSet* changeSet)
 {
-  this->Superclass::Push(label, changeSet);
-  this->InvokeEvent(PushUndoSetEvent, changeSet);
+  const double now = vtkTimerLog::GetUniversalTime();
+  const bool coalesced = this->CoalescingInterval > 0.0 &&
+    now - this->Internal->LastPushTime <= this->CoalescingInterval &&
+    this->Coalesce(label, changeSet);
+  if (!coalesced)
+  {
+    this->Superclass::Push(label, changeSet);
+    this->Internal->LastPushedSet = this->GetNextUndoSet();
+    this->Internal->LastPushedLabel = label ? label : "";
+  }
+  this->Internal->LastPushTime = now;
+  this->EnforceMemoryLimit();
+  if (!coalesced)
+  {
+    this->InvokeEvent(PushUndoSetEvent, changeSet);
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSMUndoStack::Coalesce(const char* label, vtkUndoSet* changeSet)
+{
+  vtkUndoSet* top = this->GetNextUndoSet();
+  if (!top || !changeSet || top != this->Internal->LastPushedSet || this->CanRedo() ||
+    this->Internal->LastPushedLabel != (label ? label : "") ||
+    top->GetNumberOfElements() != changeSet->GetNumberOfElements())
+  {
+    return false;
+  }
+
+  const int max = top->GetNumberOfElements();
+  for (int cc = 0; cc < max; ++cc)
+  {
+    vtkSMRemoteObjectUpdateUndoElement* elem =
+      vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(top->GetElement(cc));
+    vtkSMRemoteObjectUpdateUndoElement* next =
+      vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(changeSet->GetElement(cc));
+    if (!elem || !elem->CanMerge(next))
+    {
+      return false;
+    }
+  }
+  for (int cc = 0; cc < max; ++cc)
+  {
+    vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(top->GetElement(cc))
+      ->Merge(vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(changeSet->GetElement(cc)));
+  }
+  this->Modified();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkSMUndoStack::GetMemorySize()
+{
+  vtkTypeInt64 size = 0;
+  vtkUndoStackInternal* stacks = this->Superclass::Internal;
+  for (size_t cc = 0; cc < stacks->UndoStack.size(); ++cc)
+  {
+    size += vtkGetUndoSetByteSize(stacks->UndoStack[cc].UndoSet);
+  }
+  for (size_t cc = 0; cc < stacks->RedoStack.size(); ++cc)
+  {
+    size += vtkGetUndoSetByteSize(stacks->RedoStack[cc].UndoSet);
+  }
+  return size;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSMUndoStack::EnforceMemoryLimit()
+{
+  if (this->MemoryLimit <= 0)
+  {
+    return;
+  }
+
+  vtkUndoStackInternal* stacks = this->Superclass::Internal;
+  vtkTypeInt64 size = this->GetMemorySize();
+  while (size > this->MemoryLimit && stacks->UndoStack.size() > 1)
+  {
+    size -= vtkGetUndoSetByteSize(stacks->UndoStack.front().UndoSet);
+    stacks->UndoStack.erase(stacks->UndoStack.begin());
+    this->InvokeEvent(vtkUndoStack::UndoSetRemovedEvent);
+    this->Modified();
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -159,6 +277,7 @@ int vtkSMUndoStack::Undo()
   vtkNew<vtkCollection> remoteObjectsCollection;
   this->FillWithRemoteObjects(this->GetNextUndoSet(), remoteObjectsCollection.GetPointer());
   this->Internal->FillLocatorWithUndoStates(this->GetNextUndoSet(), true);
+  this->Internal->LastPushedSet = NULL;
 
   int retValue = this->Superclass::Undo();
   this->Internal->Clear();
@@ -179,6 +298,7 @@ int vtkSMUndoStack::Redo()
   vtkNew<vtkCollection> remoteObjectsCollection;
   this->FillWithRemoteObjects(this->GetNextRedoSet(), remoteObjectsCollection.GetPointer());
   this->Internal->FillLocatorWithUndoStates(this->GetNextRedoSet(), false);
+  this->Internal->LastPushedSet = NULL;
 
   int retValue = this->Superclass::Redo();
   this->Internal->Clear();
@@ -200,4 +320,6 @@ void vtkSMUndoStack::FillWithRemoteObjects(vtkUndoSet* undoSet, vtkCollection* c
 void vtkSMUndoStack::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CoalescingInterval: " << this->CoalescingInterval << endl;
+  os << indent << "MemoryLimit: " << this->MemoryLimit << endl;
 }
@@ -29,6 +29,12 @@
  * server. GUI can use this to push its own changes that is undoable across
  * connections.
  *
+ * To keep memory and undo/redo latency bounded over long sessions, the oldest
+ * undo sets are dropped when the states kept exceed MemoryLimit. Stacks that
+ * record interactive changes can also merge consecutive undo sets that change
+ * the same properties of the same proxies, e.g. the many changes pushed while
+ * a widget is dragged, when pushed within CoalescingInterval of each other.
+ *
  * @sa
  * vtkSMUndoStackBuilder
 */
@@ -75,6 +81,34 @@ public:
    */
   int Redo() VTK_OVERRIDE;
 
+  //@{
+  /**
+   * Get/Set the time, in seconds, within which an undo set pushed with the same
+   * label as the undo set on the top of the undo stack, and that changes the
+   * same properties of the same proxies, is merged into it instead of being
+   * pushed. Meant for stacks recording interactive changes, e.g. while a
+   * widget is dragged. Set to 0 to disable coalescing. Default is 0.
+   */
+  vtkSetClampMacro(CoalescingInterval, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(CoalescingInterval, double);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the maximum number of bytes of state kept by the undo and redo
+   * stacks. When exceeded, the oldest undo sets are removed, though the most
+   * recent one is always kept. Set to 0 for no limit. Default is 64 MiB.
+   */
+  vtkSetClampMacro(MemoryLimit, vtkTypeInt64, 0, VTK_TYPE_INT64_MAX);
+  vtkGetMacro(MemoryLimit, vtkTypeInt64);
+  //@}
+
+  /**
+   * Returns the number of bytes of state currently kept by the undo and redo
+   * stacks.
+   */
+  vtkTypeInt64 GetMemorySize();
+
   enum EventIds
   {
     PushUndoSetEvent = 1987,
@@ -95,6 +129,16 @@ protected:
   // is supposed to happen.
   void FillWithRemoteObjects(vtkUndoSet* undoSet, vtkCollection* collection);
 
+  // Merges changeSet into the undo set on the top of the undo stack when
+  // possible (see CoalescingInterval). Returns true on success.
+  bool Coalesce(const char* label, vtkUndoSet* changeSet);
+
+  // Removes the oldest undo sets until MemoryLimit is honored.
+  void EnforceMemoryLimit();
+
+  double CoalescingInterval;
+  vtkTypeInt64 MemoryLimit;
+
 private:
   vtkSMUndoStack(const vtkSMUndoStack&) = delete;
   void operator=(const vtkSMUndoStack&) = delete;
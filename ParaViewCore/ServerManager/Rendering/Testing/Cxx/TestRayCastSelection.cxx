@@ -0,0 +1,268 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestRayCastSelection.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkAlgorithm.h"
+#include "vtkCollection.h"
+#include "vtkGenericCell.h"
+#include "vtkInitializationHelper.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPolyData.h"
+#include "vtkProcessModule.h"
+#include "vtkRenderer.h"
+#include "vtkSMParaViewPipelineControllerWithRendering.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMRenderViewProxy.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSMSourceProxy.h"
+#include "vtkSMVectorProperty.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+// Single pixel selections are answered by vtkPVRenderView::SelectByRayCasting()
+// through vtkGeometryRepresentation::RayCast(). This checks the selected cells
+// and points against a brute force intersection of the pixel ray with the
+// surface, and against the hardware selection of the pixels around it.
+
+namespace
+{
+const int ViewSize = 300;
+const int PixelStep = 15;
+
+struct Hit
+{
+  vtkIdType CellId;
+  vtkIdType PointId;
+  double T;
+};
+
+// Returns the ray through the center of pixel (x, y), from the near to the
+// far plane.
+void GetPixelRay(vtkRenderer* renderer, int x, int y, double p0[3], double p1[3])
+{
+  const int* size = renderer->GetSize();
+  p0[0] = p1[0] = 2.0 * (x + 0.5) / size[0] - 1.0;
+  p0[1] = p1[1] = 2.0 * (y + 0.5) / size[1] - 1.0;
+  p0[2] = 0.0;
+  p1[2] = 1.0;
+  renderer->ViewToWorld(p0[0], p0[1], p0[2]);
+  renderer->ViewToWorld(p1[0], p1[1], p1[2]);
+}
+
+// Returns the parametric coordinate of the intersection of p0-p1 with cell
+// cellId, or a negative value if they don't intersect.
+double IntersectCell(
+  vtkPolyData* surface, vtkIdType cellId, double p0[3], double p1[3], double position[3])
+{
+  vtkNew<vtkGenericCell> cell;
+  surface->GetCell(cellId, cell.GetPointer());
+  double t, pcoords[3];
+  int subId;
+  return cell->IntersectWithLine(p0, p1, 1e-9, t, position, pcoords, subId) ? t : -1.0;
+}
+
+// Intersects the ray with every cell of the surface. Returns false when the
+// ray misses the surface.
+bool BruteForcePick(vtkPolyData* surface, double p0[3], double p1[3], Hit& hit)
+{
+  hit.T = VTK_DOUBLE_MAX;
+  hit.CellId = -1;
+  hit.PointId = -1;
+  double closestPosition[3] = { 0, 0, 0 };
+  for (vtkIdType cc = 0; cc < surface->GetNumberOfCells(); ++cc)
+  {
+    double position[3];
+    const double t = IntersectCell(surface, cc, p0, p1, position);
+    if (t >= 0.0 && t < hit.T)
+    {
+      hit.T = t;
+      hit.CellId = cc;
+      std::copy(position, position + 3, closestPosition);
+    }
+  }
+  if (hit.CellId < 0)
+  {
+    return false;
+  }
+
+  // the point of the cell closest to the intersection.
+  vtkNew<vtkGenericCell> cell;
+  surface->GetCell(hit.CellId, cell.GetPointer());
+  double closest = VTK_DOUBLE_MAX;
+  for (vtkIdType kk = 0; kk < cell->GetNumberOfPoints(); ++kk)
+  {
+    double point[3];
+    surface->GetPoint(cell->GetPointId(kk), point);
+    const double distance = vtkMath::Distance2BetweenPoints(point, closestPosition);
+    if (distance < closest)
+    {
+      closest = distance;
+      hit.PointId = cell->GetPointId(kk);
+    }
+  }
+  return true;
+}
+
+// Returns the ids selected by the selection sources, if any.
+std::set<vtkIdType> GetSelectedIds(vtkCollection* selectionSources)
+{
+  std::set<vtkIdType> ids;
+  for (int cc = 0; cc < selectionSources->GetNumberOfItems(); ++cc)
+  {
+    vtkSMProxy* source = vtkSMProxy::SafeDownCast(selectionSources->GetItemAsObject(cc));
+    vtkSMVectorProperty* idsProperty =
+      source ? vtkSMVectorProperty::SafeDownCast(source->GetProperty("IDs")) : NULL;
+    if (!idsProperty)
+    {
+      continue;
+    }
+    // ids come last in (process, id) or (composite index, process, id).
+    const int stride = idsProperty->GetNumberOfElementsPerCommand();
+    vtkSMPropertyHelper helper(idsProperty);
+    for (unsigned int kk = stride - 1; kk < helper.GetNumberOfElements(); kk += stride)
+    {
+      ids.insert(helper.GetAsIdType(kk));
+    }
+  }
+  return ids;
+}
+
+std::set<vtkIdType> Select(vtkSMRenderViewProxy* view, bool cells, int x0, int y0, int x1, int y1)
+{
+  const int region[4] = { x0, y0, x1, y1 };
+  vtkNew<vtkCollection> representations;
+  vtkNew<vtkCollection> sources;
+  if (cells)
+  {
+    view->SelectSurfaceCells(region, representations.GetPointer(), sources.GetPointer());
+  }
+  else
+  {
+    view->SelectSurfacePoints(region, representations.GetPointer(), sources.GetPointer());
+  }
+  return GetSelectedIds(sources.GetPointer());
+}
+}
+
+int TestRayCastSelection(int argc, char* argv[])
+{
+  (void)argc;
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  vtkNew<vtkSMParaViewPipelineControllerWithRendering> controller;
+  vtkNew<vtkSMSession> session;
+  vtkProcessModule::GetProcessModule()->RegisterSession(session.Get());
+  controller->InitializeSession(session.Get());
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+
+  vtkSmartPointer<vtkSMRenderViewProxy> view;
+  view.TakeReference(vtkSMRenderViewProxy::SafeDownCast(pxm->NewProxy("views", "RenderView")));
+  controller->InitializeProxy(view);
+  const int viewSize[2] = { ViewSize, ViewSize };
+  vtkSMPropertyHelper(view, "ViewSize").Set(viewSize, 2);
+  view->UpdateVTKObjects();
+  controller->RegisterViewProxy(view);
+
+  vtkSmartPointer<vtkSMSourceProxy> sphere;
+  sphere.TakeReference(vtkSMSourceProxy::SafeDownCast(pxm->NewProxy("sources", "SphereSource")));
+  controller->InitializeProxy(sphere);
+  vtkSMPropertyHelper(sphere, "ThetaResolution").Set(24);
+  vtkSMPropertyHelper(sphere, "PhiResolution").Set(24);
+  sphere->UpdateVTKObjects();
+  controller->RegisterPipelineProxy(sphere);
+  sphere->UpdatePipeline();
+  controller->Show(sphere, 0, view);
+
+  view->ResetCamera();
+  view->StillRender();
+
+  vtkPolyData* surface = vtkPolyData::SafeDownCast(
+    vtkAlgorithm::SafeDownCast(sphere->GetClientSideObject())->GetOutputDataObject(0));
+
+  int exitCode = EXIT_SUCCESS;
+  try
+  {
+    int hits = 0;
+    for (int y = PixelStep / 2; y < ViewSize; y += PixelStep)
+    {
+      for (int x = PixelStep / 2; x < ViewSize; x += PixelStep)
+      {
+        double p0[3], p1[3];
+        GetPixelRay(view->GetRenderer(), x, y, p0, p1);
+        Hit expected;
+        const bool expectedHit = BruteForcePick(surface, p0, p1, expected);
+        const std::set<vtkIdType> cells = Select(view, true, x, y, x, y);
+        const std::set<vtkIdType> points = Select(view, false, x, y, x, y);
+        if (!expectedHit)
+        {
+          if (!cells.empty() || !points.empty())
+          {
+            throw "ERROR: Selected a cell where the ray misses the surface!!!";
+          }
+          continue;
+        }
+        ++hits;
+        if (cells.size() != 1 || points.size() != 1)
+        {
+          throw "ERROR: Single pixel selection didn't select a single cell and point!!!";
+        }
+
+        // where the ray goes through an edge, several cells are the closest
+        // and so may be several points.
+        const vtkIdType cellId = *cells.begin();
+        double position[3];
+        if (cellId != expected.CellId)
+        {
+          if (std::fabs(IntersectCell(surface, cellId, p0, p1, position) - expected.T) > 1e-6)
+          {
+            throw "ERROR: Ray cast selected a different cell than the brute force pick!!!";
+          }
+        }
+        else if (*points.begin() != expected.PointId)
+        {
+          throw "ERROR: Ray cast selected a different point than the brute force pick!!!";
+        }
+
+        // the hardware selection of the pixels around contains the same cell.
+        const std::set<vtkIdType> around = Select(view, true, x - 1, y - 1, x + 1, y + 1);
+        if (around.find(cellId) == around.end())
+        {
+          throw "ERROR: Hardware selection around the pixel doesn't contain the cell!!!";
+        }
+      }
+    }
+    if (hits == 0)
+    {
+      throw "ERROR: No pixel covers the sphere!!!";
+    }
+  }
+  catch (const char* msg)
+  {
+    cerr << msg << endl;
+    exitCode = EXIT_FAILURE;
+  }
+
+  controller->UnRegisterProxy(sphere);
+  controller->UnRegisterProxy(view);
+  sphere = NULL;
+  view = NULL;
+  vtkProcessModule::GetProcessModule()->UnRegisterSession(session.Get());
+  vtkInitializationHelper::Finalize();
+  return exitCode;
+}
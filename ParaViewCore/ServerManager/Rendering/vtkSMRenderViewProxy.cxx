@@ -758,6 +758,7 @@ bool vtkSMRenderViewProxy::ConvertDisplayToPointOnSurface(
     vtkSMProxy* pickingHelper = spxm->NewProxy("misc", "PickingHelper");
     vtkSMPropertyHelper(pickingHelper, "Input").Set(input);
     vtkSMPropertyHelper(pickingHelper, "Selection").Set(selection);
+    vtkSMPropertyHelper(pickingHelper, "Representation").Set(rep);
     vtkSMPropertyHelper(pickingHelper, "PointA").Set(nearLinePoint, 3);
     vtkSMPropertyHelper(pickingHelper, "PointB").Set(farLinePoint, 3);
     vtkSMPropertyHelper(pickingHelper, "SnapOnMeshPoint").Set(snapOnMeshPoint);
@@ -1165,7 +1166,10 @@ bool vtkSMRenderViewProxy::SelectPolygonInternal(vtkIntArray* polygonPts,
 //----------------------------------------------------------------------------
 void vtkSMRenderViewProxy::RenderForImageCapture()
 {
-  if (vtkSMPropertyHelper(this, "UseInteractiveRenderingForScreenshots", /*quiet=*/true).GetAsInt())
+  // the flag of the view is used rather than the property, as GetNeedsUpdate()
+  // does, so that it can be changed for a single capture.
+  vtkPVRenderView* view = vtkPVRenderView::SafeDownCast(this->GetClientSideObject());
+  if (view && view->GetUseInteractiveRenderingForScreenshots())
   {
     this->InteractiveRender();
   }
@@ -26,6 +26,7 @@
 #include "vtkErrorCode.h"
 #include "vtkExtractGrid.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationStringKey.h"
@@ -38,6 +39,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPVInformationKeys.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyhedron.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
@@ -286,9 +288,14 @@ public:
    * `voi` can be used to read a sub-extent. VOI is specified using VTK
    * conventions i.e. 0-based point extents specified as (x-min,x-max,
    * y-min,y-max, z-min, z-max).
+   *
+   * For unstructured zones, `range` can instead be used to read a subset of
+   * the zone. It is specified as 0-based inclusive (point-min, point-max,
+   * cell-min, cell-max).
    */
   static int readSolution(const std::string& solutionName, const int cellDim, const int physicalDim,
-    const cgsize_t* zsize, vtkDataSet* dataset, const int* voi, vtkCGNSReader* self);
+    const cgsize_t* zsize, vtkDataSet* dataset, const int* voi, vtkCGNSReader* self,
+    const cgsize_t* range = nullptr);
 
   static int fillArrayInformation(const std::vector<double>& solChildId, const int physicalDim,
     std::vector<CGNSRead::CGNSVariable>& cgnsVars, std::vector<CGNSRead::CGNSVector>& cgnsVectors,
@@ -334,6 +341,20 @@ public:
     }
   }
 
+  // Returns true if this rank is the one reading `zone` whole when zones are
+  // being partitioned across ranks.
+  static bool IsZoneOwner(int zone, vtkCGNSReader* self)
+  {
+    return self->ZoneNumberOfPieces <= 1 || (zone % self->ZoneNumberOfPieces) == self->ZonePiece;
+  }
+
+  // Reads this rank's contiguous slab of elements of an unstructured zone, along
+  // with the vertices it references and the matching part of the solution.
+  // `handled` is set to false, and nothing is read, if the zone cannot be split
+  // (non fixed-size element sections, or boundary patches are requested).
+  static int readUnstructuredZonePiece(int base, int zone, int physicalDim, const cgsize_t* zsize,
+    vtkMultiBlockDataSet* mbase, bool& handled, vtkCGNSReader* self);
+
   // Reads a curvilinear zone along with its solution.
   // If voi is non-null, then a sub-extents (x-min, x-max, y-min,  y-max, z-min,
   // z-max) can be specified to only read a subset of the zone. Otherwise, the
@@ -371,6 +392,9 @@ vtkCGNSReader::vtkCGNSReader()
   this->CreateEachSolutionAsBlock = 0;
   this->IgnoreFlowSolutionPointers = false;
   this->DistributeBlocks = true;
+  this->PartitionUnstructuredZones = true;
+  this->ZonePiece = 0;
+  this->ZoneNumberOfPieces = 1;
   this->IgnoreSILChangeEvents = false;
 
   // Setup the selection callback to modify this object when an array
@@ -834,7 +858,7 @@ int vtkCGNSReader::vtkPrivate::getVarsIdAndFillRind(const double cgioSolId, std:
 //------------------------------------------------------------------------------
 int vtkCGNSReader::vtkPrivate::readSolution(const std::string& solutionNameStr, const int cellDim,
   const int physicalDim, const cgsize_t* zsize, vtkDataSet* dataset, const int* voi,
-  vtkCGNSReader* self)
+  vtkCGNSReader* self, const cgsize_t* range)
 {
   if (solutionNameStr.empty())
   {
@@ -924,6 +948,15 @@ int vtkCGNSReader::vtkPrivate::readSolution(const std::string& solutionNameStr,
       fieldMemDims[n] = fieldMemEnd[n];
     }
   }
+  else if (range != nullptr)
+  {
+    // unstructured sub-zone, only the first dimension is meaningful.
+    const cgsize_t* prange = varCentering == CGNS_ENUMV(Vertex) ? range : range + 2;
+    fieldSrcStart[0] += prange[0];
+    fieldSrcEnd[0] = fieldSrcStart[0] + (prange[1] - prange[0]);
+    fieldMemEnd[0] = (prange[1] - prange[0]) + 1;
+    fieldMemDims[0] = fieldMemEnd[0];
+  }
 
   // compute number of field values
   nVals = static_cast<vtkIdType>(fieldMemEnd[0] * fieldMemEnd[1] * fieldMemEnd[2]);
@@ -1367,6 +1400,12 @@ int vtkCGNSReader::GetCurvilinearZone(
   const char* basename = this->Internal->GetBase(base).name;
   const char* zonename = this->Internal->GetBase(base).zones[zone].name;
 
+  // structured zones are not split, only one rank reads them.
+  if (!vtkPrivate::IsZoneOwner(zone, this))
+  {
+    return 0;
+  }
+
   vtkSmartPointer<vtkDataObject> zoneDO = sil->ReadGridForZone(basename, zonename)
     ? vtkPrivate::readCurvilinearZone(base, zone, cellDim, physicalDim, zsize, nullptr, this)
     : vtkSmartPointer<vtkDataObject>();
@@ -1453,6 +1492,336 @@ int vtkCGNSReader::GetCurvilinearZone(
   return 0;
 }
 
+//------------------------------------------------------------------------------
+int vtkCGNSReader::vtkPrivate::readUnstructuredZonePiece(int base, int zone, int physicalDim,
+  const cgsize_t* zsize, vtkMultiBlockDataSet* mbase, bool& handled, vtkCGNSReader* self)
+{
+  handled = false;
+
+  //----------------------------------------------------------------------
+  // Find element sections, a zone can only be split by element slab if its
+  // core sections are fixed-size elements tiling [1, zsize[1]].
+  //----------------------------------------------------------------------
+  std::vector<double> zoneChildId;
+  CGNSRead::getNodeChildrenId(self->cgioNum, self->currentId, zoneChildId);
+
+  std::vector<double> elemIdList;
+  for (std::size_t nn = 0; nn < zoneChildId.size(); nn++)
+  {
+    char nodeLabel[CGIO_MAX_NAME_LENGTH + 1];
+    cgio_get_label(self->cgioNum, zoneChildId[nn], nodeLabel);
+    if (strcmp(nodeLabel, "Elements_t") == 0)
+    {
+      elemIdList.push_back(zoneChildId[nn]);
+    }
+    else
+    {
+      cgio_release_id(self->cgioNum, zoneChildId[nn]);
+    }
+  }
+
+  const char* basename = self->Internal->GetBase(base).name;
+  const bool requiredPatch = self->GetSIL()->ReadPatchesForBase(basename);
+
+  // core sections, sorted by element range.
+  std::map<cgsize_t, std::pair<SectionInformation, double> > coreSec;
+  bool splittable = true;
+  for (std::size_t sec = 0; sec < elemIdList.size(); ++sec)
+  {
+    SectionInformation info;
+    std::vector<int> mdata;
+    std::vector<cgsize_t> range;
+    double elemRangeId;
+    if (cgio_get_name(self->cgioNum, elemIdList[sec], info.name) != CG_OK ||
+      CGNSRead::readNodeData<int>(self->cgioNum, elemIdList[sec], mdata) != 0 ||
+      mdata.size() != 2 ||
+      cgio_get_node_id(self->cgioNum, elemIdList[sec], "ElementRange", &elemRangeId) != CG_OK ||
+      CGNSRead::readNodeDataAs<cgsize_t>(self->cgioNum, elemRangeId, range) != CG_OK ||
+      range.size() != 2)
+    {
+      splittable = false;
+      cgio_release_id(self->cgioNum, elemIdList[sec]);
+      continue;
+    }
+    info.elemType = static_cast<CGNS_ENUMT(ElementType_t)>(mdata[0]);
+    info.range[0] = range[0];
+    info.range[1] = range[1];
+
+    int npe = 0;
+    if (info.range[0] > zsize[1])
+    {
+      // boundary section, only read along with the whole zone.
+      splittable = !requiredPatch;
+    }
+    else if (info.elemType == CGNS_ENUMV(MIXED) || info.elemType == CGNS_ENUMV(NGON_n) ||
+      info.elemType == CGNS_ENUMV(NFACE_n) || cg_npe(info.elemType, &npe) || npe <= 0 ||
+      coreSec.count(info.range[0]) != 0)
+    {
+      splittable = false;
+    }
+    else
+    {
+      coreSec[info.range[0]] = std::make_pair(info, elemIdList[sec]);
+      continue;
+    }
+    cgio_release_id(self->cgioNum, elemIdList[sec]);
+  }
+
+  cgsize_t nextElement = 1;
+  for (auto iter = coreSec.begin(); iter != coreSec.end() && splittable; ++iter)
+  {
+    splittable = iter->second.first.range[0] == nextElement;
+    nextElement = iter->second.first.range[1] + 1;
+  }
+  splittable = splittable && (nextElement - 1) == zsize[1];
+  if (!splittable || !IsIdTypeBigEnough(zsize[0]) || !IsIdTypeBigEnough(zsize[1]))
+  {
+    for (auto iter = coreSec.begin(); iter != coreSec.end(); ++iter)
+    {
+      cgio_release_id(self->cgioNum, iter->second.second);
+    }
+    return 0;
+  }
+  handled = true;
+
+  //----------------------------------------------------------------------
+  // Read the connectivity of this rank's element slab [cellBegin, cellEnd).
+  //----------------------------------------------------------------------
+  const vtkIdType numCells = static_cast<vtkIdType>(zsize[1]);
+  const vtkIdType cellBegin = static_cast<vtkIdType>(
+    static_cast<vtkTypeInt64>(numCells) * self->ZonePiece / self->ZoneNumberOfPieces);
+  const vtkIdType cellEnd = static_cast<vtkIdType>(
+    static_cast<vtkTypeInt64>(numCells) * (self->ZonePiece + 1) / self->ZoneNumberOfPieces);
+
+  vtkIdType connectivitySize = 0;
+  for (auto iter = coreSec.begin(); iter != coreSec.end(); ++iter)
+  {
+    const SectionInformation& info = iter->second.first;
+    const vtkIdType lo = std::max<vtkIdType>(cellBegin, info.range[0] - 1);
+    const vtkIdType hi = std::min<vtkIdType>(cellEnd, info.range[1]);
+    int npe = 0;
+    cg_npe(info.elemType, &npe);
+    connectivitySize += hi > lo ? (hi - lo) * (npe + 1) : 0;
+  }
+
+  vtkNew<vtkIdTypeArray> cellLocations;
+  cellLocations->SetNumberOfValues(connectivitySize);
+  vtkIdType* elements = cellLocations->GetPointer(0);
+  std::vector<int> cellsTypes;
+  cellsTypes.reserve(cellEnd - cellBegin);
+
+  vtkIdType minPointId = VTK_ID_MAX;
+  vtkIdType maxPointId = -1;
+  vtkIdType offset = 0;
+  int ier = 0;
+  for (auto iter = coreSec.begin(); iter != coreSec.end(); ++iter)
+  {
+    const SectionInformation& info = iter->second.first;
+    const double cgioSectionId = iter->second.second;
+    const vtkIdType lo = std::max<vtkIdType>(cellBegin, info.range[0] - 1);
+    const vtkIdType hi = std::min<vtkIdType>(cellEnd, info.range[1]);
+    if (hi <= lo || ier != 0)
+    {
+      cgio_release_id(self->cgioNum, cgioSectionId);
+      continue;
+    }
+
+    int numPointsPerCell = 0;
+    bool higherOrderWarning;
+    bool reOrderElements;
+    cg_npe(info.elemType, &numPointsPerCell);
+    const int cellType =
+      CGNSRead::GetVTKElemType(info.elemType, higherOrderWarning, reOrderElements);
+
+    const cgsize_t npe = numPointsPerCell;
+    const cgsize_t nElts = static_cast<cgsize_t>(hi - lo);
+    const cgsize_t firstElt = static_cast<cgsize_t>(lo - (info.range[0] - 1));
+
+    cgsize_t srcStart[2] = { firstElt * npe + 1, 1 };
+    cgsize_t srcEnd[2] = { (firstElt + nElts) * npe, 1 };
+    cgsize_t srcStride[2] = { 1, 1 };
+    cgsize_t memStart[2] = { 2, 1 };
+    cgsize_t memEnd[2] = { npe + 1, nElts };
+    cgsize_t memStride[2] = { 1, 1 };
+    cgsize_t memDim[2] = { npe + 1, nElts };
+
+    vtkIdType* localElements = &(elements[offset]);
+    if (CGNSRead::get_section_connectivity(self->cgioNum, cgioSectionId, 2, srcStart, srcEnd,
+          srcStride, memStart, memEnd, memStride, memDim, localElements) != 0)
+    {
+      vtkErrorWithObjectMacro(self, "FAILED to read cells of section " << info.name);
+      ier = 1;
+    }
+    else
+    {
+      // Add numptspercell and do -1 on indexes
+      vtkIdType pos = 0;
+      for (vtkIdType icell = 0; icell < nElts; ++icell)
+      {
+        localElements[pos++] = static_cast<vtkIdType>(numPointsPerCell);
+        for (vtkIdType ip = 0; ip < numPointsPerCell; ++ip, ++pos)
+        {
+          localElements[pos] = localElements[pos] - 1;
+          minPointId = std::min(minPointId, localElements[pos]);
+          maxPointId = std::max(maxPointId, localElements[pos]);
+        }
+      }
+      if (reOrderElements == true)
+      {
+        CGNSRead::CGNS2VTKorderMonoElem(nElts, cellType, localElements);
+      }
+      cellsTypes.insert(cellsTypes.end(), static_cast<std::size_t>(nElts), cellType);
+      offset += nElts * (npe + 1);
+    }
+    cgio_release_id(self->cgioNum, cgioSectionId);
+  }
+  if (ier != 0)
+  {
+    return ier;
+  }
+  if (cellsTypes.empty() || maxPointId < minPointId)
+  {
+    return 0;
+  }
+
+  // Vertices are read as the [minPointId, maxPointId] hyperslab, then the
+  // ones not referenced by the slab are dropped. Renumber connectivity now.
+  const vtkIdType numSpanPoints = maxPointId - minPointId + 1;
+  std::vector<vtkIdType> pointMap(numSpanPoints, -1);
+  vtkIdType numUsedPoints = 0;
+  for (vtkIdType pos = 0; pos < connectivitySize;)
+  {
+    const vtkIdType npts = elements[pos++];
+    for (vtkIdType ip = 0; ip < npts; ++ip, ++pos)
+    {
+      pointMap[elements[pos] - minPointId] = 1;
+    }
+  }
+  for (vtkIdType cc = 0; cc < numSpanPoints; ++cc)
+  {
+    if (pointMap[cc] != -1)
+    {
+      pointMap[cc] = numUsedPoints++;
+    }
+  }
+  for (vtkIdType pos = 0; pos < connectivitySize;)
+  {
+    const vtkIdType npts = elements[pos++];
+    for (vtkIdType ip = 0; ip < npts; ++ip, ++pos)
+    {
+      elements[pos] = pointMap[elements[pos] - minPointId];
+    }
+  }
+
+  //----------------------------------------------------------------------
+  // Read the vertex hyperslab.
+  //----------------------------------------------------------------------
+  std::string gridCoordName;
+  std::vector<std::string> solutionNames;
+  std::vector<double> gridChildId;
+  std::size_t nCoordsArray = 0;
+  int rind[6];
+  vtkPrivate::getGridAndSolutionNames(base, gridCoordName, solutionNames, self);
+  vtkPrivate::getCoordsIdAndFillRind(
+    gridCoordName, physicalDim, nCoordsArray, gridChildId, rind, self);
+
+  const cgsize_t spanSize = static_cast<cgsize_t>(numSpanPoints);
+  cgsize_t srcStart[3] = { rind[0] + 1 + static_cast<cgsize_t>(minPointId), 1, 1 };
+  cgsize_t srcEnd[3] = { rind[0] + static_cast<cgsize_t>(maxPointId) + 1, 1, 1 };
+  cgsize_t srcStride[3] = { 1, 1, 1 };
+  cgsize_t memStart[3] = { 1, 1, 1 };
+  cgsize_t memEnd[3] = { 3 * spanSize, 1, 1 }; // for memory aliasing
+  cgsize_t memStride[3] = { 3, 1, 1 };
+  cgsize_t memDims[3] = { spanSize, 1, 1 };
+
+  vtkNew<vtkPoints> points;
+  if (self->DoublePrecisionMesh != 0)
+  {
+    points->SetDataTypeToDouble();
+  }
+  points->SetNumberOfPoints(numSpanPoints);
+  const int cellDim = 1;
+  if (self->DoublePrecisionMesh != 0) // DOUBLE PRECISION MESHPOINTS
+  {
+    CGNSRead::get_XYZ_mesh<double, float>(self->cgioNum, gridChildId, nCoordsArray, cellDim,
+      numSpanPoints, srcStart, srcEnd, srcStride, memStart, memEnd, memStride, memDims,
+      points.Get());
+  }
+  else // SINGLE PRECISION MESHPOINTS
+  {
+    CGNSRead::get_XYZ_mesh<float, double>(self->cgioNum, gridChildId, nCoordsArray, cellDim,
+      numSpanPoints, srcStart, srcEnd, srcStride, memStart, memEnd, memStride, memDims,
+      points.Get());
+  }
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetCells(static_cast<vtkIdType>(cellsTypes.size()), cellLocations.Get());
+
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  ugrid->SetPoints(points.Get());
+  ugrid->SetCells(&cellsTypes[0], cells.Get());
+
+  //----------------------------------------------------------------------
+  // Solutions, over the vertex hyperslab and the element slab.
+  //----------------------------------------------------------------------
+  const cgsize_t range[4] = { static_cast<cgsize_t>(minPointId),
+    static_cast<cgsize_t>(maxPointId), static_cast<cgsize_t>(cellBegin),
+    static_cast<cgsize_t>(cellEnd - 1) };
+  for (auto sniter = solutionNames.begin(); sniter != solutionNames.end(); ++sniter)
+  {
+    vtkPrivate::readSolution(
+      *sniter, cellDim, physicalDim, zsize, ugrid.Get(), /*voi=*/nullptr, self, range);
+  }
+
+  // Original vertex ids, so that pieces can be stitched back together.
+  vtkNew<vtkIdTypeArray> globalIds;
+  globalIds->SetName("GlobalNodeIds");
+  globalIds->SetNumberOfTuples(numSpanPoints);
+  for (vtkIdType cc = 0; cc < numSpanPoints; ++cc)
+  {
+    globalIds->SetValue(cc, minPointId + cc);
+  }
+  ugrid->GetPointData()->SetGlobalIds(globalIds.Get());
+
+  // Drop the vertices of the hyperslab that the slab does not reference.
+  if (numUsedPoints < numSpanPoints)
+  {
+    vtkNew<vtkIdList> usedIds;
+    usedIds->SetNumberOfIds(numUsedPoints);
+    for (vtkIdType cc = 0; cc < numSpanPoints; ++cc)
+    {
+      if (pointMap[cc] != -1)
+      {
+        usedIds->SetId(pointMap[cc], cc);
+      }
+    }
+
+    vtkNew<vtkPoints> usedPoints;
+    usedPoints->SetDataType(points->GetDataType());
+    points->GetPoints(usedIds.Get(), usedPoints.Get());
+    ugrid->SetPoints(usedPoints.Get());
+
+    vtkPointData* pd = ugrid->GetPointData();
+    for (int cc = 0; cc < pd->GetNumberOfArrays(); ++cc)
+    {
+      vtkAbstractArray* array = pd->GetAbstractArray(cc);
+      vtkAbstractArray* usedArray = array->NewInstance();
+      usedArray->SetName(array->GetName());
+      usedArray->SetNumberOfComponents(array->GetNumberOfComponents());
+      usedArray->SetNumberOfTuples(numUsedPoints);
+      array->GetTuples(usedIds.Get(), usedArray);
+      // same name, replaces the array in place so attributes are kept.
+      pd->AddArray(usedArray);
+      usedArray->Delete();
+    }
+  }
+
+  vtkPrivate::AttachReferenceValue(base, ugrid.Get(), self);
+  vtkPrivate::AddIsPatchArray(ugrid.Get(), false);
+  mbase->SetBlock(zone, ugrid.Get());
+  return 0;
+}
+
 //------------------------------------------------------------------------------
 int vtkCGNSReader::GetUnstructuredZone(
   int base, int zone, int cellDim, int physicalDim, void* v_zsize, vtkMultiBlockDataSet* mbase)
@@ -1478,6 +1847,21 @@ int vtkCGNSReader::GetUnstructuredZone(
   }
 #endif
   ////========================================================================
+  if (this->ZoneNumberOfPieces > 1)
+  {
+    bool handled = false;
+    int ier =
+      vtkPrivate::readUnstructuredZonePiece(base, zone, physicalDim, zsize, mbase, handled, this);
+    if (handled || ier != 0)
+    {
+      return ier;
+    }
+    // zone cannot be split, only one rank reads it.
+    if (!vtkPrivate::IsZoneOwner(zone, this))
+    {
+      return 0;
+    }
+  }
 
   int rind[6];
   // source layout
@@ -2530,6 +2914,19 @@ int vtkCGNSReader::RequestData(vtkInformation* vtkNotUsed(request),
     numZones += this->Internal->GetBase(bb).nzones;
   }
 
+  // With fewer zones than ranks, handing out whole zones leaves ranks idle.
+  // Instead every rank visits every zone and reads its own element slab of
+  // the unstructured ones (see vtkPrivate::readUnstructuredZonePiece).
+  this->ZonePiece = 0;
+  this->ZoneNumberOfPieces = 1;
+  if (this->PartitionUnstructuredZones && numZones > 0 && numProcessors > numZones)
+  {
+    this->ZonePiece = processNumber;
+    this->ZoneNumberOfPieces = numProcessors;
+    processNumber = 0;
+    numProcessors = 1;
+  }
+
   // Divide the files evenly between processors
   int num_zones_per_process = numZones / numProcessors;
 
@@ -2585,7 +2982,7 @@ int vtkCGNSReader::RequestData(vtkInformation* vtkNotUsed(request),
   }
 
   // Bnd Sections Not implemented yet for parallel
-  if (numProcessors > 1)
+  if (numProcessors > 1 || this->ZoneNumberOfPieces > 1)
   {
 #if !defined(VTK_LEGACY_REMOVE)
     this->LoadBndPatch = 0;
@@ -3003,6 +3400,7 @@ void vtkCGNSReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "CreateEachSolutionAsBlock: " << this->CreateEachSolutionAsBlock << endl;
   os << indent << "IgnoreFlowSolutionPointers: " << this->IgnoreFlowSolutionPointers << endl;
   os << indent << "DistributeBlocks: " << this->DistributeBlocks << endl;
+  os << indent << "PartitionUnstructuredZones: " << this->PartitionUnstructuredZones << endl;
   os << indent << "Controller: " << this->Controller << endl;
 }
 
@@ -209,6 +209,21 @@ public:
   vtkGetMacro(DistributeBlocks, bool);
   vtkBooleanMacro(DistributeBlocks, bool);
 
+  //@{
+  /**
+   * When distributing blocks and there are fewer zones than ranks, each
+   * unstructured zone is split into contiguous element slabs instead, with
+   * every rank reading only its slab and the vertices that slab references
+   * (default is true). Zones that cannot be split (MIXED, NGON_n/NFACE_n or
+   * zones with requested boundary patches) are read whole by a single rank, as
+   * are structured zones. Split zones carry the original vertex ids as a
+   * "GlobalNodeIds" point array.
+   */
+  vtkSetMacro(PartitionUnstructuredZones, bool);
+  vtkGetMacro(PartitionUnstructuredZones, bool);
+  vtkBooleanMacro(PartitionUnstructuredZones, bool);
+  //@}
+
   //@{
   /**
    * Set/get the communication object used to relay a list of files
@@ -280,6 +295,9 @@ private:
   int CreateEachSolutionAsBlock; // debug option to create
   bool IgnoreFlowSolutionPointers;
   bool DistributeBlocks;
+  bool PartitionUnstructuredZones;
+  int ZonePiece;          // slab of each zone read by this rank
+  int ZoneNumberOfPieces; // number of slabs zones are split into (1 when not partitioning)
 
   // For internal cgio calls (low level IO)
   int cgioNum;      // cgio file reference
@@ -98,15 +98,16 @@ int vtkPExtractHistogram::RequestData(
   reduceFilter->SetController(this->Controller);
 
   bool isRoot = (this->Controller->GetLocalProcessId() == 0);
-  if (isRoot)
-  {
-    // PostGatherHelper needs to be set only on the root node.
-    vtkSmartPointer<vtkAttributeDataReductionFilter> rf =
-      vtkSmartPointer<vtkAttributeDataReductionFilter>::New();
-    rf->SetAttributeType(vtkAttributeDataReductionFilter::ROW_DATA);
-    rf->SetReductionType(vtkAttributeDataReductionFilter::ADD);
-    reduceFilter->SetPostGatherHelper(rf);
-  }
+
+  // Summing histograms is associative, the PostGatherHelper is set on all
+  // nodes so that partial sums can be computed along a reduction tree.
+  vtkSmartPointer<vtkAttributeDataReductionFilter> rf =
+    vtkSmartPointer<vtkAttributeDataReductionFilter>::New();
+  rf->SetAttributeType(vtkAttributeDataReductionFilter::ROW_DATA);
+  rf->SetReductionType(vtkAttributeDataReductionFilter::ADD);
+  rf->GetInformation()->Set(vtkReductionFilter::POST_GATHER_HELPER_IS_ASSOCIATIVE(), 1);
+  reduceFilter->SetPostGatherHelper(rf);
+  reduceFilter->SetTreeFanIn(4);
 
   vtkSmartPointer<vtkTable> copy = vtkSmartPointer<vtkTable>::New();
   copy->ShallowCopy(output);
@@ -0,0 +1,325 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVBVHCellLocator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVBVHCellLocator.h"
+
+#include "vtkCellArray.h"
+#include "vtkDataSet.h"
+#include "vtkGenericCell.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Clips the segment origin + t * direction, t in [0, tmax], against the box
+// grown by pad. Returns false when the segment misses the box, otherwise the
+// parametric coordinate at which the segment enters it.
+bool vtkClipSegmentWithBox(const double bounds[6], const double origin[3],
+  const double direction[3], double pad, double tmax, double& tenter)
+{
+  double t0 = 0.0;
+  double t1 = tmax;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double low = bounds[2 * i] - pad;
+    const double high = bounds[2 * i + 1] + pad;
+    if (direction[i] == 0.0)
+    {
+      if (origin[i] < low || origin[i] > high)
+      {
+        return false;
+      }
+      continue;
+    }
+    double ta = (low - origin[i]) / direction[i];
+    double tb = (high - origin[i]) / direction[i];
+    if (ta > tb)
+    {
+      std::swap(ta, tb);
+    }
+    t0 = std::max(t0, ta);
+    t1 = std::min(t1, tb);
+    if (t0 > t1)
+    {
+      return false;
+    }
+  }
+  tenter = t0;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkAddBox(const double bounds[6], vtkPoints* points, vtkCellArray* lines)
+{
+  static const int edges[12][2] = { { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 }, { 0, 2 }, { 1, 3 },
+    { 4, 6 }, { 5, 7 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+
+  const vtkIdType first = points->GetNumberOfPoints();
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    points->InsertNextPoint(
+      bounds[corner & 1], bounds[2 + ((corner >> 1) & 1)], bounds[4 + ((corner >> 2) & 1)]);
+  }
+  for (int edge = 0; edge < 12; ++edge)
+  {
+    vtkIdType ids[2] = { first + edges[edge][0], first + edges[edge][1] };
+    lines->InsertNextCell(2, ids);
+  }
+}
+}
+
+vtkStandardNewMacro(vtkPVBVHCellLocator);
+//----------------------------------------------------------------------------
+vtkPVBVHCellLocator::vtkPVBVHCellLocator()
+{
+  this->NumberOfCellsPerNode = 8;
+}
+
+//----------------------------------------------------------------------------
+vtkPVBVHCellLocator::~vtkPVBVHCellLocator()
+{
+  this->FreeSearchStructure();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVBVHCellLocator::FreeSearchStructure()
+{
+  std::vector<vtkNode>().swap(this->Nodes);
+  std::vector<vtkIdType>().swap(this->CellIds);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVBVHCellLocator::BuildLocator()
+{
+  this->FreeSearchStructure();
+  if (!this->DataSet)
+  {
+    vtkErrorMacro("Input not set!");
+    return;
+  }
+
+  const vtkIdType numCells = this->DataSet->GetNumberOfCells();
+  if (numCells > 0)
+  {
+    std::vector<double> cellBounds(6 * numCells);
+    std::vector<double> centers(3 * numCells);
+    this->CellIds.resize(numCells);
+    for (vtkIdType cc = 0; cc < numCells; ++cc)
+    {
+      double* bounds = &cellBounds[6 * cc];
+      this->DataSet->GetCellBounds(cc, bounds);
+      for (int i = 0; i < 3; ++i)
+      {
+        centers[3 * cc + i] = 0.5 * (bounds[2 * i] + bounds[2 * i + 1]);
+      }
+      this->CellIds[cc] = cc;
+    }
+
+    this->Nodes.reserve(2 * (numCells / this->NumberOfCellsPerNode + 1));
+    this->BuildNode(0, numCells, cellBounds, centers);
+  }
+  this->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVBVHCellLocator::BuildNode(vtkIdType begin, vtkIdType end,
+  const std::vector<double>& cellBounds, const std::vector<double>& centers)
+{
+  const vtkIdType index = static_cast<vtkIdType>(this->Nodes.size());
+  this->Nodes.push_back(vtkNode());
+
+  double bounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+    VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  double centerBounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+    VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  for (vtkIdType cc = begin; cc < end; ++cc)
+  {
+    const vtkIdType cellId = this->CellIds[cc];
+    for (int i = 0; i < 3; ++i)
+    {
+      bounds[2 * i] = std::min(bounds[2 * i], cellBounds[6 * cellId + 2 * i]);
+      bounds[2 * i + 1] = std::max(bounds[2 * i + 1], cellBounds[6 * cellId + 2 * i + 1]);
+      centerBounds[2 * i] = std::min(centerBounds[2 * i], centers[3 * cellId + i]);
+      centerBounds[2 * i + 1] = std::max(centerBounds[2 * i + 1], centers[3 * cellId + i]);
+    }
+  }
+  std::copy(bounds, bounds + 6, this->Nodes[index].Bounds);
+
+  int axis = 0;
+  for (int i = 1; i < 3; ++i)
+  {
+    if (centerBounds[2 * i + 1] - centerBounds[2 * i] >
+      centerBounds[2 * axis + 1] - centerBounds[2 * axis])
+    {
+      axis = i;
+    }
+  }
+
+  const vtkIdType numCells = end - begin;
+  if (numCells <= this->NumberOfCellsPerNode ||
+    centerBounds[2 * axis + 1] - centerBounds[2 * axis] <= 0.0)
+  {
+    this->Nodes[index].Offset = begin;
+    this->Nodes[index].NumberOfCells = numCells;
+    return index;
+  }
+
+  const vtkIdType middle = begin + numCells / 2;
+  std::nth_element(this->CellIds.begin() + begin, this->CellIds.begin() + middle,
+    this->CellIds.begin() + end, [&centers, axis](vtkIdType a, vtkIdType b) {
+      return centers[3 * a + axis] < centers[3 * b + axis];
+    });
+
+  // the left child is the next node, nodes are appended so `index` stays valid
+  // even though Nodes may be reallocated by the recursion.
+  this->BuildNode(begin, middle, cellBounds, centers);
+  const vtkIdType right = this->BuildNode(middle, end, cellBounds, centers);
+  this->Nodes[index].Offset = right;
+  this->Nodes[index].NumberOfCells = 0;
+  return index;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVBVHCellLocator::IntersectWithLine(double a0[3], double a1[3], double tol, double& t,
+  double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell)
+{
+  cellId = -1;
+  if (this->Nodes.empty())
+  {
+    return 0;
+  }
+  if (cell == NULL)
+  {
+    cell = this->GenericCell;
+  }
+
+  const double direction[3] = { a1[0] - a0[0], a1[1] - a0[1], a1[2] - a0[2] };
+  // cells accept hits up to tol away, so grow the boxes accordingly.
+  const double pad = tol;
+
+  double closestT = 1.0;
+  double tenter;
+  std::vector<std::pair<vtkIdType, double> > stack;
+  if (vtkClipSegmentWithBox(this->Nodes[0].Bounds, a0, direction, pad, closestT, tenter))
+  {
+    stack.push_back(std::make_pair(0, tenter));
+  }
+
+  double cellT, cellX[3], cellPCoords[3];
+  int cellSubId;
+  while (!stack.empty())
+  {
+    const vtkIdType index = stack.back().first;
+    const double nodeT = stack.back().second;
+    stack.pop_back();
+    if (nodeT > closestT)
+    {
+      continue;
+    }
+
+    const vtkNode& node = this->Nodes[index];
+    if (node.NumberOfCells > 0)
+    {
+      for (vtkIdType cc = node.Offset; cc < node.Offset + node.NumberOfCells; ++cc)
+      {
+        this->DataSet->GetCell(this->CellIds[cc], cell);
+        if (cell->IntersectWithLine(a0, a1, tol, cellT, cellX, cellPCoords, cellSubId) &&
+          cellT <= closestT)
+        {
+          closestT = cellT;
+          cellId = this->CellIds[cc];
+          std::copy(cellX, cellX + 3, x);
+          std::copy(cellPCoords, cellPCoords + 3, pcoords);
+          subId = cellSubId;
+        }
+      }
+      continue;
+    }
+
+    // push the farther child first so that the nearer one is visited first.
+    const vtkIdType children[2] = { index + 1, node.Offset };
+    double childrenT[2];
+    bool hits[2];
+    for (int i = 0; i < 2; ++i)
+    {
+      hits[i] = vtkClipSegmentWithBox(
+        this->Nodes[children[i]].Bounds, a0, direction, pad, closestT, childrenT[i]);
+    }
+    const int nearer = (hits[1] && (!hits[0] || childrenT[1] < childrenT[0])) ? 1 : 0;
+    if (hits[1 - nearer])
+    {
+      stack.push_back(std::make_pair(children[1 - nearer], childrenT[1 - nearer]));
+    }
+    if (hits[nearer])
+    {
+      stack.push_back(std::make_pair(children[nearer], childrenT[nearer]));
+    }
+  }
+
+  if (cellId < 0)
+  {
+    return 0;
+  }
+  t = closestT;
+  this->DataSet->GetCell(cellId, cell);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVBVHCellLocator::GenerateRepresentation(int level, vtkPolyData* pd)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> lines;
+
+  std::vector<std::pair<vtkIdType, int> > stack;
+  if (!this->Nodes.empty())
+  {
+    stack.push_back(std::make_pair(0, 0));
+  }
+  while (!stack.empty())
+  {
+    const vtkIdType index = stack.back().first;
+    const int depth = stack.back().second;
+    stack.pop_back();
+
+    const vtkNode& node = this->Nodes[index];
+    const bool leaf = node.NumberOfCells > 0;
+    if (depth == level || (level < 0 && leaf))
+    {
+      vtkAddBox(node.Bounds, points.GetPointer(), lines.GetPointer());
+    }
+    else if (!leaf && (level < 0 || depth < level))
+    {
+      stack.push_back(std::make_pair(node.Offset, depth + 1));
+      stack.push_back(std::make_pair(index + 1, depth + 1));
+    }
+  }
+
+  pd->Initialize();
+  pd->SetPoints(points.GetPointer());
+  pd->SetLines(lines.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+void vtkPVBVHCellLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfNodes: " << this->Nodes.size() << endl;
+}
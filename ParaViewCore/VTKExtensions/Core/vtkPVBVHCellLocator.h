@@ -0,0 +1,98 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVBVHCellLocator.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVBVHCellLocator
+ * @brief   bounding volume hierarchy used to cast rays against the cells of a
+ * dataset.
+ *
+ * vtkPVBVHCellLocator sorts the cells of a dataset into a binary tree of
+ * axis aligned bounding boxes. Each node is split at the median of the cell
+ * centers along the longest axis of the node, until nodes have at most
+ * NumberOfCellsPerNode cells. The tree is stored flat, in depth first order,
+ * and is only used to answer IntersectWithLine() queries: nodes are visited
+ * front to back and skipped as soon as they are farther than the closest hit
+ * found so far, so that a ray cast only tests the cells near the ray.
+ *
+ * As with other locators, call Update() before querying to (re)build the tree
+ * when the dataset was modified since the last build.
+ */
+
+#ifndef vtkPVBVHCellLocator_h
+#define vtkPVBVHCellLocator_h
+
+#include "vtkAbstractCellLocator.h"
+#include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
+
+#include <vector> // needed for std::vector
+
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVBVHCellLocator : public vtkAbstractCellLocator
+{
+public:
+  static vtkPVBVHCellLocator* New();
+  vtkTypeMacro(vtkPVBVHCellLocator, vtkAbstractCellLocator);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Satisfy vtkLocator abstract interface. GenerateRepresentation() outputs
+   * the boxes of the nodes at the given depth, or of the leaves when level is
+   * negative.
+   */
+  void FreeSearchStructure() VTK_OVERRIDE;
+  void BuildLocator() VTK_OVERRIDE;
+  void GenerateRepresentation(int level, vtkPolyData* pd) VTK_OVERRIDE;
+  //@}
+
+  /**
+   * Returns the closest intersection of the segment a0-a1 with the cells of
+   * the dataset, if any. t is the parametric coordinate of the intersection
+   * along the segment.
+   */
+  int IntersectWithLine(double a0[3], double a1[3], double tol, double& t, double x[3],
+    double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell) VTK_OVERRIDE;
+
+  using vtkAbstractCellLocator::IntersectWithLine;
+
+  /**
+   * Returns the number of nodes of the tree built last.
+   */
+  vtkIdType GetNumberOfNodes() const { return static_cast<vtkIdType>(this->Nodes.size()); }
+
+protected:
+  vtkPVBVHCellLocator();
+  ~vtkPVBVHCellLocator() override;
+
+  struct vtkNode
+  {
+    double Bounds[6];
+    // first cell of a leaf in CellIds, or index of the right child of an
+    // inner node, whose left child immediately follows it.
+    vtkIdType Offset;
+    // number of cells of a leaf, 0 for inner nodes.
+    vtkIdType NumberOfCells;
+  };
+
+  vtkIdType BuildNode(vtkIdType begin, vtkIdType end, const std::vector<double>& cellBounds,
+    const std::vector<double>& centers);
+
+  std::vector<vtkNode> Nodes;
+  std::vector<vtkIdType> CellIds;
+
+private:
+  vtkPVBVHCellLocator(const vtkPVBVHCellLocator&) = delete;
+  void operator=(const vtkPVBVHCellLocator&) = delete;
+};
+
+#endif
@@ -0,0 +1,1464 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVExpressionEvaluator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVExpressionEvaluator.h"
+
+#include "vtkCommunicator.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkDoubleArray.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+namespace
+{
+// Number of elements evaluated at once. Each node of the program gets a buffer
+// of this size per thread.
+const vtkIdType vtkChunkSize = 1024;
+
+enum vtkValueType
+{
+  REAL_VALUE,
+  BOOLEAN_VALUE
+};
+
+enum vtkOpCode
+{
+  OP_CONSTANT,
+  OP_VARIABLE,
+  OP_MAGNITUDE,
+  OP_NEGATE,
+  OP_NOT,
+  OP_ADD,
+  OP_SUBTRACT,
+  OP_MULTIPLY,
+  OP_DIVIDE,
+  OP_POWER,
+  OP_LESS,
+  OP_LESS_EQUAL,
+  OP_GREATER,
+  OP_GREATER_EQUAL,
+  OP_EQUAL,
+  OP_NOT_EQUAL,
+  OP_AND,
+  OP_OR,
+  OP_MIN,
+  OP_MAX,
+  OP_ABS,
+  OP_SQRT,
+  OP_EXP,
+  OP_LOG,
+  OP_LOG10,
+  OP_FLOOR,
+  OP_CEIL,
+  OP_SIGN,
+  OP_SIN,
+  OP_COS,
+  OP_TAN,
+  OP_ASIN,
+  OP_ACOS,
+  OP_ATAN,
+  OP_SINH,
+  OP_COSH,
+  OP_TANH,
+  OP_IN_RANGE,
+  OP_IS_IN,
+  OP_REDUCE_MIN,
+  OP_REDUCE_MAX,
+  OP_REDUCE_MEAN,
+  OP_REDUCE_SUM
+};
+
+bool vtkIsReduction(int op)
+{
+  return op == OP_REDUCE_MIN || op == OP_REDUCE_MAX || op == OP_REDUCE_MEAN ||
+    op == OP_REDUCE_SUM;
+}
+
+// A node of the compiled program. Nodes are stored in post-order, so the
+// arguments of a node always precede it and the nodes a node depends on are
+// all found in [First, index].
+struct vtkNode
+{
+  vtkNode()
+    : Op(OP_CONSTANT)
+    , Type(REAL_VALUE)
+    , First(0)
+    , Value(0.0)
+    , Variable(-1)
+    , Component(-1)
+  {
+    this->Args[0] = this->Args[1] = this->Args[2] = -1;
+  }
+
+  int Op;
+  int Type;
+  int First;
+  int Args[3];
+  double Value;
+  int Variable;
+  // component selected with name[:,k], -1 otherwise.
+  int Component;
+  // sorted values for OP_IS_IN.
+  std::vector<double> Set;
+};
+
+// The array a variable resolves to in a given scope. A NULL array stands for
+// the element index (`id`).
+struct vtkBinding
+{
+  vtkBinding()
+    : Array(NULL)
+    , Component(-1)
+  {
+  }
+
+  vtkDataArray* Array;
+  int Component;
+};
+
+struct vtkUnaryFunction
+{
+  const char* Name;
+  int Op;
+};
+
+const vtkUnaryFunction vtkUnaryFunctions[] = { { "abs", OP_ABS }, { "sqrt", OP_SQRT },
+  { "exp", OP_EXP }, { "ln", OP_LOG }, { "log", OP_LOG }, { "log10", OP_LOG10 },
+  { "floor", OP_FLOOR }, { "ceil", OP_CEIL }, { "sign", OP_SIGN }, { "sin", OP_SIN },
+  { "cos", OP_COS }, { "tan", OP_TAN }, { "asin", OP_ASIN }, { "arcsin", OP_ASIN },
+  { "acos", OP_ACOS }, { "arccos", OP_ACOS }, { "atan", OP_ATAN }, { "arctan", OP_ATAN },
+  { "sinh", OP_SINH }, { "cosh", OP_COSH }, { "tanh", OP_TANH }, { NULL, 0 } };
+
+//----------------------------------------------------------------------------
+// Recursive descent parser producing the post-order program.
+class vtkExpressionParser
+{
+public:
+  vtkExpressionParser(const std::string& text, int syntax, std::vector<vtkNode>& nodes,
+    std::vector<std::string>& names)
+    : Text(text)
+    , Syntax(syntax)
+    , Position(0)
+    , TokenType(TOKEN_END)
+    , TokenValue(0.0)
+    , PowerParsed(false)
+    , Nodes(nodes)
+    , Names(names)
+  {
+  }
+
+  bool Parse()
+  {
+    this->Next();
+    int root = this->ParseComparison();
+    if (root >= 0 && this->TokenType != TOKEN_END)
+    {
+      this->Fail("unexpected '" + this->Token + "'");
+    }
+    return this->Error.empty();
+  }
+
+  const std::string& GetError() const { return this->Error; }
+
+private:
+  enum
+  {
+    TOKEN_END,
+    TOKEN_NUMBER,
+    TOKEN_NAME,
+    TOKEN_QUOTED_NAME,
+    TOKEN_OPERATOR,
+    TOKEN_ERROR
+  };
+
+  bool IsPython() const { return this->Syntax == vtkPVExpressionEvaluator::PYTHON_SYNTAX; }
+
+  int Fail(const std::string& message)
+  {
+    if (this->Error.empty())
+    {
+      this->Error = message;
+    }
+    return -1;
+  }
+
+  bool IsOperator(const char* op) const
+  {
+    return this->TokenType == TOKEN_OPERATOR && this->Token == op;
+  }
+
+  bool Expect(const char* op)
+  {
+    if (!this->IsOperator(op))
+    {
+      this->Fail(std::string("expected '") + op + "'");
+      return false;
+    }
+    this->Next();
+    return true;
+  }
+
+  void Next()
+  {
+    const std::string& text = this->Text;
+    size_t& pos = this->Position;
+    while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos])))
+    {
+      ++pos;
+    }
+    this->Token.clear();
+    if (pos >= text.size())
+    {
+      this->TokenType = TOKEN_END;
+      return;
+    }
+
+    const char c = text[pos];
+    const bool digitFollows =
+      pos + 1 < text.size() && isdigit(static_cast<unsigned char>(text[pos + 1]));
+    if (isdigit(static_cast<unsigned char>(c)) || (c == '.' && digitFollows))
+    {
+      size_t end = pos;
+      while (end < text.size() &&
+        (isdigit(static_cast<unsigned char>(text[end])) || text[end] == '.'))
+      {
+        ++end;
+      }
+      if (end < text.size() && (text[end] == 'e' || text[end] == 'E'))
+      {
+        size_t exponent = end + 1;
+        if (exponent < text.size() && (text[exponent] == '+' || text[exponent] == '-'))
+        {
+          ++exponent;
+        }
+        if (exponent < text.size() && isdigit(static_cast<unsigned char>(text[exponent])))
+        {
+          end = exponent;
+          while (end < text.size() && isdigit(static_cast<unsigned char>(text[end])))
+          {
+            ++end;
+          }
+        }
+      }
+      this->Token = text.substr(pos, end - pos);
+      pos = end;
+
+      std::istringstream stream(this->Token);
+      stream.imbue(std::locale::classic());
+      stream >> this->TokenValue;
+      this->TokenType = (stream.fail() || !stream.eof()) ? TOKEN_ERROR : TOKEN_NUMBER;
+      if (this->TokenType == TOKEN_ERROR)
+      {
+        this->Fail("invalid number '" + this->Token + "'");
+      }
+      return;
+    }
+
+    if (isalpha(static_cast<unsigned char>(c)) || c == '_')
+    {
+      size_t end = pos;
+      while (end < text.size() &&
+        (isalnum(static_cast<unsigned char>(text[end])) || text[end] == '_'))
+      {
+        ++end;
+      }
+      this->Token = text.substr(pos, end - pos);
+      this->TokenType = TOKEN_NAME;
+      pos = end;
+      return;
+    }
+
+    if (c == '"')
+    {
+      size_t end = text.find('"', pos + 1);
+      if (end == std::string::npos)
+      {
+        this->TokenType = TOKEN_ERROR;
+        this->Fail("unterminated quoted name");
+        return;
+      }
+      // keep the quotes, they are part of the variable names registered by
+      // vtkPVArrayCalculator.
+      this->Token = text.substr(pos, end + 1 - pos);
+      this->TokenType = TOKEN_QUOTED_NAME;
+      pos = end + 1;
+      return;
+    }
+
+    static const char* const twoCharOperators[] = { "**", "<=", ">=", "==", "!=", NULL };
+    for (int cc = 0; twoCharOperators[cc] != NULL; ++cc)
+    {
+      if (text.compare(pos, 2, twoCharOperators[cc]) == 0)
+      {
+        this->Token = twoCharOperators[cc];
+        this->TokenType = TOKEN_OPERATOR;
+        pos += 2;
+        return;
+      }
+    }
+    if (strchr("+-*/^<>&|~()[],:", c) != NULL)
+    {
+      this->Token = std::string(1, c);
+      this->TokenType = TOKEN_OPERATOR;
+      ++pos;
+      return;
+    }
+
+    this->Token = std::string(1, c);
+    this->TokenType = TOKEN_ERROR;
+    this->Fail("unexpected character '" + this->Token + "'");
+  }
+
+  int Add(vtkNode& node)
+  {
+    const int index = static_cast<int>(this->Nodes.size());
+    node.First = index;
+    for (int cc = 0; cc < 3; ++cc)
+    {
+      if (node.Args[cc] >= 0)
+      {
+        node.First = std::min(node.First, this->Nodes[node.Args[cc]].First);
+      }
+    }
+    this->Nodes.push_back(node);
+    return index;
+  }
+
+  int AddOperation(int op, int type, int arg0, int arg1 = -1, int arg2 = -1)
+  {
+    vtkNode node;
+    node.Op = op;
+    node.Type = type;
+    node.Args[0] = arg0;
+    node.Args[1] = arg1;
+    node.Args[2] = arg2;
+    return this->Add(node);
+  }
+
+  int AddVariable(int op, const std::string& name)
+  {
+    vtkNode node;
+    node.Op = op;
+    std::vector<std::string>::iterator iter =
+      std::find(this->Names.begin(), this->Names.end(), name);
+    node.Variable = static_cast<int>(iter - this->Names.begin());
+    if (iter == this->Names.end())
+    {
+      this->Names.push_back(name);
+    }
+    return this->Add(node);
+  }
+
+  int ComparisonOp() const
+  {
+    if (this->TokenType != TOKEN_OPERATOR)
+    {
+      return -1;
+    }
+    const std::string& t = this->Token;
+    return t == "<" ? OP_LESS : t == "<=" ? OP_LESS_EQUAL : t == ">" ? OP_GREATER : t == ">="
+          ? OP_GREATER_EQUAL
+          : t == "==" ? OP_EQUAL : t == "!=" ? OP_NOT_EQUAL : -1;
+  }
+
+  // comparison := or (cmp or)*, chains combine as in Python.
+  int ParseComparison()
+  {
+    int left = this->ParseOr();
+    int result = -1;
+    while (left >= 0 && this->ComparisonOp() >= 0)
+    {
+      if (!this->IsPython())
+      {
+        return this->Fail("comparisons are not supported");
+      }
+      const int op = this->ComparisonOp();
+      this->Next();
+      int right = this->ParseOr();
+      if (right < 0)
+      {
+        return -1;
+      }
+      int comparison = this->AddOperation(op, BOOLEAN_VALUE, left, right);
+      result =
+        result < 0 ? comparison : this->AddOperation(OP_AND, BOOLEAN_VALUE, result, comparison);
+      left = right;
+    }
+    return result < 0 ? left : result;
+  }
+
+  int ParseLogical(const char* symbol, int op, int (vtkExpressionParser::*operand)())
+  {
+    int left = (this->*operand)();
+    while (left >= 0 && this->IsOperator(symbol))
+    {
+      if (!this->IsPython())
+      {
+        return this->Fail(std::string("'") + symbol + "' is not supported");
+      }
+      this->Next();
+      int right = (this->*operand)();
+      if (right < 0)
+      {
+        return -1;
+      }
+      if (this->Nodes[left].Type != BOOLEAN_VALUE || this->Nodes[right].Type != BOOLEAN_VALUE)
+      {
+        return this->Fail(std::string("'") + symbol +
+          "' requires boolean operands, put comparisons in parentheses");
+      }
+      left = this->AddOperation(op, BOOLEAN_VALUE, left, right);
+    }
+    return left;
+  }
+
+  int ParseOr() { return this->ParseLogical("|", OP_OR, &vtkExpressionParser::ParseAnd); }
+  int ParseAnd() { return this->ParseLogical("&", OP_AND, &vtkExpressionParser::ParseAdditive); }
+
+  int ParseAdditive()
+  {
+    int left = this->ParseTerm();
+    while (left >= 0 && (this->IsOperator("+") || this->IsOperator("-")))
+    {
+      const int op = this->IsOperator("+") ? OP_ADD : OP_SUBTRACT;
+      this->Next();
+      int right = this->ParseTerm();
+      left = right < 0 ? -1 : this->AddOperation(op, REAL_VALUE, left, right);
+    }
+    return left;
+  }
+
+  int ParseTerm()
+  {
+    int left = this->ParseUnary();
+    while (left >= 0 && (this->IsOperator("*") || this->IsOperator("/")))
+    {
+      const int op = this->IsOperator("*") ? OP_MULTIPLY : OP_DIVIDE;
+      this->Next();
+      int right = this->ParseUnary();
+      left = right < 0 ? -1 : this->AddOperation(op, REAL_VALUE, left, right);
+    }
+    return left;
+  }
+
+  int ParseUnary()
+  {
+    if (this->IsOperator("-") || this->IsOperator("+") || this->IsOperator("~"))
+    {
+      const char sign = this->Token[0];
+      if (sign == '~' && !this->IsPython())
+      {
+        return this->Fail("'~' is not supported");
+      }
+      this->Next();
+      int operand = this->ParseUnary();
+      if (operand < 0)
+      {
+        return -1;
+      }
+      if (sign == '-' && !this->IsPython() && this->PowerParsed)
+      {
+        // vtkFunctionParser and Python disagree on -a^b, leave it to the former.
+        return this->Fail("unary minus applied to '^', use parentheses");
+      }
+      if (sign == '+')
+      {
+        return operand;
+      }
+      if (sign == '~')
+      {
+        if (this->Nodes[operand].Type != BOOLEAN_VALUE)
+        {
+          return this->Fail("'~' requires a boolean operand");
+        }
+        return this->AddOperation(OP_NOT, BOOLEAN_VALUE, operand);
+      }
+      return this->AddOperation(OP_NEGATE, REAL_VALUE, operand);
+    }
+    return this->ParsePower();
+  }
+
+  int ParsePower()
+  {
+    int base = this->ParsePostfix();
+    const char* symbol = this->IsPython() ? "**" : "^";
+    if (base < 0 || !this->IsOperator(symbol))
+    {
+      this->PowerParsed = false;
+      return base;
+    }
+    this->Next();
+    int exponent;
+    if (this->IsPython())
+    {
+      // right associative, the exponent may carry a sign: a**-b**c.
+      exponent = this->ParseUnary();
+    }
+    else
+    {
+      exponent = this->ParsePostfix();
+      if (exponent >= 0 && this->IsOperator("^"))
+      {
+        return this->Fail("chained '^', use parentheses");
+      }
+    }
+    if (exponent < 0)
+    {
+      return -1;
+    }
+    this->PowerParsed = true;
+    return this->AddOperation(OP_POWER, REAL_VALUE, base, exponent);
+  }
+
+  // postfix := primary ('[' ':' ',' integer ']')?
+  int ParsePostfix()
+  {
+    int primary = this->ParsePrimary();
+    if (primary < 0 || !this->IsOperator("["))
+    {
+      return primary;
+    }
+    vtkNode& node = this->Nodes[primary];
+    if (!this->IsPython() || node.Op != OP_VARIABLE || node.Component >= 0)
+    {
+      return this->Fail("subscripts are only supported on variables, as name[:,k]");
+    }
+    this->Next();
+    if (!this->Expect(":") || !this->Expect(","))
+    {
+      return -1;
+    }
+    if (this->TokenType != TOKEN_NUMBER || this->TokenValue < 0 ||
+      this->TokenValue != std::floor(this->TokenValue))
+    {
+      return this->Fail("expected a component index");
+    }
+    this->Nodes[primary].Component = static_cast<int>(this->TokenValue);
+    this->Next();
+    return this->Expect("]") ? primary : -1;
+  }
+
+  int ParsePrimary()
+  {
+    if (this->TokenType == TOKEN_NUMBER)
+    {
+      vtkNode node;
+      node.Value = this->TokenValue;
+      this->Next();
+      return this->Add(node);
+    }
+    if (this->IsOperator("("))
+    {
+      this->Next();
+      int expression = this->ParseComparison();
+      return (expression >= 0 && this->Expect(")")) ? expression : -1;
+    }
+    if (this->TokenType == TOKEN_NAME || this->TokenType == TOKEN_QUOTED_NAME)
+    {
+      const std::string name = this->Token;
+      const bool quoted = this->TokenType == TOKEN_QUOTED_NAME;
+      this->Next();
+      if (!quoted && this->IsOperator("("))
+      {
+        this->Next();
+        return this->ParseCall(name);
+      }
+      return this->AddVariable(OP_VARIABLE, name);
+    }
+    if (this->TokenType == TOKEN_END)
+    {
+      return this->Fail("unexpected end of expression");
+    }
+    return this->Fail("unexpected '" + this->Token + "'");
+  }
+
+  // Parses the arguments of name(...), the opening parenthesis has been
+  // consumed.
+  int ParseCall(const std::string& name)
+  {
+    if (name == "mag")
+    {
+      if (this->TokenType != TOKEN_NAME && this->TokenType != TOKEN_QUOTED_NAME)
+      {
+        return this->Fail("mag() expects a variable name");
+      }
+      const std::string variable = this->Token;
+      this->Next();
+      return this->Expect(")") ? this->AddVariable(OP_MAGNITUDE, variable) : -1;
+    }
+
+    if (name == "isin" || name == "is_in")
+    {
+      if (!this->IsPython())
+      {
+        return this->Fail(name + "() is not supported");
+      }
+      vtkNode node;
+      node.Op = OP_IS_IN;
+      node.Type = BOOLEAN_VALUE;
+      node.Args[0] = this->ParseComparison();
+      if (node.Args[0] < 0 || !this->Expect(",") || !this->Expect("["))
+      {
+        return -1;
+      }
+      while (!this->IsOperator("]"))
+      {
+        double sign = 1.0;
+        if (this->IsOperator("-"))
+        {
+          sign = -1.0;
+          this->Next();
+        }
+        if (this->TokenType != TOKEN_NUMBER)
+        {
+          return this->Fail(name + "() expects a list of numbers");
+        }
+        node.Set.push_back(sign * this->TokenValue);
+        this->Next();
+        if (!this->IsOperator("]") && !this->Expect(","))
+        {
+          return -1;
+        }
+      }
+      this->Next();
+      if (!this->Expect(")"))
+      {
+        return -1;
+      }
+      std::sort(node.Set.begin(), node.Set.end());
+      return this->Add(node);
+    }
+
+    std::vector<int> args;
+    while (!this->IsOperator(")"))
+    {
+      int arg = this->ParseComparison();
+      if (arg < 0)
+      {
+        return -1;
+      }
+      args.push_back(arg);
+      if (!this->IsOperator(")") && !this->Expect(","))
+      {
+        return -1;
+      }
+    }
+    this->Next();
+
+    for (int cc = 0; vtkUnaryFunctions[cc].Name != NULL; ++cc)
+    {
+      if (name == vtkUnaryFunctions[cc].Name && args.size() == 1)
+      {
+        return this->AddOperation(vtkUnaryFunctions[cc].Op, REAL_VALUE, args[0]);
+      }
+    }
+    if ((name == "min" || name == "max") && args.size() == 2)
+    {
+      return this->AddOperation(name == "min" ? OP_MIN : OP_MAX, REAL_VALUE, args[0], args[1]);
+    }
+    if (this->IsPython())
+    {
+      if ((name == "min" || name == "max" || name == "mean" || name == "sum") && args.size() == 1)
+      {
+        const int op = name == "min" ? OP_REDUCE_MIN : name == "max"
+            ? OP_REDUCE_MAX
+            : name == "mean" ? OP_REDUCE_MEAN : OP_REDUCE_SUM;
+        return this->AddOperation(op, REAL_VALUE, args[0]);
+      }
+      if (name == "in_range" && args.size() == 3)
+      {
+        return this->AddOperation(OP_IN_RANGE, BOOLEAN_VALUE, args[0], args[1], args[2]);
+      }
+    }
+    return this->Fail("unsupported function '" + name + "' or wrong number of arguments");
+  }
+
+  const std::string& Text;
+  int Syntax;
+  size_t Position;
+  int TokenType;
+  std::string Token;
+  double TokenValue;
+  bool PowerParsed;
+  std::string Error;
+  std::vector<vtkNode>& Nodes;
+  std::vector<std::string>& Names;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkLoadComponent(
+  const T* data, int numComps, int comp, vtkIdType begin, vtkIdType count, double* out)
+{
+  const T* ptr = data + begin * numComps + comp;
+  for (vtkIdType cc = 0; cc < count; ++cc, ptr += numComps)
+  {
+    out[cc] = static_cast<double>(*ptr);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkLoadMagnitude(const T* data, int numComps, vtkIdType begin, vtkIdType count, double* out)
+{
+  const T* ptr = data + begin * numComps;
+  for (vtkIdType cc = 0; cc < count; ++cc, ptr += numComps)
+  {
+    double sum = 0.0;
+    for (int comp = 0; comp < numComps; ++comp)
+    {
+      const double value = static_cast<double>(ptr[comp]);
+      sum += value * value;
+    }
+    out[cc] = std::sqrt(sum);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkLoadVariable(
+  const vtkBinding& binding, int component, vtkIdType begin, vtkIdType count, double* out)
+{
+  vtkDataArray* array = binding.Array;
+  if (array == NULL)
+  {
+    for (vtkIdType cc = 0; cc < count; ++cc)
+    {
+      out[cc] = static_cast<double>(begin + cc);
+    }
+    return;
+  }
+
+  const int comp = component >= 0 ? component : std::max(binding.Component, 0);
+  if (array->HasStandardMemoryLayout() && array->GetDataType() != VTK_BIT)
+  {
+    switch (array->GetDataType())
+    {
+      vtkTemplateMacro(vtkLoadComponent(static_cast<VTK_TT*>(array->GetVoidPointer(0)),
+        array->GetNumberOfComponents(), comp, begin, count, out));
+    }
+    return;
+  }
+  for (vtkIdType cc = 0; cc < count; ++cc)
+  {
+    out[cc] = array->GetComponent(begin + cc, comp);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkLoadMagnitude(const vtkBinding& binding, vtkIdType begin, vtkIdType count, double* out)
+{
+  vtkDataArray* array = binding.Array;
+  if (binding.Component >= 0)
+  {
+    vtkLoadVariable(binding, binding.Component, begin, count, out);
+    for (vtkIdType cc = 0; cc < count; ++cc)
+    {
+      out[cc] = std::fabs(out[cc]);
+    }
+    return;
+  }
+
+  if (array->HasStandardMemoryLayout() && array->GetDataType() != VTK_BIT)
+  {
+    switch (array->GetDataType())
+    {
+      vtkTemplateMacro(vtkLoadMagnitude(static_cast<VTK_TT*>(array->GetVoidPointer(0)),
+        array->GetNumberOfComponents(), begin, count, out));
+    }
+    return;
+  }
+  const int numComps = array->GetNumberOfComponents();
+  for (vtkIdType cc = 0; cc < count; ++cc)
+  {
+    double sum = 0.0;
+    for (int comp = 0; comp < numComps; ++comp)
+    {
+      const double value = array->GetComponent(begin + cc, comp);
+      sum += value * value;
+    }
+    out[cc] = std::sqrt(sum);
+  }
+}
+
+//----------------------------------------------------------------------------
+struct vtkAccumulator
+{
+  vtkAccumulator()
+    : Min(std::numeric_limits<double>::infinity())
+    , Max(-std::numeric_limits<double>::infinity())
+    , Sum(0.0)
+    , Count(0.0)
+  {
+  }
+
+  void Combine(const vtkAccumulator& other)
+  {
+    this->Min = std::min(this->Min, other.Min);
+    this->Max = std::max(this->Max, other.Max);
+    this->Sum += other.Sum;
+    this->Count += other.Count;
+  }
+
+  double Min;
+  double Max;
+  double Sum;
+  double Count;
+};
+
+//----------------------------------------------------------------------------
+// Evaluates the sub-program rooted at Root for a range of elements, chunk by
+// chunk. The values of the root are either written to Output or accumulated
+// for a reduction.
+class vtkChunkEvaluator
+{
+public:
+  vtkChunkEvaluator(const std::vector<vtkNode>& nodes, const std::vector<double>& reductions,
+    const std::vector<vtkBinding>& bindings, int root, bool replace, double replacement,
+    double* output)
+    : Nodes(nodes)
+    , Reductions(reductions)
+    , Bindings(bindings)
+    , Root(root)
+    , Replace(replace)
+    , Replacement(replacement)
+    , Output(output)
+  {
+    // only evaluate what the root depends on, reductions are already known.
+    this->Needed.assign(nodes.size(), 0);
+    this->Needed[root] = 1;
+    for (int cc = root; cc >= nodes[root].First; --cc)
+    {
+      if (this->Needed[cc] && !vtkIsReduction(nodes[cc].Op))
+      {
+        for (int arg = 0; arg < 3; ++arg)
+        {
+          if (nodes[cc].Args[arg] >= 0)
+          {
+            this->Needed[nodes[cc].Args[arg]] = 1;
+          }
+        }
+      }
+    }
+  }
+
+  void Initialize() {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<double>& buffers = this->Buffers.Local();
+    buffers.resize(this->Nodes.size() * vtkChunkSize);
+    vtkAccumulator& accumulator = this->Accumulators.Local();
+    for (vtkIdType chunk = begin; chunk < end; chunk += vtkChunkSize)
+    {
+      const vtkIdType count = std::min(vtkChunkSize, end - chunk);
+      this->EvaluateChunk(chunk, count, &buffers[0]);
+      const double* values = &buffers[this->Root * vtkChunkSize];
+      if (this->Output)
+      {
+        std::copy(values, values + count, this->Output + chunk);
+        continue;
+      }
+      for (vtkIdType cc = 0; cc < count; ++cc)
+      {
+        accumulator.Min = std::min(accumulator.Min, values[cc]);
+        accumulator.Max = std::max(accumulator.Max, values[cc]);
+        accumulator.Sum += values[cc];
+      }
+      accumulator.Count += count;
+    }
+  }
+
+  void Reduce() {}
+
+  vtkAccumulator GetAccumulator()
+  {
+    vtkAccumulator result;
+    for (vtkSMPThreadLocal<vtkAccumulator>::iterator iter = this->Accumulators.begin();
+         iter != this->Accumulators.end(); ++iter)
+    {
+      result.Combine(*iter);
+    }
+    return result;
+  }
+
+private:
+  double Invalid(double value, bool invalid) const
+  {
+    return (invalid && this->Replace) ? this->Replacement : value;
+  }
+
+  void EvaluateChunk(vtkIdType begin, vtkIdType count, double* buffers)
+  {
+    for (int index = this->Nodes[this->Root].First; index <= this->Root; ++index)
+    {
+      if (!this->Needed[index])
+      {
+        continue;
+      }
+      const vtkNode& node = this->Nodes[index];
+      double* out = buffers + index * vtkChunkSize;
+      const double* a = node.Args[0] >= 0 ? buffers + node.Args[0] * vtkChunkSize : NULL;
+      const double* b = node.Args[1] >= 0 ? buffers + node.Args[1] * vtkChunkSize : NULL;
+      const double* c = node.Args[2] >= 0 ? buffers + node.Args[2] * vtkChunkSize : NULL;
+      vtkIdType cc;
+      switch (node.Op)
+      {
+        case OP_CONSTANT:
+          std::fill(out, out + count, node.Value);
+          break;
+        case OP_VARIABLE:
+          vtkLoadVariable(this->Bindings[node.Variable], node.Component, begin, count, out);
+          break;
+        case OP_MAGNITUDE:
+          vtkLoadMagnitude(this->Bindings[node.Variable], begin, count, out);
+          break;
+        case OP_REDUCE_MIN:
+        case OP_REDUCE_MAX:
+        case OP_REDUCE_MEAN:
+        case OP_REDUCE_SUM:
+          std::fill(out, out + count, this->Reductions[index]);
+          break;
+        case OP_NEGATE:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = -a[cc];
+          }
+          break;
+        case OP_NOT:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] == 0.0 ? 1.0 : 0.0;
+          }
+          break;
+        case OP_ADD:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] + b[cc];
+          }
+          break;
+        case OP_SUBTRACT:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] - b[cc];
+          }
+          break;
+        case OP_MULTIPLY:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] * b[cc];
+          }
+          break;
+        case OP_DIVIDE:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = this->Invalid(a[cc] / b[cc], b[cc] == 0.0);
+          }
+          break;
+        case OP_POWER:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::pow(a[cc], b[cc]);
+          }
+          break;
+        case OP_LESS:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] < b[cc] ? 1.0 : 0.0;
+          }
+          break;
+        case OP_LESS_EQUAL:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] <= b[cc] ? 1.0 : 0.0;
+          }
+          break;
+        case OP_GREATER:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] > b[cc] ? 1.0 : 0.0;
+          }
+          break;
+        case OP_GREATER_EQUAL:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] >= b[cc] ? 1.0 : 0.0;
+          }
+          break;
+        case OP_EQUAL:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] == b[cc] ? 1.0 : 0.0;
+          }
+          break;
+        case OP_NOT_EQUAL:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] != b[cc] ? 1.0 : 0.0;
+          }
+          break;
+        case OP_AND:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = (a[cc] != 0.0 && b[cc] != 0.0) ? 1.0 : 0.0;
+          }
+          break;
+        case OP_OR:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = (a[cc] != 0.0 || b[cc] != 0.0) ? 1.0 : 0.0;
+          }
+          break;
+        case OP_MIN:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::min(a[cc], b[cc]);
+          }
+          break;
+        case OP_MAX:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::max(a[cc], b[cc]);
+          }
+          break;
+        case OP_ABS:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::fabs(a[cc]);
+          }
+          break;
+        case OP_SQRT:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = this->Invalid(std::sqrt(a[cc]), a[cc] < 0.0);
+          }
+          break;
+        case OP_EXP:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::exp(a[cc]);
+          }
+          break;
+        case OP_LOG:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = this->Invalid(std::log(a[cc]), a[cc] <= 0.0);
+          }
+          break;
+        case OP_LOG10:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = this->Invalid(std::log10(a[cc]), a[cc] <= 0.0);
+          }
+          break;
+        case OP_FLOOR:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::floor(a[cc]);
+          }
+          break;
+        case OP_CEIL:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::ceil(a[cc]);
+          }
+          break;
+        case OP_SIGN:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = a[cc] > 0.0 ? 1.0 : (a[cc] < 0.0 ? -1.0 : 0.0);
+          }
+          break;
+        case OP_SIN:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::sin(a[cc]);
+          }
+          break;
+        case OP_COS:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::cos(a[cc]);
+          }
+          break;
+        case OP_TAN:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::tan(a[cc]);
+          }
+          break;
+        case OP_ASIN:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = this->Invalid(std::asin(a[cc]), a[cc] < -1.0 || a[cc] > 1.0);
+          }
+          break;
+        case OP_ACOS:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = this->Invalid(std::acos(a[cc]), a[cc] < -1.0 || a[cc] > 1.0);
+          }
+          break;
+        case OP_ATAN:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::atan(a[cc]);
+          }
+          break;
+        case OP_SINH:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::sinh(a[cc]);
+          }
+          break;
+        case OP_COSH:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::cosh(a[cc]);
+          }
+          break;
+        case OP_TANH:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::tanh(a[cc]);
+          }
+          break;
+        case OP_IN_RANGE:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = (a[cc] >= b[cc] && a[cc] <= c[cc]) ? 1.0 : 0.0;
+          }
+          break;
+        case OP_IS_IN:
+          for (cc = 0; cc < count; ++cc)
+          {
+            out[cc] = std::binary_search(node.Set.begin(), node.Set.end(), a[cc]) ? 1.0 : 0.0;
+          }
+          break;
+      }
+    }
+  }
+
+  const std::vector<vtkNode>& Nodes;
+  const std::vector<double>& Reductions;
+  const std::vector<vtkBinding>& Bindings;
+  const int Root;
+  const bool Replace;
+  const double Replacement;
+  double* Output;
+  std::vector<char> Needed;
+  vtkSMPThreadLocal<std::vector<double> > Buffers;
+  vtkSMPThreadLocal<vtkAccumulator> Accumulators;
+};
+}
+
+//----------------------------------------------------------------------------
+class vtkPVExpressionEvaluator::vtkInternals
+{
+public:
+  vtkInternals()
+    : Compiled(false)
+    , CompiledSyntax(-1)
+  {
+  }
+
+  // Resolves variable `index` in scope, checking that every use of it in the
+  // program is compatible with the bound array.
+  bool Bind(const Scope& scope, int index, vtkBinding& binding)
+  {
+    const std::string& name = this->VariableNames[index];
+    std::map<std::string, std::pair<vtkDataArray*, int> >::const_iterator iter =
+      scope.Variables.find(name);
+    if (iter == scope.Variables.end() && name.size() > 2 && name[0] == '"')
+    {
+      iter = scope.Variables.find(name.substr(1, name.size() - 2));
+    }
+    if (iter != scope.Variables.end() && iter->second.first != NULL)
+    {
+      binding.Array = iter->second.first;
+      binding.Component = iter->second.second;
+    }
+    else if (name != "id")
+    {
+      this->Error = "unknown variable '" + name + "'";
+      return false;
+    }
+
+    for (size_t cc = 0; cc < this->Nodes.size(); ++cc)
+    {
+      const vtkNode& node = this->Nodes[cc];
+      if (node.Variable != index)
+      {
+        continue;
+      }
+      if (binding.Array == NULL)
+      {
+        if (node.Op == OP_MAGNITUDE || node.Component >= 0)
+        {
+          this->Error = "'id' has a single component";
+          return false;
+        }
+        continue;
+      }
+      const int numComps = binding.Array->GetNumberOfComponents();
+      if (node.Op == OP_VARIABLE && node.Component < 0 && binding.Component < 0 && numComps != 1)
+      {
+        this->Error = "'" + name + "' has multiple components, use mag() or a subscript";
+        return false;
+      }
+      if (node.Op == OP_VARIABLE && node.Component >= 0 &&
+        (binding.Component >= 0 || node.Component >= numComps))
+      {
+        this->Error = "invalid component for '" + name + "'";
+        return false;
+      }
+      if (binding.Component >= numComps)
+      {
+        this->Error = "invalid component for '" + name + "'";
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<vtkNode> Nodes;
+  std::vector<std::string> VariableNames;
+  std::vector<double> Reductions;
+  bool Compiled;
+  std::string CompiledExpression;
+  int CompiledSyntax;
+  std::string CompileError;
+  std::string Error;
+};
+
+//----------------------------------------------------------------------------
+void vtkPVExpressionEvaluator::Scope::AddVariable(
+  const std::string& name, vtkDataArray* array, int component)
+{
+  this->Variables[name] = std::make_pair(array, component);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVExpressionEvaluator::Scope::AddArrays(vtkDataSetAttributes* attributes)
+{
+  const int numArrays = attributes ? attributes->GetNumberOfArrays() : 0;
+  for (int cc = 0; cc < numArrays; ++cc)
+  {
+    vtkDataArray* array = attributes->GetArray(cc);
+    if (array && array->GetName())
+    {
+      this->AddVariable(array->GetName(), array);
+    }
+  }
+}
+
+vtkStandardNewMacro(vtkPVExpressionEvaluator);
+vtkCxxSetObjectMacro(vtkPVExpressionEvaluator, Controller, vtkMultiProcessController);
+//----------------------------------------------------------------------------
+vtkPVExpressionEvaluator::vtkPVExpressionEvaluator()
+  : Expression(NULL)
+  , Syntax(PYTHON_SYNTAX)
+  , ReplaceInvalidValues(false)
+  , ReplacementValue(0.0)
+  , Controller(NULL)
+  , Internals(new vtkInternals())
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVExpressionEvaluator::~vtkPVExpressionEvaluator()
+{
+  this->SetExpression(NULL);
+  this->SetController(NULL);
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVExpressionEvaluator::Compile()
+{
+  vtkInternals& internals = *this->Internals;
+  const std::string expression = this->Expression ? this->Expression : "";
+  if (!internals.Compiled || internals.CompiledExpression != expression ||
+    internals.CompiledSyntax != this->Syntax)
+  {
+    internals.Nodes.clear();
+    internals.VariableNames.clear();
+    internals.CompileError.clear();
+    internals.Compiled = true;
+    internals.CompiledExpression = expression;
+    internals.CompiledSyntax = this->Syntax;
+
+    vtkExpressionParser parser(expression, this->Syntax, internals.Nodes, internals.VariableNames);
+    if (!parser.Parse())
+    {
+      internals.CompileError = parser.GetError();
+      internals.Nodes.clear();
+      internals.VariableNames.clear();
+    }
+  }
+  internals.Error = internals.CompileError;
+  return internals.CompileError.empty();
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVExpressionEvaluator::GetErrorMessage() const
+{
+  return this->Internals->Error.c_str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVExpressionEvaluator::Evaluate(
+  const std::vector<Scope>& scopes, std::vector<vtkSmartPointer<vtkDoubleArray> >& results)
+{
+  results.clear();
+  if (!this->Compile())
+  {
+    return false;
+  }
+
+  vtkInternals& internals = *this->Internals;
+  const int numVariables = static_cast<int>(internals.VariableNames.size());
+  const bool parallel = this->Controller && this->Controller->GetNumberOfProcesses() > 1;
+
+  // Resolve the variables of all non-empty scopes. All processes must agree
+  // on the outcome since the reductions below are collective.
+  std::vector<std::vector<vtkBinding> > bindings(scopes.size());
+  int valid = 1;
+  for (size_t scope = 0; scope < scopes.size() && valid; ++scope)
+  {
+    bindings[scope].resize(numVariables);
+    if (scopes[scope].NumberOfElements == 0)
+    {
+      continue;
+    }
+    for (int var = 0; var < numVariables && valid; ++var)
+    {
+      valid = internals.Bind(scopes[scope], var, bindings[scope][var]) ? 1 : 0;
+    }
+  }
+  if (parallel)
+  {
+    int globalValid = 0;
+    this->Controller->AllReduce(&valid, &globalValid, 1, vtkCommunicator::MIN_OP);
+    if (valid && !globalValid)
+    {
+      internals.Error = "expression could not be evaluated on another process";
+    }
+    valid = globalValid;
+  }
+  if (!valid)
+  {
+    return false;
+  }
+
+  // Reductions are computed first, inner ones before outer ones since they
+  // come first in post-order.
+  const int numNodes = static_cast<int>(internals.Nodes.size());
+  internals.Reductions.assign(numNodes, 0.0);
+  for (int index = 0; index < numNodes; ++index)
+  {
+    const vtkNode& node = internals.Nodes[index];
+    if (!vtkIsReduction(node.Op))
+    {
+      continue;
+    }
+
+    vtkAccumulator total;
+    for (size_t scope = 0; scope < scopes.size(); ++scope)
+    {
+      if (scopes[scope].NumberOfElements > 0)
+      {
+        vtkChunkEvaluator evaluator(internals.Nodes, internals.Reductions, bindings[scope],
+          node.Args[0], this->ReplaceInvalidValues, this->ReplacementValue, NULL);
+        vtkSMPTools::For(0, scopes[scope].NumberOfElements, vtkChunkSize, evaluator);
+        total.Combine(evaluator.GetAccumulator());
+      }
+    }
+    if (parallel)
+    {
+      vtkAccumulator global;
+      double localSums[2] = { total.Sum, total.Count };
+      double globalSums[2];
+      this->Controller->AllReduce(&total.Min, &global.Min, 1, vtkCommunicator::MIN_OP);
+      this->Controller->AllReduce(&total.Max, &global.Max, 1, vtkCommunicator::MAX_OP);
+      this->Controller->AllReduce(localSums, globalSums, 2, vtkCommunicator::SUM_OP);
+      global.Sum = globalSums[0];
+      global.Count = globalSums[1];
+      total = global;
+    }
+
+    double value = std::numeric_limits<double>::quiet_NaN();
+    if (total.Count > 0)
+    {
+      switch (node.Op)
+      {
+        case OP_REDUCE_MIN:
+          value = total.Min;
+          break;
+        case OP_REDUCE_MAX:
+          value = total.Max;
+          break;
+        case OP_REDUCE_MEAN:
+          value = total.Sum / total.Count;
+          break;
+        default:
+          value = total.Sum;
+          break;
+      }
+    }
+    else if (node.Op == OP_REDUCE_SUM)
+    {
+      value = 0.0;
+    }
+    internals.Reductions[index] = value;
+  }
+
+  // The root of the program is its last node.
+  results.resize(scopes.size());
+  for (size_t scope = 0; scope < scopes.size(); ++scope)
+  {
+    const vtkIdType numElements = scopes[scope].NumberOfElements;
+    results[scope] = vtkSmartPointer<vtkDoubleArray>::New();
+    results[scope]->SetNumberOfTuples(numElements);
+    if (numElements > 0)
+    {
+      vtkChunkEvaluator evaluator(internals.Nodes, internals.Reductions, bindings[scope],
+        numNodes - 1, this->ReplaceInvalidValues, this->ReplacementValue,
+        results[scope]->GetPointer(0));
+      vtkSMPTools::For(0, numElements, vtkChunkSize, evaluator);
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVExpressionEvaluator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Expression: " << (this->Expression ? this->Expression : "(none)") << endl;
+  os << indent << "Syntax: " << this->Syntax << endl;
+  os << indent << "ReplaceInvalidValues: " << this->ReplaceInvalidValues << endl;
+  os << indent << "ReplacementValue: " << this->ReplacementValue << endl;
+  os << indent << "Controller: " << this->Controller << endl;
+}
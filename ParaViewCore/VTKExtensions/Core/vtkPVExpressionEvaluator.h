@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVExpressionEvaluator.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVExpressionEvaluator
+ * @brief   compiles array expressions once and evaluates them natively.
+ *
+ * vtkPVExpressionEvaluator parses an expression over named data arrays into a
+ * small typed program and evaluates it for all elements of one or more scopes
+ * (typically the point, cell or row data of the leaves of a dataset). The
+ * program is evaluated in fixed size chunks, one operation at a time over the
+ * whole chunk, and the chunks are spread over threads using vtkSMPTools. The
+ * compiled program is reused until the expression changes.
+ *
+ * The following constructs are supported:
+ * \li numbers, variables and `id`, the index of the element within its scope
+ * (unless a variable with that name is bound). Double quoted names may contain
+ * arbitrary characters.
+ * \li `+`, `-`, `*`, `/`, unary `-` and the power operator, `**` with
+ * PYTHON_SYNTAX and `^` with FUNCTION_PARSER_SYNTAX.
+ * \li `abs`, `sqrt`, `exp`, `ln`, `log`, `log10`, `floor`, `ceil`, `sign`,
+ * `sin`, `cos`, `tan`, `asin`, `acos`, `atan` (and their `arc` spellings),
+ * `sinh`, `cosh`, `tanh`, the element wise `min(a, b)` and `max(a, b)` and
+ * `mag(name)`, the magnitude of a multi-component variable.
+ *
+ * With PYTHON_SYNTAX, which matches the numpy expressions used by query
+ * selections, the following are supported as well:
+ * \li comparisons `<`, `<=`, `>`, `>=`, `==`, `!=`, including chained
+ * comparisons such as `0 < a < 1`, and `&`, `|`, `~` on their results.
+ * Precedence follows Python, i.e. comparisons bind looser than `&` and `|`.
+ * \li `name[:,k]`, the k-th component of a multi-component variable.
+ * \li `in_range(x, low, high)` and `isin(x, [v0, v1, ...])` (also spelled
+ * `is_in`).
+ * \li the reductions `min(x)`, `max(x)`, `mean(x)` and `sum(x)` over all
+ * elements of all scopes. When a controller is set, the reductions are
+ * computed across all of its processes and Evaluate() must be called on all of
+ * them.
+ *
+ * Anything else makes Compile() or Evaluate() fail with a message, so that
+ * callers can fall back to a more general evaluator.
+ */
+
+#ifndef vtkPVExpressionEvaluator_h
+#define vtkPVExpressionEvaluator_h
+
+#include "vtkObject.h"
+#include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
+#include "vtkSmartPointer.h"              // needed for vtkSmartPointer.
+
+#include <map>     // needed for std::map
+#include <string>  // needed for std::string
+#include <utility> // needed for std::pair
+#include <vector>  // needed for std::vector
+
+class vtkDataArray;
+class vtkDataSetAttributes;
+class vtkDoubleArray;
+class vtkMultiProcessController;
+
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVExpressionEvaluator : public vtkObject
+{
+public:
+  static vtkPVExpressionEvaluator* New();
+  vtkTypeMacro(vtkPVExpressionEvaluator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  enum
+  {
+    PYTHON_SYNTAX = 0,
+    FUNCTION_PARSER_SYNTAX = 1
+  };
+
+  //@{
+  /**
+   * Get/Set the expression to evaluate.
+   */
+  vtkSetStringMacro(Expression);
+  vtkGetStringMacro(Expression);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the syntax used to parse the expression. PYTHON_SYNTAX (the
+   * default) understands the subset of numpy used by query selections,
+   * FUNCTION_PARSER_SYNTAX the arithmetic subset of vtkFunctionParser.
+   */
+  vtkSetClampMacro(Syntax, int, PYTHON_SYNTAX, FUNCTION_PARSER_SYNTAX);
+  vtkGetMacro(Syntax, int);
+  //@}
+
+  //@{
+  /**
+   * When set, divisions by zero and arguments outside of the domain of sqrt,
+   * the logarithms, asin and acos yield ReplacementValue instead of inf/nan,
+   * like vtkFunctionParser does. Off by default.
+   */
+  vtkSetMacro(ReplaceInvalidValues, bool);
+  vtkGetMacro(ReplaceInvalidValues, bool);
+  vtkBooleanMacro(ReplaceInvalidValues, bool);
+  vtkSetMacro(ReplacementValue, double);
+  vtkGetMacro(ReplacementValue, double);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the controller used to compute reductions across processes. When
+   * NULL (the default), reductions only cover the local scopes.
+   */
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+  //@}
+
+  /**
+   * Parses the expression. The compiled program is kept until the expression
+   * or the syntax changes. Returns false if the expression is malformed or
+   * uses unsupported constructs, see GetErrorMessage().
+   */
+  bool Compile();
+
+  /**
+   * Returns the reason the last Compile() or Evaluate() failed.
+   */
+  const char* GetErrorMessage() const;
+
+  /**
+   * The variables available for one set of elements. Each variable is bound
+   * either to a single component of an array, or, with a negative component,
+   * to the whole array.
+   */
+  struct Scope
+  {
+    Scope()
+      : NumberOfElements(0)
+    {
+    }
+
+    void AddVariable(const std::string& name, vtkDataArray* array, int component = -1);
+
+    /**
+     * Binds every vtkDataArray in attributes to a variable of the same name.
+     */
+    void AddArrays(vtkDataSetAttributes* attributes);
+
+    vtkIdType NumberOfElements;
+    std::map<std::string, std::pair<vtkDataArray*, int> > Variables;
+  };
+
+  /**
+   * Evaluates the expression for all elements of each scope. On success,
+   * results holds one single component array per scope. Returns false when
+   * the expression cannot be compiled or refers to variables missing from a
+   * non-empty scope. When a controller is set, the outcome is the same on all
+   * processes.
+   */
+  bool Evaluate(
+    const std::vector<Scope>& scopes, std::vector<vtkSmartPointer<vtkDoubleArray> >& results);
+
+protected:
+  vtkPVExpressionEvaluator();
+  ~vtkPVExpressionEvaluator() override;
+
+  char* Expression;
+  int Syntax;
+  bool ReplaceInvalidValues;
+  double ReplacementValue;
+  vtkMultiProcessController* Controller;
+
+private:
+  vtkPVExpressionEvaluator(const vtkPVExpressionEvaluator&) = delete;
+  void operator=(const vtkPVExpressionEvaluator&) = delete;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
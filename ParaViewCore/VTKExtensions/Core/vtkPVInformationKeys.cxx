@@ -15,7 +15,10 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkPVInformationKeys.h"
 
 #include "vtkInformationDoubleVectorKey.h"
+#include "vtkInformationInformationVectorKey.h"
 #include "vtkInformationStringKey.h"
 
 vtkInformationKeyMacro(vtkPVInformationKeys, TIME_LABEL_ANNOTATION, String);
 vtkInformationKeyRestrictedMacro(vtkPVInformationKeys, WHOLE_BOUNDING_BOX, DoubleVector, 6);
+vtkInformationKeyMacro(vtkPVInformationKeys, TEMPORAL_ARRAY_RANGES, InformationVector);
+vtkInformationKeyMacro(vtkPVInformationKeys, TEMPORAL_RANGES, DoubleVector);
@@ -22,8 +22,9 @@
 
 #include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
 
-class vtkInformationStringKey;
 class vtkInformationDoubleVectorKey;
+class vtkInformationInformationVectorKey;
+class vtkInformationStringKey;
 
 class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVInformationKeys
 {
@@ -39,8 +40,23 @@ public:
    * information.
    */
   static vtkInformationDoubleVectorKey* WHOLE_BOUNDING_BOX();
+  //@}
+
+  //@{
+  /**
+   * Keys a reader can use to provide the ranges of its arrays over all
+   * timesteps in its output information, e.g. when they are known from the
+   * file metadata. TEMPORAL_ARRAY_RANGES() holds one vtkInformation per array
+   * with vtkDataObject::FIELD_NAME(), vtkDataObject::FIELD_ASSOCIATION(),
+   * vtkDataObject::FIELD_NUMBER_OF_COMPONENTS() and TEMPORAL_RANGES(). The
+   * latter holds, for each timestep in TIME_STEPS() order, the finite range
+   * of each component followed, for arrays with more than one component, by
+   * the range of the magnitude.
+   */
+  static vtkInformationInformationVectorKey* TEMPORAL_ARRAY_RANGES();
+  static vtkInformationDoubleVectorKey* TEMPORAL_RANGES();
+  //@}
 };
-//@}
 
 #endif // vtkPVInformationKeys_h
 // VTK-HeaderTest-Exclude: vtkPVInformationKeys.h
@@ -0,0 +1,353 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVProgressiveExecution.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVProgressiveExecution.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkDataObject.h"
+#include "vtkInformation.h"
+#include "vtkInformationDoubleKey.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkWeakPointer.h"
+
+#include <atomic>
+#include <vector>
+
+namespace
+{
+class vtkProgressiveState
+{
+public:
+  // Set from any thread, e.g. the one answering client requests on the root.
+  std::atomic<bool> AbortRequested;
+  // Set once CheckAbort() found an abort on this rank.
+  bool ExecutionAborted;
+  // Algorithms aborted, or executed after the abort, in this execution.
+  std::vector<vtkWeakPointer<vtkAlgorithm> > AbortedAlgorithms;
+
+  struct vtkOutput
+  {
+    vtkWeakPointer<vtkDataObject> Output;
+    vtkWeakPointer<vtkAlgorithm> Algorithm;
+    // Of the algorithm for partial outputs, of the output for aborted ones.
+    vtkMTimeType MTime;
+  };
+  std::vector<vtkOutput> AbortedOutputs;
+
+  double PartialOutputInterval;
+  std::vector<vtkOutput> PartialOutputs;
+
+  vtkProgressiveState()
+    : AbortRequested(false)
+    , ExecutionAborted(false)
+    , PartialOutputInterval(0.0)
+  {
+  }
+
+  // Removes the entry for the data object along with the entries of deleted
+  // data objects.
+  static void Remove(std::vector<vtkOutput>& outputs, vtkDataObject* output)
+  {
+    std::vector<vtkOutput>::iterator iter = outputs.begin();
+    while (iter != outputs.end())
+    {
+      if (iter->Output == NULL || iter->Output == output)
+      {
+        iter = outputs.erase(iter);
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+  }
+
+  static std::vector<vtkOutput>::iterator Find(
+    std::vector<vtkOutput>& outputs, vtkDataObject* output)
+  {
+    std::vector<vtkOutput>::iterator iter = outputs.begin();
+    while (iter != outputs.end() && iter->Output != output)
+    {
+      ++iter;
+    }
+    return iter;
+  }
+};
+
+vtkProgressiveState& vtkGetState()
+{
+  static vtkProgressiveState state;
+  return state;
+}
+}
+
+vtkStandardNewMacro(vtkPVProgressiveExecution);
+vtkInformationKeyMacro(vtkPVProgressiveExecution, PARTIAL_OUTPUT, Integer);
+vtkInformationKeyMacro(vtkPVProgressiveExecution, START_TIME, Double);
+vtkInformationKeyMacro(vtkPVProgressiveExecution, RESUMING, Integer);
+//----------------------------------------------------------------------------
+vtkPVProgressiveExecution::vtkPVProgressiveExecution()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVProgressiveExecution::~vtkPVProgressiveExecution()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProgressiveExecution::RequestAbort()
+{
+  vtkGetState().AbortRequested = true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVProgressiveExecution::GetAbortRequested()
+{
+  return vtkGetState().AbortRequested;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVProgressiveExecution::CheckAbort(vtkAlgorithm* self)
+{
+  vtkProgressiveState& state = vtkGetState();
+  if (!state.AbortRequested)
+  {
+    return false;
+  }
+
+  state.ExecutionAborted = true;
+  if (self)
+  {
+    self->SetAbortExecute(1);
+    vtkPVProgressiveExecution::ReportExecution(self);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVProgressiveExecution::GetExecutionAborted()
+{
+  return vtkGetState().ExecutionAborted;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProgressiveExecution::BeginExecution()
+{
+  vtkProgressiveState& state = vtkGetState();
+  state.AbortRequested = false;
+  state.ExecutionAborted = false;
+  state.AbortedAlgorithms.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProgressiveExecution::EndExecution()
+{
+  vtkProgressiveState& state = vtkGetState();
+
+  // The outputs of the algorithms rolled back on this rank are flagged so that
+  // they are not shown, and modifying the algorithms ensures the next update
+  // regenerates these outputs.
+  for (size_t cc = 0; cc < state.AbortedAlgorithms.size(); ++cc)
+  {
+    vtkAlgorithm* algorithm = state.AbortedAlgorithms[cc];
+    if (!algorithm)
+    {
+      continue;
+    }
+    for (int port = 0; port < algorithm->GetNumberOfOutputPorts(); ++port)
+    {
+      vtkDataObject* output = vtkDataObject::GetData(algorithm->GetOutputInformation(port));
+      if (output)
+      {
+        vtkProgressiveState::Remove(state.PartialOutputs, output);
+        vtkProgressiveState::Remove(state.AbortedOutputs, output);
+        output->GetInformation()->Remove(vtkPVProgressiveExecution::PARTIAL_OUTPUT());
+        vtkProgressiveState::vtkOutput item;
+        item.Output = output;
+        item.Algorithm = algorithm;
+        item.MTime = output->GetMTime();
+        state.AbortedOutputs.push_back(item);
+      }
+    }
+    algorithm->GetInformation()->Remove(vtkPVProgressiveExecution::START_TIME());
+    algorithm->GetInformation()->Remove(vtkPVProgressiveExecution::RESUMING());
+    algorithm->SetAbortExecute(0);
+    algorithm->Modified();
+  }
+  state.AbortedAlgorithms.clear();
+  state.ExecutionAborted = false;
+  state.AbortRequested = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProgressiveExecution::ReportExecution(vtkAlgorithm* algorithm)
+{
+  vtkProgressiveState& state = vtkGetState();
+  if (!algorithm || !state.ExecutionAborted)
+  {
+    return;
+  }
+  for (size_t cc = 0; cc < state.AbortedAlgorithms.size(); ++cc)
+  {
+    if (state.AbortedAlgorithms[cc] == algorithm)
+    {
+      return;
+    }
+  }
+  state.AbortedAlgorithms.push_back(algorithm);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVProgressiveExecution::IsAbortedOutput(vtkDataObject* output)
+{
+  vtkProgressiveState& state = vtkGetState();
+  std::vector<vtkProgressiveState::vtkOutput>::iterator iter =
+    vtkProgressiveState::Find(state.AbortedOutputs, output);
+  if (!output || iter == state.AbortedOutputs.end())
+  {
+    return false;
+  }
+
+  // The output was regenerated since.
+  if (iter->Algorithm == NULL || iter->MTime != output->GetMTime())
+  {
+    vtkProgressiveState::Remove(state.AbortedOutputs, output);
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProgressiveExecution::SetPartialOutputInterval(double seconds)
+{
+  vtkGetState().PartialOutputInterval = seconds > 0.0 ? seconds : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVProgressiveExecution::GetPartialOutputInterval()
+{
+  return vtkGetState().PartialOutputInterval;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVProgressiveExecution::BeginProgressiveExecution(vtkAlgorithm* self)
+{
+  vtkInformation* info = self->GetInformation();
+  info->Set(vtkPVProgressiveExecution::START_TIME(), vtkTimerLog::GetUniversalTime());
+  bool resuming = info->Has(vtkPVProgressiveExecution::RESUMING()) != 0;
+  info->Remove(vtkPVProgressiveExecution::RESUMING());
+  return resuming;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVProgressiveExecution::IsPartialOutputDue(vtkAlgorithm* self)
+{
+  vtkProgressiveState& state = vtkGetState();
+  vtkInformation* info = self->GetInformation();
+  if (state.PartialOutputInterval <= 0.0 || !info->Has(vtkPVProgressiveExecution::START_TIME()))
+  {
+    return false;
+  }
+  return vtkTimerLog::GetUniversalTime() - info->Get(vtkPVProgressiveExecution::START_TIME()) >=
+    state.PartialOutputInterval;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProgressiveExecution::SetPartialOutput(
+  vtkAlgorithm* self, vtkDataObject* output, bool partial)
+{
+  if (!self || !output)
+  {
+    return;
+  }
+
+  vtkProgressiveState& state = vtkGetState();
+  vtkProgressiveState::Remove(state.PartialOutputs, output);
+  self->GetInformation()->Remove(vtkPVProgressiveExecution::START_TIME());
+  if (partial)
+  {
+    output->GetInformation()->Set(vtkPVProgressiveExecution::PARTIAL_OUTPUT(), 1);
+    vtkProgressiveState::vtkOutput item;
+    item.Output = output;
+    item.Algorithm = self;
+    item.MTime = self->GetMTime();
+    state.PartialOutputs.push_back(item);
+  }
+  else
+  {
+    output->GetInformation()->Remove(vtkPVProgressiveExecution::PARTIAL_OUTPUT());
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVProgressiveExecution::IsPartialOutput(vtkDataObject* output)
+{
+  return output && output->GetInformation()->Has(vtkPVProgressiveExecution::PARTIAL_OUTPUT());
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVProgressiveExecution::ResumePartialOutput(vtkDataObject* output)
+{
+  if (!vtkPVProgressiveExecution::IsPartialOutput(output))
+  {
+    return false;
+  }
+
+  vtkProgressiveState& state = vtkGetState();
+  std::vector<vtkProgressiveState::vtkOutput>::iterator iter =
+    vtkProgressiveState::Find(state.PartialOutputs, output);
+  vtkSmartPointer<vtkAlgorithm> algorithm;
+  vtkMTimeType mtime = 0;
+  if (iter != state.PartialOutputs.end())
+  {
+    algorithm = iter->Algorithm;
+    mtime = iter->MTime;
+  }
+
+  int port = -1;
+  for (int cc = 0; algorithm && cc < algorithm->GetNumberOfOutputPorts(); ++cc)
+  {
+    if (algorithm->GetOutputDataObject(cc) == output)
+    {
+      port = cc;
+      break;
+    }
+  }
+
+  // A modified algorithm starts over on the next regular update.
+  vtkProgressiveState::Remove(state.PartialOutputs, output);
+  if (port < 0 || algorithm->GetMTime() != mtime)
+  {
+    return false;
+  }
+
+  algorithm->GetInformation()->Set(vtkPVProgressiveExecution::RESUMING(), 1);
+  algorithm->Modified();
+  algorithm->Update(port);
+  algorithm->GetInformation()->Remove(vtkPVProgressiveExecution::RESUMING());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProgressiveExecution::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "AbortRequested: " << vtkPVProgressiveExecution::GetAbortRequested() << endl;
+  os << indent << "PartialOutputInterval: " << vtkPVProgressiveExecution::GetPartialOutputInterval()
+     << endl;
+}
@@ -0,0 +1,188 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVProgressiveExecution.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVProgressiveExecution
+ * @brief   abort and partial output for long-running algorithms.
+ *
+ * vtkPVProgressiveExecution is a collection of helper routines long-running
+ * algorithms (filters and readers) can adopt to be aborted by the user and to
+ * show partial results while they execute.
+ *
+ * \li Abort: the user requests an abort with RequestAbort(), usually through
+ * vtkPVSession::RequestAbort() which forwards the request to the root of the
+ * server. vtkPVProgressHandler forwards it from the root to the other ranks,
+ * which pick it up on their next progress event. Algorithms poll CheckAbort()
+ * from RequestData(). CheckAbort() only looks at the flag of the local rank,
+ * so ranks stop at different points: an algorithm that communicates between
+ * ranks must only return early where all ranks agree to, e.g. by adding
+ * GetAbortRequested() to a reduction it performs anyway. The algorithms
+ * executing after the abort, on the truncated data, are rolled back as well.
+ * When the execution ends, the outputs of all these algorithms are flagged as
+ * aborted (see IsAbortedOutput()) and the algorithms are marked modified, so
+ * that the next update regenerates them. Meanwhile, representations keep
+ * showing the data they had before the aborted execution (see
+ * vtkPVDataRepresentationPipeline).
+ *
+ * \li Partial output: when PartialOutputInterval is positive, an algorithm
+ * calls BeginProgressiveExecution() at the start of RequestData() and polls
+ * IsPartialOutputDue(). When it is due, the algorithm saves its state, fills
+ * its output with what it computed so far, calls SetPartialOutput() and
+ * returns. Representations supporting it (e.g. vtkGeometryRepresentation)
+ * call ResumePartialOutput() during streaming passes: the algorithm executes
+ * again with BeginProgressiveExecution() returning true, picks up where it
+ * stopped, and the refined result is delivered through the streaming path of
+ * the view. An algorithm modified in the meantime starts over.
+ * vtkXMLCollectionReader adopts both contracts.
+ *
+ * vtkPVProgressHandler calls BeginExecution() and EndExecution() around each
+ * execution requested by the client, and ReportExecution() for each algorithm
+ * that executes.
+ */
+
+#ifndef vtkPVProgressiveExecution_h
+#define vtkPVProgressiveExecution_h
+
+#include "vtkObject.h"
+#include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
+
+class vtkAlgorithm;
+class vtkDataObject;
+class vtkInformationDoubleKey;
+class vtkInformationIntegerKey;
+
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVProgressiveExecution : public vtkObject
+{
+public:
+  static vtkPVProgressiveExecution* New();
+  vtkTypeMacro(vtkPVProgressiveExecution, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  /**
+   * Requests the current execution to be aborted. This may be called from any
+   * thread, and on any rank, usually the root.
+   */
+  static void RequestAbort();
+
+  /**
+   * Returns true when an abort was requested on this rank, or forwarded to it
+   * by vtkPVProgressHandler. Unlike CheckAbort(), no algorithm is flagged.
+   */
+  static bool GetAbortRequested();
+
+  /**
+   * Returns true when an abort was requested on this rank. When true, the
+   * AbortExecute flag of the algorithm is set and the algorithm is expected to
+   * return from RequestData() right away. This is cheap and does not
+   * communicate.
+   */
+  static bool CheckAbort(vtkAlgorithm* self);
+
+  /**
+   * Returns true once CheckAbort() returned true on this rank during the
+   * current execution.
+   */
+  static bool GetExecutionAborted();
+
+  //@{
+  /**
+   * Called on all ranks before and after each execution requested by the
+   * client. EndExecution() rolls back the algorithms aborted on this rank, and
+   * the ones that executed after them, and clears the abort request.
+   */
+  static void BeginExecution();
+  static void EndExecution();
+  //@}
+
+  /**
+   * Called when an algorithm starts executing. Once the execution is aborted,
+   * the algorithm works on truncated data and is rolled back at the end of
+   * the execution.
+   */
+  static void ReportExecution(vtkAlgorithm* algorithm);
+
+  /**
+   * Returns true if the data object is the output of an algorithm rolled back
+   * by an aborted execution, and the algorithm did not execute since. Its
+   * content is truncated and must not be shown.
+   */
+  static bool IsAbortedOutput(vtkDataObject* output);
+
+  //@{
+  /**
+   * Get/Set the interval, in seconds, at which algorithms adopting the partial
+   * output contract emit their result so far. 0 (default) disables partial
+   * outputs.
+   */
+  static void SetPartialOutputInterval(double seconds);
+  static double GetPartialOutputInterval();
+  //@}
+
+  /**
+   * To be called at the start of RequestData() by algorithms adopting the
+   * partial output contract. Returns true when the execution resumes the
+   * partial output of the previous one, false when it must start over.
+   */
+  static bool BeginProgressiveExecution(vtkAlgorithm* self);
+
+  /**
+   * Returns true when PartialOutputInterval has elapsed since
+   * BeginProgressiveExecution(). This does not communicate: ranks decide on
+   * their own, and some may emit a partial output while others complete.
+   */
+  static bool IsPartialOutputDue(vtkAlgorithm* self);
+
+  /**
+   * Flags the output of the algorithm as partial, i.e. the algorithm returned
+   * early and can resume, or as complete.
+   */
+  static void SetPartialOutput(vtkAlgorithm* self, vtkDataObject* output, bool partial);
+
+  /**
+   * Returns true if the data object is the partial output of an algorithm.
+   */
+  static bool IsPartialOutput(vtkDataObject* output);
+
+  /**
+   * Executes again the algorithm that produced the partial output, so that it
+   * refines it in place. Returns false, doing nothing, if the output is not
+   * partial or if its algorithm was modified since.
+   */
+  static bool ResumePartialOutput(vtkDataObject* output);
+
+  /**
+   * Key set in the information of partial outputs.
+   */
+  static vtkInformationIntegerKey* PARTIAL_OUTPUT();
+
+protected:
+  vtkPVProgressiveExecution();
+  ~vtkPVProgressiveExecution() VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Keys set in the information of algorithms adopting the partial output
+   * contract: the start of the current execution, and whether it resumes
+   * the partial output of the previous one.
+   */
+  static vtkInformationDoubleKey* START_TIME();
+  static vtkInformationIntegerKey* RESUMING();
+  //@}
+
+private:
+  vtkPVProgressiveExecution(const vtkPVProgressiveExecution&) = delete;
+  void operator=(const vtkPVProgressiveExecution&) = delete;
+};
+
+#endif
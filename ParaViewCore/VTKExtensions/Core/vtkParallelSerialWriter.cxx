@@ -23,10 +23,12 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTrivialProducer.h"
 
 #include <sstream>
 #include <string>
@@ -69,6 +71,7 @@ vtkParallelSerialWriter::vtkParallelSerialWriter()
   this->PostGatherHelper = 0;
 
   this->WriteAllTimeSteps = 0;
+  this->WriteInParallel = 0;
   this->NumberOfTimeSteps = 0;
   this->CurrentTimeIndex = 0;
 
@@ -220,6 +223,12 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
 {
   vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
 
+  if (this->WriteInParallel && controller && controller->GetNumberOfProcesses() > 1)
+  {
+    this->WriteAFileInParallel(filename, input, controller);
+    return;
+  }
+
   vtkSmartPointer<vtkReductionFilter> reductionFilter = vtkSmartPointer<vtkReductionFilter>::New();
   reductionFilter->SetController(controller);
   reductionFilter->SetPreGatherHelper(this->PreGatherHelper);
@@ -237,26 +246,64 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
     vtkDataObject* output = reductionFilter->GetOutputDataObject(0);
     if (vtkIsEmpty(output) == false)
     {
-      std::ostringstream fname;
-      if (this->WriteAllTimeSteps)
-      {
-        std::string path = vtksys::SystemTools::GetFilenamePath(filename);
-        std::string fnamenoext = vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
-        std::string ext = vtksys::SystemTools::GetFilenameLastExtension(filename);
-        fname << path << "/" << fnamenoext << "." << this->CurrentTimeIndex << ext;
-      }
-      else
-      {
-        fname << filename;
-      }
       this->Writer->SetInputDataObject(output);
-      this->SetWriterFileName(fname.str().c_str());
+      this->SetWriterFileName(this->GetTimeStepFileName(filename).c_str());
       this->WriteInternal();
       this->Writer->SetInputConnection(0);
     }
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkParallelSerialWriter::WriteAFileInParallel(
+  const char* filename, vtkDataObject* input, vtkMultiProcessController* controller)
+{
+  // Every process writes, even with empty data, since the writer is
+  // collective.
+  vtkSmartPointer<vtkDataObject> localData = input;
+  if (this->PreGatherHelper)
+  {
+    // Same as vtkReductionFilter: go through a producer so that the helper
+    // gets proper pipeline information.
+    this->PreGatherHelper->RemoveAllInputs();
+    vtkSmartPointer<vtkDataObject> incopy;
+    incopy.TakeReference(input->NewInstance());
+    incopy->ShallowCopy(input);
+    vtkNew<vtkTrivialProducer> incopyProducer;
+    incopyProducer->SetOutput(incopy);
+    this->PreGatherHelper->AddInputConnection(0, incopyProducer->GetOutputPort());
+    this->PreGatherHelper->Update();
+    localData.TakeReference(this->PreGatherHelper->GetOutputDataObject(0)->NewInstance());
+    localData->ShallowCopy(this->PreGatherHelper->GetOutputDataObject(0));
+    this->PreGatherHelper->RemoveAllInputs();
+  }
+
+  this->Writer->SetInputDataObject(localData);
+  this->SetWriterFileName(this->GetTimeStepFileName(filename).c_str());
+  this->SetWriterController(controller);
+  this->WriteInternal();
+  this->SetWriterController(NULL);
+  this->Writer->SetInputConnection(0);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkParallelSerialWriter::GetTimeStepFileName(const char* filename)
+{
+  std::ostringstream fname;
+  if (this->WriteAllTimeSteps)
+  {
+    std::string path = vtksys::SystemTools::GetFilenamePath(filename);
+    std::string fnamenoext = vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
+    std::string ext = vtksys::SystemTools::GetFilenameLastExtension(filename);
+    fname << path << "/" << fnamenoext << "." << this->CurrentTimeIndex << ext;
+  }
+  else
+  {
+    fname << filename;
+  }
+  return fname.str();
+}
+
 //----------------------------------------------------------------------------
 // Overload standard modified time function. If the internal reader is
 // modified, then this object is modified as well.
@@ -300,8 +347,22 @@ void vtkParallelSerialWriter::SetWriterFileName(const char* fname)
   }
 }
 
+//-----------------------------------------------------------------------------
+void vtkParallelSerialWriter::SetWriterController(vtkMultiProcessController* controller)
+{
+  if (this->Writer)
+  {
+    vtkClientServerStream stream;
+    stream << vtkClientServerStream::Invoke << this->Writer << "SetController"
+           << static_cast<vtkObjectBase*>(controller) << vtkClientServerStream::End;
+    this->Interpreter->ProcessStream(stream);
+  }
+}
+
 //-----------------------------------------------------------------------------
 void vtkParallelSerialWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "WriteAllTimeSteps: " << this->WriteAllTimeSteps << endl;
+  os << indent << "WriteInParallel: " << this->WriteInParallel << endl;
 }
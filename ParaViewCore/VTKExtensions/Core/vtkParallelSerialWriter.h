@@ -22,6 +22,10 @@
  * and PostGatherHelper.
  * This also makes it possible to write time-series for temporal datasets using
  * simple non-time-aware writers.
+ *
+ * When WriteInParallel is on, the data is not gathered. Instead the internal
+ * writer is given the controller and runs on every process with the local
+ * data produced by the PreGatherHelper, writing a single file collectively.
 */
 
 #ifndef vtkParallelSerialWriter_h
@@ -30,7 +34,10 @@
 #include "vtkDataObjectAlgorithm.h"
 #include "vtkPVVTKExtensionsCoreModule.h" //needed for exports
 
+#include <string> // for std::string
+
 class vtkClientServerInterpreter;
+class vtkMultiProcessController;
 
 class VTKPVVTKEXTENSIONSCORE_EXPORT vtkParallelSerialWriter : public vtkDataObjectAlgorithm
 {
@@ -129,6 +136,19 @@ public:
   vtkBooleanMacro(WriteAllTimeSteps, int);
   //@}
 
+  //@{
+  /**
+   * When on, and running with more than one process, the data is not
+   * gathered to the root node. The controller is passed to the internal
+   * writer with SetController() and the writer is invoked on every process,
+   * which must then cooperate to write a single file. The PostGatherHelper is
+   * not used in that case. Off by default.
+   */
+  vtkGetMacro(WriteInParallel, int);
+  vtkSetMacro(WriteInParallel, int);
+  vtkBooleanMacro(WriteInParallel, int);
+  //@}
+
   /**
    * Get/Set the interpreter to use to call methods on the writer.
    */
@@ -151,8 +171,12 @@ private:
 
   void WriteATimestep(vtkDataObject* input);
   void WriteAFile(const char* fname, vtkDataObject* input);
+  void WriteAFileInParallel(
+    const char* fname, vtkDataObject* input, vtkMultiProcessController* controller);
+  std::string GetTimeStepFileName(const char* fname);
 
   void SetWriterFileName(const char* fname);
+  void SetWriterController(vtkMultiProcessController* controller);
   void WriteInternal();
 
   vtkAlgorithm* PreGatherHelper;
@@ -165,6 +189,7 @@ private:
   int GhostLevel;
 
   int WriteAllTimeSteps;
+  int WriteInParallel;
   int NumberOfTimeSteps;
   int CurrentTimeIndex;
 
@@ -16,6 +16,7 @@
 
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkCommunicator.h"
 #include "vtkDataObjectTypes.h"
 #include "vtkDataSet.h"
 #include "vtkGenericDataObjectReader.h"
@@ -24,7 +25,9 @@
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationExecutivePortKey.h"
+#include "vtkInformationIntegerKey.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVInstantiator.h"
@@ -41,10 +44,11 @@
 #include "vtkTrivialProducer.h"
 
 #include <sstream>
-#include <sstream>
+#include <string>
 #include <vector>
 
 vtkStandardNewMacro(vtkReductionFilter);
+vtkInformationKeyMacro(vtkReductionFilter, POST_GATHER_HELPER_IS_ASSOCIATIVE, Integer);
 vtkCxxSetObjectMacro(vtkReductionFilter, Controller, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkReductionFilter, PreGatherHelper, vtkAlgorithm);
 vtkCxxSetObjectMacro(vtkReductionFilter, PostGatherHelper, vtkAlgorithm);
@@ -60,6 +64,8 @@ vtkReductionFilter::vtkReductionFilter()
   this->GenerateProcessIds = 0;
   this->ReductionMode = vtkReductionFilter::REDUCE_ALL_TO_ONE;
   this->ReductionProcessId = 0;
+  this->TreeFanIn = 0;
+  this->TreeReductionDecision = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -366,6 +372,36 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     }
   }
 
+  if (this->CanUseTreeReduction())
+  {
+    int root = this->ReductionMode == vtkReductionFilter::REDUCE_ALL_TO_ALL
+      ? 0
+      : this->ReductionProcessId;
+    vtkSmartPointer<vtkDataObject> reduced = this->TreeReduce(preOutput, output, root);
+    if (this->ReductionMode == vtkReductionFilter::REDUCE_ALL_TO_ALL)
+    {
+      // Share the reduced result instead of gathering on every process.
+      this->BroadcastDataObject(reduced, output, root);
+      if (reduced)
+      {
+        output->ShallowCopy(reduced);
+      }
+    }
+    else if (myId == this->ReductionProcessId)
+    {
+      if (reduced)
+      {
+        output->ShallowCopy(reduced);
+      }
+    }
+    else if (preOutput && this->ReductionMode == vtkReductionFilter::REDUCE_ALL_TO_ONE)
+    {
+      vtkSmartPointer<vtkDataObject> inputs[1] = { preOutput };
+      this->PostProcess(output, inputs, 1);
+    }
+    return;
+  }
+
   std::vector<vtkSmartPointer<vtkDataObject> > data_sets;
   std::vector<vtkSmartPointer<vtkDataObject> > receiveData(numProcs);
 
@@ -476,6 +512,204 @@ int vtkReductionFilter::GatherSelection(vtkSelection* sendData,
   return 0;
 }
 
+//----------------------------------------------------------------------------
+bool vtkReductionFilter::CanUseTreeReduction()
+{
+  // Every process must agree, the helper may be set on the root only. The
+  // properties the decision depends on are set on all processes, so it is only
+  // exchanged again once the filter is modified.
+  if (this->TreeReductionDecisionTime > this->GetMTime())
+  {
+    return this->TreeReductionDecision;
+  }
+  int localCanUse = (this->TreeFanIn > 1 && this->PassThrough < 0 && this->PostGatherHelper &&
+                      this->PostGatherHelper->GetInformation()->Get(
+                        vtkReductionFilter::POST_GATHER_HELPER_IS_ASSOCIATIVE()) != 0)
+    ? 1
+    : 0;
+  int globalCanUse = 0;
+  this->Controller->AllReduce(&localCanUse, &globalCanUse, 1, vtkCommunicator::MIN_OP);
+  this->TreeReductionDecision = globalCanUse != 0;
+  this->TreeReductionDecisionTime.Modified();
+  return this->TreeReductionDecision;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> vtkReductionFilter::TreeReduce(
+  vtkDataObject* preOutput, vtkDataObject* output, int root)
+{
+  vtkMultiProcessController* controller = this->Controller;
+  int numProcs = controller->GetNumberOfProcesses();
+  int myId = controller->GetLocalProcessId();
+
+  // The tree is rooted at process 0: children always have higher ranks than
+  // their parent, which keeps the inputs of each reduction in rank order, as
+  // the gather based reduction does. The result is then forwarded to root.
+  int fanIn = this->TreeFanIn;
+
+  vtkSmartPointer<vtkDataObject> partial = preOutput;
+  bool reduced = false;
+  for (int stride = 1; stride < numProcs; stride *= fanIn)
+  {
+    int groupSize = stride * fanIn;
+    if (myId % groupSize != 0)
+    {
+      // Send the result of our subtree to the group leader, we are done.
+      this->SendDataObject(partial, myId - (myId % groupSize));
+      partial = NULL;
+      break;
+    }
+
+    std::vector<vtkSmartPointer<vtkDataObject> > inputs;
+    if (partial)
+    {
+      inputs.push_back(partial);
+    }
+    for (int child = myId + stride; child < myId + groupSize && child < numProcs; child += stride)
+    {
+      vtkSmartPointer<vtkDataObject> received = this->ReceiveDataObject(child);
+      if (received)
+      {
+        inputs.push_back(received);
+      }
+    }
+
+    if (inputs.size() > 1)
+    {
+      partial.TakeReference(output->NewInstance());
+      this->PostProcess(partial, &inputs[0], static_cast<unsigned int>(inputs.size()));
+      reduced = true;
+    }
+    else if (inputs.size() == 1 && inputs[0] != partial)
+    {
+      // Only a child had data, forward its result as is.
+      partial = inputs[0];
+      reduced = false;
+    }
+
+    // Guard against overflow of stride * fanIn on huge process counts
+    if (stride > numProcs / fanIn)
+    {
+      break;
+    }
+  }
+
+  if (myId == 0)
+  {
+    // Make sure the root always produces the PostGatherHelper's output, as the
+    // gather based reduction does.
+    if (partial && !reduced)
+    {
+      vtkSmartPointer<vtkDataObject> inputs[1] = { partial };
+      partial.TakeReference(output->NewInstance());
+      this->PostProcess(partial, inputs, 1);
+    }
+    if (root != 0)
+    {
+      this->SendDataObject(partial, root);
+      return vtkSmartPointer<vtkDataObject>();
+    }
+    return partial;
+  }
+  return myId == root ? this->ReceiveDataObject(0) : vtkSmartPointer<vtkDataObject>();
+}
+
+//----------------------------------------------------------------------------
+void vtkReductionFilter::SendDataObject(vtkDataObject* data, int remoteProcessId)
+{
+  vtkSelection* sel = vtkSelection::SafeDownCast(data);
+  int type = !data ? 0 : (sel ? 2 : 1);
+  this->Controller->Send(&type, 1, remoteProcessId, TRANSMIT_TREE_DATA_OBJECT);
+  if (type == 1)
+  {
+    this->Controller->Send(data, remoteProcessId, TRANSMIT_TREE_DATA_OBJECT);
+  }
+  else if (type == 2)
+  {
+    std::ostringstream xml;
+    vtkSelectionSerializer::PrintXML(xml, vtkIndent(), 1, sel);
+    std::string buffer = xml.str();
+    vtkIdType length = static_cast<vtkIdType>(buffer.size());
+    this->Controller->Send(&length, 1, remoteProcessId, TRANSMIT_TREE_DATA_OBJECT);
+    this->Controller->Send(buffer.c_str(), length, remoteProcessId, TRANSMIT_TREE_DATA_OBJECT);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> vtkReductionFilter::ReceiveDataObject(int remoteProcessId)
+{
+  int type = 0;
+  this->Controller->Receive(&type, 1, remoteProcessId, TRANSMIT_TREE_DATA_OBJECT);
+  if (type == 1)
+  {
+    vtkSmartPointer<vtkDataObject> data;
+    data.TakeReference(
+      this->Controller->ReceiveDataObject(remoteProcessId, TRANSMIT_TREE_DATA_OBJECT));
+    return data;
+  }
+  else if (type == 2)
+  {
+    vtkIdType length = 0;
+    this->Controller->Receive(&length, 1, remoteProcessId, TRANSMIT_TREE_DATA_OBJECT);
+    std::vector<char> buffer(length + 1, 0);
+    this->Controller->Receive(&buffer[0], length, remoteProcessId, TRANSMIT_TREE_DATA_OBJECT);
+    vtkNew<vtkSelection> sel;
+    vtkSelectionSerializer::Parse(&buffer[0], static_cast<unsigned int>(length), sel.Get());
+    return sel.Get();
+  }
+  return NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkReductionFilter::BroadcastDataObject(
+  vtkSmartPointer<vtkDataObject>& data, vtkDataObject* prototype, int root)
+{
+  vtkMultiProcessController* controller = this->Controller;
+  bool isRoot = controller->GetLocalProcessId() == root;
+  vtkSelection* sel = isRoot ? vtkSelection::SafeDownCast(data) : NULL;
+  int type = isRoot && data ? (sel ? 2 : 1) : 0;
+  controller->Broadcast(&type, 1, root);
+  if (type == 1)
+  {
+    if (!isRoot)
+    {
+      data.TakeReference(prototype->NewInstance());
+    }
+    controller->Broadcast(data, root);
+  }
+  else if (type == 2)
+  {
+    std::string buffer;
+    if (isRoot)
+    {
+      std::ostringstream xml;
+      vtkSelectionSerializer::PrintXML(xml, vtkIndent(), 1, sel);
+      buffer = xml.str();
+    }
+    vtkIdType length = static_cast<vtkIdType>(buffer.size());
+    controller->Broadcast(&length, 1, root);
+    if (!isRoot)
+    {
+      buffer.resize(length);
+    }
+    if (length > 0)
+    {
+      controller->Broadcast(&buffer[0], length, root);
+    }
+    if (!isRoot)
+    {
+      vtkNew<vtkSelection> received;
+      vtkSelectionSerializer::Parse(
+        buffer.c_str(), static_cast<unsigned int>(length), received.Get());
+      data = received.Get();
+    }
+  }
+  else
+  {
+    data = NULL;
+  }
+}
+
 //-----------------------------------------------------------------------------
 void vtkReductionFilter::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -485,4 +719,5 @@ void vtkReductionFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Controller: " << this->Controller << endl;
   os << indent << "PassThrough: " << this->PassThrough << endl;
   os << indent << "GenerateProcessIds: " << this->GenerateProcessIds << endl;
+  os << indent << "TreeFanIn: " << this->TreeFanIn << endl;
 }
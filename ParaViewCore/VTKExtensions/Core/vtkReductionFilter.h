@@ -28,6 +28,14 @@
  * In addition to doing reduction the PassThrough variable lets you choose
  * to pass through the results of any one node instead of aggregating all of
  * them together.
+ *
+ * When the PostGatherHelper is associative (its output can be fed back as one
+ * of its inputs and the result doesn't depend on how inputs are grouped), the
+ * reduction can be done along a k-ary tree instead: intermediate nodes run the
+ * PostGatherHelper on the results of their subtree and the root only receives
+ * TreeFanIn - 1 messages per level. Helpers declare this by setting
+ * POST_GATHER_HELPER_IS_ASSOCIATIVE() in their algorithm information (see
+ * vtkAlgorithm::GetInformation()) on all processes.
 */
 
 #ifndef vtkReductionFilter_h
@@ -36,8 +44,10 @@
 #include "vtkDataObjectAlgorithm.h"
 #include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
 #include "vtkSmartPointer.h"              // needed for vtkSmartPointer.
+#include "vtkTimeStamp.h"                 // needed for vtkTimeStamp.
 #include <vector>                         //  needed for std::vector
 
+class vtkInformationIntegerKey;
 class vtkMultiProcessController;
 class vtkSelection;
 class VTKPVVTKEXTENSIONSCORE_EXPORT vtkReductionFilter : public vtkDataObjectAlgorithm
@@ -124,9 +134,29 @@ public:
   vtkGetMacro(GenerateProcessIds, int);
   //@}
 
+  //@{
+  /**
+   * Get/Set the fan-in of the reduction tree. When greater than 1 and the
+   * PostGatherHelper is flagged with POST_GATHER_HELPER_IS_ASSOCIATIVE() on all
+   * processes, the data is reduced along a tree where each node receives at
+   * most TreeFanIn - 1 results. Otherwise (default 0), all the results are
+   * gathered on the reduction process. Tree reduction is never used with
+   * PassThrough.
+   */
+  vtkSetClampMacro(TreeFanIn, int, 0, VTK_INT_MAX);
+  vtkGetMacro(TreeFanIn, int);
+  //@}
+
+  /**
+   * Key used to flag a PostGatherHelper as associative, making it usable for
+   * tree reduction.
+   */
+  static vtkInformationIntegerKey* POST_GATHER_HELPER_IS_ASSOCIATIVE();
+
   enum Tags
   {
-    TRANSMIT_DATA_OBJECT = 23484
+    TRANSMIT_DATA_OBJECT = 23484,
+    TRANSMIT_TREE_DATA_OBJECT = 23485
   };
 
 protected:
@@ -155,6 +185,38 @@ protected:
   int GatherSelection(vtkSelection* sendData,
     std::vector<vtkSmartPointer<vtkDataObject> >& receiveData, int destProcessId);
 
+  /**
+   * Returns true when all processes agree on using the tree reduction. The
+   * decision is cached until the filter is modified.
+   */
+  bool CanUseTreeReduction();
+
+  /**
+   * Reduce preOutput along a TreeFanIn-ary tree rooted at process 0, in rank
+   * order, and forward the result to root. The reduced result is returned on
+   * the root, NULL is returned on the other processes.
+   */
+  vtkSmartPointer<vtkDataObject> TreeReduce(
+    vtkDataObject* preOutput, vtkDataObject* output, int root);
+
+  //@{
+  /**
+   * Point to point transfer of a possibly NULL data object. vtkSelection is
+   * serialized since it is not supported by the controller.
+   */
+  void SendDataObject(vtkDataObject* data, int remoteProcessId);
+  vtkSmartPointer<vtkDataObject> ReceiveDataObject(int remoteProcessId);
+  //@}
+
+  /**
+   * Broadcasts the data object of the root, which may be NULL, to all
+   * processes. On the other processes, the received data object, created
+   * with prototype->NewInstance(), replaces data. vtkSelection is serialized
+   * since it is not supported by the controller.
+   */
+  void BroadcastDataObject(
+    vtkSmartPointer<vtkDataObject>& data, vtkDataObject* prototype, int root);
+
   vtkAlgorithm* PreGatherHelper;
   vtkAlgorithm* PostGatherHelper;
   vtkMultiProcessController* Controller;
@@ -162,6 +224,9 @@ protected:
   int GenerateProcessIds;
   int ReductionMode;
   int ReductionProcessId;
+  int TreeFanIn;
+  bool TreeReductionDecision;
+  vtkTimeStamp TreeReductionDecisionTime;
 
 private:
   vtkReductionFilter(const vtkReductionFilter&) = delete;
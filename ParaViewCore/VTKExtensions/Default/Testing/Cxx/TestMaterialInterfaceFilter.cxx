@@ -0,0 +1,250 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestMaterialInterfaceFilter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDummyController.h"
+#include "vtkMaterialInterfaceFilter.h"
+#include "vtkMath.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkNonOverlappingAMR.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUniformGrid.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Blocks are labelled concurrently, then their fragments are equated across
+// block boundaries with a concurrent union-find. This compares the fragments
+// found in a grid split into many blocks with those found when the same grid
+// is a single block, which is labelled serially and never stitched.
+
+namespace
+{
+const int GridCells[3] = { 32, 32, 16 };
+const int BlockCells = 8;
+const int NumberOfFragments = 11;
+const int NumberOfRuns = 5;
+
+struct Fragment
+{
+  int Id;
+  double Volume;
+  double Center[3];
+};
+
+double Clamp(double value)
+{
+  return std::max(0.0, std::min(1.0, value));
+}
+
+// Signed distance from the point to the surface of the closest shape. The
+// shapes cross block boundaries on faces, edges and corners. The pieces of
+// the ring in each block only connect through the other blocks, and the tube
+// goes through every block along x.
+double SignedDistance(const double x[3])
+{
+  double distance = VTK_DOUBLE_MAX;
+  // spheres on the corner of eight blocks and on the edge of four.
+  const double spheres[2][3] = { { 8, 16, 8 }, { 24, 16, 4 } };
+  for (int cc = 0; cc < 2; ++cc)
+  {
+    distance =
+      std::min(distance, std::sqrt(vtkMath::Distance2BetweenPoints(x, spheres[cc])) - 2.5);
+  }
+  // small blobs, every other one crosses a block face.
+  for (int cc = 1; cc < 8; ++cc)
+  {
+    const double center[3] = { 4.0 * cc, 22, 4 };
+    distance = std::min(distance, std::sqrt(vtkMath::Distance2BetweenPoints(x, center)) - 1.0);
+  }
+  // tube along x.
+  const double tube = std::sqrt((x[1] - 28) * (x[1] - 28) + (x[2] - 12) * (x[2] - 12));
+  const double tubeEnd = std::max(2.0 - x[0], x[0] - 30.0);
+  distance = std::min(distance, std::max(tube - 1.5, tubeEnd));
+  // ring in the plane z = 8, around (16, 6).
+  const double radial = std::sqrt((x[0] - 16) * (x[0] - 16) + (x[1] - 6) * (x[1] - 6)) - 4.5;
+  distance = std::min(distance, std::sqrt(radial * radial + (x[2] - 8) * (x[2] - 8)) - 1.3);
+  return distance;
+}
+
+vtkSmartPointer<vtkUniformGrid> NewBlock(const int origin[3], const int cells[3])
+{
+  vtkSmartPointer<vtkUniformGrid> block = vtkSmartPointer<vtkUniformGrid>::New();
+  block->SetOrigin(origin[0], origin[1], origin[2]);
+  block->SetSpacing(1.0, 1.0, 1.0);
+  block->SetDimensions(cells[0] + 1, cells[1] + 1, cells[2] + 1);
+
+  vtkNew<vtkUnsignedCharArray> fraction;
+  fraction->SetName("Material");
+  fraction->SetNumberOfTuples(cells[0] * cells[1] * cells[2]);
+  vtkIdType cellId = 0;
+  for (int k = 0; k < cells[2]; ++k)
+  {
+    for (int j = 0; j < cells[1]; ++j)
+    {
+      for (int i = 0; i < cells[0]; ++i)
+      {
+        const double center[3] = { origin[0] + i + 0.5, origin[1] + j + 0.5,
+          origin[2] + k + 0.5 };
+        const double value = 255.0 * Clamp(0.5 - SignedDistance(center));
+        fraction->SetValue(cellId++, static_cast<unsigned char>(value + 0.5));
+      }
+    }
+  }
+  block->GetCellData()->AddArray(fraction.GetPointer());
+  return block;
+}
+
+// The whole grid as one block, or split into blocks of BlockCells cells.
+vtkSmartPointer<vtkNonOverlappingAMR> NewInput(bool split)
+{
+  vtkSmartPointer<vtkNonOverlappingAMR> input = vtkSmartPointer<vtkNonOverlappingAMR>::New();
+  if (!split)
+  {
+    int numberOfBlocks = 1;
+    input->Initialize(1, &numberOfBlocks);
+    const int origin[3] = { 0, 0, 0 };
+    input->SetDataSet(0, 0, NewBlock(origin, GridCells));
+    return input;
+  }
+
+  int numberOfBlocks = 1;
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    numberOfBlocks *= GridCells[cc] / BlockCells;
+  }
+  input->Initialize(1, &numberOfBlocks);
+  const int cells[3] = { BlockCells, BlockCells, BlockCells };
+  unsigned int blockId = 0;
+  for (int z = 0; z < GridCells[2]; z += BlockCells)
+  {
+    for (int y = 0; y < GridCells[1]; y += BlockCells)
+    {
+      for (int x = 0; x < GridCells[0]; x += BlockCells)
+      {
+        const int origin[3] = { x, y, z };
+        input->SetDataSet(0, blockId++, NewBlock(origin, cells));
+      }
+    }
+  }
+  return input;
+}
+
+// Returns the fragments in the order of their ids.
+bool GetFragments(vtkNonOverlappingAMR* input, std::vector<Fragment>& fragments)
+{
+  vtkNew<vtkMaterialInterfaceFilter> filter;
+  filter->SetInputData(input);
+  filter->SelectMaterialArray("Material");
+  filter->Update();
+
+  vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::SafeDownCast(filter->GetOutputDataObject(1));
+  vtkPolyData* centers = output ? vtkPolyData::SafeDownCast(output->GetBlock(0)) : NULL;
+  vtkDataArray* ids = centers ? centers->GetPointData()->GetArray("Id") : NULL;
+  vtkDataArray* volumes = centers ? centers->GetPointData()->GetArray("Volume") : NULL;
+  if (!ids || !volumes)
+  {
+    cerr << "ERROR: No fragment statistics." << endl;
+    return false;
+  }
+  fragments.resize(centers->GetNumberOfPoints());
+  for (vtkIdType cc = 0; cc < centers->GetNumberOfPoints(); ++cc)
+  {
+    fragments[cc].Id = static_cast<int>(ids->GetTuple1(cc));
+    fragments[cc].Volume = volumes->GetTuple1(cc);
+    centers->GetPoint(cc, fragments[cc].Center);
+    if (fragments[cc].Id != cc)
+    {
+      cerr << "ERROR: Fragment " << cc << " has id " << fragments[cc].Id << "." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsSameFragment(const Fragment& fragment, const Fragment& other)
+{
+  return std::fabs(fragment.Volume - other.Volume) <= 1e-9 * other.Volume &&
+    vtkMath::Distance2BetweenPoints(fragment.Center, other.Center) <= 1e-12;
+}
+}
+
+int TestMaterialInterfaceFilter(int, char* [])
+{
+  vtkNew<vtkDummyController> controller;
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+
+  bool success = true;
+  std::vector<Fragment> expected;
+  if (!GetFragments(NewInput(false), expected) ||
+    expected.size() != static_cast<size_t>(NumberOfFragments))
+  {
+    cerr << "ERROR: Serial labelling found " << expected.size() << " fragments instead of "
+         << NumberOfFragments << "." << endl;
+    success = false;
+  }
+
+  // Every id designates the same fragment in all runs, whatever the order in
+  // which the threads labelled and stitched the blocks.
+  vtkSmartPointer<vtkNonOverlappingAMR> input = NewInput(true);
+  std::vector<int> idMap;
+  for (int run = 0; success && run < NumberOfRuns; ++run)
+  {
+    std::vector<Fragment> fragments;
+    if (!GetFragments(input, fragments) || fragments.size() != expected.size())
+    {
+      cerr << "ERROR: Run " << run << " found " << fragments.size() << " fragments instead of "
+           << expected.size() << "." << endl;
+      success = false;
+      break;
+    }
+    for (size_t cc = 0; cc < expected.size(); ++cc)
+    {
+      int id = -1;
+      for (size_t kk = 0; kk < fragments.size(); ++kk)
+      {
+        if (IsSameFragment(fragments[kk], expected[cc]))
+        {
+          id = fragments[kk].Id;
+          break;
+        }
+      }
+      if (run == 0)
+      {
+        idMap.push_back(id);
+      }
+      if (id < 0 || id != idMap[cc])
+      {
+        cerr << "ERROR: Run " << run << " gave fragment " << expected[cc].Id << " of volume "
+             << expected[cc].Volume << " id " << id << "." << endl;
+        success = false;
+      }
+    }
+  }
+  std::sort(idMap.begin(), idMap.end());
+  if (std::unique(idMap.begin(), idMap.end()) != idMap.end())
+  {
+    cerr << "ERROR: Fragments were merged." << endl;
+    success = false;
+  }
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,293 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVArrayCalculator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkArrayCalculator.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVArrayCalculator.h"
+#include "vtkPVExpressionEvaluator.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+const vtkIdType NumberOfPoints = 10000;
+
+// Exposes the native evaluation so that the tests can tell whether it was
+// used or whether the calculator fell back to vtkFunctionParser.
+class vtkTestArrayCalculator : public vtkPVArrayCalculator
+{
+public:
+  static vtkTestArrayCalculator* New();
+  vtkTypeMacro(vtkTestArrayCalculator, vtkPVArrayCalculator);
+
+  bool EvaluatePointDataNatively(vtkPolyData* input, vtkDataObject* output)
+  {
+    this->UpdateArrayAndVariableNames(input, input->GetPointData());
+    return this->EvaluateNatively(input, output, vtkDataObject::POINT);
+  }
+
+protected:
+  vtkTestArrayCalculator() {}
+  ~vtkTestArrayCalculator() override {}
+};
+vtkStandardNewMacro(vtkTestArrayCalculator);
+
+// Points with scalars a and b, b being zero or negative for some points, and
+// a 3 component vector v.
+vtkSmartPointer<vtkPolyData> NewInput()
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> a;
+  a->SetName("a");
+  vtkNew<vtkDoubleArray> b;
+  b->SetName("b");
+  vtkNew<vtkDoubleArray> v;
+  v->SetName("v");
+  v->SetNumberOfComponents(3);
+  for (vtkIdType cc = 0; cc < NumberOfPoints; ++cc)
+  {
+    points->InsertNextPoint(0.001 * cc, std::sin(0.01 * cc), 1.0);
+    a->InsertNextValue(0.0007 * cc - 3.0);
+    b->InsertNextValue(static_cast<double>(cc % 7) - 3.0);
+    v->InsertNextTuple3(std::sin(0.1 * cc), std::cos(0.1 * cc), static_cast<double>(cc % 5));
+  }
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(points.GetPointer());
+  input->GetPointData()->AddArray(a.GetPointer());
+  input->GetPointData()->AddArray(b.GetPointer());
+  input->GetPointData()->AddArray(v.GetPointer());
+  return input;
+}
+
+bool IsClose(double value, double expected)
+{
+  return std::fabs(value - expected) <= 1e-10 * std::max(1.0, std::fabs(expected));
+}
+
+bool HaveSameValues(vtkDataArray* array, vtkDataArray* expected)
+{
+  if (!array || !expected || array->GetNumberOfTuples() != expected->GetNumberOfTuples() ||
+    array->GetNumberOfComponents() != expected->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < expected->GetNumberOfTuples(); ++cc)
+  {
+    for (int kk = 0; kk < expected->GetNumberOfComponents(); ++kk)
+    {
+      if (!IsClose(array->GetComponent(cc, kk), expected->GetComponent(cc, kk)))
+      {
+        cerr << "  tuple " << cc << ", component " << kk << ": " << array->GetComponent(cc, kk)
+             << " instead of " << expected->GetComponent(cc, kk) << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Computes function with vtkPVArrayCalculator and checks that the result
+// matches the one of vtkArrayCalculator, i.e. of vtkFunctionParser, and that
+// it was computed natively if expected.
+bool CheckCalculator(vtkPolyData* input, const char* function, bool native)
+{
+  vtkNew<vtkTestArrayCalculator> calculator;
+  calculator->SetInputData(input);
+  calculator->SetFunction(function);
+  calculator->SetResultArrayName("Result");
+  calculator->ReplaceInvalidValuesOn();
+  calculator->SetReplacementValue(-1.0);
+
+  vtkNew<vtkPolyData> nativeOutput;
+  if (calculator->EvaluatePointDataNatively(input, nativeOutput.GetPointer()) != native)
+  {
+    cerr << "ERROR: '" << function << "' was " << (native ? "not " : "")
+         << "evaluated natively." << endl;
+    return false;
+  }
+  calculator->Update();
+
+  vtkNew<vtkArrayCalculator> reference;
+  reference->SetInputData(input);
+  reference->SetFunction(function);
+  reference->SetResultArrayName("Result");
+  reference->ReplaceInvalidValuesOn();
+  reference->SetReplacementValue(-1.0);
+  reference->AddCoordinateScalarVariable("coordsX", 0);
+  reference->AddCoordinateScalarVariable("coordsY", 1);
+  reference->AddScalarArrayName("a");
+  reference->AddScalarArrayName("b");
+  reference->AddScalarVariable("v_X", "v", 0);
+  reference->AddScalarVariable("v_Y", "v", 1);
+  reference->AddScalarVariable("v_Z", "v", 2);
+  reference->AddVectorArrayName("v");
+  reference->AddCoordinateVectorVariable("coords", 0, 1, 2);
+  reference->Update();
+
+  vtkDataArray* expected =
+    vtkDataSet::SafeDownCast(reference->GetOutput())->GetPointData()->GetArray("Result");
+  vtkDataArray* result =
+    vtkDataSet::SafeDownCast(calculator->GetOutput())->GetPointData()->GetArray("Result");
+  if (!HaveSameValues(result, expected) ||
+    (native && !HaveSameValues(nativeOutput->GetPointData()->GetArray("Result"), expected)))
+  {
+    cerr << "ERROR: '" << function << "' doesn't match vtkFunctionParser." << endl;
+    return false;
+  }
+  return true;
+}
+
+bool Evaluate(vtkPolyData* input, const char* expression, int syntax,
+  vtkSmartPointer<vtkDoubleArray>& result, std::string& error)
+{
+  vtkNew<vtkPVExpressionEvaluator> evaluator;
+  evaluator->SetExpression(expression);
+  evaluator->SetSyntax(syntax);
+  std::vector<vtkPVExpressionEvaluator::Scope> scopes(1);
+  scopes[0].NumberOfElements = input->GetNumberOfPoints();
+  scopes[0].AddArrays(input->GetPointData());
+  std::vector<vtkSmartPointer<vtkDoubleArray> > results;
+  const bool success = evaluator->Evaluate(scopes, results);
+  error = evaluator->GetErrorMessage();
+  if (success)
+  {
+    result = results[0];
+  }
+  return success;
+}
+
+// Evaluates expression and compares it, element by element, with expected
+// computed by the test from the input arrays.
+bool CheckExpression(vtkPolyData* input, const char* expression, int syntax,
+  double (*expected)(double a, double b, const double v[3], vtkIdType id))
+{
+  vtkSmartPointer<vtkDoubleArray> result;
+  std::string error;
+  if (!Evaluate(input, expression, syntax, result, error))
+  {
+    cerr << "ERROR: '" << expression << "' failed: " << error << endl;
+    return false;
+  }
+  vtkDataArray* a = input->GetPointData()->GetArray("a");
+  vtkDataArray* b = input->GetPointData()->GetArray("b");
+  vtkDataArray* v = input->GetPointData()->GetArray("v");
+  for (vtkIdType cc = 0; cc < input->GetNumberOfPoints(); ++cc)
+  {
+    const double value = expected(a->GetTuple1(cc), b->GetTuple1(cc), v->GetTuple3(cc), cc);
+    if (!IsClose(result->GetValue(cc), value))
+    {
+      cerr << "ERROR: '" << expression << "' is " << result->GetValue(cc) << " instead of "
+           << value << " for element " << cc << "." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CheckInvalid(vtkPolyData* input, const char* expression, int syntax)
+{
+  vtkSmartPointer<vtkDoubleArray> result;
+  std::string error;
+  if (Evaluate(input, expression, syntax, result, error) || error.empty())
+  {
+    cerr << "ERROR: '" << expression << "' was not reported as invalid." << endl;
+    return false;
+  }
+  return true;
+}
+
+const int Python = vtkPVExpressionEvaluator::PYTHON_SYNTAX;
+const int FunctionParser = vtkPVExpressionEvaluator::FUNCTION_PARSER_SYNTAX;
+}
+
+int TestPVArrayCalculator(int, char* [])
+{
+  vtkSmartPointer<vtkPolyData> input = NewInput();
+  bool success = true;
+
+  // Operator precedence and associativity.
+  success &= CheckExpression(input, "2 + 3 * 4 ** 2", Python,
+    [](double, double, const double*, vtkIdType) { return 50.0; });
+  success &= CheckExpression(input, "2 + 3 * 4 ^ 2", FunctionParser,
+    [](double, double, const double*, vtkIdType) { return 50.0; });
+  success &= CheckExpression(input, "-2 ** 2", Python,
+    [](double, double, const double*, vtkIdType) { return -4.0; });
+  success &= CheckExpression(input, "2 ** 3 ** 2", Python,
+    [](double, double, const double*, vtkIdType) { return 512.0; });
+  success &= CheckExpression(input, "2 ** -1", Python,
+    [](double, double, const double*, vtkIdType) { return 0.5; });
+  success &= CheckExpression(input, "a - b - 1", FunctionParser,
+    [](double a, double b, const double*, vtkIdType) { return a - b - 1; });
+  success &= CheckExpression(input, "a / 2 / 4", FunctionParser,
+    [](double a, double, const double*, vtkIdType) { return a / 8; });
+  success &= CheckExpression(input, "(a + b) * 2", FunctionParser,
+    [](double a, double b, const double*, vtkIdType) { return (a + b) * 2; });
+  success &= CheckExpression(input, "1 + 2 < 4", Python,
+    [](double, double, const double*, vtkIdType) { return 1.0; });
+  success &= CheckExpression(input, "-1 < a < 1", Python,
+    [](double a, double, const double*, vtkIdType) { return (-1 < a && a < 1) ? 1.0 : 0.0; });
+  success &= CheckExpression(input, "(a > 0) & (b > 0) | (b < -2)", Python,
+    [](double a, double b, const double*, vtkIdType) {
+      return ((a > 0 && b > 0) || b < -2) ? 1.0 : 0.0;
+    });
+
+  // Vector and scalar variables mixed.
+  success &= CheckExpression(input, "v[:,1] * a + mag(v) - id", Python,
+    [](double a, double, const double* v, vtkIdType id) {
+      return v[1] * a + std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]) - id;
+    });
+  success &= CheckExpression(input, "a - mean(a) + max(v[:,2])", Python,
+    [](double a, double, const double*, vtkIdType) {
+      return a - (0.0007 * (NumberOfPoints - 1) / 2 - 3.0) + 4.0;
+    });
+
+  // Invalid expressions.
+  const char* invalidPython[] = { "a +", "(a", "a b", "a $ b", "foo(a)", "1..2", "\"a",
+    "unknown + 1", "v * 2", "v[:,3]", "a[:,1]", "mag(a + b)", "a < 0 & b", NULL };
+  for (int cc = 0; invalidPython[cc] != NULL; ++cc)
+  {
+    success &= CheckInvalid(input, invalidPython[cc], Python);
+  }
+  const char* invalidFunctionParser[] = { "a < b", "~a", "2 ^ 3 ^ 2", "-a ^ 2", "min(a)",
+    "isin(a, [1])", "v[:,0]", NULL };
+  for (int cc = 0; invalidFunctionParser[cc] != NULL; ++cc)
+  {
+    success &= CheckInvalid(input, invalidFunctionParser[cc], FunctionParser);
+  }
+
+  // vtkPVArrayCalculator computes the same values as vtkFunctionParser, both
+  // when it evaluates natively and when it falls back to the superclass.
+  const char* nativeFunctions[] = { "a + b * 2", "(a + b) * 2", "a - b - 1", "2 * a ^ 2",
+    "a ^ 2 * b", "-a + b", "a / b", "mag(v) * a", "v_Y * a + coordsX", "sqrt(b) + ln(b)",
+    "abs(a - b) + exp(coordsY)", "min(a, b) + max(a, b)", "sin(a) * cos(b) + tan(v_Z)", NULL };
+  for (int cc = 0; nativeFunctions[cc] != NULL; ++cc)
+  {
+    success &= CheckCalculator(input, nativeFunctions[cc], true);
+  }
+  const char* fallbackFunctions[] = { "v * a", "a * v + coords", "-a ^ 2", NULL };
+  for (int cc = 0; fallbackFunctions[cc] != NULL; ++cc)
+  {
+    success &= CheckCalculator(input, fallbackFunctions[cc], false);
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
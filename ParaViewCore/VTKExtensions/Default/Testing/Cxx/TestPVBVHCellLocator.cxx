@@ -0,0 +1,183 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVBVHCellLocator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAppendPolyData.h"
+#include "vtkCell.h"
+#include "vtkGenericCell.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPVBVHCellLocator.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSphereSource.h"
+
+#include <cmath>
+
+namespace
+{
+const int NumberOfRays = 500;
+const double Tolerance = 1e-9;
+
+// Returns the closest intersection of p0-p1 with the cells of dataset, found
+// by testing every cell.
+bool BruteForceIntersect(
+  vtkDataSet* dataset, double p0[3], double p1[3], double& closestT, vtkIdType& closestCell)
+{
+  vtkNew<vtkGenericCell> cell;
+  closestT = VTK_DOUBLE_MAX;
+  closestCell = -1;
+  for (vtkIdType cc = 0; cc < dataset->GetNumberOfCells(); ++cc)
+  {
+    double t, x[3], pcoords[3];
+    int subId;
+    dataset->GetCell(cc, cell.GetPointer());
+    if (cell->IntersectWithLine(p0, p1, Tolerance, t, x, pcoords, subId) && t < closestT)
+    {
+      closestT = t;
+      closestCell = cc;
+    }
+  }
+  return closestCell >= 0;
+}
+
+// Returns the parametric coordinate of the intersection of p0-p1 with cell
+// cellId, or a negative value if they don't intersect.
+double IntersectCell(vtkDataSet* dataset, vtkIdType cellId, double p0[3], double p1[3])
+{
+  vtkNew<vtkGenericCell> cell;
+  dataset->GetCell(cellId, cell.GetPointer());
+  double t, x[3], pcoords[3];
+  int subId;
+  return cell->IntersectWithLine(p0, p1, Tolerance, t, x, pcoords, subId) ? t : -1.0;
+}
+
+// Casts random segments, most of them through the dataset, and compares the
+// hits of the locator with the brute force ones.
+bool CheckRays(vtkPVBVHCellLocator* locator, vtkDataSet* dataset, const char* label)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkGenericCell> cell;
+  int hits = 0;
+  for (int ray = 0; ray < NumberOfRays; ++ray)
+  {
+    double p0[3], p1[3];
+    for (int kk = 0; kk < 3; ++kk)
+    {
+      p0[kk] = random->GetRangeValue(-2.0, 2.0);
+      random->Next();
+      p1[kk] = random->GetRangeValue(-1.5, 1.5);
+      random->Next();
+    }
+    // extend the segment past the dataset.
+    for (int kk = 0; kk < 3; ++kk)
+    {
+      p1[kk] = p0[kk] + 3.0 * (p1[kk] - p0[kk]);
+    }
+
+    double expectedT;
+    vtkIdType expectedCell;
+    const bool expectedHit = BruteForceIntersect(dataset, p0, p1, expectedT, expectedCell);
+
+    double t, x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId = -1;
+    const bool hit =
+      locator->IntersectWithLine(p0, p1, Tolerance, t, x, pcoords, subId, cellId, cell.GetPointer())
+      != 0;
+    if (hit != expectedHit)
+    {
+      cerr << "ERROR: " << label << ": ray " << ray << (hit ? " hit" : " missed")
+           << " the dataset, brute force disagrees." << endl;
+      return false;
+    }
+    if (!hit)
+    {
+      continue;
+    }
+    ++hits;
+    // where the ray goes through an edge, both cells are the closest.
+    if (std::fabs(t - expectedT) > 1e-6 ||
+      (cellId != expectedCell &&
+        std::fabs(IntersectCell(dataset, cellId, p0, p1) - expectedT) > 1e-6))
+    {
+      cerr << "ERROR: " << label << ": ray " << ray << " hit cell " << cellId << " at " << t
+           << " instead of cell " << expectedCell << " at " << expectedT << "." << endl;
+      return false;
+    }
+  }
+  if (hits == 0 || hits == NumberOfRays)
+  {
+    cerr << "ERROR: " << label << ": rays don't test both hits and misses." << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestPVBVHCellLocator(int, char* [])
+{
+  // two nested spheres, so that rays cross several surfaces and the closest
+  // one must be returned.
+  vtkNew<vtkSphereSource> outer;
+  outer->SetRadius(1.0);
+  outer->SetThetaResolution(48);
+  outer->SetPhiResolution(48);
+  vtkNew<vtkSphereSource> inner;
+  inner->SetRadius(0.6);
+  inner->SetCenter(0.1, 0.0, -0.1);
+  inner->SetThetaResolution(32);
+  inner->SetPhiResolution(32);
+  vtkNew<vtkAppendPolyData> append;
+  append->AddInputConnection(outer->GetOutputPort());
+  append->AddInputConnection(inner->GetOutputPort());
+  append->Update();
+
+  vtkNew<vtkPolyData> dataset;
+  dataset->DeepCopy(append->GetOutput());
+
+  bool success = true;
+  const int cellsPerNode[] = { 1, 8, 64 };
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    vtkNew<vtkPVBVHCellLocator> locator;
+    locator->SetDataSet(dataset.GetPointer());
+    locator->SetNumberOfCellsPerNode(cellsPerNode[cc]);
+    locator->Update();
+    if (locator->GetNumberOfNodes() <= 1)
+    {
+      cerr << "ERROR: No tree was built." << endl;
+      success = false;
+      continue;
+    }
+    success &= CheckRays(locator.GetPointer(), dataset.GetPointer(), "initial");
+
+    // moving the points invalidates the tree, Update() rebuilds it.
+    vtkPoints* points = dataset->GetPoints();
+    for (vtkIdType pt = 0; pt < points->GetNumberOfPoints(); ++pt)
+    {
+      double x[3];
+      points->GetPoint(pt, x);
+      points->SetPoint(pt, 0.8 * x[0] + 0.2, x[1], 1.2 * x[2]);
+    }
+    points->Modified();
+    dataset->Modified();
+    locator->Update();
+    success &= CheckRays(locator.GetPointer(), dataset.GetPointer(), "modified");
+
+    dataset->DeepCopy(append->GetOutput());
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
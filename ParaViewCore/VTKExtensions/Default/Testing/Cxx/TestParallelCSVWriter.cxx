@@ -0,0 +1,168 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestParallelCSVWriter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCSVWriter.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPVConfig.h"
+#include "vtkSignedCharArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkTable.h"
+#include "vtkTestUtilities.h"
+
+#ifdef PARAVIEW_USE_MPI
+#include "vtkMPIController.h"
+#else
+#include "vtkDummyController.h"
+#endif
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Every process writes its rows of the table into the same file. The file
+// must be the one the serial writer produces for the whole table.
+
+namespace
+{
+const vtkIdType NumberOfRows = 1000;
+
+// The rows of the table owned by a process. When there are several
+// processes, the first one has none so that the header comes from another.
+void GetLocalRows(int me, int numProcs, vtkIdType& begin, vtkIdType& end)
+{
+  if (numProcs == 1)
+  {
+    begin = 0;
+    end = NumberOfRows;
+    return;
+  }
+  begin = me == 0 ? 0 : NumberOfRows * (me - 1) / (numProcs - 1);
+  end = me == 0 ? 0 : NumberOfRows * me / (numProcs - 1);
+}
+
+vtkSmartPointer<vtkTable> NewTable(vtkIdType begin, vtkIdType end)
+{
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("Id");
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("Value");
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("Vector");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkSignedCharArray> chars;
+  chars->SetName("Char");
+  vtkNew<vtkStringArray> strings;
+  strings->SetName("Label");
+  for (vtkIdType row = begin; row < end; ++row)
+  {
+    ids->InsertNextValue(row);
+    // values of all magnitudes, so that both notations are used.
+    values->InsertNextValue(row / 7.0 * std::pow(10.0, static_cast<int>(row % 13) - 6));
+    vectors->InsertNextTuple3(row * 0.5, -row / 3.0, 1.0 / (row + 1));
+    chars->InsertNextValue(static_cast<signed char>(row % 256 - 128));
+    std::ostringstream label;
+    label << "row " << row << (row % 3 == 0 ? ", with a delimiter" : "");
+    strings->InsertNextValue(label.str());
+  }
+
+  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+  table->AddColumn(ids.GetPointer());
+  table->AddColumn(values.GetPointer());
+  table->AddColumn(vectors.GetPointer());
+  table->AddColumn(chars.GetPointer());
+  table->AddColumn(strings.GetPointer());
+  return table;
+}
+
+std::string ReadFile(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), ios::in | ios::binary);
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+void Write(vtkTable* table, const std::string& fileName, vtkMultiProcessController* controller,
+  bool scientific)
+{
+  vtkNew<vtkCSVWriter> writer;
+  writer->SetInputData(table);
+  writer->SetFileName(fileName.c_str());
+  writer->SetController(controller);
+  writer->SetUseScientificNotation(scientific);
+  writer->SetPrecision(scientific ? 12 : 5);
+  writer->Write();
+}
+}
+
+int TestParallelCSVWriter(int argc, char* argv[])
+{
+#ifdef PARAVIEW_USE_MPI
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv, 0);
+#else
+  vtkDummyController* controller = vtkDummyController::New();
+#endif
+  vtkMultiProcessController::SetGlobalController(controller);
+  const int me = controller->GetLocalProcessId();
+  const int numProcs = controller->GetNumberOfProcesses();
+
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string prefix = std::string(tempDir) + "/TestParallelCSVWriter";
+  delete[] tempDir;
+
+  vtkIdType begin, end;
+  GetLocalRows(me, numProcs, begin, end);
+  vtkSmartPointer<vtkTable> localTable = NewTable(begin, end);
+  vtkSmartPointer<vtkTable> table = NewTable(0, NumberOfRows);
+
+  int success = 1;
+  for (int scientific = 0; scientific < 2; ++scientific)
+  {
+    const std::string parallelFile = prefix + "Parallel.csv";
+    const std::string serialFile = prefix + "Serial.csv";
+    Write(localTable, parallelFile, controller, scientific != 0);
+    if (me == 0)
+    {
+      Write(table, serialFile, NULL, scientific != 0);
+    }
+    controller->Barrier();
+
+    if (me == 0)
+    {
+      const std::string expected = ReadFile(serialFile);
+      const std::string contents = ReadFile(parallelFile);
+      if (expected.empty() || contents != expected)
+      {
+        cerr << "ERROR: File written by " << numProcs << " processes differs from the serial one"
+             << (scientific ? " in scientific notation." : ".") << endl;
+        success = 0;
+      }
+    }
+    controller->Broadcast(&success, 1, 0);
+  }
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+#ifdef PARAVIEW_USE_MPI
+  controller->Finalize();
+#endif
+  controller->Delete();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -20,6 +20,7 @@
 #include "vtkDataArray.h"
 #include "vtkErrorCode.h"
 #include "vtkInformation.h"
+#include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
@@ -28,10 +29,14 @@
 #include "vtkSmartPointer.h"
 #include "vtkTable.h"
 
+#include <cstdio>
+#include <limits>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 vtkStandardNewMacro(vtkCSVWriter);
+vtkCxxSetObjectMacro(vtkCSVWriter, Controller, vtkMultiProcessController);
 //-----------------------------------------------------------------------------
 vtkCSVWriter::vtkCSVWriter()
 {
@@ -44,6 +49,7 @@ vtkCSVWriter::vtkCSVWriter()
   this->FileName = 0;
   this->Precision = 5;
   this->UseScientificNotation = true;
+  this->Controller = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -52,6 +58,7 @@ vtkCSVWriter::~vtkCSVWriter()
   this->SetStringDelimiter(0);
   this->SetFieldDelimiter(0);
   this->SetFileName(0);
+  this->SetController(0);
   delete this->Stream;
 }
 
@@ -74,6 +81,8 @@ bool vtkCSVWriter::OpenFile()
 
   vtkDebugMacro(<< "Opening file for writing...");
 
+  delete this->Stream;
+  this->Stream = 0;
   ofstream* fptr = new ofstream(this->FileName, ios::out);
 
   if (fptr->fail())
@@ -88,118 +97,126 @@ bool vtkCSVWriter::OpenFile()
   return true;
 }
 
-//-----------------------------------------------------------------------------
-template <class iterT>
-void vtkCSVWriterGetDataString(
-  iterT* iter, vtkIdType tupleIndex, ofstream* stream, vtkCSVWriter* writer, bool* first)
+namespace
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex * numComps;
-  for (int cc = 0; cc < numComps; cc++)
+// Formats values into a character buffer with the same rules as an ostream
+// set up with the writer's precision and notation, without going through
+// the stream machinery for every value.
+struct vtkCSVWriterFormat
+{
+  vtkCSVWriterFormat(vtkCSVWriter* writer)
+    : Writer(writer)
+    , Precision(writer->GetPrecision())
+    , RealFormat(writer->GetUseScientificNotation() ? "%.*e" : "%.*g")
+    , Delimiter(writer->GetFieldDelimiter() ? writer->GetFieldDelimiter() : "")
+    , Buffer(64)
   {
-    if ((index + cc) < iter->GetNumberOfValues())
+  }
+
+  void AppendReal(std::string& out, double value)
+  {
+    int size = snprintf(&this->Buffer[0], this->Buffer.size(), this->RealFormat, this->Precision,
+      value);
+    if (size >= static_cast<int>(this->Buffer.size()))
     {
-      if (*first == false)
-      {
-        (*stream) << writer->GetFieldDelimiter();
-      }
-      *first = false;
-      (*stream) << iter->GetValue(index + cc);
+      this->Buffer.resize(size + 1);
+      size = snprintf(&this->Buffer[0], this->Buffer.size(), this->RealFormat, this->Precision,
+        value);
     }
-    else
+    out.append(&this->Buffer[0], size > 0 ? size : 0);
+  }
+
+  void AppendInteger(std::string& out, long long value)
+  {
+    int size = snprintf(&this->Buffer[0], this->Buffer.size(), "%lld", value);
+    out.append(&this->Buffer[0], size);
+  }
+
+  void AppendInteger(std::string& out, unsigned long long value)
+  {
+    int size = snprintf(&this->Buffer[0], this->Buffer.size(), "%llu", value);
+    out.append(&this->Buffer[0], size);
+  }
+
+  vtkCSVWriter* Writer;
+  int Precision;
+  const char* RealFormat;
+  std::string Delimiter;
+  std::vector<char> Buffer;
+};
+
+// Values of types that are neither integers nor reals are formatted by
+// an ostream.
+template <class T, bool IsInteger = std::numeric_limits<T>::is_integer,
+  bool IsReal = std::is_floating_point<T>::value>
+struct vtkCSVWriterValue
+{
+  static void Append(std::string& out, const T& value, vtkCSVWriterFormat& format)
+  {
+    std::ostringstream stream;
+    if (format.Writer->GetUseScientificNotation())
     {
-      if (*first == false)
-      {
-        (*stream) << writer->GetFieldDelimiter();
-      }
-      *first = false;
+      stream << std::scientific;
     }
+    stream << std::setprecision(format.Precision) << value;
+    out += stream.str();
   }
-}
+};
 
-//-----------------------------------------------------------------------------
-template <>
-void vtkCSVWriterGetDataString(vtkArrayIteratorTemplate<vtkStdString>* iter, vtkIdType tupleIndex,
-  ofstream* stream, vtkCSVWriter* writer, bool* first)
+// Integers, including char types which are written as numbers.
+template <class T>
+struct vtkCSVWriterValue<T, true, false>
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex * numComps;
-  for (int cc = 0; cc < numComps; cc++)
+  static void Append(std::string& out, const T& value, vtkCSVWriterFormat& format)
   {
-    if ((index + cc) < iter->GetNumberOfValues())
+    if (std::numeric_limits<T>::is_signed)
     {
-      if (*first == false)
-      {
-        (*stream) << writer->GetFieldDelimiter();
-      }
-      *first = false;
-      (*stream) << writer->GetString(iter->GetValue(index + cc));
+      format.AppendInteger(out, static_cast<long long>(value));
     }
     else
     {
-      if (*first == false)
-      {
-        (*stream) << writer->GetFieldDelimiter();
-      }
-      *first = false;
+      format.AppendInteger(out, static_cast<unsigned long long>(value));
     }
   }
-}
+};
+
+template <class T>
+struct vtkCSVWriterValue<T, false, true>
+{
+  static void Append(std::string& out, const T& value, vtkCSVWriterFormat& format)
+  {
+    format.AppendReal(out, static_cast<double>(value));
+  }
+};
 
-//-----------------------------------------------------------------------------
 template <>
-void vtkCSVWriterGetDataString(vtkArrayIteratorTemplate<char>* iter, vtkIdType tupleIndex,
-  ofstream* stream, vtkCSVWriter* writer, bool* first)
+struct vtkCSVWriterValue<vtkStdString, false, false>
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex * numComps;
-  for (int cc = 0; cc < numComps; cc++)
+  static void Append(std::string& out, const vtkStdString& value, vtkCSVWriterFormat& format)
   {
-    if ((index + cc) < iter->GetNumberOfValues())
-    {
-      if (*first == false)
-      {
-        (*stream) << writer->GetFieldDelimiter();
-      }
-      *first = false;
-      (*stream) << static_cast<int>(iter->GetValue(index + cc));
-    }
-    else
-    {
-      if (*first == false)
-      {
-        (*stream) << writer->GetFieldDelimiter();
-      }
-      *first = false;
-    }
+    out += format.Writer->GetString(value);
   }
+};
 }
 
 //-----------------------------------------------------------------------------
-template <>
-void vtkCSVWriterGetDataString(vtkArrayIteratorTemplate<unsigned char>* iter, vtkIdType tupleIndex,
-  ofstream* stream, vtkCSVWriter* writer, bool* first)
+template <class iterT>
+void vtkCSVWriterGetDataString(iterT* iter, vtkIdType tupleIndex, std::string& buffer,
+  vtkCSVWriterFormat& format, bool* first)
 {
+  typedef typename iterT::ValueType ValueType;
   int numComps = iter->GetNumberOfComponents();
   vtkIdType index = tupleIndex * numComps;
   for (int cc = 0; cc < numComps; cc++)
   {
-    if ((index + cc) < iter->GetNumberOfValues())
+    if (*first == false)
     {
-      if (*first == false)
-      {
-        (*stream) << writer->GetFieldDelimiter();
-      }
-      *first = false;
-      (*stream) << static_cast<int>(iter->GetValue(index + cc));
+      buffer += format.Delimiter;
     }
-    else
+    *first = false;
+    if ((index + cc) < iter->GetNumberOfValues())
     {
-      if (*first == false)
-      {
-        (*stream) << writer->GetFieldDelimiter();
-      }
-      *first = false;
+      vtkCSVWriterValue<ValueType>::Append(buffer, iter->GetValue(index + cc), format);
     }
   }
 }
@@ -235,7 +252,8 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
 {
   vtkIdType numRows = table->GetNumberOfRows();
   vtkDataSetAttributes* dsa = table->GetRowData();
-  if (!this->OpenFile())
+  bool parallel = this->Controller && this->Controller->GetNumberOfProcesses() > 1;
+  if (!parallel && !this->OpenFile())
   {
     return;
   }
@@ -245,6 +263,7 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
   int cc;
   int numArrays = dsa->GetNumberOfArrays();
   bool first = true;
+  std::string header;
   // Write headers:
   for (cc = 0; cc < numArrays; cc++)
   {
@@ -253,7 +272,7 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
     {
       if (!first)
       {
-        (*this->Stream) << this->FieldDelimiter;
+        header += this->FieldDelimiter;
       }
       first = false;
 
@@ -263,22 +282,24 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
       {
         array_name << ":" << comp;
       }
-      (*this->Stream) << this->GetString(array_name.str());
+      header += this->GetString(array_name.str());
     }
     vtkArrayIterator* iter = array->NewIterator();
     columnsIters.push_back(iter);
     iter->Delete();
   }
-  (*this->Stream) << "\n";
+  header += "\n";
 
-  // push the floating point precision/notation type.
-  if (this->UseScientificNotation)
+  if (!parallel)
   {
-    (*this->Stream) << std::scientific;
+    (*this->Stream) << header;
   }
 
-  (*this->Stream) << std::setprecision(this->Precision);
-
+  // Rows are formatted in memory; when writing on our own, the buffer is
+  // flushed to the file once it gets large.
+  const size_t flushSize = 1 << 20;
+  std::string rows;
+  vtkCSVWriterFormat format(this);
   for (vtkIdType index = 0; index < numRows; index++)
   {
     first = true;
@@ -288,13 +309,107 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
       switch ((*iter)->GetDataType())
       {
         vtkArrayIteratorTemplateMacro(vtkCSVWriterGetDataString(
-          static_cast<VTK_TT*>(iter->GetPointer()), index, this->Stream, this, &first));
+          static_cast<VTK_TT*>(iter->GetPointer()), index, rows, format, &first));
       }
     }
-    (*this->Stream) << "\n";
+    rows += "\n";
+    if (!parallel && rows.size() > flushSize)
+    {
+      this->Stream->write(rows.data(), rows.size());
+      rows.clear();
+    }
   }
 
+  if (parallel)
+  {
+    this->WriteTableInParallel(header, rows, numRows);
+    return;
+  }
+
+  this->Stream->write(rows.data(), rows.size());
   this->Stream->close();
+  delete this->Stream;
+  this->Stream = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkCSVWriter::WriteTableInParallel(
+  const std::string& header, const std::string& rows, vtkIdType numRows)
+{
+  const int numProcs = this->Controller->GetNumberOfProcesses();
+  const int myId = this->Controller->GetLocalProcessId();
+
+  vtkIdType localSizes[3] = { numRows, static_cast<vtkIdType>(header.size()),
+    static_cast<vtkIdType>(rows.size()) };
+  std::vector<vtkIdType> sizes(3 * numProcs);
+  this->Controller->AllGather(localSizes, &sizes[0], 3);
+
+  // The header comes from the first process with rows, and nothing is
+  // written when no process has any.
+  int headerProc = 0;
+  while (headerProc < numProcs && sizes[3 * headerProc] == 0)
+  {
+    ++headerProc;
+  }
+  if (headerProc == numProcs)
+  {
+    return;
+  }
+
+  // Exclusive scan of the size of the rows.
+  vtkIdType offset = sizes[3 * headerProc + 1];
+  for (int cc = 0; cc < myId; ++cc)
+  {
+    offset += sizes[3 * cc + 2];
+  }
+
+  // The root creates (or truncates) the file before anyone writes to it.
+  int status = 1;
+  if (myId == 0)
+  {
+    status = this->OpenFile() ? 1 : 0;
+    if (status)
+    {
+      this->Stream->close();
+      delete this->Stream;
+      this->Stream = 0;
+    }
+  }
+  this->Controller->Broadcast(&status, 1, 0);
+  if (!status)
+  {
+    this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
+    return;
+  }
+
+  int error = 0;
+  if (myId == headerProc || !rows.empty())
+  {
+    std::fstream file(this->FileName, ios::in | ios::out | ios::binary);
+    if (myId == headerProc)
+    {
+      file.seekp(0);
+      file.write(header.data(), header.size());
+    }
+    if (!rows.empty())
+    {
+      file.seekp(offset);
+      file.write(rows.data(), rows.size());
+    }
+    file.close();
+    error = file.fail() ? 1 : 0;
+  }
+
+  int globalError = 0;
+  this->Controller->AllReduce(&error, &globalError, 1, vtkCommunicator::MAX_OP);
+  if (globalError)
+  {
+    if (error)
+    {
+      vtkErrorMacro("Failed to write rows to " << this->FileName);
+    }
+    this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -309,4 +424,5 @@ void vtkCSVWriter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "FileName: " << (this->FileName ? this->FileName : "none") << endl;
   os << indent << "UseScientificNotation: " << this->UseScientificNotation << endl;
   os << indent << "Precision: " << this->Precision << endl;
+  os << indent << "Controller: " << this->Controller << endl;
 }
@@ -16,6 +16,14 @@
  * @class   vtkCSVWriter
  * @brief   CSV writer for vtkTable
  * Writes a vtkTable as a delimited text file (such as CSV).
+ *
+ * When a Controller with more than one process is set, every process must
+ * call Write() with its local table. Each process formats its rows into a
+ * memory buffer, computes where they start in the file from the sizes of
+ * the buffers of the processes before it, and writes them into the shared
+ * file concurrently. The header is taken from the first process that has
+ * rows, matching what vtkPVMergeTables produces when gathering the tables
+ * on the root node.
 */
 
 #ifndef vtkCSVWriter_h
@@ -24,6 +32,9 @@
 #include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
 #include "vtkWriter.h"
 
+#include <string> // for std::string
+
+class vtkMultiProcessController;
 class vtkStdString;
 class vtkTable;
 
@@ -86,6 +97,16 @@ public:
   vtkBooleanMacro(UseScientificNotation, bool);
   //@}
 
+  //@{
+  /**
+   * Get/Set the controller used to write a single file from all processes.
+   * When NULL (default) or when it has a single process, the local table is
+   * written on its own.
+   */
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+  //@}
+
   //@{
   /**
    * Internal method: decortes the "string" with the "StringDelimiter" if
@@ -103,6 +124,12 @@ protected:
   void WriteData() VTK_OVERRIDE;
   virtual void WriteTable(vtkTable* rectilinearGrid);
 
+  /**
+   * Writes the formatted header and rows of every process to the shared
+   * file. The header line is empty on processes without columns.
+   */
+  void WriteTableInParallel(const std::string& header, const std::string& rows, vtkIdType numRows);
+
   // see algorithm for more info.
   // This writer takes in vtkTable.
   int FillInputPortInformation(int port, vtkInformation* info) VTK_OVERRIDE;
@@ -113,6 +140,7 @@ protected:
   bool UseStringDelimiter;
   int Precision;
   bool UseScientificNotation;
+  vtkMultiProcessController* Controller;
 
   ofstream* Stream;
 
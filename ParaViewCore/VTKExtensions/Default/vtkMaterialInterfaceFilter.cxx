@@ -54,6 +54,7 @@
 #include "vtkMaterialInterfaceToProcMap.h"
 #include "vtkPointAccumulator.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnsignedIntArray.h"
 // IO & IPC
 #include "vtkDataSetWriter.h"
@@ -70,6 +71,7 @@
 #include "vtkOBBTree.h"
 #include "vtkTriangleFilter.h"
 // STL
+#include <atomic>
 #include <fstream>
 using std::ofstream;
 #include <sstream>
@@ -243,8 +245,11 @@ int GetEnabledArrayNames(vtkDataArraySelection* das, vector<string>& names)
 // A class that implements an equivalent set.  It is used to combine fragments
 // from different processes.
 //
-// I believe that this class is a strictly ordered tree of equivalences.
-// Every member points to its own id or an id smaller than itself.
+// This class is a union-find forest that is strictly ordered: every member
+// points to its own id or an id smaller than itself, so that the root of a
+// set is its smallest member.  Roots are found with path compression, which
+// keeps the trees shallow as equivalences between blocks and processes are
+// added.
 class vtkMaterialInterfaceEquivalenceSet
 {
 public:
@@ -288,7 +293,8 @@ private:
 
   // Return the id of the equivalent set.
   int GetReference(int memberId);
-  void EquateInternal(int id1, int id2);
+  // Return the root of the member's tree, compressing the path to it.
+  int FindRoot(int memberId);
 };
 
 //----------------------------------------------------------------------------
@@ -339,16 +345,11 @@ void vtkMaterialInterfaceEquivalenceSet::Print()
 // Return the id of the equivalent set.
 int vtkMaterialInterfaceEquivalenceSet::GetEquivalentSetId(int memberId)
 {
-  int ref;
-
-  ref = this->GetReference(memberId);
-  while (!this->Resolved && ref != memberId)
+  if (this->Resolved)
   {
-    memberId = ref;
-    ref = this->GetReference(memberId);
+    return this->GetReference(memberId);
   }
-
-  return ref;
+  return this->FindRoot(memberId);
 }
 
 //----------------------------------------------------------------------------
@@ -362,6 +363,30 @@ int vtkMaterialInterfaceEquivalenceSet::GetReference(int memberId)
   return this->EquivalenceArray->GetValue(memberId);
 }
 
+//----------------------------------------------------------------------------
+int vtkMaterialInterfaceEquivalenceSet::FindRoot(int memberId)
+{
+  if (memberId >= this->EquivalenceArray->GetNumberOfTuples())
+  { // We might consider this an error ...
+    return memberId;
+  }
+  int* refs = this->EquivalenceArray->GetPointer(0);
+  int root = memberId;
+  while (refs[root] != root)
+  {
+    root = refs[root];
+  }
+  // Point every member on the path directly to the root.  The root is the
+  // smallest member so the ordering is preserved.
+  while (refs[memberId] != root)
+  {
+    int next = refs[memberId];
+    refs[memberId] = root;
+    memberId = next;
+  }
+  return root;
+}
+
 //----------------------------------------------------------------------------
 // Makes two new or existing ids equivalent.
 // If the array is too small, the range of ids is increased until it contains
@@ -377,56 +402,32 @@ void vtkMaterialInterfaceEquivalenceSet::AddEquivalence(int id1, int id2)
   int num = this->EquivalenceArray->GetNumberOfTuples();
 
   // Expand the range to include both ids.
-  while (num <= id1 || num <= id2)
+  int newNum = (id1 > id2 ? id1 : id2) + 1;
+  if (newNum > num)
   {
+    // Inserting the last value grows the array geometrically.
+    this->EquivalenceArray->InsertValue(newNum - 1, newNum - 1);
+    int* refs = this->EquivalenceArray->GetPointer(0);
     // All values inserted are equivalent to only themselves.
-    this->EquivalenceArray->InsertNextTuple1(num);
-    ++num;
+    for (int ii = num; ii < newNum; ++ii)
+    {
+      refs[ii] = ii;
+    }
   }
 
   // Our rule for references in the equivalent set is that
   // all elements must point to a member equal to or smaller
-  // than itself.
-
-  // The only problem we could encounter is changing a reference.
-  // we do not want to orphan anything previously referenced.
-
-  // Replace the larger references.
-  if (id1 < id2)
-  {
-    // We could follow the references to the smallest.  It might
-    // make this processing more efficient.  This is a compromise.
-    // The referenced id will always be smaller than the id so
-    // order does not change.
-    this->EquateInternal(this->GetReference(id1), id2);
-  }
-  else
+  // than itself.  Linking the larger root to the smaller one
+  // keeps it, and nothing previously referenced is orphaned.
+  int root1 = this->FindRoot(id1);
+  int root2 = this->FindRoot(id2);
+  if (root1 < root2)
   {
-    this->EquateInternal(this->GetReference(id2), id1);
+    this->EquivalenceArray->SetValue(root2, root1);
   }
-}
-
-//----------------------------------------------------------------------------
-// id1 must be less than or equal to id2.
-void vtkMaterialInterfaceEquivalenceSet::EquateInternal(int id1, int id2)
-{
-  // This is the reference that might be orphaned in this process.
-  int oldRef = this->GetEquivalentSetId(id2);
-
-  // The only problem we could encounter is changing a reference.
-  // we do not want to orphan anything previously referenced.
-  if (oldRef == id2 || oldRef == id1)
+  else if (root2 < root1)
   {
-    this->EquivalenceArray->SetValue(id2, id1);
-  }
-  else if (oldRef > id1)
-  {
-    this->EquivalenceArray->SetValue(id2, id1);
-    this->EquateInternal(id1, oldRef);
-  }
-  else
-  { // oldRef < id1
-    this->EquateInternal(oldRef, id1);
+    this->EquivalenceArray->SetValue(root1, root2);
   }
 }
 
@@ -1540,6 +1541,222 @@ int vtkMaterialInterfaceFilterRingBuffer::Pop(vtkMaterialInterfaceFilterIterator
 
 //============================================================================
 
+//----------------------------------------------------------------------------
+// The fragments found in a single block. Blocks are labelled concurrently,
+// each into its own instance, and the fragments are then appended to the
+// filter's arrays in block order. Until then, the fragment ids are local to
+// the block.
+class vtkMaterialInterfaceFilterBlockFragments
+{
+public:
+  vtkMaterialInterfaceFilterBlockFragments() { this->FragmentIdOffset = 0; }
+
+  // Id of the first fragment of the block within this process.
+  int FragmentIdOffset;
+  // Surface of each fragment.
+  vector<vtkPolyData*> Meshes;
+  // Integrated attributes, the tuples of the fragments one after the other.
+  vector<double> Volumes;
+  vector<double> ClipDepthMaximums;
+  vector<double> ClipDepthMinimums;
+  vector<double> Moments;
+  vector<vector<double> > VolumeWtdAvgs;
+  vector<vector<double> > MassWtdAvgs;
+  vector<vector<double> > Sums;
+  // Voxels of the block next to voxels of the material that the labelling
+  // of the blocks leaves out: the ghost block voxels, and the voxels right at
+  // the threshold that are only connected to fragments of other blocks. The
+  // connectivity search continues from them once all blocks are labelled.
+  vector<vtkMaterialInterfaceFilterIterator> Seeds;
+};
+
+//----------------------------------------------------------------------------
+// State of the connectivity search and of the surface extraction. Each block
+// that is being labelled has its own, so that blocks can be processed on
+// several threads.
+class vtkMaterialInterfaceFilterLabeller
+{
+public:
+  enum Modes
+  {
+    // Flood fill the fragments of Block, extract their surface and
+    // integrate their attributes.
+    LABEL_BLOCK,
+    // Equate the fragments on the boundary of Block with those of the
+    // neighboring blocks.
+    STITCH_BLOCK,
+    // Flood fill, across blocks, the voxels left out by LABEL_BLOCK and
+    // add them to the fragments they touch.
+    LABEL_ACROSS_BLOCKS
+  };
+
+  vtkMaterialInterfaceFilterLabeller()
+  {
+    this->Mode = LABEL_BLOCK;
+    this->Block = 0;
+    this->Fragments = 0;
+    this->Equivalences = 0;
+    this->FragmentId = 0;
+    this->Mesh = 0;
+    this->Volume = 0.0;
+    this->ClipDepthMax = 0.0;
+    this->ClipDepthMin = VTK_FLOAT_MAX;
+  }
+
+  int Mode;
+  // The block being labelled or stitched.
+  vtkMaterialInterfaceFilterBlock* Block;
+  // Where the fragments of the block are saved.
+  vtkMaterialInterfaceFilterBlockFragments* Fragments;
+  // Where the equivalences found while stitching are added.
+  vtkMaterialInterfaceConcurrentEquivalenceSet* Equivalences;
+  // Id given to the voxels of the current fragment.
+  int FragmentId;
+  // Surface of the current fragment, faces are not created when NULL.
+  vtkPolyData* Mesh;
+  // Accumulators for the current fragment.
+  double Volume;
+  double ClipDepthMax;
+  double ClipDepthMin;
+  vector<double> Moment; // =(Myz, Mxz, Mxy, m)
+  vector<vector<double> > VolumeWtdAvg;
+  vector<vector<double> > MassWtdAvg;
+  vector<vector<double> > Sum;
+  // Ivars for computing the point on corners and edges of a face.
+  vtkMaterialInterfaceFilterIterator FaceNeighbors[32];
+  double FaceCornerPoints[12];
+  double FaceEdgePoints[12];
+  int FaceEdgeFlags[4];
+};
+
+//----------------------------------------------------------------------------
+// Union-find over the fragment ids of this process, to which the blocks add
+// equivalences concurrently. As in vtkMaterialInterfaceEquivalenceSet, every
+// member points to its own id or an id smaller than itself. References are
+// only ever replaced by smaller ids, so that races are settled with
+// compare-and-swap and no locks.
+class vtkMaterialInterfaceConcurrentEquivalenceSet
+{
+public:
+  vtkMaterialInterfaceConcurrentEquivalenceSet(int numberOfMembers);
+  ~vtkMaterialInterfaceConcurrentEquivalenceSet();
+
+  int GetNumberOfMembers() { return this->NumberOfMembers; }
+  void AddEquivalence(int id1, int id2);
+  int FindRoot(int memberId);
+
+private:
+  std::atomic<int>* References;
+  int NumberOfMembers;
+};
+
+//----------------------------------------------------------------------------
+vtkMaterialInterfaceConcurrentEquivalenceSet::vtkMaterialInterfaceConcurrentEquivalenceSet(
+  int numberOfMembers)
+{
+  this->NumberOfMembers = numberOfMembers;
+  this->References = new std::atomic<int>[numberOfMembers];
+  for (int ii = 0; ii < numberOfMembers; ++ii)
+  {
+    this->References[ii] = ii;
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkMaterialInterfaceConcurrentEquivalenceSet::~vtkMaterialInterfaceConcurrentEquivalenceSet()
+{
+  delete[] this->References;
+  this->References = 0;
+  this->NumberOfMembers = 0;
+}
+
+//----------------------------------------------------------------------------
+// Path halving: every member visited is pointed to its grand parent.
+int vtkMaterialInterfaceConcurrentEquivalenceSet::FindRoot(int memberId)
+{
+  int ref = this->References[memberId];
+  while (ref != memberId)
+  {
+    int next = this->References[ref];
+    if (next != ref)
+    {
+      // Another thread may have moved the reference closer to the root
+      // already, in which case this does nothing.
+      this->References[memberId].compare_exchange_weak(ref, next);
+    }
+    memberId = next;
+    ref = this->References[memberId];
+  }
+  return memberId;
+}
+
+//----------------------------------------------------------------------------
+void vtkMaterialInterfaceConcurrentEquivalenceSet::AddEquivalence(int id1, int id2)
+{
+  for (;;)
+  {
+    int root1 = this->FindRoot(id1);
+    int root2 = this->FindRoot(id2);
+    if (root1 == root2)
+    {
+      return;
+    }
+    if (root1 > root2)
+    {
+      std::swap(root1, root2);
+    }
+    // Link the larger root to the smaller one, unless another thread linked
+    // it first, in which case we start over from its new root.
+    int expected = root2;
+    if (this->References[root2].compare_exchange_strong(expected, root1))
+    {
+      return;
+    }
+    id1 = root1;
+    id2 = root2;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Labels, relabels or stitches a range of blocks. Used with vtkSMPTools.
+class vtkMaterialInterfaceFilterBlockFunctor
+{
+public:
+  enum Passes
+  {
+    LABEL,
+    RELABEL,
+    STITCH
+  };
+
+  vtkMaterialInterfaceFilter* Filter;
+  vector<vtkMaterialInterfaceFilterBlockFragments>* Fragments;
+  vtkMaterialInterfaceConcurrentEquivalenceSet* Equivalences;
+  int Pass;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType blockId = begin; blockId < end; ++blockId)
+    {
+      vtkMaterialInterfaceFilterBlockFragments* fragments = &(*this->Fragments)[blockId];
+      switch (this->Pass)
+      {
+        case LABEL:
+          this->Filter->ProcessBlock(static_cast<int>(blockId), fragments);
+          break;
+        case RELABEL:
+          this->Filter->RelabelBlock(static_cast<int>(blockId), fragments);
+          break;
+        case STITCH:
+          this->Filter->StitchBlock(static_cast<int>(blockId), fragments, this->Equivalences);
+          break;
+      }
+    }
+  }
+};
+
+//============================================================================
+
 //----------------------------------------------------------------------------
 // Description:
 // Construct object with initial range (0,1) and single contour value
@@ -1608,17 +1825,13 @@ vtkMaterialInterfaceFilter::vtkMaterialInterfaceFilter()
   this->RootSpacing[0] = this->RootSpacing[1] = this->RootSpacing[2] = 1.0;
 
   this->FragmentId = 0;
-  this->FragmentVolume = 0.0;
   this->FragmentVolumes = 0;
-  this->FragmentMoment.resize(4, 0.0);
   this->FragmentMoments = 0;
   this->FragmentAABBCenters = 0;
   this->FragmentOBBs = 0;
   this->FragmentSplitGeometry = 0;
 
   // Keep depth of crater along clip plane normal.
-  this->ClipDepthMax = 0.0;
-  this->ClipDepthMin = VTK_FLOAT_MAX;
   this->ClipDepthMaximums = 0;
   this->ClipDepthMinimums = 0;
 
@@ -1633,10 +1846,6 @@ vtkMaterialInterfaceFilter::vtkMaterialInterfaceFilter()
   this->ResolvedFragmentCenters = 0;
   this->ResolvedFragmentOBBs = 0;
 
-  this->FaceNeighbors = new vtkMaterialInterfaceFilterIterator[32];
-
-  this->CurrentFragmentMesh = 0;
-
   this->NVolumeWtdAvgs = 0;
   this->NToSum = 0;
   this->ComputeMoments = false;
@@ -1679,9 +1888,6 @@ vtkMaterialInterfaceFilter::~vtkMaterialInterfaceFilter()
   this->RootSpacing[0] = this->RootSpacing[1] = this->RootSpacing[2] = 1.0;
 
   this->FragmentId = 0;
-  this->FragmentVolume = 0.0;
-  this->ClipDepthMax = 0.0;
-  this->ClipDepthMin = VTK_FLOAT_MAX;
 
   this->SetClipFunction(0);
 
@@ -1699,9 +1905,6 @@ vtkMaterialInterfaceFilter::~vtkMaterialInterfaceFilter()
   delete this->EquivalenceSet;
   this->EquivalenceSet = 0;
 
-  delete[] this->FaceNeighbors;
-  this->FaceNeighbors = 0;
-
   // clean up PV interface
   this->MaterialArraySelection->RemoveObserver(this->SelectionObserver);
   this->MaterialArraySelection->Delete();
@@ -3229,14 +3432,11 @@ void vtkMaterialInterfaceFilter::PrepareForPass(vtkNonOverlappingAMR* hbdsInput,
 {
   this->FragmentId = 0;
 
-  this->FragmentVolume = 0.0;
   ReNewVtkPointer(this->FragmentVolumes);
   this->FragmentVolumes->SetName("Volume");
 
   if (this->ClipWithPlane)
   {
-    this->ClipDepthMax = 0.0;
-    this->ClipDepthMin = VTK_FLOAT_MAX;
     ReNewVtkPointer(this->ClipDepthMaximums);
     ReNewVtkPointer(this->ClipDepthMinimums);
     this->ClipDepthMaximums->SetName("ClipDepthMax");
@@ -3245,8 +3445,6 @@ void vtkMaterialInterfaceFilter::PrepareForPass(vtkNonOverlappingAMR* hbdsInput,
 
   if (this->ComputeMoments)
   {
-    this->FragmentMoment.clear();
-    this->FragmentMoment.resize(4, 0.0);
     ReNewVtkPointer(this->FragmentMoments);
     this->FragmentMoments->SetNumberOfComponents(4);
     this->FragmentMoments->SetName("Moments");
@@ -3267,7 +3465,7 @@ void vtkMaterialInterfaceFilter::PrepareForPass(vtkNonOverlappingAMR* hbdsInput,
 
   // Below for each integrated array we figure out if we
   // are integrating vector or scalars, in order to build the
-  // appropriate accumulator
+  // appropriate result array
   vtkCompositeDataIterator* hbdsIt = hbdsInput->NewIterator();
   hbdsIt->SkipEmptyNodesOn();
   hbdsIt->InitTraversal();
@@ -3284,11 +3482,9 @@ void vtkMaterialInterfaceFilter::PrepareForPass(vtkNonOverlappingAMR* hbdsInput,
   // Configure data structures
   // 1) Volume weighted average of attribute over the
   // fragment set up containers
-  this->FragmentVolumeWtdAvg.clear();
-  this->FragmentVolumeWtdAvg.resize(this->NVolumeWtdAvgs);
   ClearVectorOfVtkPointers(this->FragmentVolumeWtdAvgs);
   this->FragmentVolumeWtdAvgs.resize(this->NVolumeWtdAvgs);
-  // set up data array and accumulator for each weighted average
+  // set up data array for each weighted average
   for (int j = 0; j < this->NVolumeWtdAvgs; ++j)
   {
     // data array
@@ -3307,16 +3503,12 @@ void vtkMaterialInterfaceFilter::PrepareForPass(vtkNonOverlappingAMR* hbdsInput,
     ostringstream osIntegratedArrayName;
     osIntegratedArrayName << "VolumeWeightedAverage-" << thisArrayName;
     this->FragmentVolumeWtdAvgs[j]->SetName(osIntegratedArrayName.str().c_str());
-    // accumulator
-    this->FragmentVolumeWtdAvg[j].resize(nComp, 0.0);
   }
   // 2) Mass weighted average of attribute over the fragment
   // set up containers
-  this->FragmentMassWtdAvg.clear();
-  this->FragmentMassWtdAvg.resize(this->NMassWtdAvgs);
   ClearVectorOfVtkPointers(this->FragmentMassWtdAvgs);
   this->FragmentMassWtdAvgs.resize(this->NMassWtdAvgs);
-  // set up data array and accumulator for each weighted average
+  // set up data array for each weighted average
   for (int j = 0; j < this->NMassWtdAvgs; ++j)
   {
     // data array
@@ -3335,16 +3527,12 @@ void vtkMaterialInterfaceFilter::PrepareForPass(vtkNonOverlappingAMR* hbdsInput,
     ostringstream osIntegratedArrayName;
     osIntegratedArrayName << "MassWeightedAverage-" << thisArrayName;
     this->FragmentMassWtdAvgs[j]->SetName(osIntegratedArrayName.str().c_str());
-    // accumulator
-    this->FragmentMassWtdAvg[j].resize(nComp, 0.0);
   }
   // 3) Summation of attribute over the fragment
   // set up containers
-  this->FragmentSum.clear();
-  this->FragmentSum.resize(this->NToSum);
   ClearVectorOfVtkPointers(this->FragmentSums);
   this->FragmentSums.resize(this->NToSum);
-  // set up data array and accumulator for each weighted average
+  // set up data array for each weighted average
   for (int j = 0; j < this->NToSum; ++j)
   {
     // data array
@@ -3363,8 +3551,6 @@ void vtkMaterialInterfaceFilter::PrepareForPass(vtkNonOverlappingAMR* hbdsInput,
     ostringstream osIntegratedArrayName;
     osIntegratedArrayName << "Summation-" << thisArrayName;
     this->FragmentSums[j]->SetName(osIntegratedArrayName.str().c_str());
-    // accumulator
-    this->FragmentSum[j].resize(nComp, 0.0);
   }
 
   // 4) Unique list of integrated attributes
@@ -3592,12 +3778,7 @@ int vtkMaterialInterfaceFilter::RequestData(vtkInformation* vtkNotUsed(request),
     // Lets profile to see what takes the most time for large number of processes.
     this->ProcessBlocksTimer->StartTimer();
 #endif
-    int blockId;
-    for (blockId = 0; blockId < this->NumberOfInputBlocks; ++blockId)
-    {
-      // build fragments
-      this->ProcessBlock(blockId);
-    }
+    this->ProcessBlocks();
 #ifdef vtkMaterialInterfaceFilterPROFILE
     // Lets profile to see what takes the most time for large number of processes.
     this->ProcessBlocksTimer->StopTimer();
@@ -3741,23 +3922,143 @@ int vtkMaterialInterfaceFilter::RequestData(vtkInformation* vtkNotUsed(request),
 }
 
 //----------------------------------------------------------------------------
-int vtkMaterialInterfaceFilter::ProcessBlock(int blockId)
-{
-#ifdef vtkMaterialInterfaceFilterDEBUG
-  ostringstream progressMesg;
-  progressMesg << "vtkMaterialInterfaceFilter::ProcessBlock(" << blockId << ") , Material "
-               << this->MaterialId;
-  this->SetProgressText(progressMesg.str().c_str());
-#endif
-  this->Progress += this->ProgressBlockInc;
+// Blocks are labelled concurrently. The flood fill of a block does not leave
+// it, so the threads never write to the same voxels. The fragments that span
+// several blocks are then connected:
+// - the block local fragment ids are offset into ids local to this process,
+// - the voxels on the boundary of each block are equated with their
+//   neighbors in the other local blocks,
+// - the ghost blocks are flood filled, which equates the fragments that
+//   only connect through them and labels the ghost voxels for the exchange
+//   with the processes that own them. Voxels right at the threshold do not
+//   start a fragment, those only connected to other blocks are added then.
+void vtkMaterialInterfaceFilter::ProcessBlocks()
+{
+  vector<vtkMaterialInterfaceFilterBlockFragments> fragments(this->NumberOfInputBlocks);
+  vtkMaterialInterfaceFilterBlockFunctor functor;
+  functor.Filter = this;
+  functor.Fragments = &fragments;
+  functor.Equivalences = 0;
+
+  // build fragments
+  functor.Pass = vtkMaterialInterfaceFilterBlockFunctor::LABEL;
+  vtkSMPTools::For(0, this->NumberOfInputBlocks, functor);
+
+  this->Progress += this->ProgressBlockInc * this->NumberOfInputBlocks;
   this->UpdateProgress(this->Progress);
 
+  // Save the fragments in block order.
+  for (int blockId = 0; blockId < this->NumberOfInputBlocks; ++blockId)
+  {
+    vtkMaterialInterfaceFilterBlockFragments& blockFragments = fragments[blockId];
+    blockFragments.FragmentIdOffset = this->FragmentId;
+    int numFragments = static_cast<int>(blockFragments.Meshes.size());
+    for (int ii = 0; ii < numFragments; ++ii)
+    {
+      // the id is implicit given by its position in the vector, but only
+      // until fragments are resolved. After resolution we add addributes such
+      // as id, volume, summations averages, etc..
+      this->FragmentMeshes.push_back(blockFragments.Meshes[ii]);
+      this->FragmentVolumes->InsertTuple1(this->FragmentId, blockFragments.Volumes[ii]);
+      if (this->ClipWithPlane)
+      {
+        this->ClipDepthMaximums->InsertTuple1(
+          this->FragmentId, blockFragments.ClipDepthMaximums[ii]);
+        this->ClipDepthMinimums->InsertTuple1(
+          this->FragmentId, blockFragments.ClipDepthMinimums[ii]);
+      }
+      if (this->ComputeMoments)
+      {
+        this->FragmentMoments->InsertTuple(this->FragmentId, &blockFragments.Moments[4 * ii]);
+      }
+      for (int i = 0; i < this->NVolumeWtdAvgs; ++i)
+      {
+        int nComps = this->FragmentVolumeWtdAvgs[i]->GetNumberOfComponents();
+        this->FragmentVolumeWtdAvgs[i]->InsertTuple(
+          this->FragmentId, &blockFragments.VolumeWtdAvgs[i][nComps * ii]);
+      }
+      for (int i = 0; i < this->NMassWtdAvgs; ++i)
+      {
+        int nComps = this->FragmentMassWtdAvgs[i]->GetNumberOfComponents();
+        this->FragmentMassWtdAvgs[i]->InsertTuple(
+          this->FragmentId, &blockFragments.MassWtdAvgs[i][nComps * ii]);
+      }
+      for (int i = 0; i < this->NToSum; ++i)
+      {
+        int nComps = this->FragmentSums[i]->GetNumberOfComponents();
+        this->FragmentSums[i]->InsertTuple(
+          this->FragmentId, &blockFragments.Sums[i][nComps * ii]);
+      }
+      ++this->FragmentId;
+    }
+    blockFragments.Meshes.clear();
+  }
+  if (this->FragmentId == 0)
+  {
+    return;
+  }
+  // Every fragment starts out equivalent to itself only.
+  this->EquivalenceSet->AddEquivalence(this->FragmentId - 1, this->FragmentId - 1);
+
+  functor.Pass = vtkMaterialInterfaceFilterBlockFunctor::RELABEL;
+  vtkSMPTools::For(0, this->NumberOfInputBlocks, functor);
+
+  vtkMaterialInterfaceConcurrentEquivalenceSet equivalences(this->FragmentId);
+  functor.Equivalences = &equivalences;
+  functor.Pass = vtkMaterialInterfaceFilterBlockFunctor::STITCH;
+  vtkSMPTools::For(0, this->NumberOfInputBlocks, functor);
+  for (int id = 0; id < this->FragmentId; ++id)
+  {
+    int root = equivalences.FindRoot(id);
+    if (root != id)
+    {
+      this->EquivalenceSet->AddEquivalence(id, root);
+    }
+  }
+
+  // The voxels left out are shared by the blocks around them, so this last
+  // search is not threaded. Ghost voxels are neither integrated nor given
+  // faces.
+  vtkMaterialInterfaceFilterLabeller labeller;
+  labeller.Mode = vtkMaterialInterfaceFilterLabeller::LABEL_ACROSS_BLOCKS;
+  this->InitializeAccumulators(&labeller);
+  vtkMaterialInterfaceFilterRingBuffer* queue = new vtkMaterialInterfaceFilterRingBuffer;
+  for (int blockId = 0; blockId < this->NumberOfInputBlocks; ++blockId)
+  {
+    vector<vtkMaterialInterfaceFilterIterator>& seeds = fragments[blockId].Seeds;
+    for (size_t ii = 0; ii < seeds.size(); ++ii)
+    {
+      labeller.FragmentId = *(seeds[ii].FragmentIdPointer);
+      // The seed already has its faces.
+      labeller.Mesh = 0;
+      this->ConnectNeighbors(&labeller, queue, &seeds[ii]);
+      labeller.Mesh = this->FragmentMeshes[labeller.FragmentId];
+      this->ConnectFragment(&labeller, queue);
+      this->AddToFragment(&labeller);
+    }
+  }
+  delete queue;
+}
+
+//----------------------------------------------------------------------------
+int vtkMaterialInterfaceFilter::ProcessBlock(
+  int blockId, vtkMaterialInterfaceFilterBlockFragments* fragments)
+{
   vtkMaterialInterfaceFilterBlock* block = this->InputBlocks[blockId];
   if (block == 0)
   {
     return 0;
   }
 
+  vtkMaterialInterfaceFilterLabeller labeller;
+  labeller.Mode = vtkMaterialInterfaceFilterLabeller::LABEL_BLOCK;
+  labeller.Block = block;
+  labeller.Fragments = fragments;
+  this->InitializeAccumulators(&labeller);
+  fragments->VolumeWtdAvgs.resize(this->NVolumeWtdAvgs);
+  fragments->MassWtdAvgs.resize(this->NMassWtdAvgs);
+  fragments->Sums.resize(this->NToSum);
+
   vtkMaterialInterfaceFilterIterator* xIterator = new vtkMaterialInterfaceFilterIterator;
   vtkMaterialInterfaceFilterIterator* yIterator = new vtkMaterialInterfaceFilterIterator;
   vtkMaterialInterfaceFilterIterator* zIterator = new vtkMaterialInterfaceFilterIterator;
@@ -3791,65 +4092,15 @@ int vtkMaterialInterfaceFilter::ProcessBlock(int blockId)
         if (*(xIterator->FragmentIdPointer) == -1 &&
           *(xIterator->VolumeFractionPointer) > this->scaledMaterialFractionThreshold)
         { // We have a new fragment.
-          this->CurrentFragmentMesh = this->NewFragmentMesh();
-          this->EquivalenceSet->AddEquivalence(this->FragmentId, this->FragmentId);
+          labeller.Mesh = this->NewFragmentMesh();
           // We have to mark every voxel we push on the queue.
-          *(xIterator->FragmentIdPointer) = this->FragmentId;
+          *(xIterator->FragmentIdPointer) = labeller.FragmentId;
           // There should be no need to clear the queue.
           queue->Push(xIterator);
-          this->ConnectFragment(queue);
-          // save the current fragment mesh
-          // the id is implicit given by its position in the vector, but only
-          // until fragments are resolved. After resolution we add addributes such
-          // as id, volume, summations averages, etc..
-          this->CurrentFragmentMesh->Squeeze();
-          this->FragmentMeshes.push_back(this->CurrentFragmentMesh);
-          // Save the volume from the last fragment.
-          this->FragmentVolumes->InsertTuple1(this->FragmentId, this->FragmentVolume);
-          if (this->ClipWithPlane)
-          {
-            this->ClipDepthMaximums->InsertTuple1(this->FragmentId, this->ClipDepthMax);
-            this->ClipDepthMinimums->InsertTuple1(this->FragmentId, this->ClipDepthMin);
-          }
-          // clear the volume accumulator
-          this->FragmentVolume = 0.0;
-          this->ClipDepthMax = 0.0;
-          this->ClipDepthMin = VTK_FLOAT_MAX;
-          if (this->ComputeMoments)
-          {
-            // Save the moments from the last fragment
-            this->FragmentMoments->InsertTuple(this->FragmentId, &this->FragmentMoment[0]);
-            // clear the moment accumulator
-            FillVector(this->FragmentMoment, 0.0);
-          }
-          // for the volume weighted averaged scalars/vectors...
-          for (int i = 0; i < this->NVolumeWtdAvgs; ++i)
-          {
-            // update the integrated value, independent of ncomps
-            this->FragmentVolumeWtdAvgs[i]->InsertTuple(
-              this->FragmentId, &this->FragmentVolumeWtdAvg[i][0]);
-            // clear the accumulator
-            FillVector(this->FragmentVolumeWtdAvg[i], 0.0);
-          }
-          // for the mass weighted averaged scalars/vectors...
-          for (int i = 0; i < this->NMassWtdAvgs; ++i)
-          {
-            // update the integrated value, independent of ncomps
-            this->FragmentMassWtdAvgs[i]->InsertTuple(
-              this->FragmentId, &this->FragmentMassWtdAvg[i][0]);
-            // clear the accumulator
-            FillVector(this->FragmentMassWtdAvg[i], 0.0);
-          }
-          // for the summed scalars/vectors...
-          for (int i = 0; i < this->NToSum; ++i)
-          {
-            // update the integrated value, independent of ncomps
-            this->FragmentSums[i]->InsertTuple(this->FragmentId, &this->FragmentSum[i][0]);
-            // clear the accumulator
-            FillVector(this->FragmentSum[i], 0.0);
-          }
+          this->ConnectFragment(&labeller, queue);
+          this->SaveFragment(&labeller);
           // Move to next fragment.
-          ++this->FragmentId;
+          ++labeller.FragmentId;
         }
         xIterator->FlatIndex += cellIncs[0]; // 1/ncomp
         xIterator->VolumeFractionPointer += cellIncs[0];
@@ -3872,6 +4123,225 @@ int vtkMaterialInterfaceFilter::ProcessBlock(int blockId)
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkMaterialInterfaceFilter::InitializeAccumulators(
+  vtkMaterialInterfaceFilterLabeller* labeller)
+{
+  labeller->Volume = 0.0;
+  labeller->ClipDepthMax = 0.0;
+  labeller->ClipDepthMin = VTK_FLOAT_MAX;
+  if (this->ComputeMoments)
+  {
+    labeller->Moment.resize(4, 0.0);
+  }
+  labeller->VolumeWtdAvg.resize(this->NVolumeWtdAvgs);
+  for (int i = 0; i < this->NVolumeWtdAvgs; ++i)
+  {
+    int nComps = this->FragmentVolumeWtdAvgs[i]->GetNumberOfComponents();
+    labeller->VolumeWtdAvg[i].resize(nComps, 0.0);
+  }
+  labeller->MassWtdAvg.resize(this->NMassWtdAvgs);
+  for (int i = 0; i < this->NMassWtdAvgs; ++i)
+  {
+    int nComps = this->FragmentMassWtdAvgs[i]->GetNumberOfComponents();
+    labeller->MassWtdAvg[i].resize(nComps, 0.0);
+  }
+  labeller->Sum.resize(this->NToSum);
+  for (int i = 0; i < this->NToSum; ++i)
+  {
+    labeller->Sum[i].resize(this->FragmentSums[i]->GetNumberOfComponents(), 0.0);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMaterialInterfaceFilter::SaveFragment(vtkMaterialInterfaceFilterLabeller* labeller)
+{
+  vtkMaterialInterfaceFilterBlockFragments* fragments = labeller->Fragments;
+  // save the current fragment mesh
+  labeller->Mesh->Squeeze();
+  fragments->Meshes.push_back(labeller->Mesh);
+  labeller->Mesh = 0;
+  // Save the volume from the last fragment.
+  fragments->Volumes.push_back(labeller->Volume);
+  if (this->ClipWithPlane)
+  {
+    fragments->ClipDepthMaximums.push_back(labeller->ClipDepthMax);
+    fragments->ClipDepthMinimums.push_back(labeller->ClipDepthMin);
+  }
+  // clear the volume accumulator
+  labeller->Volume = 0.0;
+  labeller->ClipDepthMax = 0.0;
+  labeller->ClipDepthMin = VTK_FLOAT_MAX;
+  if (this->ComputeMoments)
+  {
+    // Save the moments from the last fragment
+    fragments->Moments.insert(
+      fragments->Moments.end(), labeller->Moment.begin(), labeller->Moment.end());
+    // clear the moment accumulator
+    FillVector(labeller->Moment, 0.0);
+  }
+  // for the volume weighted averaged scalars/vectors...
+  for (int i = 0; i < this->NVolumeWtdAvgs; ++i)
+  {
+    fragments->VolumeWtdAvgs[i].insert(fragments->VolumeWtdAvgs[i].end(),
+      labeller->VolumeWtdAvg[i].begin(), labeller->VolumeWtdAvg[i].end());
+    // clear the accumulator
+    FillVector(labeller->VolumeWtdAvg[i], 0.0);
+  }
+  // for the mass weighted averaged scalars/vectors...
+  for (int i = 0; i < this->NMassWtdAvgs; ++i)
+  {
+    fragments->MassWtdAvgs[i].insert(fragments->MassWtdAvgs[i].end(),
+      labeller->MassWtdAvg[i].begin(), labeller->MassWtdAvg[i].end());
+    // clear the accumulator
+    FillVector(labeller->MassWtdAvg[i], 0.0);
+  }
+  // for the summed scalars/vectors...
+  for (int i = 0; i < this->NToSum; ++i)
+  {
+    fragments->Sums[i].insert(
+      fragments->Sums[i].end(), labeller->Sum[i].begin(), labeller->Sum[i].end());
+    // clear the accumulator
+    FillVector(labeller->Sum[i], 0.0);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Add what was integrated to the fragment that is already saved, and clear
+// the accumulators.
+void vtkMaterialInterfaceFilter::AddToFragment(vtkMaterialInterfaceFilterLabeller* labeller)
+{
+  int id = labeller->FragmentId;
+  double* volume = this->FragmentVolumes->GetPointer(id);
+  volume[0] += labeller->Volume;
+  labeller->Volume = 0.0;
+  if (this->ClipWithPlane)
+  {
+    double* clipDepthMax = this->ClipDepthMaximums->GetPointer(id);
+    clipDepthMax[0] = std::max(clipDepthMax[0], labeller->ClipDepthMax);
+    double* clipDepthMin = this->ClipDepthMinimums->GetPointer(id);
+    clipDepthMin[0] = std::min(clipDepthMin[0], labeller->ClipDepthMin);
+    labeller->ClipDepthMax = 0.0;
+    labeller->ClipDepthMin = VTK_FLOAT_MAX;
+  }
+  if (this->ComputeMoments)
+  {
+    double* moment = this->FragmentMoments->GetPointer(4 * id);
+    for (int q = 0; q < 4; ++q)
+    {
+      moment[q] += labeller->Moment[q];
+    }
+    FillVector(labeller->Moment, 0.0);
+  }
+  for (int i = 0; i < this->NVolumeWtdAvgs; ++i)
+  {
+    int nComps = static_cast<int>(labeller->VolumeWtdAvg[i].size());
+    double* avg = this->FragmentVolumeWtdAvgs[i]->GetPointer(nComps * id);
+    for (int q = 0; q < nComps; ++q)
+    {
+      avg[q] += labeller->VolumeWtdAvg[i][q];
+    }
+    FillVector(labeller->VolumeWtdAvg[i], 0.0);
+  }
+  for (int i = 0; i < this->NMassWtdAvgs; ++i)
+  {
+    int nComps = static_cast<int>(labeller->MassWtdAvg[i].size());
+    double* avg = this->FragmentMassWtdAvgs[i]->GetPointer(nComps * id);
+    for (int q = 0; q < nComps; ++q)
+    {
+      avg[q] += labeller->MassWtdAvg[i][q];
+    }
+    FillVector(labeller->MassWtdAvg[i], 0.0);
+  }
+  for (int i = 0; i < this->NToSum; ++i)
+  {
+    int nComps = static_cast<int>(labeller->Sum[i].size());
+    double* sum = this->FragmentSums[i]->GetPointer(nComps * id);
+    for (int q = 0; q < nComps; ++q)
+    {
+      sum[q] += labeller->Sum[i][q];
+    }
+    FillVector(labeller->Sum[i], 0.0);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMaterialInterfaceFilter::RelabelBlock(
+  int blockId, vtkMaterialInterfaceFilterBlockFragments* fragments)
+{
+  vtkMaterialInterfaceFilterBlock* block = this->InputBlocks[blockId];
+  int offset = fragments->FragmentIdOffset;
+  if (block == 0 || offset == 0)
+  {
+    return;
+  }
+  int ext[6];
+  block->GetCellExtent(ext);
+  int numCells = (ext[1] - ext[0] + 1) * (ext[3] - ext[2] + 1) * (ext[5] - ext[4] + 1);
+  int* fragmentIds = block->GetFragmentIdPointer();
+  for (int ii = 0; ii < numCells; ++ii)
+  {
+    if (fragmentIds[ii] != -1)
+    {
+      fragmentIds[ii] += offset;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Only the voxels on the boundary of the block have neighbors in other
+// blocks.
+void vtkMaterialInterfaceFilter::StitchBlock(int blockId,
+  vtkMaterialInterfaceFilterBlockFragments* fragments,
+  vtkMaterialInterfaceConcurrentEquivalenceSet* equivalences)
+{
+  vtkMaterialInterfaceFilterBlock* block = this->InputBlocks[blockId];
+  if (block == 0)
+  {
+    return;
+  }
+
+  vtkMaterialInterfaceFilterLabeller labeller;
+  labeller.Mode = vtkMaterialInterfaceFilterLabeller::STITCH_BLOCK;
+  labeller.Block = block;
+  labeller.Fragments = fragments;
+  labeller.Equivalences = equivalences;
+
+  vtkMaterialInterfaceFilterIterator iterator;
+  iterator.Block = block;
+  const int* ext = block->GetBaseCellExtent();
+  int cellIncs[3];
+  block->GetCellIncrements(cellIncs);
+  for (int iz = ext[4]; iz <= ext[5]; ++iz)
+  {
+    iterator.Index[2] = iz;
+    for (int iy = ext[2]; iy <= ext[3]; ++iy)
+    {
+      iterator.Index[1] = iy;
+      // Inside rows only have their first and last voxels on the boundary.
+      int step = 1;
+      if (iz != ext[4] && iz != ext[5] && iy != ext[2] && iy != ext[3] && ext[1] > ext[0])
+      {
+        step = ext[1] - ext[0];
+      }
+      for (int ix = ext[0]; ix <= ext[1]; ix += step)
+      {
+        int offset = (ix - ext[0]) * cellIncs[0] + (iy - ext[2]) * cellIncs[1] +
+          (iz - ext[4]) * cellIncs[2];
+        iterator.Index[0] = ix;
+        iterator.VolumeFractionPointer = block->GetBaseVolumeFractionPointer() + offset;
+        iterator.FragmentIdPointer = block->GetBaseFragmentIdPointer() + offset;
+        iterator.FlatIndex = block->GetBaseFlatIndex() + offset;
+        if (*(iterator.FragmentIdPointer) != -1)
+        {
+          labeller.FragmentId = *(iterator.FragmentIdPointer);
+          this->ConnectNeighbors(&labeller, 0, &iterator);
+        }
+      }
+    }
+  }
+}
+
 // We conserver neighbor relations and put the reference (in)
 // block in position 0, and the out block in position 1.
 // The face being generated is between 0 and 1.
@@ -4249,8 +4719,9 @@ int vtkMaterialInterfaceFilter::ComputeDisplacementFactors(
 // It will be modified with the sub voxel displacement.
 // The return value indicates that an edge may be non manifold.
 // It returns the y or z axis index of the edge that may be non manifold.
-int vtkMaterialInterfaceFilter::SubVoxelPositionCorner(double* point,
-  vtkMaterialInterfaceFilterIterator* pointNeighborIterators[8], int rootNeighborIdx, int faceAxis)
+int vtkMaterialInterfaceFilter::SubVoxelPositionCorner(vtkMaterialInterfaceFilterLabeller* labeller,
+  double* point, vtkMaterialInterfaceFilterIterator* pointNeighborIterators[8], int rootNeighborIdx,
+  int faceAxis)
 {
   int retVal;
 
@@ -4298,13 +4769,13 @@ int vtkMaterialInterfaceFilter::SubVoxelPositionCorner(double* point,
     projection = (point[0] - this->ClipCenter[0]) * this->ClipPlaneNormal[0];
     projection += (point[1] - this->ClipCenter[1]) * this->ClipPlaneNormal[1];
     projection += (point[2] - this->ClipCenter[2]) * this->ClipPlaneNormal[2];
-    if (this->ClipDepthMax < projection)
+    if (labeller->ClipDepthMax < projection)
     {
-      this->ClipDepthMax = projection;
+      labeller->ClipDepthMax = projection;
     }
-    if (this->ClipDepthMin > projection)
+    if (labeller->ClipDepthMin > projection)
     {
-      this->ClipDepthMin = projection;
+      labeller->ClipDepthMin = projection;
     }
   }
 
@@ -4322,8 +4793,9 @@ int vtkMaterialInterfaceFilter::SubVoxelPositionCorner(double* point,
 // Now to fix cracks.  If neighbors are higher level,
 // I need to have more than 4 points for a face.
 // I am only going to support transitions of 1 level.
-void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterIterator* in,
-  vtkMaterialInterfaceFilterIterator* out, int axis, int outMaxFlag)
+void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterLabeller* labeller,
+  vtkMaterialInterfaceFilterIterator* in, vtkMaterialInterfaceFilterIterator* out, int axis,
+  int outMaxFlag)
 {
   if (in->Block == 0 || in->Block->GetGhostFlag())
   {
@@ -4346,8 +4818,8 @@ void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterIterator*
   // Add points to the output.  Create separate points for each triangle.
   // We can worry about merging points later.
   vtkMaterialInterfaceFilterIterator* cornerNeighbors[8];
-  vtkPoints* points = this->CurrentFragmentMesh->GetPoints(); // TODO for performance store?
-  vtkCellArray* polys = this->CurrentFragmentMesh->GetPolys();
+  vtkPoints* points = labeller->Mesh->GetPoints(); // TODO for performance store?
+  vtkCellArray* polys = labeller->Mesh->GetPolys();
   vtkIdType quadCornerIds[4];
   vtkIdType quadMidIds[4];
   vtkIdType triPtIds[3];
@@ -4357,11 +4829,11 @@ void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterIterator*
   quadMidIds[0] = quadMidIds[1] = quadMidIds[2] = quadMidIds[3] = 0;
 
   // Compute the corner and edge points (before subpixel positioning).
-  // Store the results in ivars.
-  this->ComputeFacePoints(in, out, axis, outMaxFlag);
+  // Store the results in the labeller.
+  this->ComputeFacePoints(labeller, in, out, axis, outMaxFlag);
   // Find the neighbor iterators.
-  // Store the results in ivars.
-  this->ComputeFaceNeighbors(in, out, axis, outMaxFlag);
+  // Store the results in the labeller.
+  this->ComputeFaceNeighbors(labeller, in, out, axis, outMaxFlag);
 
   // A word about indexing:
   // face neighbors 2x4x4 indexed face normal axis first, axis1, then axis2.
@@ -4396,55 +4868,55 @@ void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterIterator*
   // to perform connectivity on the 2x2x2 point neighbors.
   int inNeighborIdx;
 
-  cornerNeighbors[i0] = &(this->FaceNeighbors[0]);
-  cornerNeighbors[i1] = &(this->FaceNeighbors[1]);
-  cornerNeighbors[i2] = &(this->FaceNeighbors[2]);
-  cornerNeighbors[i3] = &(this->FaceNeighbors[3]);
-  cornerNeighbors[i4] = &(this->FaceNeighbors[8]);
-  cornerNeighbors[i5] = &(this->FaceNeighbors[9]);
-  cornerNeighbors[i6] = &(this->FaceNeighbors[10]);
-  cornerNeighbors[i7] = &(this->FaceNeighbors[11]);
+  cornerNeighbors[i0] = &(labeller->FaceNeighbors[0]);
+  cornerNeighbors[i1] = &(labeller->FaceNeighbors[1]);
+  cornerNeighbors[i2] = &(labeller->FaceNeighbors[2]);
+  cornerNeighbors[i3] = &(labeller->FaceNeighbors[3]);
+  cornerNeighbors[i4] = &(labeller->FaceNeighbors[8]);
+  cornerNeighbors[i5] = &(labeller->FaceNeighbors[9]);
+  cornerNeighbors[i6] = &(labeller->FaceNeighbors[10]);
+  cornerNeighbors[i7] = &(labeller->FaceNeighbors[11]);
   inNeighborIdx = outMaxFlag ? i6 : i7; // Face neighbor 10 or 11
-  manifoldIssue[0] =
-    this->SubVoxelPositionCorner(this->FaceCornerPoints, cornerNeighbors, inNeighborIdx, axis);
+  manifoldIssue[0] = this->SubVoxelPositionCorner(
+    labeller, labeller->FaceCornerPoints, cornerNeighbors, inNeighborIdx, axis);
   // 1 =>
-  quadCornerIds[0] = points->InsertNextPoint(this->FaceCornerPoints);
-  cornerNeighbors[i0] = &(this->FaceNeighbors[4]);
-  cornerNeighbors[i1] = &(this->FaceNeighbors[5]);
-  cornerNeighbors[i2] = &(this->FaceNeighbors[6]);
-  cornerNeighbors[i3] = &(this->FaceNeighbors[7]);
-  cornerNeighbors[i4] = &(this->FaceNeighbors[12]);
-  cornerNeighbors[i5] = &(this->FaceNeighbors[13]);
-  cornerNeighbors[i6] = &(this->FaceNeighbors[14]);
-  cornerNeighbors[i7] = &(this->FaceNeighbors[15]);
+  quadCornerIds[0] = points->InsertNextPoint(labeller->FaceCornerPoints);
+  cornerNeighbors[i0] = &(labeller->FaceNeighbors[4]);
+  cornerNeighbors[i1] = &(labeller->FaceNeighbors[5]);
+  cornerNeighbors[i2] = &(labeller->FaceNeighbors[6]);
+  cornerNeighbors[i3] = &(labeller->FaceNeighbors[7]);
+  cornerNeighbors[i4] = &(labeller->FaceNeighbors[12]);
+  cornerNeighbors[i5] = &(labeller->FaceNeighbors[13]);
+  cornerNeighbors[i6] = &(labeller->FaceNeighbors[14]);
+  cornerNeighbors[i7] = &(labeller->FaceNeighbors[15]);
   inNeighborIdx = outMaxFlag ? i4 : i5; // Face neighbor 12 or 13
-  manifoldIssue[1] =
-    this->SubVoxelPositionCorner(this->FaceCornerPoints + 3, cornerNeighbors, inNeighborIdx, axis);
-  quadCornerIds[1] = points->InsertNextPoint(this->FaceCornerPoints + 3);
-  cornerNeighbors[i0] = &(this->FaceNeighbors[16]);
-  cornerNeighbors[i1] = &(this->FaceNeighbors[17]);
-  cornerNeighbors[i2] = &(this->FaceNeighbors[18]);
-  cornerNeighbors[i3] = &(this->FaceNeighbors[19]);
-  cornerNeighbors[i4] = &(this->FaceNeighbors[24]);
-  cornerNeighbors[i5] = &(this->FaceNeighbors[25]);
-  cornerNeighbors[i6] = &(this->FaceNeighbors[26]);
-  cornerNeighbors[i7] = &(this->FaceNeighbors[27]);
+  manifoldIssue[1] = this->SubVoxelPositionCorner(
+    labeller, labeller->FaceCornerPoints + 3, cornerNeighbors, inNeighborIdx, axis);
+  quadCornerIds[1] = points->InsertNextPoint(labeller->FaceCornerPoints + 3);
+  cornerNeighbors[i0] = &(labeller->FaceNeighbors[16]);
+  cornerNeighbors[i1] = &(labeller->FaceNeighbors[17]);
+  cornerNeighbors[i2] = &(labeller->FaceNeighbors[18]);
+  cornerNeighbors[i3] = &(labeller->FaceNeighbors[19]);
+  cornerNeighbors[i4] = &(labeller->FaceNeighbors[24]);
+  cornerNeighbors[i5] = &(labeller->FaceNeighbors[25]);
+  cornerNeighbors[i6] = &(labeller->FaceNeighbors[26]);
+  cornerNeighbors[i7] = &(labeller->FaceNeighbors[27]);
   inNeighborIdx = outMaxFlag ? i2 : i3; // Face neighbor 18 or 19
-  manifoldIssue[2] =
-    this->SubVoxelPositionCorner(this->FaceCornerPoints + 6, cornerNeighbors, inNeighborIdx, axis);
-  quadCornerIds[2] = points->InsertNextPoint(this->FaceCornerPoints + 6);
-  cornerNeighbors[i0] = &(this->FaceNeighbors[20]);
-  cornerNeighbors[i1] = &(this->FaceNeighbors[21]);
-  cornerNeighbors[i2] = &(this->FaceNeighbors[22]);
-  cornerNeighbors[i3] = &(this->FaceNeighbors[23]);
-  cornerNeighbors[i4] = &(this->FaceNeighbors[28]);
-  cornerNeighbors[i5] = &(this->FaceNeighbors[29]);
-  cornerNeighbors[i6] = &(this->FaceNeighbors[30]);
-  cornerNeighbors[i7] = &(this->FaceNeighbors[31]);
+  manifoldIssue[2] = this->SubVoxelPositionCorner(
+    labeller, labeller->FaceCornerPoints + 6, cornerNeighbors, inNeighborIdx, axis);
+  quadCornerIds[2] = points->InsertNextPoint(labeller->FaceCornerPoints + 6);
+  cornerNeighbors[i0] = &(labeller->FaceNeighbors[20]);
+  cornerNeighbors[i1] = &(labeller->FaceNeighbors[21]);
+  cornerNeighbors[i2] = &(labeller->FaceNeighbors[22]);
+  cornerNeighbors[i3] = &(labeller->FaceNeighbors[23]);
+  cornerNeighbors[i4] = &(labeller->FaceNeighbors[28]);
+  cornerNeighbors[i5] = &(labeller->FaceNeighbors[29]);
+  cornerNeighbors[i6] = &(labeller->FaceNeighbors[30]);
+  cornerNeighbors[i7] = &(labeller->FaceNeighbors[31]);
   inNeighborIdx = outMaxFlag ? i0 : i1; // Face neighbor 20 or 21
-  manifoldIssue[3] =
-    this->SubVoxelPositionCorner(this->FaceCornerPoints + 9, cornerNeighbors, inNeighborIdx, axis);
-  quadCornerIds[3] = points->InsertNextPoint(this->FaceCornerPoints + 9);
+  manifoldIssue[3] = this->SubVoxelPositionCorner(
+    labeller, labeller->FaceCornerPoints + 9, cornerNeighbors, inNeighborIdx, axis);
+  quadCornerIds[3] = points->InsertNextPoint(labeller->FaceCornerPoints + 9);
 
   // If both corners of an edge have an issue, the we need an extra
   // point on the edge to generate a hole.
@@ -4457,93 +4929,97 @@ void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterIterator*
   if (manifoldIssue[0] != 0 && manifoldIssue[1] != 0 && tmp[manifoldIssue[0]] == 1 &&
     tmp[manifoldIssue[1]] == 1)
   {
-    this->FaceEdgeFlags[0] = 1;
+    labeller->FaceEdgeFlags[0] = 1;
   }
 
   if (manifoldIssue[0] != 0 && manifoldIssue[2] != 0 && tmp[manifoldIssue[0]] == 2 &&
     tmp[manifoldIssue[2]] == 2)
   {
-    this->FaceEdgeFlags[1] = 1;
+    labeller->FaceEdgeFlags[1] = 1;
   }
   if (manifoldIssue[1] != 0 && manifoldIssue[3] != 0 && tmp[manifoldIssue[1]] == 2 &&
     tmp[manifoldIssue[3]] == 2)
   {
-    this->FaceEdgeFlags[2] = 1;
+    labeller->FaceEdgeFlags[2] = 1;
   }
   if (manifoldIssue[2] != 0 && manifoldIssue[3] && tmp[manifoldIssue[2]] == 1 &&
     tmp[manifoldIssue[3]] == 1)
   {
-    this->FaceEdgeFlags[3] = 1;
+    labeller->FaceEdgeFlags[3] = 1;
   }
 
   // Now for the mid edge point if the neighbors on that side are smaller.
-  if (this->FaceEdgeFlags[0])
-  {
-    cornerNeighbors[i0] = &(this->FaceNeighbors[2]);
-    cornerNeighbors[i1] = &(this->FaceNeighbors[3]);
-    cornerNeighbors[i2] = &(this->FaceNeighbors[4]);
-    cornerNeighbors[i3] = &(this->FaceNeighbors[5]);
-    cornerNeighbors[i4] = &(this->FaceNeighbors[10]);
-    cornerNeighbors[i5] = &(this->FaceNeighbors[11]);
-    cornerNeighbors[i6] = &(this->FaceNeighbors[12]);
-    cornerNeighbors[i7] = &(this->FaceNeighbors[13]);
+  if (labeller->FaceEdgeFlags[0])
+  {
+    cornerNeighbors[i0] = &(labeller->FaceNeighbors[2]);
+    cornerNeighbors[i1] = &(labeller->FaceNeighbors[3]);
+    cornerNeighbors[i2] = &(labeller->FaceNeighbors[4]);
+    cornerNeighbors[i3] = &(labeller->FaceNeighbors[5]);
+    cornerNeighbors[i4] = &(labeller->FaceNeighbors[10]);
+    cornerNeighbors[i5] = &(labeller->FaceNeighbors[11]);
+    cornerNeighbors[i6] = &(labeller->FaceNeighbors[12]);
+    cornerNeighbors[i7] = &(labeller->FaceNeighbors[13]);
     // Two choices here (10, 12) because they both are the same voxel.
     inNeighborIdx = outMaxFlag ? i4 : i5;
-    this->SubVoxelPositionCorner(this->FaceEdgePoints, cornerNeighbors, inNeighborIdx, axis);
-    quadMidIds[0] = points->InsertNextPoint(this->FaceEdgePoints);
-  }
-  if (this->FaceEdgeFlags[1])
-  {
-    cornerNeighbors[i0] = &(this->FaceNeighbors[8]);
-    cornerNeighbors[i1] = &(this->FaceNeighbors[9]);
-    cornerNeighbors[i2] = &(this->FaceNeighbors[10]);
-    cornerNeighbors[i3] = &(this->FaceNeighbors[11]);
-    cornerNeighbors[i4] = &(this->FaceNeighbors[16]);
-    cornerNeighbors[i5] = &(this->FaceNeighbors[17]);
-    cornerNeighbors[i6] = &(this->FaceNeighbors[18]);
-    cornerNeighbors[i7] = &(this->FaceNeighbors[19]);
+    this->SubVoxelPositionCorner(
+      labeller, labeller->FaceEdgePoints, cornerNeighbors, inNeighborIdx, axis);
+    quadMidIds[0] = points->InsertNextPoint(labeller->FaceEdgePoints);
+  }
+  if (labeller->FaceEdgeFlags[1])
+  {
+    cornerNeighbors[i0] = &(labeller->FaceNeighbors[8]);
+    cornerNeighbors[i1] = &(labeller->FaceNeighbors[9]);
+    cornerNeighbors[i2] = &(labeller->FaceNeighbors[10]);
+    cornerNeighbors[i3] = &(labeller->FaceNeighbors[11]);
+    cornerNeighbors[i4] = &(labeller->FaceNeighbors[16]);
+    cornerNeighbors[i5] = &(labeller->FaceNeighbors[17]);
+    cornerNeighbors[i6] = &(labeller->FaceNeighbors[18]);
+    cornerNeighbors[i7] = &(labeller->FaceNeighbors[19]);
     // Two choices here (10, 18) because they both are the same voxel.
     inNeighborIdx = outMaxFlag ? i2 : i3;
-    this->SubVoxelPositionCorner(this->FaceEdgePoints + 3, cornerNeighbors, inNeighborIdx, axis);
-    quadMidIds[1] = points->InsertNextPoint(this->FaceEdgePoints + 3);
-  }
-  if (this->FaceEdgeFlags[2])
-  {
-    cornerNeighbors[i0] = &(this->FaceNeighbors[12]);
-    cornerNeighbors[i1] = &(this->FaceNeighbors[13]);
-    cornerNeighbors[i2] = &(this->FaceNeighbors[14]);
-    cornerNeighbors[i3] = &(this->FaceNeighbors[15]);
-    cornerNeighbors[i4] = &(this->FaceNeighbors[20]);
-    cornerNeighbors[i5] = &(this->FaceNeighbors[21]);
-    cornerNeighbors[i6] = &(this->FaceNeighbors[22]);
-    cornerNeighbors[i7] = &(this->FaceNeighbors[23]);
+    this->SubVoxelPositionCorner(
+      labeller, labeller->FaceEdgePoints + 3, cornerNeighbors, inNeighborIdx, axis);
+    quadMidIds[1] = points->InsertNextPoint(labeller->FaceEdgePoints + 3);
+  }
+  if (labeller->FaceEdgeFlags[2])
+  {
+    cornerNeighbors[i0] = &(labeller->FaceNeighbors[12]);
+    cornerNeighbors[i1] = &(labeller->FaceNeighbors[13]);
+    cornerNeighbors[i2] = &(labeller->FaceNeighbors[14]);
+    cornerNeighbors[i3] = &(labeller->FaceNeighbors[15]);
+    cornerNeighbors[i4] = &(labeller->FaceNeighbors[20]);
+    cornerNeighbors[i5] = &(labeller->FaceNeighbors[21]);
+    cornerNeighbors[i6] = &(labeller->FaceNeighbors[22]);
+    cornerNeighbors[i7] = &(labeller->FaceNeighbors[23]);
     // Two choices here (12, 20) because they both are the same voxel.
     inNeighborIdx = outMaxFlag ? i0 : i1;
-    this->SubVoxelPositionCorner(this->FaceEdgePoints + 6, cornerNeighbors, inNeighborIdx, axis);
-    quadMidIds[2] = points->InsertNextPoint(this->FaceEdgePoints + 6);
-  }
-  if (this->FaceEdgeFlags[3])
-  {
-    cornerNeighbors[i0] = &(this->FaceNeighbors[18]);
-    cornerNeighbors[i1] = &(this->FaceNeighbors[19]);
-    cornerNeighbors[i2] = &(this->FaceNeighbors[20]);
-    cornerNeighbors[i3] = &(this->FaceNeighbors[21]);
-    cornerNeighbors[i4] = &(this->FaceNeighbors[26]);
-    cornerNeighbors[i5] = &(this->FaceNeighbors[27]);
-    cornerNeighbors[i6] = &(this->FaceNeighbors[28]);
-    cornerNeighbors[i7] = &(this->FaceNeighbors[29]);
+    this->SubVoxelPositionCorner(
+      labeller, labeller->FaceEdgePoints + 6, cornerNeighbors, inNeighborIdx, axis);
+    quadMidIds[2] = points->InsertNextPoint(labeller->FaceEdgePoints + 6);
+  }
+  if (labeller->FaceEdgeFlags[3])
+  {
+    cornerNeighbors[i0] = &(labeller->FaceNeighbors[18]);
+    cornerNeighbors[i1] = &(labeller->FaceNeighbors[19]);
+    cornerNeighbors[i2] = &(labeller->FaceNeighbors[20]);
+    cornerNeighbors[i3] = &(labeller->FaceNeighbors[21]);
+    cornerNeighbors[i4] = &(labeller->FaceNeighbors[26]);
+    cornerNeighbors[i5] = &(labeller->FaceNeighbors[27]);
+    cornerNeighbors[i6] = &(labeller->FaceNeighbors[28]);
+    cornerNeighbors[i7] = &(labeller->FaceNeighbors[29]);
     // Two choices here (18, 20) because they both are the same voxel.
     inNeighborIdx = outMaxFlag ? i0 : i1;
-    this->SubVoxelPositionCorner(this->FaceEdgePoints + 9, cornerNeighbors, inNeighborIdx, axis);
-    quadMidIds[3] = points->InsertNextPoint(this->FaceEdgePoints + 9);
+    this->SubVoxelPositionCorner(
+      labeller, labeller->FaceEdgePoints + 9, cornerNeighbors, inNeighborIdx, axis);
+    quadMidIds[3] = points->InsertNextPoint(labeller->FaceEdgePoints + 9);
   }
 
   // Now there are 9 possibilities
   // (10 if you count the two ways to triangulate the simple quad).
   // No edges, $ cases with one mid point, 4 cases with two mid points.
   // That is all because the face is always the smallest of the two in/out voxels.
-  int caseIdx = this->FaceEdgeFlags[0] | (this->FaceEdgeFlags[1] << 1) |
-    (this->FaceEdgeFlags[2] << 2) | (this->FaceEdgeFlags[3] << 3);
+  int caseIdx = labeller->FaceEdgeFlags[0] | (labeller->FaceEdgeFlags[1] << 1) |
+    (labeller->FaceEdgeFlags[2] << 2) | (labeller->FaceEdgeFlags[3] << 3);
 
   // c2 e3 c3
   // e1    e2
@@ -4689,10 +5165,10 @@ void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterIterator*
       // This will help us decide which way to split up the quad into triangles.
       double d0011 = 0.0;
       double d0110 = 0.0;
-      double* pt00 = this->FaceCornerPoints;
-      double* pt01 = this->FaceCornerPoints + 3;
-      double* pt10 = this->FaceCornerPoints + 6;
-      double* pt11 = this->FaceCornerPoints + 9;
+      double* pt00 = labeller->FaceCornerPoints;
+      double* pt01 = labeller->FaceCornerPoints + 3;
+      double* pt10 = labeller->FaceCornerPoints + 6;
+      double* pt11 = labeller->FaceCornerPoints + 9;
       for (int ii = 0; ii < 3; ++ii)
       {
         double tmp2 = pt00[ii] - pt11[ii];
@@ -4742,7 +5218,7 @@ void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterIterator*
 
     // fragment
     vtkDoubleArray* destArray =
-      dynamic_cast<vtkDoubleArray*>(this->CurrentFragmentMesh->GetCellData()->GetArray(i));
+      dynamic_cast<vtkDoubleArray*>(labeller->Mesh->GetCellData()->GetArray(i));
     for (vtkIdType ii = 0; ii < numTris; ++ii)
     {
       destArray->InsertNextTuple(&thisTup[0]);
@@ -4751,13 +5227,13 @@ void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterIterator*
 // Cell data attributes for debugging.
 #ifdef vtkMaterialInterfaceFilterDEBUG
   vtkIntArray* levelArray =
-    dynamic_cast<vtkIntArray*>(this->CurrentFragmentMesh->GetCellData()->GetArray("Level"));
+    dynamic_cast<vtkIntArray*>(labeller->Mesh->GetCellData()->GetArray("Level"));
 
   vtkIntArray* blockIdArray =
-    dynamic_cast<vtkIntArray*>(this->CurrentFragmentMesh->GetCellData()->GetArray("BlockId"));
+    dynamic_cast<vtkIntArray*>(labeller->Mesh->GetCellData()->GetArray("BlockId"));
 
   vtkIntArray* procIdArray =
-    dynamic_cast<vtkIntArray*>(this->CurrentFragmentMesh->GetCellData()->GetArray("ProcId"));
+    dynamic_cast<vtkIntArray*>(labeller->Mesh->GetCellData()->GetArray("ProcId"));
 
   for (vtkIdType ii = 0; ii < numTris; ++ii)
   {
@@ -4771,8 +5247,9 @@ void vtkMaterialInterfaceFilter::CreateFace(vtkMaterialInterfaceFilterIterator*
 //----------------------------------------------------------------------------
 // Computes the face and edge middle points of the shared contact face
 // between the two iterators.
-void vtkMaterialInterfaceFilter::ComputeFacePoints(vtkMaterialInterfaceFilterIterator* in,
-  vtkMaterialInterfaceFilterIterator* out, int axis, int outMaxFlag)
+void vtkMaterialInterfaceFilter::ComputeFacePoints(vtkMaterialInterfaceFilterLabeller* labeller,
+  vtkMaterialInterfaceFilterIterator* in, vtkMaterialInterfaceFilterIterator* out, int axis,
+  int outMaxFlag)
 {
   vtkMaterialInterfaceFilterIterator* smaller;
   double* origin;
@@ -4812,42 +5289,44 @@ void vtkMaterialInterfaceFilter::ComputeFacePoints(vtkMaterialInterfaceFilterIte
   // 6 9
   // 0 3
   // First set them all to the origin.
-  this->FaceCornerPoints[0] = this->FaceCornerPoints[3] = this->FaceCornerPoints[6] =
-    this->FaceCornerPoints[9] = faceOrigin[0];
-  this->FaceCornerPoints[1] = this->FaceCornerPoints[4] = this->FaceCornerPoints[7] =
-    this->FaceCornerPoints[10] = faceOrigin[1];
-  this->FaceCornerPoints[2] = this->FaceCornerPoints[5] = this->FaceCornerPoints[8] =
-    this->FaceCornerPoints[11] = faceOrigin[2];
+  labeller->FaceCornerPoints[0] = labeller->FaceCornerPoints[3] = labeller->FaceCornerPoints[6] =
+    labeller->FaceCornerPoints[9] = faceOrigin[0];
+  labeller->FaceCornerPoints[1] = labeller->FaceCornerPoints[4] = labeller->FaceCornerPoints[7] =
+    labeller->FaceCornerPoints[10] = faceOrigin[1];
+  labeller->FaceCornerPoints[2] = labeller->FaceCornerPoints[5] = labeller->FaceCornerPoints[8] =
+    labeller->FaceCornerPoints[11] = faceOrigin[2];
   // Now offset them to the corners.
-  this->FaceCornerPoints[3 + axis1] += spacing[axis1];
-  this->FaceCornerPoints[9 + axis1] += spacing[axis1];
-  this->FaceCornerPoints[6 + axis2] += spacing[axis2];
-  this->FaceCornerPoints[9 + axis2] += spacing[axis2];
+  labeller->FaceCornerPoints[3 + axis1] += spacing[axis1];
+  labeller->FaceCornerPoints[9 + axis1] += spacing[axis1];
+  labeller->FaceCornerPoints[6 + axis2] += spacing[axis2];
+  labeller->FaceCornerPoints[9 + axis2] += spacing[axis2];
 
   // Now do the same for the edge points
   //   3
   // 1   2
   //   0
   // First set them all to the origin.
-  this->FaceEdgePoints[0] = this->FaceEdgePoints[3] = this->FaceEdgePoints[6] =
-    this->FaceEdgePoints[9] = faceOrigin[0];
-  this->FaceEdgePoints[1] = this->FaceEdgePoints[4] = this->FaceEdgePoints[7] =
-    this->FaceEdgePoints[10] = faceOrigin[1];
-  this->FaceEdgePoints[2] = this->FaceEdgePoints[5] = this->FaceEdgePoints[8] =
-    this->FaceEdgePoints[11] = faceOrigin[2];
+  labeller->FaceEdgePoints[0] = labeller->FaceEdgePoints[3] = labeller->FaceEdgePoints[6] =
+    labeller->FaceEdgePoints[9] = faceOrigin[0];
+  labeller->FaceEdgePoints[1] = labeller->FaceEdgePoints[4] = labeller->FaceEdgePoints[7] =
+    labeller->FaceEdgePoints[10] = faceOrigin[1];
+  labeller->FaceEdgePoints[2] = labeller->FaceEdgePoints[5] = labeller->FaceEdgePoints[8] =
+    labeller->FaceEdgePoints[11] = faceOrigin[2];
   // Now offset the points to the middle of the edges.
-  this->FaceEdgePoints[axis1] += halfSpacing[axis1];
-  this->FaceEdgePoints[9 + axis1] += halfSpacing[axis1];
-  this->FaceEdgePoints[6 + axis1] += spacing[axis1];
-  this->FaceEdgePoints[3 + axis2] += halfSpacing[axis2];
-  this->FaceEdgePoints[6 + axis2] += halfSpacing[axis2];
-  this->FaceEdgePoints[9 + axis2] += spacing[axis2];
+  labeller->FaceEdgePoints[axis1] += halfSpacing[axis1];
+  labeller->FaceEdgePoints[9 + axis1] += halfSpacing[axis1];
+  labeller->FaceEdgePoints[6 + axis1] += spacing[axis1];
+  labeller->FaceEdgePoints[3 + axis2] += halfSpacing[axis2];
+  labeller->FaceEdgePoints[6 + axis2] += halfSpacing[axis2];
+  labeller->FaceEdgePoints[9 + axis2] += spacing[axis2];
 }
 
 //----------------------------------------------------------------------------
-void vtkMaterialInterfaceFilter::ComputeFaceNeighbors(vtkMaterialInterfaceFilterIterator* in,
+void vtkMaterialInterfaceFilter::ComputeFaceNeighbors(
+  vtkMaterialInterfaceFilterLabeller* labeller, vtkMaterialInterfaceFilterIterator* in,
   vtkMaterialInterfaceFilterIterator* out, int axis, int outMaxFlag)
 {
+  vtkMaterialInterfaceFilterIterator* neighbors = labeller->FaceNeighbors;
   int axis1 = (axis + 1) % 3;
   int axis2 = (axis + 2) % 3;
 
@@ -4893,17 +5372,15 @@ void vtkMaterialInterfaceFilter::ComputeFaceNeighbors(vtkMaterialInterfaceFilter
   // for subdivision.
   if (outMaxFlag)
   {
-    this->FaceNeighbors[10] = this->FaceNeighbors[12] = this->FaceNeighbors[18] =
-      this->FaceNeighbors[20] = *in;
-    this->FaceNeighbors[11] = this->FaceNeighbors[13] = this->FaceNeighbors[19] =
-      this->FaceNeighbors[21] = *out;
+    neighbors[10] = neighbors[12] = neighbors[18] =
+      neighbors[20] = *in;
+    neighbors[11] = neighbors[13] = neighbors[19] = neighbors[21] = *out;
   }
   else
   {
-    this->FaceNeighbors[10] = this->FaceNeighbors[12] = this->FaceNeighbors[18] =
-      this->FaceNeighbors[20] = *out;
-    this->FaceNeighbors[11] = this->FaceNeighbors[13] = this->FaceNeighbors[19] =
-      this->FaceNeighbors[21] = *in;
+    neighbors[10] = neighbors[12] = neighbors[18] =
+      neighbors[20] = *out;
+    neighbors[11] = neighbors[13] = neighbors[19] = neighbors[21] = *in;
   }
 
   // Ok, we have 24 neighbors to compute.
@@ -4913,91 +5390,83 @@ void vtkMaterialInterfaceFilter::ComputeFaceNeighbors(vtkMaterialInterfaceFilter
   // increments: 1, 2, 8
   // Start at the corner and march around the edges.
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 3, this->FaceNeighbors + 11);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 3, neighbors + 11);
   faceIndex[axis1] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 5, this->FaceNeighbors + 3);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 5, neighbors + 3);
   faceIndex[axis1] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 7, this->FaceNeighbors + 5);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 7, neighbors + 5);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 15, this->FaceNeighbors + 7);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 15, neighbors + 7);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 23, this->FaceNeighbors + 15);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 23, neighbors + 15);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 31, this->FaceNeighbors + 23);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 31, neighbors + 23);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 29, this->FaceNeighbors + 31);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 29, neighbors + 31);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 27, this->FaceNeighbors + 29);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 27, neighbors + 29);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 25, this->FaceNeighbors + 27);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 25, neighbors + 27);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 17, this->FaceNeighbors + 25);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 17, neighbors + 25);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 9, this->FaceNeighbors + 17);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 9, neighbors + 17);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 1, this->FaceNeighbors + 9);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 1, neighbors + 9);
   // Now for the other side (min axis).
   faceIndex[axis] -= 1;  // Move to the other layer
   faceIndex[axis1] += 1; // Start below reference block.
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 2, this->FaceNeighbors + 10);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 2, neighbors + 10);
   faceIndex[axis1] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 4, this->FaceNeighbors + 2);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 4, neighbors + 2);
   faceIndex[axis1] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 6, this->FaceNeighbors + 4);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 6, neighbors + 4);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 14, this->FaceNeighbors + 6);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 14, neighbors + 6);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 22, this->FaceNeighbors + 14);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 22, neighbors + 14);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 30, this->FaceNeighbors + 22);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 30, neighbors + 22);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 28, this->FaceNeighbors + 30);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 28, neighbors + 30);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 26, this->FaceNeighbors + 28);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 26, neighbors + 28);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 24, this->FaceNeighbors + 26);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 24, neighbors + 26);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 16, this->FaceNeighbors + 24);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 16, neighbors + 24);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 8, this->FaceNeighbors + 16);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 8, neighbors + 16);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors + 0, this->FaceNeighbors + 8);
+  this->FindNeighbor(faceIndex, faceLevel, neighbors + 0, neighbors + 8);
 
   // Split edges if neighbors are a higher level than face.
   --faceLevel;
-  this->FaceEdgeFlags[0] = 0;
+  labeller->FaceEdgeFlags[0] = 0;
   // Checking equivalences (this->FaceNeighbor[2] != this->FaceNeighbor[4])
   // May be faster and work fine.
-  if (this->FaceNeighbors[2].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[3].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[4].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[5].Block->GetLevel() > faceLevel)
+  if (neighbors[2].Block->GetLevel() > faceLevel || neighbors[3].Block->GetLevel() > faceLevel ||
+    neighbors[4].Block->GetLevel() > faceLevel || neighbors[5].Block->GetLevel() > faceLevel)
   {
-    this->FaceEdgeFlags[0] = 1;
+    labeller->FaceEdgeFlags[0] = 1;
   }
-  this->FaceEdgeFlags[1] = 0;
-  if (this->FaceNeighbors[8].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[9].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[16].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[17].Block->GetLevel() > faceLevel)
+  labeller->FaceEdgeFlags[1] = 0;
+  if (neighbors[8].Block->GetLevel() > faceLevel || neighbors[9].Block->GetLevel() > faceLevel ||
+    neighbors[16].Block->GetLevel() > faceLevel || neighbors[17].Block->GetLevel() > faceLevel)
   {
-    this->FaceEdgeFlags[1] = 1;
+    labeller->FaceEdgeFlags[1] = 1;
   }
-  this->FaceEdgeFlags[2] = 0;
-  if (this->FaceNeighbors[14].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[15].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[22].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[23].Block->GetLevel() > faceLevel)
+  labeller->FaceEdgeFlags[2] = 0;
+  if (neighbors[14].Block->GetLevel() > faceLevel || neighbors[15].Block->GetLevel() > faceLevel ||
+    neighbors[22].Block->GetLevel() > faceLevel || neighbors[23].Block->GetLevel() > faceLevel)
   {
-    this->FaceEdgeFlags[2] = 1;
+    labeller->FaceEdgeFlags[2] = 1;
   }
-  this->FaceEdgeFlags[3] = 0;
-  if (this->FaceNeighbors[26].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[27].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[28].Block->GetLevel() > faceLevel ||
-    this->FaceNeighbors[29].Block->GetLevel() > faceLevel)
+  labeller->FaceEdgeFlags[3] = 0;
+  if (neighbors[26].Block->GetLevel() > faceLevel || neighbors[27].Block->GetLevel() > faceLevel ||
+    neighbors[28].Block->GetLevel() > faceLevel || neighbors[29].Block->GetLevel() > faceLevel)
   {
-    this->FaceEdgeFlags[3] = 1;
+    labeller->FaceEdgeFlags[3] = 1;
   }
 }
 
@@ -5477,8 +5946,8 @@ inline int vtkMaterialInterfaceFilter::AccumulateMoments(double* moments, // =(M
 // This extracts faces at the same time.
 // This integrates quantities at the same time.
 // This is called only when the voxel is part of a fragment.
-// I tried to create a generic API to replace the hard coded conditional ifs.
-void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingBuffer* queue)
+void vtkMaterialInterfaceFilter::ConnectFragment(
+  vtkMaterialInterfaceFilterLabeller* labeller, vtkMaterialInterfaceFilterRingBuffer* queue)
 {
   while (queue->GetSize())
   {
@@ -5498,14 +5967,14 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
       double voxelVolumeFrac =
         dX[0] * dX[1] * dX[2] * (double)(*(iterator.VolumeFractionPointer)) / 255.0;
 #endif
-      this->FragmentVolume += voxelVolumeFrac;
+      labeller->Volume += voxelVolumeFrac;
       // The clip depth is accumulated in SubvoxelPositionCorner.
       // accumulate volume weighted average
       for (int i = 0; i < this->NVolumeWtdAvgs; ++i)
       {
         vtkDataArray* arrayToIntegrate = iterator.Block->GetVolumeWtdAvgArray(i);
         int nComps = arrayToIntegrate->GetNumberOfComponents();
-        this->Accumulate(&this->FragmentVolumeWtdAvg[i][0], arrayToIntegrate, nComps,
+        this->Accumulate(&labeller->VolumeWtdAvg[i][0], arrayToIntegrate, nComps,
           iterator.FlatIndex, voxelVolumeFrac);
       }
       // accumulate mass weighted average
@@ -5517,7 +5986,7 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
         const double* X0 = iterator.Block->GetOrigin();
         double X[3] = { X0[0] + dX[0] * (0.5 + iterator.Index[0]),
           X0[1] + dX[1] * (0.5 + iterator.Index[1]), X0[2] + dX[2] * (0.5 + iterator.Index[2]) };
-        this->AccumulateMoments(&this->FragmentMoment[0], massArray, iterator.FlatIndex, X);
+        this->AccumulateMoments(&labeller->Moment[0], massArray, iterator.FlatIndex, X);
         // mass weighted averages
         double voxelMass;
         massArray->GetTuple(iterator.FlatIndex, &voxelMass);
@@ -5525,7 +5994,7 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
         {
           vtkDataArray* arrayToIntegrate = iterator.Block->GetMassWtdAvgArray(i);
           int nComps = arrayToIntegrate->GetNumberOfComponents();
-          this->Accumulate(&this->FragmentMassWtdAvg[i][0], arrayToIntegrate, nComps,
+          this->Accumulate(&labeller->MassWtdAvg[i][0], arrayToIntegrate, nComps,
             iterator.FlatIndex, voxelMass);
         }
       }
@@ -5535,44 +6004,31 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
         vtkDataArray* arrayToIntegrate = iterator.Block->GetArrayToSum(i);
         int nComps = arrayToIntegrate->GetNumberOfComponents();
         this->Accumulate(
-          &this->FragmentSum[i][0], arrayToIntegrate, nComps, iterator.FlatIndex, 1.0);
+          &labeller->Sum[i][0], arrayToIntegrate, nComps, iterator.FlatIndex, 1.0);
       }
     }
 
-    // Create another iterator on the stack for recursion.
-    vtkMaterialInterfaceFilterIterator next;
+    this->ConnectNeighbors(labeller, queue, &iterator);
+  }
+}
 
-    // Look at the face connected neighbors and recurse.
-    // We are not on the border and volume fraction of neighbor is high and
-    // we have not visited the voxel yet.
-    for (int ii = 0; ii < 3; ++ii)
+//----------------------------------------------------------------------------
+// Look at the face connected neighbors and recurse.
+// I tried to create a generic API to replace the hard coded conditional ifs.
+void vtkMaterialInterfaceFilter::ConnectNeighbors(vtkMaterialInterfaceFilterLabeller* labeller,
+  vtkMaterialInterfaceFilterRingBuffer* queue, vtkMaterialInterfaceFilterIterator* iterator)
+{
+  // Create another iterator on the stack for recursion.
+  vtkMaterialInterfaceFilterIterator next;
+  vtkMaterialInterfaceFilterIterator next2;
+
+  for (int ii = 0; ii < 3; ++ii)
+  {
+    // "Left"/min then "Right"/max
+    for (int maxFlag = 0; maxFlag < 2; ++maxFlag)
     {
-      // I would make these variables to make the computation more clear,
-      // but they would accumulate on the stack.
-      // axis0 = ii;
-      // axis1 = (ii+1)%3;
-      // axis2 = (ii+2)%3;
-      // idxMin = 2*ii;
-      // idxMax = 2*ii+1this->IndexMax+1;
-      // "Left"/min
-      this->GetNeighborIterator(&next, &iterator, ii, 0, (ii + 1) % 3, 0, (ii + 2) % 3, 0);
-
-      if (next.VolumeFractionPointer == 0 ||
-        next.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
-      {
-        // Neighbor is outside of fragment.  Make a face.
-        this->CreateFace(&iterator, &next, ii, 0);
-      }
-      else if (next.FragmentIdPointer[0] == -1)
-      { // We have not visited this neighbor yet. Mark the voxel and recurse.
-        *(next.FragmentIdPointer) = this->FragmentId;
-        queue->Push(&next);
-      }
-      else
-      { // The last case is that we have already visited this voxel and it
-        // is in the same fragment.
-        this->AddEquivalence(&iterator, &next);
-      }
+      this->GetNeighborIterator(&next, iterator, ii, maxFlag, (ii + 1) % 3, 0, (ii + 2) % 3, 0);
+      this->ConnectNeighbor(labeller, queue, iterator, &next, ii, maxFlag);
 
       // Handle the case when the new iterator is a higher level.
       // We need to loop over all the faces of the higher level that touch this face.
@@ -5580,163 +6036,83 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
       // If level skip, things should still work OK. Biggest issue is holes in surface.
       // This also sort of assumes that at most one other block touches this face.
       // Holes might appear if this is not true.
-      if (next.Block && next.Block->GetLevel() > iterator.Block->GetLevel())
+      if (next.Block && next.Block->GetLevel() > iterator->Block->GetLevel())
       {
-        vtkMaterialInterfaceFilterIterator next2;
+        next2.Block = 0;
         bool threeDimFlag = next.Block->GetBaseCellExtent()[4] < next.Block->GetBaseCellExtent()[5];
         // Take the first neighbor found and move +Y
         if (ii != 1 || threeDimFlag)
         { // stupid after the fact way of dealing with 2d AMR input.
           this->GetNeighborIterator(&next2, &next, (ii + 1) % 3, 1, (ii + 2) % 3, 0, ii, 0);
-          if (next2.VolumeFractionPointer == 0 ||
-            next2.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
-          {
-            // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next2, ii, 0);
-          }
-          else if (next2.FragmentIdPointer[0] == -1)
-          { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next2.FragmentIdPointer) = this->FragmentId;
-            queue->Push(&next2);
-          }
-          else
-          { // The last case is that we have already visited this voxel and it
-            // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
-          }
+          this->ConnectNeighbor(labeller, queue, iterator, &next2, ii, maxFlag);
         }
         // Take the fist iterator found and move +Z
         if (ii != 0 || threeDimFlag)
         { // stupid after the fact way of dealing with 2d AMR input.
           this->GetNeighborIterator(&next2, &next, (ii + 2) % 3, 1, ii, 0, (ii + 1) % 3, 0);
-          if (next2.VolumeFractionPointer == 0 ||
-            next2.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
-          {
-            // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next2, ii, 0);
-          }
-          else if (next2.FragmentIdPointer[0] == -1)
-          { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next2.FragmentIdPointer) = this->FragmentId;
-            queue->Push(&next2);
-          }
-          else
-          { // The last case is that we have already visited this voxel and it
-            // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
-          }
+          this->ConnectNeighbor(labeller, queue, iterator, &next2, ii, maxFlag);
         }
         // To get the +Y+Z start with the +Z iterator and move +Y put results in "next"
         if (next2.Block && threeDimFlag)
         {
           this->GetNeighborIterator(&next, &next2, (ii + 1) % 3, 1, (ii + 2) % 3, 0, ii, 0);
-          if (next.VolumeFractionPointer == 0 ||
-            next.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
-          {
-            // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next, ii, 0);
-          }
-          else if (next.FragmentIdPointer[0] == -1)
-          { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next.FragmentIdPointer) = this->FragmentId;
-            queue->Push(&next);
-          }
-          else
-          { // The last case is that we have already visited this voxel and it
-            // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
-          }
+          this->ConnectNeighbor(labeller, queue, iterator, &next, ii, maxFlag);
         }
       }
+    }
+  }
+}
 
-      // "Right"/max
-      this->GetNeighborIterator(&next, &iterator, ii, 1, (ii + 1) % 3, 0, (ii + 2) % 3, 0);
-      if (next.VolumeFractionPointer == 0 ||
-        next.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
-      { // Neighbor is outside of fragment.  Make a face.
-        this->CreateFace(&iterator, &next, ii, 1);
-      }
-      else if (next.FragmentIdPointer[0] == -1)
-      { // We have not visited this neighbor yet. Mark the voxel and recurse.
-        *(next.FragmentIdPointer) = this->FragmentId;
-        queue->Push(&next);
-      }
-      else
-      { // The last case is that we have already visited this voxel and it
-        // is in the same fragment.
-        this->AddEquivalence(&iterator, &next);
-      }
-      // Same case as above with the same logic to visit the
-      // four smaller cells that touch this face of the current block.
-      if (next.Block && next.Block->GetLevel() > iterator.Block->GetLevel())
+//----------------------------------------------------------------------------
+// A block is labelled without leaving it, the neighbors in other blocks are
+// connected once all the blocks are labelled (see ProcessBlocks).
+void vtkMaterialInterfaceFilter::ConnectNeighbor(vtkMaterialInterfaceFilterLabeller* labeller,
+  vtkMaterialInterfaceFilterRingBuffer* queue, vtkMaterialInterfaceFilterIterator* in,
+  vtkMaterialInterfaceFilterIterator* next, int axis, int outMaxFlag)
+{
+  bool otherBlock = (next->Block != labeller->Block);
+  if (labeller->Mode == vtkMaterialInterfaceFilterLabeller::STITCH_BLOCK && !otherBlock)
+  {
+    return;
+  }
+  if (next->VolumeFractionPointer == 0 ||
+    next->VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
+  {
+    // Neighbor is outside of fragment.  Make a face.
+    if (labeller->Mesh)
+    {
+      this->CreateFace(labeller, in, next, axis, outMaxFlag);
+    }
+    return;
+  }
+  if (otherBlock && labeller->Mode == vtkMaterialInterfaceFilterLabeller::LABEL_BLOCK)
+  {
+    return;
+  }
+  if (labeller->Mode == vtkMaterialInterfaceFilterLabeller::STITCH_BLOCK)
+  {
+    if (next->Block->GetGhostFlag() || next->FragmentIdPointer[0] == -1)
+    { // Continue the search from this voxel once all blocks are labelled.
+      vector<vtkMaterialInterfaceFilterIterator>& seeds = labeller->Fragments->Seeds;
+      if (seeds.empty() || seeds.back().FlatIndex != in->FlatIndex)
       {
-        vtkMaterialInterfaceFilterIterator next2;
-        bool threeDimFlag = next.Block->GetBaseCellExtent()[4] < next.Block->GetBaseCellExtent()[5];
-        // Take the first neighbor found and move +Y
-        if (ii != 1 || threeDimFlag)
-        { // stupid after the fact way of dealing with 2d AMR input.
-          this->GetNeighborIterator(&next2, &next, (ii + 1) % 3, 1, (ii + 2) % 3, 0, ii, 0);
-          if (next2.VolumeFractionPointer == 0 ||
-            next2.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
-          {
-            // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next2, ii, 1);
-          }
-          else if (next2.FragmentIdPointer[0] == -1)
-          { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next2.FragmentIdPointer) = this->FragmentId;
-            queue->Push(&next2);
-          }
-          else
-          { // The last case is that we have already visited this voxel and it
-            // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
-          }
-        }
-        // Take the fist iterator found and move +Z
-        if (ii != 0 || threeDimFlag)
-        { // stupid after the fact way of dealing with 2d AMR input.
-          this->GetNeighborIterator(&next2, &next, (ii + 2) % 3, 1, ii, 0, (ii + 1) % 3, 0);
-          if (next2.VolumeFractionPointer == 0 ||
-            next2.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
-          {
-            // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next2, ii, 1);
-          }
-          else if (next2.FragmentIdPointer[0] == -1)
-          { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next2.FragmentIdPointer) = this->FragmentId;
-            queue->Push(&next2);
-          }
-          else
-          { // The last case is that we have already visited this voxel and it
-            // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
-          }
-        }
-        // To get the +Y+Z start with the +Z iterator and move +Y put results in "next"
-        if (next2.Block && threeDimFlag)
-        {
-          this->GetNeighborIterator(&next, &next2, (ii + 1) % 3, 1, (ii + 2) % 3, 0, ii, 0);
-          if (next.VolumeFractionPointer == 0 ||
-            next.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
-          {
-            // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next, ii, 1);
-          }
-          else if (next.FragmentIdPointer[0] == -1)
-          { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next.FragmentIdPointer) = this->FragmentId;
-            queue->Push(&next);
-          }
-          else
-          { // The last case is that we have already visited this voxel and it
-            // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
-          }
-        }
+        seeds.push_back(*in);
       }
     }
+    else
+    {
+      labeller->Equivalences->AddEquivalence(in->FragmentIdPointer[0], next->FragmentIdPointer[0]);
+    }
+  }
+  else if (next->FragmentIdPointer[0] == -1)
+  { // We have not visited this neighbor yet. Mark the voxel and recurse.
+    *(next->FragmentIdPointer) = labeller->FragmentId;
+    queue->Push(next);
+  }
+  else
+  { // The last case is that we have already visited this voxel. Within a
+    // block it is in the same fragment, otherwise the fragments are equated.
+    this->AddEquivalence(in, next);
   }
 }
 
@@ -7903,7 +8279,7 @@ int vtkMaterialInterfaceFilter::PrepareToResolveIntegratedAttributes()
     NewVtkArrayPointer(this->ClipDepthMinimums, nComps, this->NumberOfResolvedFragments,
       this->ClipDepthMinimums->GetName());
     pResolved = this->ClipDepthMinimums->GetPointer(0);
-    memset(pResolved, 0, bytesPerComponent);
+    std::fill(pResolved, pResolved + this->NumberOfResolvedFragments, VTK_FLOAT_MAX);
   }
 
   // moments
@@ -8008,7 +8384,7 @@ int vtkMaterialInterfaceFilter::ResolveIntegratedAttributes(const int controllin
         for (int i = 0; i < nUnresolved; ++i)
         {
           int resIdx = this->EquivalenceSet->GetEquivalentSetId(eqSetId);
-          pResolved[resIdx] += pUnresolved[0];
+          pResolved[resIdx] = std::max(pResolved[resIdx], pUnresolved[0]);
           ++pUnresolved;
           ++eqSetId;
         }
@@ -8018,7 +8394,7 @@ int vtkMaterialInterfaceFilter::ResolveIntegratedAttributes(const int controllin
         for (int i = 0; i < nUnresolved; ++i)
         {
           int resIdx = this->EquivalenceSet->GetEquivalentSetId(eqSetId);
-          pResolved[resIdx] += pUnresolved[0];
+          pResolved[resIdx] = std::min(pResolved[resIdx], pUnresolved[0]);
           ++pUnresolved;
           ++eqSetId;
         }
@@ -8321,8 +8697,6 @@ void vtkMaterialInterfaceFilter::GatherEquivalenceSets(vtkMaterialInterfaceEquiv
   for (int ii = 0; ii < numLocalMembers; ++ii)
   {
     memberSetId = set->GetEquivalentSetId(ii);
-    // This will be inefficient until I make the scheduled improvemnt to the
-    // add method (Ordered multilevel tree instead of a one level tree).
     globalSet->AddEquivalence(ii + myOffset, memberSetId + myOffset);
   }
 
@@ -8393,7 +8767,7 @@ void vtkMaterialInterfaceFilter::MergeGhostEquivalenceSets(
     for (int jj = 0; jj < numIds; ++jj)
     {
       if (tmp[jj] != jj)
-      { // TODO: Make sure this is efficient.  Avoid n^2.
+      {
         globalSet->AddEquivalence(jj, tmp[jj]);
       }
     }
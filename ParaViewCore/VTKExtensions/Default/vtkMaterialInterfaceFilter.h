@@ -63,6 +63,9 @@ class vtkMaterialInterfaceFilterBlock;
 class vtkMaterialInterfaceFilterIterator;
 class vtkMaterialInterfaceEquivalenceSet;
 class vtkMaterialInterfaceFilterRingBuffer;
+class vtkMaterialInterfaceFilterLabeller;
+class vtkMaterialInterfaceFilterBlockFragments;
+class vtkMaterialInterfaceConcurrentEquivalenceSet;
 class vtkMaterialInterfacePieceLoading;
 class vtkMaterialInterfaceCommBuffer;
 
@@ -348,22 +351,45 @@ protected:
     std::vector<std::string>& integratedArrayNames);
   // Craete a new fragment/piece.
   vtkPolyData* NewFragmentMesh();
-  // Process each cell, looking for fragments.
-  int ProcessBlock(int blockId);
+  // Label the fragments of all the local blocks. Blocks are labelled
+  // concurrently, then connected to their neighbors.
+  void ProcessBlocks();
+  // Process each cell, looking for the fragments of a single block.
+  int ProcessBlock(int blockId, vtkMaterialInterfaceFilterBlockFragments* fragments);
+  // Turn the block local fragment ids into ids local to this process.
+  void RelabelBlock(int blockId, vtkMaterialInterfaceFilterBlockFragments* fragments);
+  // Find the equivalences between the fragments of a block and those of
+  // its neighbors.
+  void StitchBlock(int blockId, vtkMaterialInterfaceFilterBlockFragments* fragments,
+    vtkMaterialInterfaceConcurrentEquivalenceSet* equivalences);
+  // Size the accumulators of a labeller for the result arrays.
+  void InitializeAccumulators(vtkMaterialInterfaceFilterLabeller* labeller);
+  // Save the fragment that was just connected and clear the accumulators.
+  void SaveFragment(vtkMaterialInterfaceFilterLabeller* labeller);
+  // Add to a saved fragment what was connected to it across blocks.
+  void AddToFragment(vtkMaterialInterfaceFilterLabeller* labeller);
   // Cell has been identified as inside the fragment. Integrate, and
   // generate fragement surface etc...
-  void ConnectFragment(vtkMaterialInterfaceFilterRingBuffer* iterator);
+  void ConnectFragment(
+    vtkMaterialInterfaceFilterLabeller* labeller, vtkMaterialInterfaceFilterRingBuffer* queue);
+  // Visit the face connected neighbors of a voxel.
+  void ConnectNeighbors(vtkMaterialInterfaceFilterLabeller* labeller,
+    vtkMaterialInterfaceFilterRingBuffer* queue, vtkMaterialInterfaceFilterIterator* iterator);
+  void ConnectNeighbor(vtkMaterialInterfaceFilterLabeller* labeller,
+    vtkMaterialInterfaceFilterRingBuffer* queue, vtkMaterialInterfaceFilterIterator* in,
+    vtkMaterialInterfaceFilterIterator* next, int axis, int outMaxFlag);
   void GetNeighborIterator(vtkMaterialInterfaceFilterIterator* next,
     vtkMaterialInterfaceFilterIterator* iterator, int axis0, int maxFlag0, int axis1, int maxFlag1,
     int axis2, int maxFlag2);
   void GetNeighborIteratorPad(vtkMaterialInterfaceFilterIterator* next,
     vtkMaterialInterfaceFilterIterator* iterator, int axis0, int maxFlag0, int axis1, int maxFlag1,
     int axis2, int maxFlag2);
-  void CreateFace(vtkMaterialInterfaceFilterIterator* in, vtkMaterialInterfaceFilterIterator* out,
-    int axis, int outMaxFlag);
+  void CreateFace(vtkMaterialInterfaceFilterLabeller* labeller,
+    vtkMaterialInterfaceFilterIterator* in, vtkMaterialInterfaceFilterIterator* out, int axis,
+    int outMaxFlag);
   int ComputeDisplacementFactors(vtkMaterialInterfaceFilterIterator* pointNeighborIterators[8],
     double displacmentFactors[3], int rootNeighborIdx, int faceAxis);
-  int SubVoxelPositionCorner(double* point,
+  int SubVoxelPositionCorner(vtkMaterialInterfaceFilterLabeller* labeller, double* point,
     vtkMaterialInterfaceFilterIterator* pointNeighborIterators[8], int rootNeighborIdx,
     int faceAxis);
   void FindPointNeighbors(vtkMaterialInterfaceFilterIterator* iteratorMin0,
@@ -525,10 +551,6 @@ protected:
   char* MaterialFractionArrayName;
   vtkSetStringMacro(MaterialFractionArrayName);
 
-  // while processing a material array this holds
-  // a pointer to the output poly data
-  // data set
-  vtkPolyData* CurrentFragmentMesh;
   // As peices/fragments are found they are stored here
   // until resolution.
   std::vector<vtkPolyData*> FragmentMeshes;
@@ -538,23 +560,18 @@ protected:
   // all of the supported operations.
   /// class vtkMaterialInterfaceFilterIntegrator
   ///{
-  // Local id of current fragment
+  // Number of fragments found on this process, the accumulators for
+  // the fragment being connected are in vtkMaterialInterfaceFilterLabeller.
   int FragmentId;
-  // Accumulator for the volume of the current fragment.
-  double FragmentVolume;
   // Fragment volumes indexed by the fragment id. It's a local
   // per-process indexing until fragments have been resolved
   vtkDoubleArray* FragmentVolumes;
 
   // Min and max depth of crater.
   // These are only computed when the clip plane is on.
-  double ClipDepthMin;
-  double ClipDepthMax;
   vtkDoubleArray* ClipDepthMinimums;
   vtkDoubleArray* ClipDepthMaximums;
 
-  // Accumulator for moments of the current fragment
-  std::vector<double> FragmentMoment; // =(Myz, Mxz, Mxy, m)
   // Moments indexed by fragment id
   vtkDoubleArray* FragmentMoments;
   // Centers of fragment AABBs, only computed if moments are not
@@ -563,8 +580,6 @@ protected:
   bool ComputeMoments;
 
   // Weighted average, where weights correspond to fragment volume.
-  // Accumulators one for each array to average, scalar or vector
-  std::vector<std::vector<double> > FragmentVolumeWtdAvg;
   // weighted averages indexed by fragment id.
   std::vector<vtkDoubleArray*> FragmentVolumeWtdAvgs;
   // number of arrays for which to compute the weighted average
@@ -573,8 +588,6 @@ protected:
   std::vector<std::string> VolumeWtdAvgArrayNames;
 
   // Weighted average, where weights correspond to fragment mass.
-  // Accumulators one for each array to average, scalar or vector
-  std::vector<std::vector<double> > FragmentMassWtdAvg;
   // weighted averages indexed by fragment id.
   std::vector<vtkDoubleArray*> FragmentMassWtdAvgs;
   // number of arrays for which to compute the weighted average
@@ -591,8 +604,6 @@ protected:
   int NToIntegrate;
 
   // Sum of data over the fragment.
-  // Accumulators, one for each array to sum
-  std::vector<std::vector<double> > FragmentSum;
   // sums indexed by fragment id.
   std::vector<vtkDoubleArray*> FragmentSums;
   // number of arrays for which to compute the weighted average
@@ -656,20 +667,15 @@ protected:
   // It could be changed into the primary storage of blocks.
   std::vector<vtkMaterialInterfaceLevel*> Levels;
 
-  // Ivars for computing the point on corners and edges of a face.
-  vtkMaterialInterfaceFilterIterator* FaceNeighbors;
-  // Permutation of the neighbors. Axis0 normal to face.
-  int faceAxis0;
-  int faceAxis1;
-  int faceAxis2;
-  double FaceCornerPoints[12];
-  double FaceEdgePoints[12];
-  int FaceEdgeFlags[4];
+  // Compute the point on corners and edges of a face, the results are
+  // stored in the labeller.
   // outMaxFlag implies out is positive direction of axis.
-  void ComputeFacePoints(vtkMaterialInterfaceFilterIterator* in,
-    vtkMaterialInterfaceFilterIterator* out, int axis, int outMaxFlag);
-  void ComputeFaceNeighbors(vtkMaterialInterfaceFilterIterator* in,
-    vtkMaterialInterfaceFilterIterator* out, int axis, int outMaxFlag);
+  void ComputeFacePoints(vtkMaterialInterfaceFilterLabeller* labeller,
+    vtkMaterialInterfaceFilterIterator* in, vtkMaterialInterfaceFilterIterator* out, int axis,
+    int outMaxFlag);
+  void ComputeFaceNeighbors(vtkMaterialInterfaceFilterLabeller* labeller,
+    vtkMaterialInterfaceFilterIterator* in, vtkMaterialInterfaceFilterIterator* out, int axis,
+    int outMaxFlag);
 
   long ComputeProximity(const int faceIdx[3], int faceLevel, const int ext[6], int refLevel);
 
@@ -724,6 +730,8 @@ protected:
 #endif
 
 private:
+  friend class vtkMaterialInterfaceFilterBlockFunctor;
+
   vtkMaterialInterfaceFilter(const vtkMaterialInterfaceFilter&) = delete;
   void operator=(const vtkMaterialInterfaceFilter&) = delete;
 };
@@ -25,6 +25,7 @@
 #include "vtkPVXMLParser.h"
 #include "vtkPhastaReader.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnstructuredGrid.h"
@@ -33,6 +34,8 @@
 
 #include <map>
 #include <sstream>
+#include <string>
+#include <vector>
 
 struct vtkPPhastaReaderInternal
 {
@@ -54,6 +57,35 @@ struct vtkPPhastaReaderInternal
   TimeStepInfoMapType TimeStepInfoMap;
   typedef std::map<int, vtkSmartPointer<vtkUnstructuredGrid> > CachedGridsMapType;
   CachedGridsMapType CachedGrids;
+
+  struct PieceInfo
+  {
+    int Index;
+    std::string GeometryFileName;
+    std::string FieldFileName;
+    vtkSmartPointer<vtkUnstructuredGrid> CachedGrid;
+    vtkSmartPointer<vtkUnstructuredGrid> Output;
+    int Status;
+  };
+
+  // Reads the pieces in [begin, end). Each piece only touches its own files
+  // and output, so pieces are read concurrently.
+  struct ReadPiecesFunctor
+  {
+    vtkPhastaReader* Reader;
+    std::vector<PieceInfo>* Pieces;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType i = begin; i < end; i++)
+      {
+        PieceInfo& info = (*this->Pieces)[i];
+        info.Output = vtkSmartPointer<vtkUnstructuredGrid>::New();
+        info.Status = this->Reader->ReadPiece(info.GeometryFileName.c_str(),
+          info.FieldFileName.c_str(), info.CachedGrid, info.Output);
+      }
+    }
+  };
 };
 
 //----------------------------------------------------------------------------
@@ -211,6 +243,7 @@ int vtkPPhastaReader::RequestData(
   char* field_name = new char[strlen(fieldPattern) + 60];
 
   // now loop over all of the files that I should load
+  std::vector<vtkPPhastaReaderInternal::PieceInfo> pieces;
   for (int loadingPiece = piece; loadingPiece < numPieces; loadingPiece += numProcPieces)
   {
     if (geomHasTime && geomHasPiece)
@@ -248,7 +281,7 @@ int vtkPPhastaReader::RequestData(
     }
     else
     {
-      strcpy(geom_name, fieldPattern);
+      strcpy(field_name, fieldPattern);
     }
 
     std::ostringstream geomFName;
@@ -261,8 +294,7 @@ int vtkPPhastaReader::RequestData(
         geomFName << path.c_str() << "/";
       }
     }
-    geomFName << geom_name << ends;
-    this->Reader->SetGeometryFileName(geomFName.str().c_str());
+    geomFName << geom_name;
 
     std::ostringstream fieldFName;
     std::string fpath = vtksys::SystemTools::GetFilenamePath(field_name);
@@ -274,37 +306,54 @@ int vtkPPhastaReader::RequestData(
         fieldFName << path.c_str() << "/";
       }
     }
-    fieldFName << field_name << ends;
-    this->Reader->SetFieldFileName(fieldFName.str().c_str());
+    fieldFName << field_name;
 
-    vtkPPhastaReaderInternal::CachedGridsMapType::iterator CachedCopy =
-      this->Internal->CachedGrids.find(loadingPiece);
+    vtkPPhastaReaderInternal::PieceInfo info;
+    info.Index = loadingPiece;
+    info.GeometryFileName = geomFName.str();
+    info.FieldFileName = fieldFName.str();
+    info.Status = 0;
 
     // if there is a cached copy, use that
+    vtkPPhastaReaderInternal::CachedGridsMapType::iterator CachedCopy =
+      this->Internal->CachedGrids.find(loadingPiece);
     if (CachedCopy != this->Internal->CachedGrids.end())
     {
-      this->Reader->SetCachedGrid(CachedCopy->second);
+      info.CachedGrid = CachedCopy->second;
     }
+    pieces.push_back(info);
+  }
 
-    this->Reader->Update();
+  delete[] geom_name;
+  delete[] field_name;
+
+  vtkPPhastaReaderInternal::ReadPiecesFunctor functor;
+  functor.Reader = this->Reader;
+  functor.Pieces = &pieces;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(pieces.size()), functor);
 
-    if (CachedCopy == this->Internal->CachedGrids.end())
+  for (size_t i = 0; i < pieces.size(); i++)
+  {
+    vtkPPhastaReaderInternal::PieceInfo& info = pieces[i];
+    if (!info.Status)
+    {
+      vtkErrorMacro("Could not read piece " << info.Index << " from "
+                                            << info.GeometryFileName << " and "
+                                            << info.FieldFileName);
+    }
+
+    if (!info.CachedGrid)
     {
       vtkSmartPointer<vtkUnstructuredGrid> cached = vtkSmartPointer<vtkUnstructuredGrid>::New();
-      cached->ShallowCopy(this->Reader->GetOutput());
+      cached->ShallowCopy(info.Output);
       cached->GetPointData()->Initialize();
       cached->GetCellData()->Initialize();
       cached->GetFieldData()->Initialize();
-      this->Internal->CachedGrids[loadingPiece] = cached;
+      this->Internal->CachedGrids[info.Index] = cached;
     }
-    vtkSmartPointer<vtkUnstructuredGrid> copy = vtkSmartPointer<vtkUnstructuredGrid>::New();
-    copy->ShallowCopy(this->Reader->GetOutput());
-    MultiPieceDataSet->SetPiece(loadingPiece, copy);
+    MultiPieceDataSet->SetPiece(info.Index, info.Output);
   }
 
-  delete[] geom_name;
-  delete[] field_name;
-
   if (steps)
   {
     output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), steps[this->ActualTimeStep]);
@@ -17,13 +17,18 @@
 #include "vtkCellData.h"
 #include "vtkDataObject.h"
 #include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
 #include "vtkFunctionParser.h"
 #include "vtkGraph.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVExpressionEvaluator.h"
 #include "vtkPVPostFilter.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
 #include "vtkTable.h"
 
 #include <algorithm>
@@ -31,6 +36,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace
 {
@@ -73,11 +79,14 @@ vtkStandardNewMacro(vtkPVArrayCalculator);
 // ----------------------------------------------------------------------------
 vtkPVArrayCalculator::vtkPVArrayCalculator()
 {
+  this->Evaluator = vtkPVExpressionEvaluator::New();
+  this->Evaluator->SetSyntax(vtkPVExpressionEvaluator::FUNCTION_PARSER_SYNTAX);
 }
 
 // ----------------------------------------------------------------------------
 vtkPVArrayCalculator::~vtkPVArrayCalculator()
 {
+  this->Evaluator->Delete();
 }
 
 // ----------------------------------------------------------------------------
@@ -197,11 +206,92 @@ int vtkPVArrayCalculator::RequestData(
     // put is the input of a (some) subsequent calculator(s) or the user changes
     // the input of a downstream calculator.
     this->UpdateArrayAndVariableNames(input, dataAttrs);
+
+    vtkDataObject* output = vtkDataObject::GetData(outputVector, 0);
+    if (this->EvaluateNatively(input, output, attributeType))
+    {
+      return 1;
+    }
   }
 
   return this->Superclass::RequestData(request, inputVector, outputVector);
 }
 
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculator::EvaluateNatively(
+  vtkDataObject* input, vtkDataObject* output, int attributeType)
+{
+  // vtkFunctionParser reports invalid values as errors unless they are
+  // replaced, and only the superclass knows how to output vector results.
+  if (!this->GetFunction() || !this->GetReplaceInvalidValues() || this->GetCoordinateResults() ||
+    this->GetResultNormals() || this->GetResultTCoords() || !output)
+  {
+    return false;
+  }
+  vtkDataSetAttributes* inDataAttrs = input->GetAttributes(attributeType);
+  if ((!vtkDataSet::SafeDownCast(input) && !vtkTable::SafeDownCast(input)) || !inDataAttrs)
+  {
+    return false;
+  }
+
+  this->Evaluator->SetExpression(this->GetFunction());
+  this->Evaluator->SetReplaceInvalidValues(true);
+  this->Evaluator->SetReplacementValue(this->GetReplacementValue());
+  if (!this->Evaluator->Compile())
+  {
+    return false;
+  }
+
+  // bind the variables registered with the superclass.
+  std::vector<vtkPVExpressionEvaluator::Scope> scopes(1);
+  vtkPVExpressionEvaluator::Scope& scope = scopes[0];
+  scope.NumberOfElements = input->GetNumberOfElements(attributeType);
+  for (int cc = 0; cc < this->GetNumberOfScalarArrays(); ++cc)
+  {
+    scope.AddVariable(this->GetScalarVariableName(cc),
+      inDataAttrs->GetArray(this->GetScalarArrayName(cc)), this->GetSelectedScalarComponent(cc));
+  }
+  for (int cc = 0; cc < this->GetNumberOfVectorArrays(); ++cc)
+  {
+    scope.AddVariable(
+      this->GetVectorVariableName(cc), inDataAttrs->GetArray(this->GetVectorArrayName(cc)));
+  }
+  vtkPointSet* psInput = vtkPointSet::SafeDownCast(input);
+  if (attributeType == vtkDataObject::POINT && psInput && psInput->GetPoints())
+  {
+    vtkDataArray* coords = psInput->GetPoints()->GetData();
+    for (int cc = 0; cc < this->GetNumberOfCoordinateScalarArrays(); ++cc)
+    {
+      scope.AddVariable(this->GetCoordinateScalarVariableName(cc), coords,
+        this->GetSelectedCoordinateScalarComponent(cc));
+    }
+    for (int cc = 0; cc < this->GetNumberOfCoordinateVectorArrays(); ++cc)
+    {
+      scope.AddVariable(this->GetCoordinateVectorVariableName(cc), coords);
+    }
+  }
+
+  std::vector<vtkSmartPointer<vtkDoubleArray> > results;
+  if (!this->Evaluator->Evaluate(scopes, results))
+  {
+    return false;
+  }
+
+  vtkSmartPointer<vtkDataArray> resultArray = results[0].GetPointer();
+  if (this->GetResultArrayType() != VTK_DOUBLE)
+  {
+    resultArray.TakeReference(vtkDataArray::CreateDataArray(this->GetResultArrayType()));
+    resultArray->DeepCopy(results[0]);
+  }
+  resultArray->SetName(this->GetResultArrayName());
+
+  output->ShallowCopy(input);
+  vtkDataSetAttributes* outDataAttrs = output->GetAttributes(attributeType);
+  outDataAttrs->AddArray(resultArray);
+  outDataAttrs->SetActiveScalars(this->GetResultArrayName());
+  return true;
+}
+
 // ----------------------------------------------------------------------------
 void vtkPVArrayCalculator::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -23,7 +23,9 @@
  *  vtkArrayCalculator provides API for users to add scalar/vector fields and
  *  their mapping with the input fields. We extend vtkArrayCalculator to
  *  automatically add scalar/vector fields mapping using the array available in
- *  the input.
+ *  the input. Scalar results of expressions vtkPVExpressionEvaluator can
+ *  handle are computed natively, a chunk of tuples at a time and in
+ *  parallel, instead of one tuple at a time through vtkFunctionParser.
  * @sa
  *  vtkArrayCalculator vtkFunctionParser
 */
@@ -36,6 +38,7 @@
 
 class vtkDataObject;
 class vtkDataSetAttributes;
+class vtkPVExpressionEvaluator;
 
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPVArrayCalculator : public vtkArrayCalculator
 {
@@ -62,11 +65,21 @@ protected:
    * RequestData() only.
    */
   void UpdateArrayAndVariableNames(vtkDataObject* theInputObj, vtkDataSetAttributes* inDataAttrs);
+  //@}
+
+  /**
+   * Computes the result with vtkPVExpressionEvaluator using the variables
+   * registered by UpdateArrayAndVariableNames(). Returns false, leaving the
+   * output untouched, when the function or the options need the superclass,
+   * e.g. for vector results or comparisons.
+   */
+  bool EvaluateNatively(vtkDataObject* input, vtkDataObject* output, int attributeType);
 
 private:
   vtkPVArrayCalculator(const vtkPVArrayCalculator&) = delete;
   void operator=(const vtkPVArrayCalculator&) = delete;
+
+  vtkPVExpressionEvaluator* Evaluator;
 };
-//@}
 
 #endif
@@ -71,18 +71,10 @@ struct vtkPhastaReaderInternal
     B = ucTmp;                                                                                     \
   }
 
-std::map<int, char*> LastHeaderKey;
-std::vector<FILE*> fileArray;
-std::vector<int> byte_order;
-std::vector<int> header_type;
-int DataSize = 0;
-int LastHeaderNotFound = 0;
-int Wrong_Endian = 0;
-int Strict_Error = 0;
-int binary_format = 0;
-
+namespace
+{
 // the caller has the responsibility to delete the returned string
-char* vtkPhastaReader::StringStripper(const char istring[])
+char* StringStripper(const char istring[])
 {
   size_t length = strlen(istring);
   char* dest = new char[length + 1];
@@ -97,7 +89,7 @@ char* vtkPhastaReader::StringStripper(const char istring[])
   return dest;
 }
 
-int vtkPhastaReader::cscompare(const char teststring[], const char targetstring[])
+int cscompare(const char teststring[], const char targetstring[])
 {
 
   char* s1 = const_cast<char*>(teststring);
@@ -134,21 +126,7 @@ int vtkPhastaReader::cscompare(const char teststring[], const char targetstring[
   }
 }
 
-void vtkPhastaReader::isBinary(const char iotype[])
-{
-  char* fname = StringStripper(iotype);
-  if (cscompare(fname, "binary"))
-  {
-    binary_format = 1;
-  }
-  else
-  {
-    binary_format = 0;
-  }
-  delete[] fname;
-}
-
-size_t vtkPhastaReader::typeSize(const char typestring[])
+size_t typeSize(const char typestring[])
 {
   char* ts1 = StringStripper(typestring);
 
@@ -175,105 +153,7 @@ size_t vtkPhastaReader::typeSize(const char typestring[])
   }
 }
 
-int vtkPhastaReader::readHeader(FILE* fileObject, const char phrase[], int* params, int expect)
-{
-  char* text_header;
-  char* token;
-  char Line[1024];
-  char junk;
-  int FOUND = 0;
-  size_t real_length;
-  int skip_size, integer_value;
-  int rewind_count = 0;
-
-  if (!fgets(Line, 1024, fileObject) && feof(fileObject))
-  {
-    rewind(fileObject);
-    clearerr(fileObject);
-    rewind_count++;
-    fgets(Line, 1024, fileObject);
-  }
-
-  while (!FOUND && (rewind_count < 2))
-  {
-    if ((Line[0] != '\n') && (real_length = strcspn(Line, "#")))
-    {
-      text_header = new char[real_length + 1];
-      strncpy(text_header, Line, real_length);
-      text_header[real_length] = static_cast<char>(NULL);
-      token = strtok(text_header, ":");
-      if (cscompare(phrase, token))
-      {
-        FOUND = 1;
-        token = strtok(NULL, " ,;<>");
-        skip_size = atoi(token);
-        int i;
-        for (i = 0; i < expect && (token = strtok(NULL, " ,;<>")); i++)
-        {
-          params[i] = atoi(token);
-        }
-        if (i < expect)
-        {
-          fprintf(stderr, "Expected # of ints not found for: %s\n", phrase);
-        }
-      }
-      else if (cscompare(token, "byteorder magic number"))
-      {
-        if (binary_format)
-        {
-          fread((void*)&integer_value, sizeof(int), 1, fileObject);
-          fread(&junk, sizeof(char), 1, fileObject);
-          if (362436 != integer_value)
-          {
-            Wrong_Endian = 1;
-          }
-        }
-        else
-        {
-          fscanf(fileObject, "%d\n", &integer_value);
-        }
-      }
-      else
-      {
-        /* some other header, so just skip over */
-        token = strtok(NULL, " ,;<>");
-        skip_size = atoi(token);
-        if (binary_format)
-        {
-          fseek(fileObject, skip_size, SEEK_CUR);
-        }
-        else
-        {
-          for (int gama = 0; gama < skip_size; gama++)
-          {
-            fgets(Line, 1024, fileObject);
-          }
-        }
-      }
-      delete[] text_header;
-    }
-
-    if (!FOUND)
-    {
-      if (!fgets(Line, 1024, fileObject) && feof(fileObject))
-      {
-        rewind(fileObject);
-        clearerr(fileObject);
-        rewind_count++;
-        fgets(Line, 1024, fileObject);
-      }
-    }
-  }
-
-  if (!FOUND)
-  {
-    fprintf(stderr, "Error: Cound not find: %s\n", phrase);
-    return 1;
-  }
-  return 0;
-}
-
-void vtkPhastaReader::SwapArrayByteOrder(void* array, int nbytes, int nItems)
+void SwapArrayByteOrder(void* array, int nbytes, int nItems)
 {
   /* This swaps the byte order for the array of nItems each
      of size nbytes , This will be called only locally  */
@@ -291,172 +171,209 @@ void vtkPhastaReader::SwapArrayByteOrder(void* array, int nbytes, int nItems)
   }
 }
 
-void vtkPhastaReader::openfile(const char filename[], const char mode[], int* fileDescriptor)
+// Re-entrant replacement of strtok: returns the next token of the string at
+// cursor, or NULL, and moves cursor after it.
+char* NextToken(char*& cursor, const char* delimiters)
 {
-  FILE* file = NULL;
-  *fileDescriptor = 0;
-  // Stripping a filename is not correct, since
-  // filenames can certainly have spaces.
-  // char* fname = StringStripper( filename );
-  const char* fname = filename;
-  char* imode = StringStripper(mode);
-
-  if (cscompare("read", imode))
+  cursor += strspn(cursor, delimiters);
+  if (!*cursor)
   {
-    file = fopen(fname, "rb");
+    return NULL;
   }
-  else if (cscompare("write", imode))
+  char* token = cursor;
+  cursor += strcspn(cursor, delimiters);
+  if (*cursor)
   {
-    file = fopen(fname, "wb");
+    *cursor++ = '\0';
   }
-  else if (cscompare("append", imode))
-  {
-    file = fopen(fname, "ab");
-  }
-
-  if (!file)
-  {
-    fprintf(stderr, "unable to open file : %s\n", fname);
-  }
-  else
-  {
-    fileArray.push_back(file);
-    byte_order.push_back(0);
-    header_type.push_back(sizeof(int));
-    *fileDescriptor = static_cast<int>(fileArray.size());
-  }
-  delete[] imode;
+  return token;
 }
 
-void vtkPhastaReader::closefile(int* fileDescriptor, const char mode[])
+int SeekFile(FILE* file, vtkTypeInt64 offset)
 {
-  char* imode = StringStripper(mode);
-
-  if (cscompare("write", imode) || cscompare("append", imode))
-  {
-    fflush(fileArray[*fileDescriptor - 1]);
-  }
-
-  fclose(fileArray[*fileDescriptor - 1]);
-  delete[] imode;
+#if defined(_WIN32)
+  return _fseeki64(file, offset, SEEK_SET);
+#else
+  return fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
 }
 
-void vtkPhastaReader::readheader(int* fileDescriptor, const char keyphrase[], void* valueArray,
-  int* nItems, const char datatype[], const char iotype[])
+vtkTypeInt64 TellFile(FILE* file)
 {
-  int filePtr = *fileDescriptor - 1;
-  FILE* fileObject;
-  int* valueListInt;
+#if defined(_WIN32)
+  return _ftelli64(file);
+#else
+  return static_cast<vtkTypeInt64>(ftello(file));
+#endif
+}
 
-  if (*fileDescriptor < 1 || *fileDescriptor > (int)fileArray.size())
+//----------------------------------------------------------------------------
+// A binary PHASTA file opened for reading. All the headers are indexed in a
+// single pass when the file is opened, so looking up a header does not
+// scan the file and data blocks are read directly from their offset. All
+// the state lives in the object: files read concurrently do not share
+// anything.
+class PhastaFile
+{
+public:
+  PhastaFile()
+    : File(NULL)
+    , WrongEndian(false)
+    , NextHeader(0)
+    , LastHeader(NULL)
   {
-    fprintf(stderr, "No file associated with Descriptor %d\n", *fileDescriptor);
-    fprintf(stderr, "openfile function has to be called before \n");
-    fprintf(stderr, "acessing the file\n ");
-    fprintf(stderr, "fatal error: cannot continue, returning out of call\n");
-    return;
   }
 
-  LastHeaderKey[filePtr] = const_cast<char*>(keyphrase);
-  LastHeaderNotFound = 0;
-
-  fileObject = fileArray[filePtr];
-  Wrong_Endian = byte_order[filePtr];
-
-  isBinary(iotype);
-  typeSize(datatype); // redundant call, just avoid a compiler warning.
-
-  // right now we are making the assumption that we will only write integers
-  // on the header line.
-
-  valueListInt = static_cast<int*>(valueArray);
-  int ierr = readHeader(fileObject, keyphrase, valueListInt, *nItems);
-
-  byte_order[filePtr] = Wrong_Endian;
-
-  if (ierr)
+  ~PhastaFile()
   {
-    LastHeaderNotFound = 1;
+    if (this->File)
+    {
+      fclose(this->File);
+    }
   }
 
-  return;
-}
-
-void vtkPhastaReader::readdatablock(int* fileDescriptor, const char keyphrase[], void* valueArray,
-  int* nItems, const char datatype[], const char iotype[])
-{
-  int filePtr = *fileDescriptor - 1;
-  FILE* fileObject;
-  char junk;
-
-  if (*fileDescriptor < 1 || *fileDescriptor > (int)fileArray.size())
+  bool Open(const char* filename)
   {
-    fprintf(stderr, "No file associated with Descriptor %d\n", *fileDescriptor);
-    fprintf(stderr, "openfile function has to be called before \n");
-    fprintf(stderr, "acessing the file\n ");
-    fprintf(stderr, "fatal error: cannot continue, returning out of call\n");
-    return;
+    // Stripping a filename is not correct, since
+    // filenames can certainly have spaces.
+    this->File = fopen(filename, "rb");
+    if (!this->File)
+    {
+      fprintf(stderr, "unable to open file : %s\n", filename);
+      return false;
+    }
+    this->BuildIndex();
+    return true;
   }
 
-  // error check..
-  // since we require that a consistant header always preceed the data block
-  // let us check to see that it is actually the case.
-
-  if (!cscompare(LastHeaderKey[filePtr], keyphrase))
+  // Find the next header matching keyphrase, in file order, starting after
+  // the last header found and wrapping around once. Up to nItems integers
+  // following the block size are copied to values.
+  bool ReadHeader(const char* keyphrase, int* values, int nItems)
   {
-    fprintf(stderr, "Header not consistant with data block\n");
-    fprintf(stderr, "Header: %s\n", LastHeaderKey[filePtr]);
-    fprintf(stderr, "DataBlock: %s\n ", keyphrase);
-    fprintf(stderr, "Please recheck read sequence \n");
-    if (Strict_Error)
+    this->LastHeader = NULL;
+    const size_t numHeaders = this->Headers.size();
+    for (size_t n = 0; n < numHeaders; n++)
     {
-      fprintf(stderr, "fatal error: cannot continue, returning out of call\n");
-      return;
+      size_t idx = (this->NextHeader + n) % numHeaders;
+      const Header& header = this->Headers[idx];
+      if (cscompare(keyphrase, header.Key.c_str()))
+      {
+        int i;
+        for (i = 0; i < nItems && i < static_cast<int>(header.Values.size()); i++)
+        {
+          values[i] = header.Values[i];
+        }
+        if (i < nItems)
+        {
+          fprintf(stderr, "Expected # of ints not found for: %s\n", keyphrase);
+        }
+        this->LastHeader = &header;
+        this->NextHeader = idx + 1;
+        return true;
+      }
     }
+    fprintf(stderr, "Error: Cound not find: %s\n", keyphrase);
+    return false;
   }
 
-  if (LastHeaderNotFound)
+  // Read the data block of the last header found.
+  bool ReadDataBlock(const char* keyphrase, void* values, int nItems, const char* datatype)
   {
-    return;
-  }
-
-  fileObject = fileArray[filePtr];
-  Wrong_Endian = byte_order[filePtr];
-
-  size_t type_size = typeSize(datatype);
-  int nUnits = *nItems;
-  isBinary(iotype);
+    // since we require that a consistant header always preceed the data block
+    // let us check to see that it is actually the case.
+    if (!this->LastHeader)
+    {
+      return false;
+    }
+    if (!cscompare(keyphrase, this->LastHeader->Key.c_str()))
+    {
+      fprintf(stderr, "Header not consistant with data block\n");
+      fprintf(stderr, "Header: %s\n", this->LastHeader->Key.c_str());
+      fprintf(stderr, "DataBlock: %s\n ", keyphrase);
+      fprintf(stderr, "Please recheck read sequence \n");
+    }
 
-  if (binary_format)
-  {
-    fread(valueArray, type_size, nUnits, fileObject);
-    fread(&junk, sizeof(char), 1, fileObject);
-    if (Wrong_Endian)
+    size_t type_size = typeSize(datatype);
+    if (SeekFile(this->File, this->LastHeader->Offset) != 0 ||
+      fread(values, type_size, nItems, this->File) != static_cast<size_t>(nItems))
     {
-      SwapArrayByteOrder(valueArray, static_cast<int>(type_size), nUnits);
+      fprintf(stderr, "Error: Could not read data block: %s\n", keyphrase);
+      return false;
     }
+    if (this->WrongEndian)
+    {
+      SwapArrayByteOrder(values, static_cast<int>(type_size), nItems);
+    }
+    return true;
   }
-  else
+
+private:
+  struct Header
   {
-    char* ts1 = StringStripper(datatype);
-    if (cscompare("integer", ts1))
+    std::string Key;
+    std::vector<int> Values; // integers following the block size
+    vtkTypeInt64 Offset;     // start of the data block
+  };
+
+  void BuildIndex()
+  {
+    char Line[1024];
+    size_t real_length;
+    while (fgets(Line, 1024, this->File))
     {
-      for (int n = 0; n < nUnits; n++)
+      if ((Line[0] == '\n') || !(real_length = strcspn(Line, "#")))
       {
-        fscanf(fileObject, "%d\n", (int*)((int*)valueArray + n));
+        continue;
       }
-    }
-    else if (cscompare("double", ts1))
-    {
-      for (int n = 0; n < nUnits; n++)
+      std::string text_header(Line, real_length);
+      char* cursor = &text_header[0];
+      char* token = NextToken(cursor, ":");
+      if (!token)
+      {
+        continue;
+      }
+      if (cscompare(token, "byteorder magic number"))
+      {
+        int integer_value = 0;
+        char junk;
+        if (fread(&integer_value, sizeof(int), 1, this->File) == 1 &&
+          fread(&junk, sizeof(char), 1, this->File) == 1 && 362436 != integer_value)
+        {
+          this->WrongEndian = true;
+        }
+        continue;
+      }
+
+      Header header;
+      header.Key = token;
+      token = NextToken(cursor, " ,;<>");
+      vtkTypeInt64 skip_size = token ? atoll(token) : 0;
+      while ((token = NextToken(cursor, " ,;<>")))
+      {
+        header.Values.push_back(atoi(token));
+      }
+      header.Offset = TellFile(this->File);
+      this->Headers.push_back(header);
+
+      /* skip over the data block */
+      if (SeekFile(this->File, header.Offset + skip_size) != 0)
       {
-        fscanf(fileObject, "%lf\n", (double*)((double*)valueArray + n));
+        break;
       }
     }
-    delete[] ts1;
+    clearerr(this->File);
   }
 
-  return;
+  FILE* File;
+  bool WrongEndian;
+  std::vector<Header> Headers;
+  size_t NextHeader;
+  const Header* LastHeader;
+
+  PhastaFile(const PhastaFile&) = delete;
+  void operator=(const PhastaFile&) = delete;
+};
 }
 
 // End of copy from phastaIO
@@ -504,21 +421,28 @@ void vtkPhastaReader::SetFieldInfo(const char* paraviewFieldTag, const char* pha
 int vtkPhastaReader::RequestData(
   vtkInformation*, vtkInformationVector**, vtkInformationVector* outputVector)
 {
-  int firstVertexNo = 0;
-  int fvn = 0;
-  int noOfNodes, noOfCells, noOfDatas;
-
   // get the data object
   vtkInformation* outInfo = outputVector->GetInformationObject(0);
 
   vtkUnstructuredGrid* output =
     vtkUnstructuredGrid::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  if (this->GetCachedGrid())
+  return this->ReadPiece(
+    this->GeometryFileName, this->FieldFileName, this->GetCachedGrid(), output);
+}
+
+int vtkPhastaReader::ReadPiece(const char* geomFileName, const char* fieldFileName,
+  vtkUnstructuredGrid* cachedGrid, vtkUnstructuredGrid* output)
+{
+  int firstVertexNo = 0;
+  int fvn = 0;
+  int noOfNodes, noOfCells, noOfDatas;
+
+  if (cachedGrid)
   {
     // shallow the cached grid that was previously set...
     vtkDebugMacro("Using a cached copy of the grid.");
-    output->ShallowCopy(this->GetCachedGrid());
+    output->ShallowCopy(cachedGrid);
   }
   else
   {
@@ -530,17 +454,22 @@ int vtkPhastaReader::RequestData(
 
     vtkDebugMacro(<< "Reading Phasta file...");
 
-    if (!this->GeometryFileName || !this->FieldFileName)
+    if (!geomFileName || !fieldFileName)
     {
       vtkErrorMacro(<< "All input parameters not set.");
+      points->Delete();
       return 0;
     }
     vtkDebugMacro(<< "Updating ensa with ....");
-    vtkDebugMacro(<< "Geom File : " << this->GeometryFileName);
-    vtkDebugMacro(<< "Field File : " << this->FieldFileName);
+    vtkDebugMacro(<< "Geom File : " << geomFileName);
+    vtkDebugMacro(<< "Field File : " << fieldFileName);
 
     fvn = firstVertexNo;
-    this->ReadGeomFile(this->GeometryFileName, firstVertexNo, points, noOfNodes, noOfCells);
+    if (!this->ReadGeomFile(geomFileName, firstVertexNo, points, output, noOfNodes, noOfCells))
+    {
+      points->Delete();
+      return 0;
+    }
     /* set the points over here, this is because vtkUnStructuredGrid
        only insert points once, next insertion overwrites the previous one */
     // acbauer is not sure why the above comment is about...
@@ -551,11 +480,11 @@ int vtkPhastaReader::RequestData(
   if (!this->Internal->FieldInfoMap.size())
   {
     vtkDataSetAttributes* field = output->GetPointData();
-    this->ReadFieldFile(this->FieldFileName, fvn, field, noOfNodes);
+    this->ReadFieldFile(fieldFileName, fvn, field, noOfNodes);
   }
   else
   {
-    this->ReadFieldFile(this->FieldFileName, fvn, output, noOfDatas);
+    this->ReadFieldFile(fieldFileName, fvn, output, noOfDatas);
   }
 
   // if there exists point arrays called coordsX, coordsY and coordsZ,
@@ -589,12 +518,11 @@ int vtkPhastaReader::RequestData(
    them into one, ReadGeomfile can then be called repeatedly from Execute with
    firstVertexNo forming consecutive series of vertex numbers */
 
-void vtkPhastaReader::ReadGeomFile(
-  char* geomFileName, int& firstVertexNo, vtkPoints* points, int& num_nodes, int& num_cells)
+int vtkPhastaReader::ReadGeomFile(const char* geomFileName, int& firstVertexNo,
+  vtkPoints* points, vtkUnstructuredGrid* output, int& num_nodes, int& num_cells)
 {
 
   /* variables for vtk */
-  vtkUnstructuredGrid* output = this->GetOutput();
   double* coordinates;
   vtkIdType* nodes;
   int cell_type;
@@ -614,33 +542,30 @@ void vtkPhastaReader::ReadGeomFile(
 
   /* misc variables*/
   int i, j, k, item;
-  int geomfile;
-
-  openfile(geomFileName, "read", &geomfile);
-  // geomfile = fopen(GeometryFileName,"rb");
+  PhastaFile geomfile;
 
-  if (!geomfile)
+  if (!geomfile.Open(geomFileName))
   {
     vtkErrorMacro(<< "Cannot open file " << geomFileName);
-    return;
+    return 0;
   }
 
   int expect;
-  int array[10];
+  int array[10] = { 0 };
   expect = 1;
 
   /* read number of nodes */
 
-  readheader(&geomfile, "number of nodes", array, &expect, "integer", "binary");
+  geomfile.ReadHeader("number of nodes", array, expect);
   num_nodes = array[0];
 
   /* read number of elements */
-  readheader(&geomfile, "number of interior elements", array, &expect, "integer", "binary");
+  geomfile.ReadHeader("number of interior elements", array, expect);
   num_elems = array[0];
   num_cells = array[0];
 
   /* read number of interior */
-  readheader(&geomfile, "number of interior tpblocks", array, &expect, "integer", "binary");
+  geomfile.ReadHeader("number of interior tpblocks", array, expect);
   num_int_blocks = array[0];
 
   vtkDebugMacro(<< "Nodes: " << num_nodes << "Elements: " << num_elems
@@ -648,7 +573,11 @@ void vtkPhastaReader::ReadGeomFile(
 
   /* read coordinates */
   expect = 2;
-  readheader(&geomfile, "co-ordinates", array, &expect, "double", "binary");
+  if (!geomfile.ReadHeader("co-ordinates", array, expect))
+  {
+    vtkErrorMacro(<< "No co-ordinates in " << geomFileName);
+    return 0;
+  }
   // TEST *******************
   num_nodes = array[0];
   // TEST *******************
@@ -657,7 +586,7 @@ void vtkPhastaReader::ReadGeomFile(
     vtkErrorMacro(<< "Ambigous information in geom.data file, number of nodes does not match the "
                      "co-ordinates size. Nodes: "
                   << num_nodes << " Coordinates: " << array[0]);
-    return;
+    return 0;
   }
   dim = array[1];
 
@@ -667,7 +596,7 @@ void vtkPhastaReader::ReadGeomFile(
   if (coordinates == NULL)
   {
     vtkErrorMacro(<< "Unable to allocate memory for nodal info");
-    return;
+    return 0;
   }
 
   pos = new double[num_nodes * dim];
@@ -675,11 +604,11 @@ void vtkPhastaReader::ReadGeomFile(
   {
     vtkErrorMacro(<< "Unable to allocate memory for nodal info");
     delete[] coordinates;
-    return;
+    return 0;
   }
 
   item = num_nodes * dim;
-  readdatablock(&geomfile, "co-ordinates", pos, &item, "double", "binary");
+  geomfile.ReadDataBlock("co-ordinates", pos, item, "double");
 
   for (i = 0; i < num_nodes; i++)
   {
@@ -699,7 +628,10 @@ void vtkPhastaReader::ReadGeomFile(
         points->InsertNextPoint(coordinates);
         break;
       default:
-        vtkErrorMacro(<< "Unrecognized dimension in " << geomFileName) return;
+        vtkErrorMacro(<< "Unrecognized dimension in " << geomFileName);
+        delete[] coordinates;
+        delete[] pos;
+        return 0;
     }
   }
 
@@ -708,22 +640,25 @@ void vtkPhastaReader::ReadGeomFile(
 
   for (k = 0; k < num_int_blocks; k++)
   {
-    readheader(&geomfile, "connectivity interior", array, &expect, "integer", "binary");
+    geomfile.ReadHeader("connectivity interior", array, expect);
 
     /* read information about the block*/
     num_elems = array[0];
     num_vertices = array[1];
     num_per_line = array[3];
+    delete[] connectivity;
     connectivity = new int[num_elems * num_per_line];
 
     if (connectivity == NULL)
     {
       vtkErrorMacro(<< "Unable to allocate memory for connectivity info");
-      return;
+      delete[] coordinates;
+      delete[] pos;
+      return 0;
     }
 
     item = num_elems * num_per_line;
-    readdatablock(&geomfile, "connectivity interior", connectivity, &item, "integer", "binary");
+    geomfile.ReadDataBlock("connectivity interior", connectivity, item, "integer");
 
     /* insert cells */
     for (i = 0; i < num_elems; i++)
@@ -758,7 +693,10 @@ void vtkPhastaReader::ReadGeomFile(
         default:
           delete[] nodes;
           vtkErrorMacro(<< "Unrecognized CELL_TYPE in " << geomFileName);
-          return;
+          delete[] coordinates;
+          delete[] pos;
+          delete[] connectivity;
+          return 0;
       }
 
       /* insert the element */
@@ -770,27 +708,26 @@ void vtkPhastaReader::ReadGeomFile(
   firstVertexNo = firstVertexNo + num_nodes;
 
   // clean up
-  closefile(&geomfile, "read");
   delete[] coordinates;
   delete[] pos;
   delete[] connectivity;
+  return 1;
 }
 
 void vtkPhastaReader::ReadFieldFile(
-  char* fieldFileName, int, vtkDataSetAttributes* field, int& noOfNodes)
+  const char* fieldFileName, int, vtkDataSetAttributes* field, int& noOfNodes)
 {
 
   int i, j;
   int item;
   double* data;
-  int fieldfile;
+  int numOfVars;
+  PhastaFile fieldfile;
 
-  openfile(fieldFileName, "read", &fieldfile);
-  // fieldfile = fopen(FieldFileName,"rb");
-
-  if (!fieldfile)
+  if (!fieldfile.Open(fieldFileName))
   {
-    vtkErrorMacro(<< "Cannot open file " << FieldFileName) return;
+    vtkErrorMacro(<< "Cannot open file " << fieldFileName);
+    return;
   }
   int array[10], expect;
 
@@ -804,16 +741,23 @@ void vtkPhastaReader::ReadFieldFile(
   temperature->SetName("temperature");
 
   expect = 3;
-  readheader(&fieldfile, "solution", array, &expect, "double", "binary");
+  if (!fieldfile.ReadHeader("solution", array, expect))
+  {
+    vtkErrorMacro(<< "No solution in " << fieldFileName);
+    pressure->Delete();
+    velocity->Delete();
+    temperature->Delete();
+    return;
+  }
   noOfNodes = array[0];
-  this->NumberOfVariables = array[1];
+  numOfVars = array[1];
 
   vtkDoubleArray* sArrays[4];
   for (i = 0; i < 4; i++)
   {
     sArrays[i] = 0;
   }
-  item = noOfNodes * this->NumberOfVariables;
+  item = noOfNodes * numOfVars;
   data = new double[item];
   if (data == NULL)
   {
@@ -821,9 +765,9 @@ void vtkPhastaReader::ReadFieldFile(
     return;
   }
 
-  readdatablock(&fieldfile, "solution", data, &item, "double", "binary");
+  fieldfile.ReadDataBlock("solution", data, item, "double");
 
-  for (i = 5; i < this->NumberOfVariables; i++)
+  for (i = 5; i < numOfVars; i++)
   {
     int idx = i - 5;
     sArrays[idx] = vtkDoubleArray::New();
@@ -841,7 +785,7 @@ void vtkPhastaReader::ReadFieldFile(
     pressure->SetTuple1(i, data[i]);
     velocity->SetTuple3(i, data[noOfNodes + i], data[2 * noOfNodes + i], data[3 * noOfNodes + i]);
     temperature->SetTuple1(i, data[4 * noOfNodes + i]);
-    for (j = 5; j < this->NumberOfVariables; j++)
+    for (j = 5; j < numOfVars; j++)
     {
       sArrays[j - 5]->SetTuple1(i, data[j * noOfNodes + i]);
     }
@@ -856,7 +800,7 @@ void vtkPhastaReader::ReadFieldFile(
   field->AddArray(temperature);
   temperature->Delete();
 
-  for (i = 5; i < this->NumberOfVariables; i++)
+  for (i = 5; i < numOfVars; i++)
   {
     int idx = i - 5;
     field->AddArray(sArrays[idx]);
@@ -864,25 +808,22 @@ void vtkPhastaReader::ReadFieldFile(
   }
 
   // clean up
-  closefile(&fieldfile, "read");
   delete[] data;
 
 } // closes ReadFieldFile
 
 void vtkPhastaReader::ReadFieldFile(
-  char* fieldFileName, int, vtkUnstructuredGrid* output, int& noOfDatas)
+  const char* fieldFileName, int, vtkUnstructuredGrid* output, int& noOfDatas)
 {
 
   int i, j, numOfVars;
   int item;
-  int fieldfile;
+  PhastaFile fieldfile;
 
-  openfile(fieldFileName, "read", &fieldfile);
-  // fieldfile = fopen(FieldFileName,"rb");
-
-  if (!fieldfile)
+  if (!fieldfile.Open(fieldFileName))
   {
-    vtkErrorMacro(<< "Cannot open file " << FieldFileName) return;
+    vtkErrorMacro(<< "Cannot open file " << fieldFileName);
+    return;
   }
   int array[10], expect;
 
@@ -929,9 +870,12 @@ void vtkPhastaReader::ReadFieldFile(
     dataArray->SetNumberOfComponents(numOfComps);
 
     expect = 3;
-    readheader(&fieldfile, phastaFieldTag, array, &expect, dataType, "binary");
+    if (!fieldfile.ReadHeader(phastaFieldTag, array, expect))
+    {
+      dataArray->Delete();
+      continue;
+    }
     noOfDatas = array[0];
-    this->NumberOfVariables = array[1];
     numOfVars = array[1];
     dataArray->SetNumberOfTuples(noOfDatas);
 
@@ -971,7 +915,7 @@ void vtkPhastaReader::ReadFieldFile(
         continue;
       }
 
-      readdatablock(&fieldfile, phastaFieldTag, data, &item, dataType, "binary");
+      fieldfile.ReadDataBlock(phastaFieldTag, data, item, dataType);
 
       switch (numOfComps)
       {
@@ -1048,7 +992,7 @@ void vtkPhastaReader::ReadFieldFile(
         continue;
       }
 
-      readdatablock(&fieldfile, phastaFieldTag, data, &item, dataType, "binary");
+      fieldfile.ReadDataBlock(phastaFieldTag, data, item, dataType);
 
       switch (numOfComps)
       {
@@ -1144,9 +1088,6 @@ void vtkPhastaReader::ReadFieldFile(
     // delete [] data;
   }
 
-  // close up
-  closefile(&fieldfile, "read");
-
 } // closes ReadFieldFile
 
 void vtkPhastaReader::PrintSelf(ostream& os, vtkIndent indent)
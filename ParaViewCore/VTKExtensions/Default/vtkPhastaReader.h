@@ -70,6 +70,16 @@ public:
   void SetCachedGrid(vtkUnstructuredGrid*);
   vtkGetObjectMacro(CachedGrid, vtkUnstructuredGrid);
 
+  /**
+   * Read the given geometry and field files into output, outside of the
+   * pipeline. If cachedGrid is not NULL, its geometry is used instead of
+   * reading the geometry file. No state is kept in the reader between or
+   * during calls, so several pieces can be read concurrently as long as the
+   * field info is not modified meanwhile. Returns 0 on failure.
+   */
+  int ReadPiece(const char* geomFileName, const char* fieldFileName,
+    vtkUnstructuredGrid* cachedGrid, vtkUnstructuredGrid* output);
+
 protected:
   vtkPhastaReader();
   ~vtkPhastaReader() override;
@@ -77,33 +87,18 @@ protected:
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
     vtkInformationVector* outputVector) VTK_OVERRIDE;
 
-  void ReadGeomFile(
-    char* GeomFileName, int& firstVertexNo, vtkPoints* points, int& noOfNodes, int& noOfCells);
+  int ReadGeomFile(const char* geomFileName, int& firstVertexNo, vtkPoints* points,
+    vtkUnstructuredGrid* output, int& noOfNodes, int& noOfCells);
   void ReadFieldFile(
-    char* fieldFileName, int firstVertexNo, vtkDataSetAttributes* field, int& noOfNodes);
+    const char* fieldFileName, int firstVertexNo, vtkDataSetAttributes* field, int& noOfNodes);
   void ReadFieldFile(
-    char* fieldFileName, int firstVertexNo, vtkUnstructuredGrid* output, int& noOfDatas);
+    const char* fieldFileName, int firstVertexNo, vtkUnstructuredGrid* output, int& noOfDatas);
 
 private:
   char* GeometryFileName;
   char* FieldFileName;
   vtkUnstructuredGrid* CachedGrid;
 
-  int NumberOfVariables; // number of variable in the field file
-
-  static char* StringStripper(const char istring[]);
-  static int cscompare(const char teststring[], const char targetstring[]);
-  static void isBinary(const char iotype[]);
-  static size_t typeSize(const char typestring[]);
-  static int readHeader(FILE* fileObject, const char phrase[], int* params, int expect);
-  static void SwapArrayByteOrder(void* array, int nbytes, int nItems);
-  static void openfile(const char filename[], const char mode[], int* fileDescriptor);
-  static void closefile(int* fileDescriptor, const char mode[]);
-  static void readheader(int* fileDescriptor, const char keyphrase[], void* valueArray, int* nItems,
-    const char datatype[], const char iotype[]);
-  static void readdatablock(int* fileDescriptor, const char keyphrase[], void* valueArray,
-    int* nItems, const char datatype[], const char iotype[]);
-
 private:
   vtkPhastaReaderInternal* Internal;
 
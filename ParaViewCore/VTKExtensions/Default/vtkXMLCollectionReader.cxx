@@ -23,6 +23,7 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVInstantiator.h"
+#include "vtkPVProgressiveExecution.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkXMLDataElement.h"
@@ -194,7 +195,7 @@ void vtkXMLCollectionReader::InternalProgressCallback()
   float dataProgress = reader->GetProgress();
   float progress = this->ProgressRange[0] + dataProgress * width;
   this->UpdateProgressDiscrete(progress);
-  if (this->AbortExecute)
+  if (this->AbortExecute || vtkPVProgressiveExecution::CheckAbort(this))
   {
     reader->SetAbortExecute(1);
   }
@@ -516,10 +517,20 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
   {
     vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::GetData(outInfo);
 
+    // When resuming a partial output, the readers of the data sets read so far
+    // are up to date: only the remaining data sets are read.
+    vtkPVProgressiveExecution::BeginProgressiveExecution(this);
+
     unsigned int nBlocks = static_cast<unsigned int>(this->Internal->Readers.size());
     output->SetNumberOfBlocks(nBlocks);
+    float progressRange[2] = { 0.0f, 1.0f };
     for (unsigned int i = 0; i < nBlocks; ++i)
     {
+      if (vtkPVProgressiveExecution::CheckAbort(this))
+      {
+        return;
+      }
+
       vtkMultiBlockDataSet* block = vtkMultiBlockDataSet::SafeDownCast(output->GetBlock(i));
       if (!block)
       {
@@ -529,8 +540,17 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
       }
 
       this->CurrentOutput = i;
+      this->SetProgressRange(progressRange, i, nBlocks);
       vtkDataObject* actualOutput = this->SetupOutput(filePath.c_str(), i);
       this->ReadAFile(i, updatePiece, updateNumPieces, updateGhostLevels, actualOutput);
+      if (this->AbortExecute)
+      {
+        if (actualOutput)
+        {
+          actualOutput->Delete();
+        }
+        return;
+      }
       block->SetNumberOfBlocks(updateNumPieces);
       block->SetBlock(updatePiece, actualOutput);
 
@@ -543,7 +563,14 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
       }
 
       actualOutput->Delete();
+
+      if (i + 1 < nBlocks && vtkPVProgressiveExecution::IsPartialOutputDue(this))
+      {
+        vtkPVProgressiveExecution::SetPartialOutput(this, output, true);
+        return;
+      }
     }
+    vtkPVProgressiveExecution::SetPartialOutput(this, output, false);
   }
 }
 
@@ -567,6 +594,12 @@ void vtkXMLCollectionReader::ReadAFile(int index, int updatePiece, int updateNum
     // we delete the reader later.
     r->RemoveObserver(this->InternalProgressObserver);
 
+    // An aborted reader only read part of the file, it must read it again.
+    if (r->GetAbortExecute())
+    {
+      r->Modified();
+    }
+
     // Share the new data with our output.
     actualOutput->ShallowCopy(r->GetOutputDataObject(0));
 
@@ -24,6 +24,10 @@
  * the file matching the restrictions will be read.  Each matching
  * data set becomes an output of this reader in the order in which
  * they appear in the file.
+ *
+ * When the output is a multiblock, the reader can be aborted between and
+ * while reading data sets, and emits partial outputs holding the data sets
+ * read so far (see vtkPVProgressiveExecution).
 */
 
 #ifndef vtkXMLCollectionReader_h
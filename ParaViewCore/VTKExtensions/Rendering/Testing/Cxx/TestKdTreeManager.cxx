@@ -0,0 +1,224 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestKdTreeManager.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkKdTreeManager.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkOrderedCompositeDistributor.h"
+#include "vtkPKdTree.h"
+#include "vtkPVConfig.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#ifdef PARAVIEW_USE_MPI
+#include "vtkMPIController.h"
+#else
+#include "vtkDummyController.h"
+#endif
+
+// Redistributes a point cloud with the kd-tree of the manager, then moves the
+// points a little, which keeps the cuts, and a lot, which rebuilds them. After
+// each redistribution, every cell must still exist once and lie in a region
+// assigned to the process that has it.
+
+namespace
+{
+const vtkIdType NumberOfCells = 2000;
+const double Tolerance = 0.1;
+
+// Process me has (me + 1) * NumberOfCells vertices spread over the unit cube,
+// so that the initial distribution is both unbalanced and interleaved.
+vtkSmartPointer<vtkUnstructuredGrid> NewInput(int me)
+{
+  const vtkIdType numberOfCells = (me + 1) * NumberOfCells;
+  const vtkIdType firstId = NumberOfCells * me * (me + 1) / 2;
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(me + 1);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("CellIds");
+  vtkSmartPointer<vtkUnstructuredGrid> input = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  input->Allocate(numberOfCells);
+  for (vtkIdType cc = 0; cc < numberOfCells; ++cc)
+  {
+    double x[3];
+    for (int kk = 0; kk < 3; ++kk)
+    {
+      x[kk] = random->GetRangeValue(0.0, 1.0);
+      random->Next();
+    }
+    vtkIdType ptId = points->InsertNextPoint(x);
+    input->InsertNextCell(VTK_VERTEX, 1, &ptId);
+    ids->InsertNextValue(firstId + cc);
+  }
+  input->SetPoints(points.GetPointer());
+  input->GetCellData()->AddArray(ids.GetPointer());
+  return input;
+}
+
+// Scales the points of data by factor around center.
+vtkSmartPointer<vtkUnstructuredGrid> Move(vtkDataSet* data, const double center[3], double factor)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> moved = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  moved->DeepCopy(data);
+  vtkPoints* points = moved->GetPoints();
+  for (vtkIdType cc = 0; points && cc < points->GetNumberOfPoints(); ++cc)
+  {
+    double x[3];
+    points->GetPoint(cc, x);
+    for (int kk = 0; kk < 3; ++kk)
+    {
+      x[kk] = center[kk] + factor * (x[kk] - center[kk]);
+    }
+    points->SetPoint(cc, x);
+  }
+  return moved;
+}
+
+vtkSmartPointer<vtkDataSet> Redistribute(
+  vtkDataSet* input, vtkPKdTree* tree, vtkMultiProcessController* controller)
+{
+  vtkNew<vtkOrderedCompositeDistributor> redistributor;
+  redistributor->SetController(controller);
+  redistributor->SetInputData(input);
+  redistributor->SetPKdTree(tree);
+  redistributor->SetPassThrough(0);
+  redistributor->Update();
+  return vtkDataSet::SafeDownCast(redistributor->GetOutputDataObject(0));
+}
+
+// Generates the kd-tree for data and checks whether the cuts were kept.
+bool GenerateKdTree(vtkKdTreeManager* manager, vtkDataSet* data, bool retained, const char* label)
+{
+  vtkPKdTree* tree = manager->GetKdTree();
+  const vtkMTimeType mtime = tree->GetMTime();
+  manager->RemoveAllDataObjects();
+  manager->AddDataObject(data);
+  manager->GenerateKdTree();
+  if (manager->GetCutsRetained() != retained || (retained && tree->GetMTime() != mtime))
+  {
+    cerr << "ERROR: " << label << ": the cuts were " << (retained ? "rebuilt" : "kept")
+         << " instead of " << (retained ? "kept" : "rebuilt") << "." << endl;
+    return false;
+  }
+  return true;
+}
+
+// Checks that all cells were redistributed once, to the process owning their
+// region.
+bool CheckOwnership(vtkDataSet* output, vtkPKdTree* tree, vtkMultiProcessController* controller,
+  const char* label)
+{
+  const int me = controller->GetLocalProcessId();
+  const int numProcs = controller->GetNumberOfProcesses();
+  const vtkIdType total = NumberOfCells * numProcs * (numProcs + 1) / 2;
+
+  int valid = 1;
+  vtkIdType cells[2] = { output ? output->GetNumberOfCells() : 0, 0 };
+  vtkDataArray* ids = output ? output->GetCellData()->GetArray("CellIds") : NULL;
+  if (cells[0] > 0 && !ids)
+  {
+    cerr << "ERROR: " << label << ": the cell ids were not redistributed." << endl;
+    valid = 0;
+    cells[0] = 0;
+  }
+  double bounds[6];
+  for (vtkIdType cc = 0; cc < cells[0]; ++cc)
+  {
+    cells[1] += static_cast<vtkIdType>(ids->GetTuple1(cc));
+    output->GetCellBounds(cc, bounds);
+    const int region = tree->GetRegionContainingPoint(0.5 * (bounds[0] + bounds[1]),
+      0.5 * (bounds[2] + bounds[3]), 0.5 * (bounds[4] + bounds[5]));
+    if (numProcs > 1 && (region < 0 || tree->GetProcessAssignedToRegion(region) != me))
+    {
+      valid = 0;
+    }
+  }
+
+  int globalValid = 0;
+  vtkIdType globalCells[2] = { 0, 0 };
+  controller->AllReduce(&valid, &globalValid, 1, vtkCommunicator::MIN_OP);
+  controller->AllReduce(cells, globalCells, 2, vtkCommunicator::SUM_OP);
+  if (!globalValid)
+  {
+    cerr << "ERROR: " << label << ": cells lie in regions of other processes." << endl;
+  }
+  if (globalCells[0] != total || globalCells[1] != total * (total - 1) / 2)
+  {
+    cerr << "ERROR: " << label << ": " << globalCells[0] << " cells instead of " << total << "."
+         << endl;
+    globalValid = 0;
+  }
+  return globalValid != 0;
+}
+}
+
+int TestKdTreeManager(int argc, char* argv[])
+{
+#ifdef PARAVIEW_USE_MPI
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv, 0);
+#else
+  (void)argc;
+  (void)argv;
+  vtkDummyController* controller = vtkDummyController::New();
+#endif
+  vtkMultiProcessController::SetGlobalController(controller);
+  const int numProcs = controller->GetNumberOfProcesses();
+
+  bool success = true;
+  {
+    vtkNew<vtkKdTreeManager> manager;
+    manager->SetLoadImbalanceTolerance(Tolerance);
+    vtkPKdTree* tree = manager->GetKdTree();
+
+    // the first tree is always built from the data.
+    vtkSmartPointer<vtkDataSet> data = NewInput(controller->GetLocalProcessId());
+    success &= GenerateKdTree(manager.GetPointer(), data, false, "initial");
+    data = Redistribute(data, tree, controller);
+    success &= CheckOwnership(data, tree, controller, "initial");
+
+    // shrinking the cloud slightly keeps it in the tree and balanced, the
+    // cells that crossed a cut are moved to the process owning their region.
+    // The number of regions is a power of two, so the processes are only
+    // balanced when their number is one too.
+    const double center[3] = { 0.5, 0.5, 0.5 };
+    const bool balanced = (numProcs & (numProcs - 1)) == 0;
+    data = Move(data, center, 0.999);
+    success &= GenerateKdTree(manager.GetPointer(), data, balanced, "balanced");
+    data = Redistribute(data, tree, controller);
+    success &= CheckOwnership(data, tree, controller, "balanced");
+
+    // gathering the cloud in [0.2, 0.4]^3, inside the tree, leaves most
+    // regions empty, so the cuts are rebuilt unless there is a single process.
+    const double focus[3] = { 0.25, 0.25, 0.25 };
+    data = Move(data, focus, 0.2);
+    success &= GenerateKdTree(manager.GetPointer(), data, numProcs == 1, "unbalanced");
+    data = Redistribute(data, tree, controller);
+    success &= CheckOwnership(data, tree, controller, "unbalanced");
+  }
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+#ifdef PARAVIEW_USE_MPI
+  controller->Finalize();
+#endif
+  controller->Delete();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
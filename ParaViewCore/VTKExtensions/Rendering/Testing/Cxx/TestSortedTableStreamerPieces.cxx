@@ -0,0 +1,200 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSortedTableStreamerPieces.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVConfig.h"
+#include "vtkSmartPointer.h"
+#include "vtkSortedTableStreamer.h"
+#include "vtkTable.h"
+
+#ifdef PARAVIEW_USE_MPI
+#include "vtkMPIController.h"
+#else
+#include "vtkDummyController.h"
+#endif
+
+// Sorts and extracts tables whose pieces don't have the same columns, nor the
+// same column order: the merged blocks must keep each value in the row and
+// column it belongs to.
+
+namespace
+{
+const int NumberOfRowsPerBlock = 50;
+const vtkIdType BlockSize = 64;
+
+void AddColumn(vtkTable* table, vtkDataArray* array, const char* name)
+{
+  array->SetName(name);
+  table->AddColumn(array);
+}
+
+// Each process has two blocks. Keys are unique and interleaved across blocks
+// and processes, so every block of the sorted output mixes all pieces. Only
+// the second block of each process has "second", only even processes have
+// "even", and odd processes list the columns in another order.
+vtkSmartPointer<vtkMultiBlockDataSet> NewInput(int me, int numProcs)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> input = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  for (int block = 0; block < 2; ++block)
+  {
+    vtkNew<vtkDoubleArray> key;
+    vtkNew<vtkDoubleArray> twice;
+    vtkNew<vtkDoubleArray> constant;
+    vtkNew<vtkIntArray> even;
+    vtkNew<vtkDoubleArray> second;
+    for (int row = 0; row < NumberOfRowsPerBlock; ++row)
+    {
+      const double value = (2.0 * row + block) * numProcs + me;
+      key->InsertNextValue(value);
+      twice->InsertNextValue(2 * value);
+      constant->InsertNextValue(1.0);
+      even->InsertNextValue(static_cast<int>(3 * value));
+      second->InsertNextValue(value + 0.5);
+    }
+
+    vtkNew<vtkTable> table;
+    if (me % 2 == 1)
+    {
+      AddColumn(table.GetPointer(), twice.GetPointer(), "twice");
+      AddColumn(table.GetPointer(), constant.GetPointer(), "constant");
+      AddColumn(table.GetPointer(), key.GetPointer(), "key");
+    }
+    else
+    {
+      AddColumn(table.GetPointer(), key.GetPointer(), "key");
+      AddColumn(table.GetPointer(), even.GetPointer(), "even");
+      AddColumn(table.GetPointer(), twice.GetPointer(), "twice");
+      AddColumn(table.GetPointer(), constant.GetPointer(), "constant");
+    }
+    if (block == 1)
+    {
+      AddColumn(table.GetPointer(), second.GetPointer(), "second");
+    }
+    input->SetBlock(block, table.GetPointer());
+  }
+  return input;
+}
+
+// Checks that every row of the output is consistent with its key. Returns the
+// number of rows, or -1 on error.
+vtkIdType CheckRows(vtkTable* output, int numProcs, bool sorted, double& lastKey)
+{
+  vtkDataArray* key = vtkDataArray::SafeDownCast(output->GetColumnByName("key"));
+  vtkDataArray* twice = vtkDataArray::SafeDownCast(output->GetColumnByName("twice"));
+  vtkDataArray* even = vtkDataArray::SafeDownCast(output->GetColumnByName("even"));
+  vtkDataArray* second = vtkDataArray::SafeDownCast(output->GetColumnByName("second"));
+  vtkDataArray* processIds =
+    vtkDataArray::SafeDownCast(output->GetColumnByName("vtkOriginalProcessIds"));
+  if (output->GetNumberOfRows() == 0)
+  {
+    return 0;
+  }
+  if (!key || !twice || !even || !second || (numProcs > 1 && !processIds))
+  {
+    cerr << "ERROR: Columns are missing from the output." << endl;
+    return -1;
+  }
+
+  for (vtkIdType row = 0; row < output->GetNumberOfRows(); ++row)
+  {
+    const double value = key->GetTuple1(row);
+    const int process = static_cast<int>(value) % numProcs;
+    const int block = (static_cast<int>(value) / numProcs) % 2;
+    bool valid = twice->GetTuple1(row) == 2 * value &&
+      even->GetTuple1(row) == (process % 2 == 0 ? 3 * value : 0.0) &&
+      (block == 1 ? second->GetTuple1(row) == value + 0.5 : vtkMath::IsNan(second->GetTuple1(row)))
+      && (!processIds || processIds->GetTuple1(row) == process);
+    if (sorted)
+    {
+      valid &= value > lastKey;
+      lastKey = value;
+    }
+    if (!valid)
+    {
+      cerr << "ERROR: Row " << row << " of key " << value << " has mismatched values." << endl;
+      return -1;
+    }
+  }
+  return output->GetNumberOfRows();
+}
+
+// Requests all blocks of the input sorted by column and checks them.
+bool CheckBlocks(vtkMultiProcessController* controller, vtkMultiBlockDataSet* input,
+  const char* column, bool sorted)
+{
+  const int numProcs = controller->GetNumberOfProcesses();
+  const vtkIdType total = 2 * NumberOfRowsPerBlock * numProcs;
+
+  vtkNew<vtkSortedTableStreamer> streamer;
+  streamer->SetController(controller);
+  streamer->SetInputData(input);
+  streamer->SetColumnNameToSort(column);
+  streamer->SetSelectedComponent(0);
+  streamer->SetBlockSize(BlockSize);
+
+  int valid = 1;
+  vtkIdType rows = 0;
+  double lastKey = -1.0;
+  for (vtkIdType block = 0; block * BlockSize < total; ++block)
+  {
+    streamer->SetBlock(block);
+    streamer->Update();
+    const vtkIdType blockRows = CheckRows(streamer->GetOutput(), numProcs, sorted, lastKey);
+    valid &= blockRows >= 0 ? 1 : 0;
+    rows += blockRows;
+  }
+
+  int globalValid = 0;
+  vtkIdType globalRows = 0;
+  controller->AllReduce(&valid, &globalValid, 1, vtkCommunicator::MIN_OP);
+  controller->AllReduce(&rows, &globalRows, 1, vtkCommunicator::SUM_OP);
+  if (globalValid && globalRows != total)
+  {
+    cerr << "ERROR: Blocks have " << globalRows << " rows instead of " << total << "." << endl;
+  }
+  return globalValid && globalRows == total;
+}
+}
+
+int TestSortedTableStreamerPieces(int argc, char* argv[])
+{
+#ifdef PARAVIEW_USE_MPI
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv, 0);
+#else
+  (void)argc;
+  (void)argv;
+  vtkDummyController* controller = vtkDummyController::New();
+#endif
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  vtkSmartPointer<vtkMultiBlockDataSet> input =
+    NewInput(controller->GetLocalProcessId(), controller->GetNumberOfProcesses());
+
+  // sorted blocks go through the distributed sort index, blocks of a column
+  // that can't be sorted are extracted in process order.
+  bool success = CheckBlocks(controller, input, "key", true);
+  success &= CheckBlocks(controller, input, "constant", false);
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+#ifdef PARAVIEW_USE_MPI
+  controller->Finalize();
+#endif
+  controller->Delete();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
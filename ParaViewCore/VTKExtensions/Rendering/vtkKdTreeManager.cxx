@@ -26,8 +26,10 @@
 #include "vtkPKdTree.h"
 #include "vtkPoints.h"
 #include "vtkSphereSource.h"
+#include "vtkTimerLog.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -48,6 +50,9 @@ vtkKdTreeManager::vtkKdTreeManager()
   this->KdTree = 0;
   this->NumberOfPieces = globalController ? globalController->GetNumberOfProcesses() : 1;
   this->KdTreeInitialized = false;
+  this->LoadImbalanceTolerance = -1.0;
+  this->CutsRetained = false;
+  this->CutsFromData = false;
 
   vtkPKdTree* tree = vtkPKdTree::New();
   tree->SetController(globalController);
@@ -81,6 +86,7 @@ void vtkKdTreeManager::AddDataObject(vtkDataObject* dataObject)
 void vtkKdTreeManager::RemoveAllDataObjects()
 {
   this->DataObjects->clear();
+  this->ExtentTranslator = NULL;
   this->Modified();
 }
 
@@ -108,6 +114,19 @@ void vtkKdTreeManager::SetStructuredDataInformation(vtkExtentTranslator* transla
 //----------------------------------------------------------------------------
 void vtkKdTreeManager::GenerateKdTree()
 {
+  this->CutsRetained = false;
+  if (!this->ExtentTranslator && this->CutsFromData && this->LoadImbalanceTolerance >= 0.0)
+  {
+    vtkTimerLog::MarkStartEvent("Evaluate Kd-Tree Load Balance");
+    this->CutsRetained = this->IsLoadBalanced();
+    vtkTimerLog::MarkEndEvent("Evaluate Kd-Tree Load Balance");
+    if (this->CutsRetained)
+    {
+      return;
+    }
+  }
+
+  vtkTimerLog::MarkStartEvent("Generate Kd-Tree Cuts");
   this->KdTree->RemoveAllDataSets();
   if (!this->KdTreeInitialized)
   {
@@ -166,9 +185,92 @@ void vtkKdTreeManager::GenerateKdTree()
   }
 
   this->KdTree->BuildLocator();
+  this->CutsFromData = !this->ExtentTranslator;
+  vtkTimerLog::MarkEndEvent("Generate Kd-Tree Cuts");
   // this->KdTree->PrintTree();
 }
 
+//-----------------------------------------------------------------------------
+bool vtkKdTreeManager::IsLoadBalanced()
+{
+  vtkPKdTree* tree = this->KdTree;
+  const int numRegions = tree->GetNumberOfRegions();
+  const int* assignment = tree->GetRegionAssignmentMap();
+  if (numRegions <= 0 || assignment == NULL ||
+    tree->GetRegionAssignmentMapLength() != numRegions || tree->GetController() == NULL)
+  {
+    return false;
+  }
+  for (int region = 0; region < numRegions; ++region)
+  {
+    if (assignment[region] < 0 || assignment[region] >= this->NumberOfPieces)
+    {
+      // the number of pieces changed.
+      return false;
+    }
+  }
+
+  // number of cells per region, the last entry counts the cells outside of
+  // the tree.
+  std::vector<vtkIdType> localCounts(numRegions + 1, 0);
+  std::vector<vtkDataSet*> datasets;
+  for (vtkDataObjectSet::iterator iter = this->DataObjects->begin();
+       iter != this->DataObjects->end(); ++iter)
+  {
+    vtkCompositeDataSet* cds = vtkCompositeDataSet::SafeDownCast(iter->GetPointer());
+    if (!cds)
+    {
+      datasets.push_back(vtkDataSet::SafeDownCast(iter->GetPointer()));
+      continue;
+    }
+    vtkSmartPointer<vtkCompositeDataIterator> citer;
+    citer.TakeReference(cds->NewIterator());
+    for (citer->InitTraversal(); !citer->IsDoneWithTraversal(); citer->GoToNextItem())
+    {
+      datasets.push_back(vtkDataSet::SafeDownCast(citer->GetCurrentDataObject()));
+    }
+  }
+
+  double bounds[6];
+  for (size_t cc = 0; cc < datasets.size(); ++cc)
+  {
+    vtkDataSet* ds = datasets[cc];
+    const vtkIdType numCells = ds ? ds->GetNumberOfCells() : 0;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      ds->GetCellBounds(cellId, bounds);
+      const int region = tree->GetRegionContainingPoint(0.5 * (bounds[0] + bounds[1]),
+        0.5 * (bounds[2] + bounds[3]), 0.5 * (bounds[4] + bounds[5]));
+      localCounts[region >= 0 && region < numRegions ? region : numRegions]++;
+    }
+  }
+
+  std::vector<vtkIdType> counts(numRegions + 1, 0);
+  tree->GetController()->AllReduce(
+    &localCounts[0], &counts[0], numRegions + 1, vtkCommunicator::SUM_OP);
+  if (counts[numRegions] > 0)
+  {
+    // the data moved out of the tree.
+    return false;
+  }
+
+  std::vector<vtkIdType> loads(this->NumberOfPieces, 0);
+  vtkIdType total = 0;
+  for (int region = 0; region < numRegions; ++region)
+  {
+    loads[assignment[region]] += counts[region];
+    total += counts[region];
+  }
+  if (total == 0)
+  {
+    return true;
+  }
+
+  const double average = static_cast<double>(total) / this->NumberOfPieces;
+  const vtkIdType maxLoad = *std::max_element(loads.begin(), loads.end());
+  return maxLoad <= (1.0 + this->LoadImbalanceTolerance) * average;
+}
+
 //-----------------------------------------------------------------------------
 void vtkKdTreeManager::AddDataObjectToKdTree(vtkDataObject* data)
 {
@@ -285,4 +387,6 @@ void vtkKdTreeManager::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "KdTree: " << this->KdTree << endl;
   os << indent << "NumberOfPieces: " << this->NumberOfPieces << endl;
+  os << indent << "LoadImbalanceTolerance: " << this->LoadImbalanceTolerance << endl;
+  os << indent << "CutsRetained: " << this->CutsRetained << endl;
 }
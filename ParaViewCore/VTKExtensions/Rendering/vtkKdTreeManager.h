@@ -23,6 +23,11 @@
  * translator. This class manages this logic. When structure data's extent
  * translator is to be used, it simply uses vtkKdTreeGenerator. Otherwise, it
  * lets the vtkPKdTree build the optimal partitioning for the data.
+ *
+ * Building the partitioning from the data is expensive. When
+ * LoadImbalanceTolerance is non-negative, GenerateKdTree() keeps the cuts it
+ * computed from the data earlier as long as the data still fits in the tree
+ * and the processes remain balanced, leaving the KdTree unmodified.
 */
 
 #ifndef vtkKdTreeManager_h
@@ -47,7 +52,8 @@ public:
 
   //@{
   /**
-   * Add data objects.
+   * Add data objects. RemoveAllDataObjects() also clears the structured data
+   * information.
    */
   void AddDataObject(vtkDataObject*);
   void RemoveAllDataObjects();
@@ -78,11 +84,33 @@ public:
   vtkGetMacro(NumberOfPieces, int);
   //@}
 
+  //@{
   /**
-   * Rebuilds the KdTree.
+   * Get/Set the tolerance on the load imbalance below which GenerateKdTree()
+   * keeps the current cuts. The load of a process is the number of cells
+   * whose center lies in the regions assigned to it, and the cuts are kept
+   * if no cell lies outside of the tree and no load exceeds the average by
+   * more than this fraction. Cuts provided by the structured data
+   * information are always regenerated. Negative (default) always rebuilds
+   * the KdTree.
+   */
+  vtkSetMacro(LoadImbalanceTolerance, double);
+  vtkGetMacro(LoadImbalanceTolerance, double);
+  //@}
+
+  /**
+   * Rebuilds the KdTree, unless the current cuts can be kept (see
+   * SetLoadImbalanceTolerance()).
    */
   void GenerateKdTree();
 
+  //@{
+  /**
+   * Returns true if the last call to GenerateKdTree() kept the previous cuts.
+   */
+  vtkGetMacro(CutsRetained, bool);
+  //@}
+
 protected:
   vtkKdTreeManager();
   ~vtkKdTreeManager() override;
@@ -90,9 +118,20 @@ protected:
   void AddDataObjectToKdTree(vtkDataObject* data);
   void AddDataSetToKdTree(vtkDataSet* data);
 
+  /**
+   * Returns true if the data objects are balanced among the processes by the
+   * current cuts, see SetLoadImbalanceTolerance(). Must be called on all
+   * processes.
+   */
+  bool IsLoadBalanced();
+
   bool KdTreeInitialized;
   vtkPKdTree* KdTree;
   int NumberOfPieces;
+  double LoadImbalanceTolerance;
+  bool CutsRetained;
+  // true when the current cuts were computed from the data objects.
+  bool CutsFromData;
 
   vtkSmartPointer<vtkExtentTranslator> ExtentTranslator;
   double Origin[3];
@@ -22,6 +22,7 @@
 #include "vtkEventForwarderCommand.h"
 #include "vtkExtractSelection.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -36,6 +37,7 @@
 #include "vtkTable.h"
 #include "vtkTree.h"
 #include "vtkVertexListIterator.h"
+#include "vtkWeakPointer.h"
 
 #include "vtkCommunicator.h"
 #include "vtkCompositeDataIterator.h"
@@ -86,32 +88,96 @@ public:
   //    while (debug) sleep(5);
   //    }
   // --------------------------------------------------------------------------
-  static void MergeTable(
-    vtkIdType processId, vtkTable* otherTable, vtkTable* mergedTable, vtkIdType minSize)
+  // Pieces don't necessarily have the same columns, e.g. when an array only
+  // exists on some blocks or processes. Columns are matched by name, rows of
+  // a piece missing a column get NaN (or 0 for integers, an empty value for
+  // non numeric columns) so that the other columns stay aligned.
+  static void AppendEmptyTuples(vtkAbstractArray* array, vtkIdType count)
   {
+    const vtkIdType start = array->GetNumberOfTuples();
+    array->SetNumberOfTuples(start + count);
+    vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+    if (dataArray)
+    {
+      const int dataType = dataArray->GetDataType();
+      const double value =
+        (dataType == VTK_FLOAT || dataType == VTK_DOUBLE) ? vtkMath::Nan() : 0.0;
+      for (vtkIdType idx = start; idx < start + count; ++idx)
+      {
+        for (int comp = 0; comp < dataArray->GetNumberOfComponents(); ++comp)
+        {
+          dataArray->SetComponent(idx, comp, value);
+        }
+      }
+    }
+  }
+
+  // --------------------------------------------------------------------------
+  // Whether the tuples of a column of a piece can be copied into the column of
+  // the same name of another piece. Reports the mismatch if not.
+  static bool AreCompatible(vtkAbstractArray* array, vtkAbstractArray* dstArray)
+  {
+    const bool dataArrays =
+      vtkDataArray::SafeDownCast(array) != NULL && vtkDataArray::SafeDownCast(dstArray) != NULL;
+    if (array->GetNumberOfComponents() != dstArray->GetNumberOfComponents() ||
+      (!dataArrays && array->GetDataType() != dstArray->GetDataType()))
+    {
+      vtkGenericWarningMacro("Column '"
+        << array->GetName() << "' has " << array->GetNumberOfComponents() << " components of type "
+        << array->GetDataTypeAsString() << " on a piece and " << dstArray->GetNumberOfComponents()
+        << " components of type " << dstArray->GetDataTypeAsString()
+        << " on another, it is left empty for the former.");
+      return false;
+    }
+    return true;
+  }
+
+  // --------------------------------------------------------------------------
+  // Appends the rows of otherTable to mergedTable. The caller appends the
+  // values of filledColumn itself, if any.
+  static void MergeTable(vtkIdType processId, vtkTable* otherTable, vtkTable* mergedTable,
+    vtkIdType minSize, const char* filledColumn = NULL)
+  {
+    const vtkIdType nbMergedRows =
+      mergedTable->GetNumberOfColumns() > 0 ? mergedTable->GetNumberOfRows() : 0;
+    const vtkIdType nbOtherRows = otherTable->GetNumberOfRows();
+
     // Loop on all column of the table
     vtkAbstractArray* otherArray = 0;
     vtkAbstractArray* dstArray = 0;
     bool needNewArray = false;
+    std::set<std::string> otherNames;
     for (vtkIdType colIdx = 0; colIdx < otherTable->GetNumberOfColumns(); ++colIdx)
     {
       otherArray = otherTable->GetColumn(colIdx);
       dstArray = mergedTable->GetColumnByName(otherArray->GetName());
       needNewArray = (!dstArray);
+      if (otherArray->GetName())
+      {
+        otherNames.insert(otherArray->GetName());
+      }
 
       if (needNewArray)
       {
         dstArray = otherArray->NewInstance();
         dstArray->SetNumberOfComponents(otherArray->GetNumberOfComponents());
         dstArray->SetName(otherArray->GetName());
-        dstArray->Allocate(minSize * otherArray->GetNumberOfComponents());
+        dstArray->Allocate((nbMergedRows + minSize) * otherArray->GetNumberOfComponents());
+        AppendEmptyTuples(dstArray, nbMergedRows);
       }
 
-      for (vtkIdType idx = 0; idx < otherArray->GetNumberOfTuples(); ++idx)
+      if (!needNewArray && !AreCompatible(otherArray, dstArray))
       {
-        if (dstArray->InsertNextTuple(idx, otherArray) == -1)
+        AppendEmptyTuples(dstArray, nbOtherRows);
+      }
+      else
+      {
+        for (vtkIdType idx = 0; idx < otherArray->GetNumberOfTuples(); ++idx)
         {
-          cout << "ERROR MergeTable::InsertNextTuple is not working." << endl;
+          if (dstArray->InsertNextTuple(idx, otherArray) == -1)
+          {
+            cout << "ERROR MergeTable::InsertNextTuple is not working." << endl;
+          }
         }
       }
 
@@ -122,6 +188,19 @@ public:
       }
     }
 
+    // Columns the other table doesn't have
+    for (vtkIdType colIdx = 0; colIdx < mergedTable->GetNumberOfColumns(); ++colIdx)
+    {
+      dstArray = mergedTable->GetColumn(colIdx);
+      const char* name = dstArray->GetName();
+      if (name && otherNames.find(name) == otherNames.end() &&
+        (processId < 0 || strcmp(name, "vtkOriginalProcessIds") != 0) &&
+        (!filledColumn || strcmp(name, filledColumn) != 0))
+      {
+        AppendEmptyTuples(dstArray, nbOtherRows);
+      }
+    }
+
     if (processId > -1 && mergedTable->GetColumnByName("vtkOriginalProcessIds"))
     {
       vtkIdTypeArray* processIdArray =
@@ -559,12 +638,47 @@ public:
     }
   };
 
+  // Entry of the distributed sort index: a value and where its row lives.
+  // This is a POD so slices can be exchanged as raw bytes.
+  struct IndexEntry
+  {
+    T Value;
+    vtkIdType OriginalIndex;
+    int ProcessId;
+  };
+  // Global ordering of the index. Equal values are ordered by process and
+  // original index so that the order is total and matches the local sorter.
+  class IndexEntryCompare
+  {
+  public:
+    IndexEntryCompare(bool inverted)
+      : Inverted(inverted)
+    {
+    }
+    bool operator()(const IndexEntry& a, const IndexEntry& b) const
+    {
+      return this->Inverted ? Less(b, a) : Less(a, b);
+    }
+    static bool Less(const IndexEntry& a, const IndexEntry& b)
+    {
+      if (a.Value != b.Value)
+      {
+        return a.Value < b.Value;
+      }
+      if (a.ProcessId != b.ProcessId)
+      {
+        return a.ProcessId < b.ProcessId;
+      }
+      return a.OriginalIndex < b.OriginalIndex;
+    }
+    bool Inverted;
+  };
+
 public:
   Internals()
   {
     // Only used for testing
     this->LocalSorter = 0;
-    this->GlobalHistogram = 0;
     this->Debug = false;
   }
 
@@ -576,11 +690,7 @@ public:
     this->DataToSort = dataToSort;
 
     this->InputMTime = input->GetMTime();
-
-    if (dataToSort) // Might be NULL
-    {
-      this->DataMTime = dataToSort->GetMTime();
-    }
+    this->DataMTime = dataToSort ? dataToSort->GetMTime() : 0; // Might be NULL
 
     // Get MPI objects
     this->MPI = controller->GetCommunicator();
@@ -589,15 +699,12 @@ public:
 
     // Create internal objects
     this->LocalSorter = new ArraySorter();
-    this->GlobalHistogram = new Histogram(HISTOGRAM_SIZE);
   }
 
   ~Internals() override
   {
     if (this->LocalSorter)
       delete this->LocalSorter;
-    if (this->GlobalHistogram)
-      delete this->GlobalHistogram;
   }
 
   // --------------------------------------------------------------------------
@@ -663,15 +770,27 @@ public:
     return sortable;
   }
 
+  // --------------------------------------------------------------------------
+  // Decide collectively whether the cache must be (re)built. Processes that
+  // don't have the array to sort may otherwise disagree with the others which
+  // would lead to mismatched collective calls.
+  bool NeedToBuildCacheOnAnyProcess()
+  {
+    int localNeed = this->NeedToBuildCache ? 1 : 0;
+    int globalNeed = localNeed;
+    if (this->NumProcs > 1)
+    {
+      this->MPI->AllReduce(&localNeed, &globalNeed, 1, vtkCommunicator::MAX_OP);
+    }
+    return globalNeed != 0;
+  }
+
   // --------------------------------------------------------------------------
   int BuildCache(bool sortableArray, bool invertOrder)
   {
     // We are building the cache so no need to build it next time
     this->NeedToBuildCache = false;
 
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs * HISTOGRAM_SIZE];
-
     // Is there something to sort ???
     if (!sortableArray)
     {
@@ -680,45 +799,156 @@ public:
       {
         this->LocalSorter->FillArray(this->DataToSort->GetNumberOfTuples());
       }
+      return 1;
+    }
+
+    if (this->DataToSort)
+    {
+      // Sort the local array
+      this->LocalSorter->Update(static_cast<T*>(this->DataToSort->GetVoidPointer(0)),
+        this->DataToSort->GetNumberOfTuples(), this->DataToSort->GetNumberOfComponents(),
+        this->SelectedComponent, HISTOGRAM_SIZE, this->CommonRange, invertOrder);
     }
     else
     {
-      if (this->DataToSort)
-      {
-        // Sort and build local histogram
-        this->LocalSorter->Update(static_cast<T*>(this->DataToSort->GetVoidPointer(0)),
-          this->DataToSort->GetNumberOfTuples(), this->DataToSort->GetNumberOfComponents(),
-          this->SelectedComponent, HISTOGRAM_SIZE, this->CommonRange, invertOrder);
-      }
-      else
-      {
-        // Build empty local histogram
-        this->LocalSorter->Clear();
-        this->LocalSorter->Histo = new Histogram(HISTOGRAM_SIZE);
-        this->LocalSorter->Histo->SetScalarRange(this->CommonRange);
-        this->LocalSorter->Histo->Inverted = invertOrder;
-      }
+      this->LocalSorter->Clear();
+    }
+
+    // Build the distributed index. Once done, the local sorter is not needed
+    // anymore since the index knows where every row lives.
+    this->BuildSortIndex(invertOrder);
+    this->LocalSorter->Clear();
+    return 1;
+  }
+
+  // --------------------------------------------------------------------------
+  // Build the distributed sort index using a sample sort: every process
+  // contributes regular samples of its locally sorted array, the gathered
+  // samples give the splitters used to route each local entry to the process
+  // owning that part of the global order. Each process ends up with a
+  // contiguous slice of the globally sorted sequence, SliceOffsets gives the
+  // global position of each slice.
+  void BuildSortIndex(bool invertOrder)
+  {
+    IndexEntryCompare compare(invertOrder);
+    vtkIdType nbLocal = this->LocalSorter->Array ? this->LocalSorter->ArraySize : 0;
+
+    std::vector<IndexEntry> localEntries(nbLocal);
+    for (vtkIdType idx = 0; idx < nbLocal; ++idx)
+    {
+      localEntries[idx].Value = this->LocalSorter->Array[idx].Value;
+      localEntries[idx].OriginalIndex = this->LocalSorter->Array[idx].OriginalIndex;
+      localEntries[idx].ProcessId = this->Me;
+    }
+
+    this->SliceOffsets.assign(this->NumProcs + 1, 0);
+    if (this->NumProcs == 1)
+    {
+      this->IndexSlice.swap(localEntries);
+      this->SliceOffsets[1] = static_cast<vtkIdType>(this->IndexSlice.size());
+      return;
+    }
+
+    // Regular sampling of the local sorted array
+    std::vector<IndexEntry> samples;
+    for (int cc = 1; nbLocal > 0 && cc < this->NumProcs; ++cc)
+    {
+      samples.push_back(localEntries[(cc * nbLocal) / this->NumProcs]);
+    }
 
-      // Initialize the global histogram with same range
-      this->LocalSorter->Histo->CopyRangeTo(*this->GlobalHistogram);
+    std::vector<vtkIdType> sampleCounts(this->NumProcs);
+    vtkIdType nbSamples = static_cast<vtkIdType>(samples.size());
+    this->MPI->AllGather(&nbSamples, &sampleCounts[0], 1);
+    std::vector<IndexEntry> allSamples;
+    this->AllGatherEntries(samples, sampleCounts, allSamples);
+    std::sort(allSamples.begin(), allSamples.end(), compare);
 
-      // Make sure that the global histogram is properly initialized
-      this->GlobalHistogram->ClearHistogramValues();
-      this->GlobalHistogram->Inverted = invertOrder;
+    // Split the local array into one bucket per process
+    std::vector<vtkIdType> bucketStart(this->NumProcs + 1, nbLocal);
+    bucketStart[0] = 0;
+    for (int cc = 1; cc < this->NumProcs && !allSamples.empty(); ++cc)
+    {
+      const IndexEntry& splitter = allSamples[(cc * allSamples.size()) / this->NumProcs];
+      bucketStart[cc] = std::lower_bound(localEntries.begin() + bucketStart[cc - 1],
+                          localEntries.end(), splitter, compare) -
+        localEntries.begin();
+    }
 
-      // Send local histogram and receive every histogram from everybody
-      this->MPI->AllGather(this->LocalSorter->Histo->Values, bufferHistogramValues, HISTOGRAM_SIZE);
+    std::vector<vtkIdType> sendCounts(this->NumProcs);
+    for (int cc = 0; cc < this->NumProcs; ++cc)
+    {
+      sendCounts[cc] = bucketStart[cc + 1] - bucketStart[cc];
+    }
+    std::vector<vtkIdType> allCounts(this->NumProcs * this->NumProcs);
+    this->MPI->AllGather(&sendCounts[0], &allCounts[0], this->NumProcs);
 
-      // Merge all histogram into the GlobalHistogram
-      for (int idx = 0, nb = this->NumProcs * HISTOGRAM_SIZE; idx < nb; ++idx)
+    // Route each bucket to its owner. Gathering on each process in turn keeps
+    // the exchange deadlock free without requiring an all-to-all.
+    std::vector<vtkIdType> recvLengths(this->NumProcs);
+    std::vector<vtkIdType> recvOffsets(this->NumProcs);
+    for (int root = 0; root < this->NumProcs; ++root)
+    {
+      vtkIdType total = 0;
+      for (int cc = 0; cc < this->NumProcs; ++cc)
+      {
+        recvLengths[cc] = allCounts[cc * this->NumProcs + root] * sizeof(IndexEntry);
+        recvOffsets[cc] = total;
+        total += recvLengths[cc];
+      }
+      if (root == this->Me)
       {
-        this->GlobalHistogram->TotalValues += bufferHistogramValues[idx];
-        this->GlobalHistogram->Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
+        this->IndexSlice.resize(total / sizeof(IndexEntry));
       }
+      IndexEntry dummy;
+      const IndexEntry* sendBuffer =
+        sendCounts[root] > 0 ? &localEntries[bucketStart[root]] : &dummy;
+      IndexEntry* recvBuffer =
+        (root == this->Me && !this->IndexSlice.empty()) ? &this->IndexSlice[0] : &dummy;
+      this->MPI->GatherV(reinterpret_cast<const char*>(sendBuffer),
+        reinterpret_cast<char*>(recvBuffer), sendCounts[root] * sizeof(IndexEntry),
+        &recvLengths[0], &recvOffsets[0], root);
     }
+    std::vector<IndexEntry>().swap(localEntries);
 
-    delete[] bufferHistogramValues;
-    return 1;
+    // The received slice is made of one sorted run per process, merge them.
+    vtkIdType runStart = 0;
+    for (int cc = 0; cc < this->NumProcs; ++cc)
+    {
+      vtkIdType runEnd = runStart + allCounts[cc * this->NumProcs + this->Me];
+      std::inplace_merge(this->IndexSlice.begin(), this->IndexSlice.begin() + runStart,
+        this->IndexSlice.begin() + runEnd, compare);
+      runStart = runEnd;
+    }
+
+    // Global position of each slice
+    std::vector<vtkIdType> sliceSizes(this->NumProcs);
+    vtkIdType sliceSize = static_cast<vtkIdType>(this->IndexSlice.size());
+    this->MPI->AllGather(&sliceSize, &sliceSizes[0], 1);
+    for (int cc = 0; cc < this->NumProcs; ++cc)
+    {
+      this->SliceOffsets[cc + 1] = this->SliceOffsets[cc] + sliceSizes[cc];
+    }
+  }
+
+  // --------------------------------------------------------------------------
+  void AllGatherEntries(const std::vector<IndexEntry>& localEntries,
+    const std::vector<vtkIdType>& counts, std::vector<IndexEntry>& allEntries)
+  {
+    std::vector<vtkIdType> lengths(this->NumProcs);
+    std::vector<vtkIdType> offsets(this->NumProcs);
+    vtkIdType total = 0;
+    for (int cc = 0; cc < this->NumProcs; ++cc)
+    {
+      lengths[cc] = counts[cc] * sizeof(IndexEntry);
+      offsets[cc] = total;
+      total += lengths[cc];
+    }
+    allEntries.resize(total / sizeof(IndexEntry));
+    IndexEntry dummy;
+    this->MPI->AllGatherV(
+      reinterpret_cast<const char*>(localEntries.empty() ? &dummy : &localEntries[0]),
+      reinterpret_cast<char*>(allEntries.empty() ? &dummy : &allEntries[0]),
+      static_cast<vtkIdType>(localEntries.size() * sizeof(IndexEntry)), &lengths[0], &offsets[0]);
   }
 
   // --------------------------------------------------------------------------
@@ -731,7 +961,7 @@ public:
     //    This will sort the local array, that's why we don't want to do it
     //    at each execution. Specialy when we only change the requested block.
     // ------------------------------------------------------------------------
-    if (this->NeedToBuildCache)
+    if (this->NeedToBuildCacheOnAnyProcess())
     {
       this->BuildCache(false, revertOrder);
     }
@@ -860,195 +1090,207 @@ public:
     bool revertOrder) override
   {
     // ------------------------------------------------------------------------
-    // Make sure that the Cache is builded
-    //    This will sort the local array, that's why we don't want to do it
-    //    at each execution. Specialy when we only change the requested block.
+    // Make sure that the sort index is built
+    //    This will sort the local array and distribute the index, that's why
+    //    we don't want to do it at each execution. Specialy when we only
+    //    change the requested block.
     // ------------------------------------------------------------------------
-    if (this->NeedToBuildCache)
+    if (this->NeedToBuildCacheOnAnyProcess())
     {
       this->BuildCache(true, revertOrder);
     }
 
     // ------------------------------------------------------------------------
-    // Search for lower bound
+    // Global range covered by the block and the part of it this process owns
+    // in its slice of the index. Every process knows all the slice offsets so
+    // it can compute what the others will contribute without communicating.
     // ------------------------------------------------------------------------
-    vtkIdType nbElementsToRemoveFromHead = 0;
-    vtkIdType localOffset = 0;
-    vtkIdType nbElementsInBar = 0;
-    this->SearchGlobalIndexLocation((block * blockSize), this->LocalSorter->Histo,
-      this->GlobalHistogram, nbElementsToRemoveFromHead, localOffset, nbElementsInBar);
-
-    // ------------------------------------------------------------------------
-    // Search for upper bound
-    // ------------------------------------------------------------------------
-    vtkIdType upperOffset = 0;
-    vtkIdType globalUpperOffset = 0;
-    vtkIdType searchIdx = (this->GlobalHistogram->TotalValues < (block + 1) * blockSize)
-      ? this->GlobalHistogram->TotalValues
-      : ((block + 1) * blockSize);
-    searchIdx--; // It is not a size it is an index (so -1)
-
-    this->SearchGlobalIndexLocation(searchIdx, this->LocalSorter->Histo, this->GlobalHistogram,
-      globalUpperOffset, upperOffset, nbElementsInBar);
-
-    // We have to include our searched index (so +1)
-    vtkIdType localSize = (upperOffset + nbElementsInBar) - localOffset + 1;
+    vtkIdType total = this->SliceOffsets[this->NumProcs];
+    vtkIdType first = vtkMath::Min(block * blockSize, total);
+    vtkIdType last = vtkMath::Min(first + blockSize, total);
 
-    // ------------------------------------------------------------------------
-    // Build local subset table
-    // ------------------------------------------------------------------------
-    vtkSmartPointer<vtkTable> localSubset;
-    localSubset.TakeReference(
-      this->NewSubsetTable(input, this->LocalSorter, localOffset, localSize));
+    std::vector<vtkIdType> lengths(this->NumProcs);
+    std::vector<vtkIdType> offsets(this->NumProcs);
+    vtkIdType blockLength = 0;
+    for (int pid = 0; pid < this->NumProcs; ++pid)
+    {
+      vtkIdType begin = vtkMath::Max(first, this->SliceOffsets[pid]);
+      vtkIdType end = vtkMath::Min(last, this->SliceOffsets[pid + 1]);
+      lengths[pid] = 2 * vtkMath::Max(static_cast<vtkIdType>(0), end - begin);
+      offsets[pid] = blockLength;
+      blockLength += lengths[pid];
+    }
 
-    // ------------------------------------------------------------------------
-    // Find the process that will merge all subset table
-    // ------------------------------------------------------------------------
-    int mergePid = GetMergingProcessId(localSubset.GetPointer());
+    // (ProcessId, OriginalIndex) for each row of the block in the global order
+    std::vector<vtkIdType> localRows(lengths[this->Me] + 1);
+    vtkIdType sliceBegin = vtkMath::Max(first, this->SliceOffsets[this->Me]);
+    for (vtkIdType idx = 0; idx < lengths[this->Me] / 2; ++idx)
+    {
+      const IndexEntry& entry = this->IndexSlice[sliceBegin - this->SliceOffsets[this->Me] + idx];
+      localRows[2 * idx] = entry.ProcessId;
+      localRows[2 * idx + 1] = entry.OriginalIndex;
+    }
+    std::vector<vtkIdType> blockRows(blockLength + 1);
+    if (this->NumProcs > 1)
+    {
+      this->MPI->AllGatherV(
+        &localRows[0], &blockRows[0], lengths[this->Me], &lengths[0], &offsets[0]);
+    }
+    else
+    {
+      blockRows.swap(localRows);
+    }
 
     // ------------------------------------------------------------------------
-    // Add local meta-data in case of merge process
+    // Extract the local rows of the block and count the contribution of each
+    // process. The biggest contributor merges the block.
     // ------------------------------------------------------------------------
-    if (this->NumProcs > 1 && this->Me == mergePid)
+    std::vector<vtkIdType> contributions(this->NumProcs, 0);
+    vtkSmartPointer<vtkIdList> localIds = vtkSmartPointer<vtkIdList>::New();
+    for (vtkIdType idx = 0; idx < blockLength; idx += 2)
     {
-      vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
-      processIdArray->SetName("vtkOriginalProcessIds");
-      processIdArray->SetNumberOfComponents(1);
-      processIdArray->Allocate((blockSize < localSize) ? localSize : blockSize);
-      for (vtkIdType idx = 0; idx < localSubset->GetNumberOfRows(); idx++)
+      contributions[blockRows[idx]]++;
+      if (blockRows[idx] == this->Me)
       {
-        processIdArray->InsertNextTuple1(mergePid);
+        localIds->InsertNextId(blockRows[idx + 1]);
       }
-      localSubset->GetRowData()->AddArray(processIdArray);
     }
+    int mergePid = static_cast<int>(
+      std::max_element(contributions.begin(), contributions.end()) - contributions.begin());
+
+    vtkSmartPointer<vtkTable> localSubset;
+    localSubset.TakeReference(NewSubsetTable(input, localIds));
 
-    // ------------------------------------------------------------------------
-    // Send local subset array to process mergePid
-    // ------------------------------------------------------------------------
     if (this->Me != mergePid)
     {
-      this->MPI->Send(localSubset.GetPointer(), mergePid, VTK_TABLE_EXCHANGE_TAG);
+      if (localIds->GetNumberOfIds() > 0)
+      {
+        this->MPI->Send(localSubset.GetPointer(), mergePid, VTK_TABLE_EXCHANGE_TAG);
+      }
+
+      // Ask other processes to provide metadata for table decoration
+      this->DecorateTable(input, NULL, mergePid);
+      return 1;
     }
 
     // ------------------------------------------------------------------------
-    // Merging procedure only on process mergePid
+    // Merging procedure only on process mergePid: rows are interleaved using
+    // the block ordering, no need to sort anything.
     // ------------------------------------------------------------------------
-    if (this->Me == mergePid)
+    std::vector<vtkSmartPointer<vtkTable> > pieces(this->NumProcs);
+    pieces[this->Me] = localSubset;
+    for (int pid = 0; pid < this->NumProcs; ++pid)
     {
-      vtkSmartPointer<vtkTable> tmp = vtkSmartPointer<vtkTable>::New();
-      for (int i = 0; i < this->NumProcs; i++)
+      if (pid != mergePid && contributions[pid] > 0)
       {
-        if (i == mergePid)
-          continue;
-
-        this->MPI->Receive(tmp.GetPointer(), i, VTK_TABLE_EXCHANGE_TAG);
-        this->MergeTable(i, tmp.GetPointer(), localSubset.GetPointer(), blockSize);
+        pieces[pid] = vtkSmartPointer<vtkTable>::New();
+        this->MPI->Receive(pieces[pid].GetPointer(), pid, VTK_TABLE_EXCHANGE_TAG);
       }
+    }
 
-      // Sort new table/array
-      if (!this->DataToSort)
+    // Columns are matched by name: the block has every column found on any
+    // of its pieces, in the order they are first found.
+    std::vector<vtkAbstractArray*> columns;
+    std::set<std::string> columnNames;
+    for (int cc = 0; cc < this->NumProcs; ++cc)
+    {
+      // start with the local piece, which is the biggest one.
+      const int pid = (this->Me + cc) % this->NumProcs;
+      for (vtkIdType colIdx = 0; pieces[pid] && colIdx < pieces[pid]->GetNumberOfColumns();
+           ++colIdx)
       {
-        // This mean that no output can be provided
-        // cout << "ERROR the merge process have no DataArray." << endl;
-        return 1;
+        vtkAbstractArray* column = pieces[pid]->GetColumn(colIdx);
+        if (column->GetName() && columnNames.insert(column->GetName()).second)
+        {
+          columns.push_back(column);
+        }
       }
-      vtkDataArray* subsetArray =
-        vtkDataArray::SafeDownCast(localSubset->GetColumnByName(this->DataToSort->GetName()));
+    }
 
-      if (!subsetArray)
+    vtkSmartPointer<vtkTable> result = vtkSmartPointer<vtkTable>::New();
+    vtkIdType nbRows = blockLength / 2;
+    for (size_t colIdx = 0; colIdx < columns.size(); ++colIdx)
+    {
+      vtkAbstractArray* srcArray = columns[colIdx];
+      vtkAbstractArray* dstArray = srcArray->NewInstance();
+      dstArray->SetNumberOfComponents(srcArray->GetNumberOfComponents());
+      dstArray->SetName(srcArray->GetName());
+      dstArray->Allocate(nbRows * srcArray->GetNumberOfComponents());
+
+      std::vector<vtkAbstractArray*> pieceArrays(this->NumProcs, static_cast<vtkAbstractArray*>(0));
+      for (int pid = 0; pid < this->NumProcs; ++pid)
       {
-        vtkSortedTableStreamer::PrintInfo(localSubset.GetPointer());
+        if (pieces[pid])
+        {
+          pieceArrays[pid] = pieces[pid]->GetColumnByName(srcArray->GetName());
+          if (pieceArrays[pid] && !AreCompatible(pieceArrays[pid], srcArray))
+          {
+            pieceArrays[pid] = NULL;
+          }
+        }
       }
 
-      ArraySorter sorter;
-      sorter.Update(static_cast<T*>(subsetArray->GetVoidPointer(0)),
-        subsetArray->GetNumberOfTuples(), subsetArray->GetNumberOfComponents(),
-        this->SelectedComponent, HISTOGRAM_SIZE, this->CommonRange, revertOrder);
-
-      // trim it (remove head and tail that don't belong to the result)
-      localSubset.TakeReference(this->NewSubsetTable(
-        localSubset.GetPointer(), &sorter, nbElementsToRemoveFromHead, blockSize));
-
-      // Add extra information such as structured indices, block number...
-      this->DecorateTable(input, localSubset.GetPointer(), mergePid);
-
-      // ShallowCopy it to the output
-      output->ShallowCopy(localSubset.GetPointer());
+      std::vector<vtkIdType> cursors(this->NumProcs, 0);
+      for (vtkIdType idx = 0; idx < blockLength; idx += 2)
+      {
+        vtkIdType pid = blockRows[idx];
+        vtkIdType row = cursors[pid]++;
+        if (!pieceArrays[pid])
+        {
+          AppendEmptyTuples(dstArray, 1);
+        }
+        else if (dstArray->InsertNextTuple(row, pieceArrays[pid]) == -1)
+        {
+          cout << "ERROR Compute::InsertNextTuple is not working." << endl;
+        }
+      }
+      result->GetRowData()->AddArray(dstArray);
+      dstArray->FastDelete();
     }
-    else
+
+    if (this->NumProcs > 1)
     {
-      // Ask other processes to provide metadata for table decoration
-      this->DecorateTable(input, NULL, mergePid);
+      vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
+      processIdArray->SetName("vtkOriginalProcessIds");
+      processIdArray->SetNumberOfComponents(1);
+      processIdArray->SetNumberOfTuples(nbRows);
+      for (vtkIdType idx = 0; idx < nbRows; ++idx)
+      {
+        processIdArray->SetValue(idx, blockRows[2 * idx]);
+      }
+      result->GetRowData()->AddArray(processIdArray);
     }
 
+    // Add extra information such as structured indices, block number...
+    this->DecorateTable(input, result.GetPointer(), mergePid);
+
+    // ShallowCopy it to the output
+    output->ShallowCopy(result.GetPointer());
     return 1;
   }
 
   // --------------------------------------------------------------------------
-  // nbGlobalToSkip is the number of elements that should be skiped at the end
-  // if you exactly want to reach the searchedGlobalIndex.
-  // localOffset is the corresponding local index in the sorted table to the
-  // global index of (searchedGlobalIndex - nbGlobalToSkip)
-  // nbInLocalBar is the local number of elements that are available
-  // in the hitogram bar where the searchedGlobalIndex has been found.
-  // nbInLocalBar is used when you want to get an upper bound that
-  // will include the searchedGlobalIndex.
-  void SearchGlobalIndexLocation(vtkIdType searchedGlobalIndex, Histogram* localHistogram,
-    Histogram* globalHistogram, vtkIdType& nbGlobalToSkip, vtkIdType& localOffset,
-    vtkIdType& nbInLocalBar)
+  static vtkTable* NewSubsetTable(vtkTable* srcTable, vtkIdList* rowIds)
   {
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs * HISTOGRAM_SIZE];
-
-    // Local internal working var
-    vtkIdType histogramBarIdx = -1;
-    double currentRange[2];
-    vtkIdType idx, idxEnd;
-
-    // Setup inital hitogram range and values
-    Histogram _globalHistogram;
-    Histogram _localHistogram;
-    localHistogram->CopyTo(_localHistogram);
-    globalHistogram->CopyTo(_globalHistogram);
-
-    // Reset local offsets
-    localOffset = 0;
-    nbGlobalToSkip = searchedGlobalIndex;
-
-    do
+    vtkTable* subTable = vtkTable::New();
+    for (vtkIdType colIdx = 0; colIdx < srcTable->GetNumberOfColumns(); ++colIdx)
     {
-      nbGlobalToSkip -= _globalHistogram.GetNewRange(nbGlobalToSkip, histogramBarIdx, currentRange);
-
-      localOffset += _localHistogram.GetNumberOfElements(0, histogramBarIdx);
-      nbInLocalBar = _localHistogram.GetNumberOfElements(histogramBarIdx, histogramBarIdx + 1);
-
-      // Based on a narrowed range, build local histogram to get closer to the
-      // real index of the object
-      _localHistogram.SetScalarRange(currentRange);
-      _localHistogram.ClearHistogramValues();
-
-      idxEnd = localOffset + nbInLocalBar;
-      for (idx = localOffset; idx < idxEnd; ++idx)
-      {
-        _localHistogram.AddValue(this->LocalSorter->Array[idx].Value);
-      }
-
-      // Exchange local histo with everyone
-      this->MPI->AllGather(_localHistogram.Values, bufferHistogramValues, HISTOGRAM_SIZE);
-
-      // Build global histogram
-      _globalHistogram.SetScalarRange(currentRange);
-      _globalHistogram.ClearHistogramValues();
-
-      idxEnd = this->NumProcs * HISTOGRAM_SIZE;
-      for (idx = 0; idx < idxEnd; ++idx)
+      vtkAbstractArray* srcArray = srcTable->GetColumn(colIdx);
+      vtkAbstractArray* subArray = srcArray->NewInstance();
+      subArray->SetNumberOfComponents(srcArray->GetNumberOfComponents());
+      subArray->SetName(srcArray->GetName());
+      subArray->Allocate(rowIds->GetNumberOfIds() * srcArray->GetNumberOfComponents());
+      for (vtkIdType idx = 0; idx < rowIds->GetNumberOfIds(); ++idx)
       {
-        _globalHistogram.TotalValues += bufferHistogramValues[idx];
-        _globalHistogram.Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
+        if (subArray->InsertNextTuple(rowIds->GetId(idx), srcArray) == -1)
+        {
+          cout << "ERROR NewSubsetTable::InsertNextTuple is not working." << endl;
+        }
       }
-    } while (nbGlobalToSkip > 0 && _globalHistogram.CanBeReduced());
-
-    delete[] bufferHistogramValues;
+      subTable->GetRowData()->AddArray(subArray);
+      subArray->FastDelete();
+    }
+    return subTable;
   }
 
   // --------------------------------------------------------------------------
@@ -1114,8 +1356,10 @@ public:
   // --------------------------------------------------------------------------
   bool IsInvalid(vtkTable* input, vtkDataArray* dataToProcess) override
   {
-    return !dataToProcess || input->GetMTime() != this->InputMTime ||
-      dataToProcess->GetMTime() != this->DataMTime;
+    // A process without the array to sort stays valid as long as its input
+    // doesn't change, the rebuild decision is made collectively anyway.
+    return dataToProcess != this->DataToSort || input->GetMTime() != this->InputMTime ||
+      (dataToProcess && dataToProcess->GetMTime() != this->DataMTime);
   }
 
   // --------------------------------------------------------------------------
@@ -1312,7 +1556,8 @@ private:
   vtkMTimeType DataMTime;     // Keep the original data MTime
   vtkDataArray* DataToSort;   // DataArray to sort
   ArraySorter* LocalSorter;   // Local ArraySorter based on global range
-  Histogram* GlobalHistogram; // Globaly merged Histogram based on global range
+  std::vector<IndexEntry> IndexSlice;  // Local slice of the global sort index
+  std::vector<vtkIdType> SliceOffsets; // Global position of each process slice
   double CommonRange[2];      // Scalar range used across processes
   int Me;                     // Current process ID
   int NumProcs;               // Number of processes involved
@@ -1330,6 +1575,93 @@ private:
   // the best.
   const static int HISTOGRAM_SIZE = 256;
 };
+//****************************************************************************
+// Sort indices are retained per (column, component, order) until the input
+// changes. The merged table built from a composite input is kept as well,
+// otherwise every block request would produce a new input and invalidate all
+// the indices.
+class vtkSortedTableStreamer::InternalsCache
+{
+public:
+  struct Entry
+  {
+    std::string Column;
+    int Component;
+    bool Inverted;
+    InternalsBase* Internal;
+  };
+
+  InternalsCache()
+    : InputMTime(0)
+    , MergedInputMTime(0)
+  {
+  }
+
+  ~InternalsCache() { this->Clear(); }
+
+  void Clear()
+  {
+    for (std::vector<Entry>::iterator iter = this->Entries.begin(); iter != this->Entries.end();
+         ++iter)
+    {
+      delete iter->Internal;
+    }
+    this->Entries.clear();
+  }
+
+  // Returns the retained internal object for that key or NULL. Outdated
+  // objects are released.
+  InternalsBase* Find(vtkTable* input, vtkDataArray* data, const std::string& column,
+    int component, bool inverted)
+  {
+    if (input->GetMTime() != this->InputMTime)
+    {
+      this->Clear();
+      this->InputMTime = input->GetMTime();
+      return NULL;
+    }
+    for (std::vector<Entry>::iterator iter = this->Entries.begin(); iter != this->Entries.end();
+         ++iter)
+    {
+      if (iter->Column == column && iter->Component == component && iter->Inverted == inverted)
+      {
+        Entry entry = *iter;
+        this->Entries.erase(iter);
+        if (entry.Internal->IsInvalid(input, data))
+        {
+          delete entry.Internal;
+          return NULL;
+        }
+        // Keep most recently used entries at the back
+        this->Entries.push_back(entry);
+        return entry.Internal;
+      }
+    }
+    return NULL;
+  }
+
+  void Add(InternalsBase* internal, const std::string& column, int component, bool inverted)
+  {
+    if (this->Entries.size() >= MAX_RETAINED_INDICES)
+    {
+      delete this->Entries.front().Internal;
+      this->Entries.erase(this->Entries.begin());
+    }
+    Entry entry = { column, component, inverted, internal };
+    this->Entries.push_back(entry);
+  }
+
+  std::vector<Entry> Entries;
+  vtkMTimeType InputMTime;
+
+  vtkSmartPointer<vtkTable> MergedInput;
+  vtkWeakPointer<vtkDataObject> MergedInputSource;
+  vtkMTimeType MergedInputMTime;
+
+  // Each index costs about the size of the sorted column, keep only a few.
+  static const size_t MAX_RETAINED_INDICES = 4;
+};
+
 //****************************************************************************
 vtkStandardNewMacro(vtkSortedTableStreamer);
 vtkCxxSetObjectMacro(vtkSortedTableStreamer, Controller, vtkMultiProcessController);
@@ -1344,6 +1676,7 @@ vtkSortedTableStreamer::vtkSortedTableStreamer()
   this->Block = 0;
   this->BlockSize = 1024;
   this->Internal = 0;
+  this->Cache = new InternalsCache();
   this->SelectedComponent = 0;
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
@@ -1353,11 +1686,9 @@ vtkSortedTableStreamer::~vtkSortedTableStreamer()
 {
   this->SetColumnToSort(0);
   this->SetController(0);
-  if (this->Internal)
-  {
-    delete this->Internal;
-    this->Internal = 0;
-  }
+  // Internal is owned by the cache
+  this->Internal = 0;
+  delete this->Cache;
 }
 
 //----------------------------------------------------------------------------
@@ -1382,6 +1713,13 @@ int vtkSortedTableStreamer::RequestData(vtkInformation* vtkNotUsed(request),
 
   bool orderInverted = this->InvertOrder > 0;
 
+  // Reuse the table merged from the same composite input if it didn't change
+  if (!input && inputDO && this->Cache->MergedInputSource == inputDO &&
+    this->Cache->MergedInputMTime == inputDO->GetMTime())
+  {
+    input = this->Cache->MergedInput;
+  }
+
   // Convert a composite dataset into a vtkTable input.
   if (!input)
   {
@@ -1408,7 +1746,8 @@ int vtkSortedTableStreamer::RequestData(vtkInformation* vtkNotUsed(request),
       vtkTable* other = 0;
       if ((other = vtkTable::SafeDownCast(iter->GetCurrentDataObject())))
       {
-        InternalsBase::MergeTable(-1, other, input.GetPointer(), allocationSize);
+        InternalsBase::MergeTable(
+          -1, other, input.GetPointer(), allocationSize, "vtkCompositeIndexArray");
 
         // Add metadata to the merged table
         vtkSmartPointer<vtkUnsignedIntArray> compositeIndex =
@@ -1461,6 +1800,10 @@ int vtkSortedTableStreamer::RequestData(vtkInformation* vtkNotUsed(request),
       }
     }
     iter->Delete();
+
+    this->Cache->MergedInput = input;
+    this->Cache->MergedInputSource = inputDO;
+    this->Cache->MergedInputMTime = inputDO ? inputDO->GetMTime() : 0;
   }
 
   // Get input data
@@ -1476,17 +1819,24 @@ int vtkSortedTableStreamer::RequestData(vtkInformation* vtkNotUsed(request),
   // single point/cell.
   // --------------------------------------------------------------------------
 
-  // Delete internal object if the input has change (table or array to sort)
-  if (this->Internal && this->Internal->IsInvalid(input, arrayToProcess))
-  {
-    delete this->Internal;
-    this->Internal = 0;
-  }
-
-  // Make sure that an internal object is available
-  this->CreateInternalIfNeeded(input, arrayToProcess);
   int realComponent =
     (!arrayToProcess) ? 0 : this->GetSelectedComponent() % arrayToProcess->GetNumberOfComponents();
+
+  // Look for a retained index matching the requested sort, the cache drops
+  // everything if the input has changed (table or array to sort)
+  std::string column = this->GetColumnToSort() ? this->GetColumnToSort() : "";
+  this->Internal = this->Cache->Find(input, arrayToProcess, column, realComponent, orderInverted);
+
+  // Make sure that an internal object is available
+  if (!this->Internal)
+  {
+    this->CreateInternalIfNeeded(input, arrayToProcess);
+    if (!this->Internal)
+    {
+      return 0;
+    }
+    this->Cache->Add(this->Internal, column, realComponent, orderInverted);
+  }
   this->Internal->SetSelectedComponent(realComponent);
 
   // Manage custom case where sorting occur on a virtual array (process id)
@@ -1519,29 +1869,13 @@ const char* vtkSortedTableStreamer::GetColumnNameToSort()
 //----------------------------------------------------------------------------
 void vtkSortedTableStreamer::SetColumnNameToSort(const char* columnName)
 {
+  // The matching sort index is looked up in the cache on the next execution
   this->SetColumnToSort(columnName);
-  if (strcmp("vtkOriginalProcessIds", this->GetColumnToSort()) != 0)
-  {
-    if (this->Internal)
-    {
-      delete this->Internal;
-      this->Internal = 0;
-    }
-  }
 }
 //----------------------------------------------------------------------------
 void vtkSortedTableStreamer::SetInvertOrder(int newValue)
 {
-  bool changed = this->InvertOrder != newValue;
-  bool removeInternal = changed && strcmp("vtkOriginalProcessIds", this->GetColumnToSort()) != 0;
-
-  if (removeInternal && this->Internal)
-  {
-    delete this->Internal;
-    this->Internal = 0;
-  }
-
-  if (changed)
+  if (this->InvertOrder != newValue)
   {
     this->InvertOrder = newValue;
     this->Modified();
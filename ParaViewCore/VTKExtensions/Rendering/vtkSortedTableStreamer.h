@@ -20,6 +20,12 @@
  * This filter is used quickly get a sorted subset of a given vtkTable.
  * By sorted we mean a subset build from a global sort even if some optimisation
  * allow us to skip a global table sorting.
+ *
+ * The first request for a given column, component and order builds a
+ * distributed sort index (parallel sample sort). The index is kept until the
+ * input changes so that fetching any other block only costs the block size.
+ * A few indices are retained at once so switching between sorted columns
+ * doesn't rebuild them either.
 */
 
 #ifndef vtkSortedTableStreamer_h
@@ -37,7 +43,9 @@ private:
   class InternalsBase;
   template <class T>
   class Internals;
+  class InternalsCache;
   InternalsBase* Internal;
+  InternalsCache* Cache;
 
 public:
   static void PrintInfo(vtkTable* input);
@@ -14,21 +14,146 @@
 =========================================================================*/
 
 #include "vtkVolumeRepresentationPreprocessor.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkDataSetTriangleFilter.h"
 #include "vtkExtractBlock.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+
+namespace
+{
+const char* PointIdsArrayName = "vtkVolumeRepresentationPreprocessorPointIds";
+const char* CellIdsArrayName = "vtkVolumeRepresentationPreprocessorCellIds";
+
+vtkMTimeType GetMTime(vtkObject* object)
+{
+  return object ? object->GetMTime() : 0;
+}
+
+//----------------------------------------------------------------------------
+// What the tetrahedralization of a dataset depends on: its points, cells and
+// ghost cells, but none of its other attributes. The objects are referenced,
+// and compared by identity and modification time.
+struct GeometryKey
+{
+  vtkSmartPointer<vtkObject> Points;
+  vtkSmartPointer<vtkObject> Cells;
+  vtkSmartPointer<vtkObject> CellTypes;
+  vtkSmartPointer<vtkObject> Faces;
+  vtkSmartPointer<vtkObject> Ghosts;
+  vtkMTimeType MTime;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  int Extent[6];
+  double Origin[3];
+  double Spacing[3];
+
+  GeometryKey()
+    : MTime(0)
+    , NumberOfPoints(0)
+    , NumberOfCells(0)
+  {
+    std::fill(this->Extent, this->Extent + 6, 0);
+    std::fill(this->Origin, this->Origin + 3, 0.0);
+    std::fill(this->Spacing, this->Spacing + 3, 0.0);
+  }
+
+  // Returns false for datasets whose geometry cannot be keyed.
+  bool Set(vtkDataSet* ds)
+  {
+    *this = GeometryKey();
+    this->NumberOfPoints = ds->GetNumberOfPoints();
+    this->NumberOfCells = ds->GetNumberOfCells();
+    this->Ghosts = ds->GetCellGhostArray();
+    if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(ds))
+    {
+      vtkCellArray* cells = ug->GetCells();
+      this->Points = ug->GetPoints();
+      this->Cells = cells;
+      this->CellTypes = ug->GetCellTypesArray();
+      this->Faces = ug->GetFaces();
+      this->MTime = std::max(GetMTime(cells ? cells->GetData() : NULL), GetMTime(this->Cells));
+    }
+    else if (vtkImageData* image = vtkImageData::SafeDownCast(ds))
+    {
+      image->GetExtent(this->Extent);
+      image->GetOrigin(this->Origin);
+      image->GetSpacing(this->Spacing);
+    }
+    else
+    {
+      return false;
+    }
+    this->MTime = std::max(this->MTime, GetMTime(this->Points));
+    this->MTime = std::max(this->MTime, GetMTime(this->CellTypes));
+    this->MTime = std::max(this->MTime, GetMTime(this->Faces));
+    this->MTime = std::max(this->MTime, GetMTime(this->Ghosts));
+    return true;
+  }
+
+  bool operator==(const GeometryKey& other) const
+  {
+    return this->Points == other.Points && this->Cells == other.Cells &&
+      this->CellTypes == other.CellTypes && this->Faces == other.Faces &&
+      this->Ghosts == other.Ghosts && this->MTime == other.MTime &&
+      this->NumberOfPoints == other.NumberOfPoints &&
+      this->NumberOfCells == other.NumberOfCells &&
+      std::equal(this->Extent, this->Extent + 6, other.Extent) &&
+      std::equal(this->Origin, this->Origin + 3, other.Origin) &&
+      std::equal(this->Spacing, this->Spacing + 3, other.Spacing);
+  }
+};
+}
+
+//----------------------------------------------------------------------------
+class vtkVolumeRepresentationPreprocessor::vtkInternals
+{
+public:
+  // tetrahedralization of the last input, without attributes, with for each
+  // of its points and cells the input point and cell it comes from.
+  vtkSmartPointer<vtkUnstructuredGrid> Geometry;
+  vtkSmartPointer<vtkIdTypeArray> PointMap;
+  vtkSmartPointer<vtkIdTypeArray> CellMap;
+  bool PointMapIsIdentity;
+  bool HasGhostArray;
+  GeometryKey Key;
+
+  vtkInternals()
+    : PointMapIsIdentity(false)
+    , HasGhostArray(false)
+  {
+  }
+
+  void Clear()
+  {
+    this->Geometry = NULL;
+    this->PointMap = NULL;
+    this->CellMap = NULL;
+    this->Key = GeometryKey();
+  }
+};
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkVolumeRepresentationPreprocessor);
 
 //----------------------------------------------------------------------------
 vtkVolumeRepresentationPreprocessor::vtkVolumeRepresentationPreprocessor()
 {
+  this->Internals = new vtkInternals();
   this->DataSetTriangleFilter = vtkDataSetTriangleFilter::New();
   this->ExtractBlockFilter = vtkExtractBlock::New();
   this->ExtractBlockFilter->SetPruneOutput(1);
@@ -42,6 +167,7 @@ vtkVolumeRepresentationPreprocessor::~vtkVolumeRepresentationPreprocessor()
 {
   this->DataSetTriangleFilter->Delete();
   this->ExtractBlockFilter->Delete();
+  delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
@@ -85,13 +211,119 @@ int vtkVolumeRepresentationPreprocessor::RequestData(vtkInformation* vtkNotUsed(
     }
   }
 
+  this->Tetrahedralize(triangleFilterInput, output);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkVolumeRepresentationPreprocessor::Tetrahedralize(
+  vtkDataSet* input, vtkUnstructuredGrid* output)
+{
+  vtkInternals* internals = this->Internals;
+
+  GeometryKey key;
+  bool cacheable = key.Set(input);
+  if (cacheable && internals->Geometry && key == internals->Key)
+  {
+    // only the attributes changed: map them onto the cached tetrahedra.
+    output->ShallowCopy(internals->Geometry);
+
+    vtkPointData* inPD = input->GetPointData();
+    vtkPointData* outPD = output->GetPointData();
+    if (internals->PointMapIsIdentity)
+    {
+      outPD->PassData(inPD);
+    }
+    else
+    {
+      vtkIdType numPoints = internals->PointMap->GetNumberOfTuples();
+      outPD->CopyAllocate(inPD, numPoints);
+      for (vtkIdType i = 0; i < numPoints; i++)
+      {
+        outPD->CopyData(inPD, internals->PointMap->GetValue(i), i);
+      }
+    }
+
+    vtkCellData* inCD = input->GetCellData();
+    vtkCellData* outCD = output->GetCellData();
+    vtkIdType numCells = internals->CellMap->GetNumberOfTuples();
+    outCD->CopyAllocate(inCD, numCells);
+    for (vtkIdType i = 0; i < numCells; i++)
+    {
+      outCD->CopyData(inCD, internals->CellMap->GetValue(i), i);
+    }
+    if (!internals->HasGhostArray)
+    {
+      outCD->RemoveArray(vtkDataSetAttributes::GhostArrayName());
+    }
+    return;
+  }
+
+  internals->Clear();
+
+  // tag points and cells with their ids to know where the tetrahedra come from.
+  vtkSmartPointer<vtkDataSet> clone;
+  clone.TakeReference(input->NewInstance());
+  clone->ShallowCopy(input);
+  if (cacheable)
+  {
+    vtkNew<vtkIdTypeArray> pointIds;
+    pointIds->SetName(PointIdsArrayName);
+    pointIds->SetNumberOfTuples(input->GetNumberOfPoints());
+    for (vtkIdType i = 0; i < input->GetNumberOfPoints(); i++)
+    {
+      pointIds->SetValue(i, i);
+    }
+    clone->GetPointData()->AddArray(pointIds.GetPointer());
+
+    vtkNew<vtkIdTypeArray> cellIds;
+    cellIds->SetName(CellIdsArrayName);
+    cellIds->SetNumberOfTuples(input->GetNumberOfCells());
+    for (vtkIdType i = 0; i < input->GetNumberOfCells(); i++)
+    {
+      cellIds->SetValue(i, i);
+    }
+    clone->GetCellData()->AddArray(cellIds.GetPointer());
+  }
+
   // push dataset through the triangle filter
-  vtkUnstructuredGrid* triangleFilterOutput = this->TriangulateDataSet(triangleFilterInput);
+  vtkUnstructuredGrid* triangleFilterOutput = this->TriangulateDataSet(clone);
 
   // copy to output
   output->ShallowCopy(triangleFilterOutput);
+
+  // points added by the triangulation have interpolated ids, which cannot be
+  // used to map the attributes.
+  cacheable = cacheable && output->GetNumberOfPoints() == input->GetNumberOfPoints();
+
   output->RemoveGhostCells();
-  return 1;
+
+  vtkIdTypeArray* pointMap =
+    vtkIdTypeArray::SafeDownCast(output->GetPointData()->GetArray(PointIdsArrayName));
+  vtkIdTypeArray* cellMap =
+    vtkIdTypeArray::SafeDownCast(output->GetCellData()->GetArray(CellIdsArrayName));
+  if (cacheable && pointMap && cellMap)
+  {
+    internals->PointMap = pointMap;
+    internals->CellMap = cellMap;
+    internals->PointMapIsIdentity = pointMap->GetNumberOfTuples() == input->GetNumberOfPoints();
+    for (vtkIdType i = 0; internals->PointMapIsIdentity && i < pointMap->GetNumberOfTuples(); i++)
+    {
+      internals->PointMapIsIdentity = pointMap->GetValue(i) == i;
+    }
+    internals->HasGhostArray = output->GetCellGhostArray() != NULL;
+    internals->Key = key;
+  }
+  output->GetPointData()->RemoveArray(PointIdsArrayName);
+  output->GetCellData()->RemoveArray(CellIdsArrayName);
+
+  if (internals->CellMap)
+  {
+    internals->Geometry = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    internals->Geometry->ShallowCopy(output);
+    internals->Geometry->GetPointData()->Initialize();
+    internals->Geometry->GetCellData()->Initialize();
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -151,6 +383,7 @@ void vtkVolumeRepresentationPreprocessor::SetExtractedBlockIndex(int index)
     this->ExtractedBlockIndex = index;
     this->ExtractBlockFilter->RemoveAllIndices();
     this->ExtractBlockFilter->AddIndex(this->ExtractedBlockIndex);
+    this->Internals->Clear();
     this->Modified();
   }
 }
@@ -160,6 +393,7 @@ void vtkVolumeRepresentationPreprocessor::SetTetrahedraOnly(int value)
 {
   this->TetrahedraOnly = value;
   this->DataSetTriangleFilter->SetTetrahedraOnly(this->TetrahedraOnly);
+  this->Internals->Clear();
   this->Modified();
 }
 
@@ -25,6 +25,11 @@
  * property may by set to indicate which unstructured grid to volume render.  The TetrahedraOnly
  * property may be set and it will be passed to the vtkDataSetTriangleFilter.
  *
+ * The tetrahedralization is cached. When the input only differs from the
+ * previous one by its point and cell attributes, i.e. it shares the same
+ * points, cells and ghost cells, the cached tetrahedra are reused and only
+ * the attributes are mapped onto them.
+ *
  * @sa
  * vtkExtractBlock vtkTriangleFilter
 */
@@ -72,6 +77,12 @@ protected:
   vtkUnstructuredGrid* TriangulateDataSet(vtkDataSet*);
   vtkDataSet* MultiBlockToDataSet(vtkMultiBlockDataSet*);
 
+  /**
+   * Triangulates input into output, or reuses the cached tetrahedralization
+   * if the geometry and topology of input did not change.
+   */
+  void Tetrahedralize(vtkDataSet* input, vtkUnstructuredGrid* output);
+
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) VTK_OVERRIDE;
   int FillInputPortInformation(int port, vtkInformation* info) VTK_OVERRIDE;
 
@@ -84,6 +95,9 @@ protected:
 private:
   vtkVolumeRepresentationPreprocessor(const vtkVolumeRepresentationPreprocessor&) = delete;
   void operator=(const vtkVolumeRepresentationPreprocessor&) = delete;
+
+  class vtkInternals;
+  vtkInternals* Internals;
 };
 
 #endif
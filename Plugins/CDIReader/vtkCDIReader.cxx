@@ -42,6 +42,7 @@
 #include "vtkCellType.h"
 #include "vtkDataArraySelection.h"
 #include "vtkDataObject.h"
+#include "vtkDataSetAttributes.h"
 #include "vtkDoubleArray.h"
 #include "vtkErrorCode.h"
 #include "vtkInformation.h"
@@ -56,6 +57,7 @@
 #include "vtkStringArray.h"
 #include "vtkTableExtentTranslator.h"
 #include "vtkToolkits.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtk_netcdfcpp.h"
 
@@ -68,6 +70,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -100,6 +103,13 @@ public:
   cdiVar_t cellVars[MAX_VARS];
   cdiVar_t pointVars[MAX_VARS];
   string domainVars[MAX_VARS];
+
+  // cells of the output piece (owned ones first, then ghosts), the points
+  // they use and their connectivity in terms of those points.
+  std::vector<int> PieceCells;
+  int NumberOfOwnedCells;
+  std::vector<int> PiecePoints;
+  std::vector<int> PieceConnections;
 };
 
 //----------------------------------------------------------------------------
@@ -346,11 +356,6 @@ void vtkCDIReader::DestroyData()
 
   if (this->reconstruct_new)
   {
-    if (this->PointVarData)
-    {
-      delete[] this->PointVarData;
-      this->PointVarData = NULL;
-    }
     if (this->CellMap)
     {
       free(this->CellMap);
@@ -531,6 +536,7 @@ int vtkCDIReader::RequestInformation(
     outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), tRange, 2);
   }
 
+  outInfo->Set(CAN_HANDLE_PIECE_REQUEST(), 1);
   return 1;
 }
 
@@ -548,6 +554,19 @@ int vtkCDIReader::RequestData(vtkInformation* vtkNotUsed(reqInfo),
   if (this->DataRequested)
     this->DestroyData();
 
+  this->Piece = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+  this->NumberOfPieces =
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+  this->GhostLevels =
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS());
+  if (this->NumberOfPieces < 1 || this->Piece < 0 || this->Piece >= this->NumberOfPieces)
+  {
+    this->Piece = 0;
+    this->NumberOfPieces = 1;
+  }
+  vtkDebugMacro(<< "Piece " << this->Piece << " of " << this->NumberOfPieces << " with "
+                << this->GhostLevels << " ghost levels" << endl);
+
   if (!this->ReadAndOutputGrid(true))
     return 0;
 
@@ -683,6 +702,9 @@ void vtkCDIReader::SetDefaults()
   this->ProjectCassini = false;
   this->ShowMultilayerView = false;
   this->reconstruct_new = false;
+  this->Piece = 0;
+  this->NumberOfPieces = 1;
+  this->GhostLevels = 0;
   this->CellDataSelected = 0;
   this->PointDataSelected = 0;
   this->gotMask = false;
@@ -708,7 +730,6 @@ void vtkCDIReader::SetDefaults()
   this->CellVarDataArray = NULL;
   this->PointVarDataArray = NULL;
   this->DomainVarDataArray = NULL;
-  this->PointVarData = NULL;
   this->TimeSteps = NULL;
   this->buildDomainArrays = false;
 
@@ -1023,15 +1044,12 @@ int vtkCDIReader::ReadAndOutputGrid(bool init)
       return 0;
   }
 
+  if (!BuildPiece())
+    return 0;
+
+  CheckForMaskData();
   OutputPoints(init);
   OutputCells(init);
-
-  // Allocate the data arrays which will hold the NetCDF var data
-  vtkDebugMacro(<< "pointVarData: Alloc " << this->MaximumPoints << " doubles" << endl);
-  if (this->PointVarData)
-    delete[] this->PointVarData;
-
-  this->PointVarData = new double[this->MaximumPoints];
   vtkDebugMacro(<< "Leaving vtkCDIReader::ReadAndOutputGrid" << endl);
 
   return (1);
@@ -1222,11 +1240,116 @@ int vtkCDIReader::ConstructGridGeometry()
   grid_reconstructed = true;
   reconstruct_new = false;
   free(vertexID);
+  free(new_cells);
+
+  // the per cell vertex bounds are not needed once points are built
+  free(this->clon_vertices);
+  free(this->clat_vertices);
+  this->clon_vertices = NULL;
+  this->clat_vertices = NULL;
 
   vtkDebugMacro(<< "Grid Reconstruction complete..." << endl);
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Select the cells of the requested piece: a contiguous range of the cells,
+// plus on request layers of ghost cells sharing a point with them. Only the
+// points used by these cells are output, numbered in their original order.
+//----------------------------------------------------------------------------
+int vtkCDIReader::BuildPiece()
+{
+  const int numCells = this->CurrentExtraCell;
+  const int numPoints = this->CurrentExtraPoint;
+  const int* connections =
+    (this->ProjectLatLon || this->ProjectCassini) ? this->ModConnections : this->OrigConnections;
+
+  std::vector<int>& cells = this->Internals->PieceCells;
+  const int begin =
+    static_cast<int>(static_cast<long long>(numCells) * this->Piece / this->NumberOfPieces);
+  const int end =
+    static_cast<int>(static_cast<long long>(numCells) * (this->Piece + 1) / this->NumberOfPieces);
+  cells.clear();
+  for (int j = begin; j < end; j++)
+    cells.push_back(j);
+  this->Internals->NumberOfOwnedCells = end - begin;
+
+  // ghost cells, one layer of point neighbors at a time. Cells collapsed to
+  // a single point (wrapping cells of the projections) are left out.
+  if (this->GhostLevels > 0 && this->NumberOfPieces > 1)
+  {
+    std::vector<bool> cellUsed(numCells, false);
+    std::vector<bool> pointUsed(numPoints, false);
+    std::fill(cellUsed.begin() + begin, cellUsed.begin() + end, true);
+
+    size_t layerStart = 0;
+    for (int level = 0; level < this->GhostLevels; level++)
+    {
+      const size_t layerEnd = cells.size();
+      for (size_t c = layerStart; c < layerEnd; c++)
+        for (int k = 0; k < this->PointsPerCell; k++)
+          pointUsed[connections[cells[c] * this->PointsPerCell + k]] = true;
+
+      for (int j = 0; j < numCells; j++)
+      {
+        const int* conns = connections + (j * this->PointsPerCell);
+        if (cellUsed[j] || conns[0] == conns[this->PointsPerCell - 1])
+          continue;
+
+        for (int k = 0; k < this->PointsPerCell; k++)
+          if (pointUsed[conns[k]])
+          {
+            cellUsed[j] = true;
+            cells.push_back(j);
+            break;
+          }
+      }
+      layerStart = layerEnd;
+    }
+  }
+
+  // renumber the points used by the piece
+  std::vector<int> pointIds(numPoints, -1);
+  for (size_t c = 0; c < cells.size(); c++)
+    for (int k = 0; k < this->PointsPerCell; k++)
+      pointIds[connections[cells[c] * this->PointsPerCell + k]] = 0;
+
+  std::vector<int>& points = this->Internals->PiecePoints;
+  points.clear();
+  for (int j = 0; j < numPoints; j++)
+    if (pointIds[j] != -1)
+    {
+      pointIds[j] = static_cast<int>(points.size());
+      points.push_back(j);
+    }
+
+  std::vector<int>& pieceConns = this->Internals->PieceConnections;
+  pieceConns.resize(cells.size() * this->PointsPerCell);
+  for (size_t c = 0; c < cells.size(); c++)
+    for (int k = 0; k < this->PointsPerCell; k++)
+      pieceConns[c * this->PointsPerCell + k] =
+        pointIds[connections[cells[c] * this->PointsPerCell + k]];
+
+  vtkDebugMacro(<< "Piece has " << this->Internals->NumberOfOwnedCells << " cells, "
+                << (cells.size() - this->Internals->NumberOfOwnedCells) << " ghost cells and "
+                << points.size() << " points" << endl);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Map cells and points added when eliminating wraps to the ones they were
+// copied from, i.e. to their index in the variables read from the file.
+//----------------------------------------------------------------------------
+int vtkCDIReader::GetOriginalCell(int cell) const
+{
+  return cell < this->NumberOfCells ? cell : this->CellMap[cell - this->NumberOfCells];
+}
+
+int vtkCDIReader::GetOriginalPoint(int point) const
+{
+  return point < this->NumberOfPoints ? point : this->PointMap[point - this->NumberOfPoints];
+}
+
 //----------------------------------------------------------------------------
 // Allocate into sphere view of geometry
 //----------------------------------------------------------------------------
@@ -1254,7 +1377,6 @@ int vtkCDIReader::AllocSphereGeometry()
     vtkDebugMacro(<< "alloc sphere: singlelayer: setting MaximumPoints to " << this->MaximumPoints);
   }
 
-  CheckForMaskData();
   vtkDebugMacro(<< "Leaving AllocSphereGeometry...");
   return 1;
 }
@@ -1297,7 +1419,6 @@ int vtkCDIReader::AllocLatLonGeometry()
                   << this->MaximumPoints << endl);
   }
 
-  CheckForMaskData();
   vtkDebugMacro(<< "Leaving AllocLatLonGeometry..." << endl);
   return 1;
 }
@@ -1321,41 +1442,30 @@ int vtkCDIReader::CheckForMaskData()
 
   if (this->gotMask)
   {
+    // read one level at a time, only keeping the values of the piece's cells
     cdiVar_t* cdiVar = &(this->Internals->cellVars[mask_pos]);
-    if (ShowMultilayerView)
-    {
-      this->CellMask = (int*)malloc(this->MaximumCells * sizeof(int));
-      double* dataTmpMask = (double*)malloc(this->MaximumCells * sizeof(double));
-      CHECK_MALLOC(this->CellMask);
-      CHECK_MALLOC(dataTmpMask);
-
-      cdi_set_cur(cdiVar, 0, 0);
-      cdi_get(cdiVar, dataTmpMask, this->MaximumNVertLevels);
-      // readjust the data
-      for (int j = 0; j < this->NumberOfCells; j++)
-        for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-        {
-          int i = j * this->MaximumNVertLevels;
-          this->CellMask[i + levelNum] = (int)(dataTmpMask[j + (levelNum * this->NumberOfCells)]);
-        }
-      free(dataTmpMask);
-      vtkDebugMacro(<< "Got data for land/sea mask (3D)" << endl);
-    }
-    else
-    {
-      this->CellMask = (int*)malloc(this->NumberOfCells * sizeof(int));
-      CHECK_MALLOC(this->CellMask);
-      double* dataTmpMask = (double*)malloc(this->MaximumCells * sizeof(double));
+    const std::vector<int>& cells = this->Internals->PieceCells;
+    const int numPieceCells = static_cast<int>(cells.size());
+    const int levels = ShowMultilayerView ? this->MaximumNVertLevels : 1;
 
-      cdi_set_cur(cdiVar, 0, this->VerticalLevelSelected);
-      cdi_get(cdiVar, dataTmpMask, 1);
-      // readjust the data
-      for (int j = 0; j < this->NumberOfCells; j++)
-        this->CellMask[j] = (int)(dataTmpMask[j]);
+    this->CellMask = (int*)malloc(numPieceCells * levels * sizeof(int));
+    double* dataTmpMask =
+      (double*)malloc(std::max(cdiVar->gridsize, this->NumberOfCells) * sizeof(double));
+    CHECK_MALLOC(this->CellMask);
+    CHECK_MALLOC(dataTmpMask);
 
-      free(dataTmpMask);
-      vtkDebugMacro(<< "Got data for land/sea mask (2D)" << endl);
+    for (int levelNum = 0; levelNum < levels; levelNum++)
+    {
+      int level = 0;
+      if (cdiVar->nlevel > 1)
+        level = ShowMultilayerView ? levelNum : this->VerticalLevelSelected;
+      cdi_set_cur(cdiVar, 0, level);
+      cdi_get(cdiVar, dataTmpMask, 1);
+      for (int i = 0; i < numPieceCells; i++)
+        this->CellMask[i * levels + levelNum] = (int)(dataTmpMask[GetOriginalCell(cells[i])]);
     }
+    free(dataTmpMask);
+    vtkDebugMacro(<< "Got data for land/sea mask" << endl);
     this->gotMask = true;
   }
   return 1;
@@ -1368,11 +1478,10 @@ int vtkCDIReader::CheckForMaskData()
 //----------------------------------------------------------------------------
 bool vtkCDIReader::BuildDomainCellVars()
 {
-  this->DomainCellVar =
-    (double*)malloc(this->NumberOfCells * this->NumberOfDomainVars * sizeof(double));
   vtkUnstructuredGrid* output = GetOutput();
+  const std::vector<int>& cells = this->Internals->PieceCells;
+  const int numPieceCells = static_cast<int>(cells.size());
   double* domainTMP = (double*)malloc(this->NumberOfCells * sizeof(double));
-  CHECK_MALLOC(this->DomainCellVar);
   CHECK_MALLOC(domainTMP);
   double val = 0;
 
@@ -1389,15 +1498,15 @@ bool vtkCDIReader::BuildDomainCellVars()
   for (int j = 0; j < (this->NumberOfDomainVars); j++)
   {
     vtkDoubleArray* domainVar = vtkDoubleArray::New();
-    for (int k = 0; k < this->NumberOfCells; k++)
+    domainVar->SetNumberOfTuples(numPieceCells);
+    for (int k = 0; k < numPieceCells; k++)
     {
-      val = this->DomainVarDataArray[j]->GetComponent(domainTMP[k], 0l);
-      this->DomainCellVar[k + (j * this->NumberOfCells)] = val;
+      val = this->DomainVarDataArray[j]->GetComponent(domainTMP[GetOriginalCell(cells[k])], 0l);
+      domainVar->SetValue(k, val);
     }
-    domainVar->SetArray(this->DomainCellVar + (j * this->NumberOfCells), this->CurrentExtraCell, 0,
-      vtkDoubleArray::VTK_DATA_ARRAY_FREE);
     domainVar->SetName(this->Internals->domainVars[j].c_str());
     output->GetCellData()->AddArray(domainVar);
+    domainVar->Delete();
   }
 
   free(domainTMP);
@@ -1546,21 +1655,26 @@ void vtkCDIReader::OutputPoints(bool init)
                 << " this->MaximumNVertLevels: " << this->MaximumNVertLevels
                 << " LayerThickness: " << LayerThickness << "ProjectLatLon: " << ProjectLatLon
                 << " ShowMultilayerView: " << ShowMultilayerView << endl);
+  const std::vector<int>& piecePoints = this->Internals->PiecePoints;
+  const int numPiecePoints = static_cast<int>(piecePoints.size());
+  const int numPoints =
+    ShowMultilayerView ? numPiecePoints * (this->MaximumNVertLevels + 1) : numPiecePoints;
   if (init)
   {
     points = vtkSmartPointer<vtkPoints>::New();
-    points->Allocate(this->MaximumPoints, this->MaximumPoints);
+    points->Allocate(numPoints, numPoints);
     output->SetPoints(points);
   }
   else
   {
     points = output->GetPoints();
     points->Initialize();
-    points->Allocate(this->MaximumPoints, this->MaximumPoints);
+    points->Allocate(numPoints, numPoints);
   }
 
-  for (int j = 0; j < this->CurrentExtraPoint; j++)
+  for (int i = 0; i < numPiecePoints; i++)
   {
+    const int j = piecePoints[i];
     double x, y, z;
     if (ProjectLatLon)
     {
@@ -1671,14 +1785,17 @@ void vtkCDIReader::OutputCells(bool init)
 {
   vtkDebugMacro(<< "In OutputCells..." << endl);
   vtkUnstructuredGrid* output = GetOutput();
+  const int numPieceCells = static_cast<int>(this->Internals->PieceCells.size());
+  const int levels = this->ShowMultilayerView ? this->MaximumNVertLevels : 1;
+  const int numCells = numPieceCells * levels;
 
   if (init)
-    output->Allocate(this->MaximumCells, this->MaximumCells);
+    output->Allocate(numCells, numCells);
   else
   {
     vtkCellArray* cells = output->GetCells();
     cells->Initialize();
-    output->Allocate(this->MaximumCells, this->MaximumCells);
+    output->Allocate(numCells, numCells);
   }
 
   int cellType = GetCellType();
@@ -1697,13 +1814,10 @@ void vtkCDIReader::OutputCells(bool init)
                 << " ShowMultilayerView: " << this->ShowMultilayerView);
 
   std::vector<vtkIdType> polygon(pointsPerPolygon);
-  for (int j = 0; j < this->CurrentExtraCell; j++)
+  for (int j = 0; j < numPieceCells; j++)
   {
-    int* conns;
-    if (this->ProjectLatLon || this->ProjectCassini)
-      conns = this->ModConnections + (j * this->PointsPerCell);
-    else
-      conns = this->OrigConnections + (j * this->PointsPerCell);
+    // connectivity is already expressed in the piece's point numbering
+    const int* conns = &this->Internals->PieceConnections[j * this->PointsPerCell];
 
     // singlelayer
     if (!this->ShowMultilayerView)
@@ -1757,9 +1871,28 @@ void vtkCDIReader::OutputCells(bool init)
   if (this->gotMask)
   {
     vtkIntArray* mask = vtkIntArray::New();
-    mask->SetArray(this->CellMask, this->CurrentExtraCell, 0, vtkIntArray::VTK_DATA_ARRAY_FREE);
+    mask->SetArray(this->CellMask, numCells, 0, vtkIntArray::VTK_DATA_ARRAY_FREE);
     mask->SetName("Land/Sea Mask (wet_c)");
     output->GetCellData()->AddArray(mask);
+    mask->Delete();
+    this->CellMask = NULL;
+  }
+
+  // flag the cells that were only added as ghost layers around the owned range
+  const int numOwnedCells = this->Internals->NumberOfOwnedCells;
+  if (numOwnedCells < numPieceCells)
+  {
+    vtkUnsignedCharArray* ghosts = vtkUnsignedCharArray::New();
+    ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+    ghosts->SetNumberOfTuples(numCells);
+    for (int j = 0; j < numPieceCells; j++)
+    {
+      unsigned char flag = (j < numOwnedCells) ? 0 : vtkDataSetAttributes::DUPLICATECELL;
+      for (int levelNum = 0; levelNum < levels; levelNum++)
+        ghosts->SetValue(j * levels + levelNum, flag);
+    }
+    output->GetCellData()->AddArray(ghosts);
+    ghosts->Delete();
   }
 
   if (this->reconstruct_new)
@@ -1781,6 +1914,11 @@ int vtkCDIReader::LoadPointVarData(int variableIndex, double dTimeStep)
   vtkDebugMacro(<< "In vtkICONReader::LoadPointVarData" << endl);
   cdiVar_t* cdiVar = &(this->Internals->pointVars[variableIndex]);
   int varType = cdiVar->type;
+  const std::vector<int>& points = this->Internals->PiecePoints;
+  const int numPiecePoints = static_cast<int>(points.size());
+  const int levels = ShowMultilayerView ? this->MaximumNVertLevels : 1;
+  // in the multilayer view, every point has a dummy level on top
+  const int stride = ShowMultilayerView ? this->MaximumNVertLevels + 1 : 1;
 
   // Allocate data array for this variable
   if (this->PointVarDataArray[variableIndex] == NULL)
@@ -1788,103 +1926,46 @@ int vtkCDIReader::LoadPointVarData(int variableIndex, double dTimeStep)
     vtkDebugMacro(<< "allocating data array in vtkICONReader::LoadPointVarData" << endl);
     this->PointVarDataArray[variableIndex] = vtkDoubleArray::New();
     this->PointVarDataArray[variableIndex]->SetName(this->Internals->pointVars[variableIndex].name);
-    this->PointVarDataArray[variableIndex]->SetNumberOfTuples(this->MaximumPoints);
     this->PointVarDataArray[variableIndex]->SetNumberOfComponents(1);
   }
+  this->PointVarDataArray[variableIndex]->SetNumberOfTuples(numPiecePoints * stride);
 
   vtkDebugMacro(<< "getting pointer in vtkICONReader::LoadPointVarData" << endl);
   double* dataBlock = this->PointVarDataArray[variableIndex]->GetPointer(0);
-  double* dataTmp = (double*)malloc(this->MaximumPoints * sizeof(double));
+  double* dataTmp =
+    (double*)malloc(std::max(cdiVar->gridsize, this->NumberOfPoints) * sizeof(double));
+  CHECK_MALLOC(dataTmp);
   vtkDebugMacro(<< "dTimeStep requested: " << dTimeStep << endl);
   int timestep = min((int)floor(dTimeStep), (int)(this->NumberOfTimeSteps - 1));
   vtkDebugMacro(<< "Time: " << timestep << endl);
 
-  // 3D arrays ...
+  // The whole grid has to be read, as CDI cannot read parts of a level.
+  // Read one level at a time and only keep the values of the piece.
   vtkDebugMacro(<< "Dimensions: " << varType << endl);
-  if (varType == 3)
+  for (int levelNum = 0; levelNum < levels; levelNum++)
   {
-    // singlelayer
-    if (!ShowMultilayerView)
+    // 2D arrays have the same values on all levels
+    if (levelNum == 0 || varType == 3)
     {
-      cdi_set_cur(cdiVar, timestep, this->VerticalLevelSelected);
-      cdi_get(cdiVar, dataBlock, 1);
-      dataBlock[0] = dataBlock[1];
-    }
-    else
-    { // multilayer
-      cdi_set_cur(cdiVar, timestep, 0);
-      cdi_get(cdiVar, dataTmp, this->MaximumNVertLevels);
-      dataTmp[0] = dataTmp[1];
-    }
-  }
-  // 2D arrays ...
-  else if (varType == 2)
-  {
-    if (!ShowMultilayerView)
-    {
-      cdi_set_cur(cdiVar, timestep, 0);
-      cdi_get(cdiVar, dataBlock, 1);
-      dataBlock[0] = dataBlock[1];
-    }
-    else
-    {
-      cdi_set_cur(cdiVar, timestep, 0);
-      cdi_get(cdiVar, dataTmp, this->MaximumNVertLevels);
-      dataTmp[0] = dataTmp[1];
+      int level = 0;
+      if (varType == 3)
+        level = ShowMultilayerView ? levelNum : this->VerticalLevelSelected;
+      cdi_set_cur(cdiVar, timestep, level);
+      cdi_get(cdiVar, dataTmp, 1);
+      if (levelNum == 0)
+        dataTmp[0] = dataTmp[1];
     }
+    for (int i = 0; i < numPiecePoints; i++)
+      dataBlock[i * stride + levelNum] = dataTmp[GetOriginalPoint(points[i])];
   }
   vtkDebugMacro(<< "got point data in vtkICONReader::LoadPointVarData" << endl);
 
-  int i = 0, k = 0;
+  // write highest level dummy points (duplicate of last level)
   if (ShowMultilayerView)
-  {
-    // put in some dummy points
-    for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-      dataBlock[levelNum] = dataTmp[this->MaximumNVertLevels + levelNum];
-
-    // write highest level dummy point (duplicate of last level)
-    dataBlock[this->MaximumNVertLevels] =
-      dataTmp[this->MaximumNVertLevels + this->MaximumNVertLevels - 1];
-    vtkDebugMacro(<< "Wrote dummy vtkICONReader::LoadPointVarData" << endl);
-
-    // readjust the data
-    for (int j = 0; j < this->NumberOfPoints; j++)
-    {
-      i = j * (this->MaximumNVertLevels + 1);
-      k = j * (this->MaximumNVertLevels);
-      // write data for one point -- lowest level to highest
-      for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-        dataBlock[i++] = dataTmp[j + (levelNum * this->NumberOfPoints)];
-
-      // layer below, which is repeated ...
-      dataBlock[i++] = dataTmp[j + ((MaximumNVertLevels - 1) * this->NumberOfPoints)];
-    }
-  }
-  vtkDebugMacro(<< "Wrote next pts vtkICONReader::LoadPointVarData" << endl);
-  vtkDebugMacro(<< "this->NumberOfPoints: " << this->NumberOfPoints
-                << " this->CurrentExtraPoint: " << this->CurrentExtraPoint << endl);
-
-  // put out data for extra points
-  for (int j = this->NumberOfPoints; j < this->CurrentExtraPoint; j++)
-  {
-    // use map to find out what point data we are using
-    if (!ShowMultilayerView)
-    {
-      k = this->PointMap[j - this->NumberOfPoints];
-      dataBlock[j] = dataBlock[k];
-    }
-    else
-    {
-      k = this->PointMap[j - this->NumberOfPoints] * this->MaximumNVertLevels;
-      // write data for one point -- lowest level to highest
-      for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-        dataBlock[i++] = dataTmp[k++];
+    for (int i = 0; i < numPiecePoints; i++)
+      dataBlock[i * stride + levels] = dataBlock[i * stride + levels - 1];
 
-      // for last layer of points, repeat last level's values
-      dataBlock[i++] = dataTmp[--k];
-    }
-  }
-  vtkDebugMacro(<< "wrote extra point data in vtkICONReader::LoadPointVarData" << endl);
+  vtkDebugMacro(<< "wrote point data in vtkICONReader::LoadPointVarData" << endl);
   free(dataTmp);
 
   return 1;
@@ -1899,6 +1980,9 @@ int vtkCDIReader::LoadCellVarData(int variableIndex, double dTimeStep)
   cdiVar_t* cdiVar = &(this->Internals->cellVars[variableIndex]);
   this->CellDataSelected = variableIndex;
   int varType = cdiVar->type;
+  const std::vector<int>& cells = this->Internals->PieceCells;
+  const int numPieceCells = static_cast<int>(cells.size());
+  const int levels = ShowMultilayerView ? this->MaximumNVertLevels : 1;
 
   // Allocate data array for this variable
   if (this->CellVarDataArray[variableIndex] == NULL)
@@ -1907,107 +1991,35 @@ int vtkCDIReader::LoadCellVarData(int variableIndex, double dTimeStep)
     vtkDebugMacro(<< "Allocated cell var index: " << this->Internals->cellVars[variableIndex].name
                   << endl);
     this->CellVarDataArray[variableIndex]->SetName(this->Internals->cellVars[variableIndex].name);
-    this->CellVarDataArray[variableIndex]->SetNumberOfTuples(this->MaximumCells);
     this->CellVarDataArray[variableIndex]->SetNumberOfComponents(1);
   }
+  this->CellVarDataArray[variableIndex]->SetNumberOfTuples(numPieceCells * levels);
 
   vtkDebugMacro(<< "getting pointer in vtkCDIReader::LoadCellVarData" << endl);
   double* dataBlock = this->CellVarDataArray[variableIndex]->GetPointer(0);
-  double* dataTmp = (double*)malloc(this->MaximumCells * sizeof(double));
+  double* dataTmp =
+    (double*)malloc(std::max(cdiVar->gridsize, this->NumberOfCells) * sizeof(double));
+  CHECK_MALLOC(dataTmp);
   vtkDebugMacro(<< "dTimeStep requested: " << dTimeStep << endl);
   int timestep = min((int)floor(dTimeStep), (int)(this->NumberOfTimeSteps - 1));
   vtkDebugMacro(<< "Time: " << timestep << endl);
 
-  // 3D arrays ...
+  // The whole grid has to be read, as CDI cannot read parts of a level.
+  // Read one level at a time and only keep the values of the piece.
   vtkDebugMacro(<< "Dimensions: " << varType << endl);
-  if (varType == 3)
+  for (int levelNum = 0; levelNum < levels; levelNum++)
   {
-    if (!ShowMultilayerView)
+    // 2D arrays have the same values on all levels
+    if (levelNum == 0 || varType == 3)
     {
-      cdi_set_cur(cdiVar, timestep, this->VerticalLevelSelected);
-      cdi_get(cdiVar, dataBlock, 1);
-    }
-    else
-    {
-      cdi_set_cur(cdiVar, timestep, 0);
-      cdi_get(cdiVar, dataTmp, this->MaximumNVertLevels);
-
-      // readjust the data
-      for (int j = 0; j < this->NumberOfCells; j++)
-        for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-        {
-          int i = j * this->MaximumNVertLevels;
-          dataBlock[i + levelNum] = dataTmp[j + (levelNum * this->NumberOfCells)];
-        }
-    }
-    vtkDebugMacro(<< "Got data for cell var: " << this->Internals->cellVars[variableIndex].name
-                  << endl);
-
-    // put out data for extra cells
-    for (int j = this->NumberOfCells; j < this->CurrentExtraCell; j++)
-    {
-      // use map to find out what cell data we are using
-      if (!ShowMultilayerView)
-      {
-        int k = this->CellMap[j - this->NumberOfCells];
-        dataBlock[j] = dataBlock[k];
-      }
-      else
-      {
-        int i = j * this->MaximumNVertLevels;
-        for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-          dataBlock[i + levelNum] = dataTmp[j + (levelNum * this->NumberOfCells)];
-      }
-    }
-  }
-  // 2D arrays ...
-  else
-  {
-    if (!ShowMultilayerView)
-    {
-      cdi_set_cur(cdiVar, timestep, 0);
-      if (varType == 2)
-        cdi_get(cdiVar, dataBlock, 1);
-      else
-        cdi_get(cdiVar, dataBlock, 1);
-    }
-    else
-    {
-      cdi_set_cur(cdiVar, timestep, 0);
-      if (varType == 2)
-        cdi_get(cdiVar, dataTmp, 1);
-      else
-        cdi_get(cdiVar, dataTmp, 1);
-
-      for (int j = 0; j < +this->NumberOfCells; j++)
-        for (int levelNum = 0; levelNum < this->MaximumNVertLevels; levelNum++)
-        {
-          int i = j * this->MaximumNVertLevels;
-          dataBlock[i + levelNum] = dataTmp[j];
-        }
-    }
-    vtkDebugMacro(<< "Got data for cell var: " << this->Internals->cellVars[variableIndex].name
-                  << endl);
-
-    // put out data for extra cells
-    if (!ShowMultilayerView)
-    {
-      for (int j = this->NumberOfCells; j < this->CurrentExtraCell; j++)
-      {
-        // use map to find out what cell data we are using
-        int k = this->CellMap[j - this->NumberOfCells];
-        dataBlock[j] = dataBlock[k];
-      }
-    }
-    else
-    {
-      for (int j = this->NumberOfCells; j < this->CurrentExtraCell; j++)
-      {
-        // use map to find out what cell data we are using
-        int k = this->CellMap[j - this->NumberOfCells];
-        dataBlock[j] = dataTmp[k];
-      }
-    }
+      int level = 0;
+      if (varType == 3)
+        level = ShowMultilayerView ? levelNum : this->VerticalLevelSelected;
+      cdi_set_cur(cdiVar, timestep, level);
+      cdi_get(cdiVar, dataTmp, 1);
+    }
+    for (int i = 0; i < numPieceCells; i++)
+      dataBlock[i * levels + levelNum] = dataTmp[GetOriginalCell(cells[i])];
   }
   vtkDebugMacro(<< "Stored data for cell var: " << this->Internals->cellVars[variableIndex].name
                 << endl);
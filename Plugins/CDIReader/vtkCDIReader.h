@@ -211,6 +211,9 @@ protected:
   int LoadDomainVarData(int variable);
   int RegenerateGeometry();
   int ConstructGridGeometry();
+  int BuildPiece();
+  int GetOriginalCell(int cell) const;
+  int GetOriginalPoint(int point) const;
   int MirrorMesh();
   bool BuildDomainCellVars();
   void Remove_Duplicates(
@@ -277,6 +280,11 @@ protected:
   int CurrentExtraCell;  // current extra  cell
   bool reconstruct_new;
 
+  // piece requested by the pipeline, see BuildPiece
+  int Piece;
+  int NumberOfPieces;
+  int GhostLevels;
+
   double* clon_vertices;
   double* clat_vertices;
   double* depth_var;
@@ -290,7 +298,6 @@ protected:
   int* CellMap;         // maps from added cell to original cell #
   int* CellMask;
   int* DomainMask;        // in which line is which domain variable
-  double* DomainCellVar;  // in which line is which domain variable
   int* PointMap;          // maps from added point to original point #
   int* MaximumLevelPoint; //
   int MaximumCells;       // max cells
@@ -300,7 +307,6 @@ protected:
   int NumberOfCellVars;
   int NumberOfPointVars;
   int NumberOfDomainVars;
-  double* PointVarData;
   bool grid_reconstructed;
 
   // cdi vars
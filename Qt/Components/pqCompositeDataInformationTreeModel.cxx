@@ -740,6 +740,12 @@ bool pqCompositeDataInformationTreeModel::reset(vtkPVDataInformation* info)
 {
   pqInternals& internals = (*this->Internals);
 
+  // the whole tree is built, gather its summarized nodes in one go.
+  if (info)
+  {
+    info->GetCompositeDataInformation()->ExpandSubtree();
+  }
+
   this->beginResetModel();
   bool retVal = internals.build(info, this->ExpandMultiPiece);
   internals.clearCheckState(this);
@@ -33,13 +33,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "pqFileDialogModel.h"
 
 #include <algorithm>
+#include <iterator>
 
 #include <QApplication>
 #include <QDateTime>
 #include <QDir>
+#include <QHash>
 #include <QLocale>
 #include <QMessageBox>
 #include <QStyle>
+#include <QTimer>
 
 #include <pqApplicationCore.h>
 #include <pqServer.h>
@@ -47,6 +50,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vtkCollection.h>
 #include <vtkCollectionIterator.h>
 #include <vtkDirectory.h>
+#include <vtkNew.h>
 #include <vtkPVFileInformation.h>
 #include <vtkPVFileInformationHelper.h>
 #include <vtkSMDirectoryProxy.h>
@@ -314,8 +318,13 @@ class pqFileDialogModel::pqImplementation
 public:
   pqImplementation(pqServer* server)
     : Separator(0)
+    , NumberOfDirectories(0)
+    , NextPageOffset(0)
+    , TotalNumberOfEntries(0)
     , Server(server)
   {
+    this->PageTimer.setSingleShot(true);
+    this->PageTimer.setInterval(0);
 
     // if we are doing remote browsing
     if (server)
@@ -367,22 +376,28 @@ public:
   }
 
   /// query the file system for information
-  vtkPVFileInformation* GetData(
-    bool dirListing, const QString& workingDir, const QString& path, bool specialDirs)
+  vtkPVFileInformation* GetData(bool dirListing, const QString& workingDir, const QString& path,
+    bool specialDirs, int pageOffset = 0, int pageSize = 0)
   {
     if (this->FileInformationHelperProxy)
     {
-      // send data to server
+      // send the query along with the request, so that the server can answer
+      // it while it updates a pipeline.
       vtkSMProxy* helper = this->FileInformationHelperProxy;
-      pqSMAdaptor::setElementProperty(helper->GetProperty("WorkingDirectory"), workingDir.toUtf8());
-      pqSMAdaptor::setElementProperty(helper->GetProperty("DirectoryListing"), dirListing);
-      pqSMAdaptor::setElementProperty(helper->GetProperty("Path"), path.toUtf8());
-      pqSMAdaptor::setElementProperty(helper->GetProperty("SpecialDirectories"), specialDirs);
-      helper->UpdateVTKObjects();
+      vtkNew<vtkPVFileInformationHelper> query;
+      query->SetDirectoryListing(dirListing);
+      query->SetPath(path.toUtf8().data());
+      query->SetSpecialDirectories(specialDirs);
+      query->SetWorkingDirectory(workingDir.toUtf8().data());
+      query->SetReadDetailedFileInformation(
+        vtkSMPropertyHelper(helper, "ReadDetailedFileInformation").GetAsInt() != 0);
+      query->SetPageOffset(pageOffset);
+      query->SetPageSize(pageSize);
 
       // get data from server
       this->FileInformation->Initialize();
-      this->FileInformationHelperProxy->GatherInformation(this->FileInformation);
+      this->FileInformation->SetQuery(query.Get());
+      helper->GatherInformation(this->FileInformation);
     }
     else
     {
@@ -391,17 +406,47 @@ public:
       helper->SetPath(path.toUtf8().data());
       helper->SetSpecialDirectories(specialDirs);
       helper->SetWorkingDirectory(workingDir.toUtf8().data());
+      helper->SetPageOffset(pageOffset);
+      helper->SetPageSize(pageSize);
       this->FileInformation->CopyFromObject(helper);
     }
     return this->FileInformation;
   }
 
-  /// put queried information into our model
+  /// query a page of the listing of a directory
+  vtkPVFileInformation* GetListing(const QString& path, int pageOffset)
+  {
+    vtkPVFileInformation* info =
+      this->GetData(true, path, false, pageOffset, pqImplementation::ListingPageSize);
+    this->NextPageOffset = pageOffset + pqImplementation::ListingPageSize;
+    this->TotalNumberOfEntries = info->GetTotalNumberOfEntries();
+    return info;
+  }
+
+  /// returns whether the listing of the current path has pages left to query
+  bool hasMorePages() const { return this->NextPageOffset < this->TotalNumberOfEntries; }
+
+  /// put the first page of queried information into our model
   void Update(const QString& path, vtkPVFileInformation* dir)
   {
     this->CurrentPath = path;
+    this->ListingPath = QString::fromUtf8(dir->GetFullPath());
     this->FileList.clear();
+    this->NumberOfDirectories = 0;
+    this->Append(dir);
+    if (this->hasMorePages())
+    {
+      this->PageTimer.start();
+    }
+    else
+    {
+      this->PageTimer.stop();
+    }
+  }
 
+  /// merge a page of queried information into our model
+  void Append(vtkPVFileInformation* dir)
+  {
     QList<pqFileDialogModelFileInfo> dirs;
     QList<pqFileDialogModelFileInfo> files;
 
@@ -453,14 +498,15 @@ public:
     qSort(dirs.begin(), dirs.end(), CaseInsensitiveSort);
     qSort(files.begin(), files.end(), CaseInsensitiveSort);
 
-    for (int i = 0; i != dirs.size(); ++i)
-    {
-      this->FileList.push_back(dirs[i]);
-    }
-    for (int i = 0; i != files.size(); ++i)
-    {
-      this->FileList.push_back(files[i]);
-    }
+    // directories are listed before files, each sorted on their own.
+    QVector<pqFileDialogModelFileInfo> merged;
+    merged.reserve(this->FileList.size() + dirs.size() + files.size());
+    std::merge(this->FileList.begin(), this->FileList.begin() + this->NumberOfDirectories,
+      dirs.begin(), dirs.end(), std::back_inserter(merged), CaseInsensitiveSort);
+    std::merge(this->FileList.begin() + this->NumberOfDirectories, this->FileList.end(),
+      files.begin(), files.end(), std::back_inserter(merged), CaseInsensitiveSort);
+    this->FileList.swap(merged);
+    this->NumberOfDirectories += dirs.size();
   }
 
   QStringList getFilePaths(const QModelIndex& index)
@@ -522,6 +568,18 @@ public:
   QString CurrentPath;
   /// Caches information about the set of files within the current path.
   QVector<pqFileDialogModelFileInfo> FileList; // adjacent memory occupation for QModelIndex
+  /// Number of directories at the beginning of FileList.
+  int NumberOfDirectories;
+
+  /// Number of entries queried per page of a directory listing. The first
+  /// page is shown right away, the others are merged in by fetchMore().
+  static const int ListingPageSize = 1024;
+  /// Full path of the directory being listed, and paging of its listing.
+  QString ListingPath;
+  int NextPageOffset;
+  int TotalNumberOfEntries;
+  /// Queries the remaining pages of the listing between events.
+  QTimer PageTimer;
 
   const pqFileDialogModelFileInfo* infoForIndex(const QModelIndex& idx) const
   {
@@ -588,6 +646,8 @@ pqFileDialogModel::pqFileDialogModel(pqServer* _server, QObject* Parent)
   : base(Parent)
   , Implementation(new pqImplementation(_server))
 {
+  QObject::connect(
+    &this->Implementation->PageTimer, SIGNAL(timeout()), this, SLOT(fetchRemainingPages()));
 }
 
 pqFileDialogModel::~pqFileDialogModel()
@@ -616,11 +676,76 @@ void pqFileDialogModel::setCurrentPath(const QString& path)
   this->beginResetModel();
   QString cPath = this->Implementation->cleanPath(path);
   vtkPVFileInformation* info;
-  info = this->Implementation->GetData(true, cPath, false);
+  info = this->Implementation->GetListing(cPath, 0);
   this->Implementation->Update(cPath, info);
   this->endResetModel();
 }
 
+void pqFileDialogModel::fetchRemainingPages()
+{
+  this->fetchMore(QModelIndex());
+  if (this->canFetchMore(QModelIndex()))
+  {
+    this->Implementation->PageTimer.start();
+  }
+}
+
+bool pqFileDialogModel::canFetchMore(const QModelIndex& p) const
+{
+  return !p.isValid() && this->Implementation->hasMorePages();
+}
+
+void pqFileDialogModel::fetchMore(const QModelIndex& p)
+{
+  if (!this->canFetchMore(p))
+  {
+    return;
+  }
+
+  pqImplementation* impl = this->Implementation;
+  vtkPVFileInformation* info = impl->GetListing(impl->ListingPath, impl->NextPageOffset);
+
+  // the page is merged in between the existing rows, keep persistent indexes
+  // (e.g. the selection) on the same files.
+  emit this->layoutAboutToBeChanged();
+  const QModelIndexList oldIndexes = this->persistentIndexList();
+  QStringList oldPaths;
+  for (int i = 0; i < oldIndexes.size(); ++i)
+  {
+    const QModelIndex& idx = oldIndexes[i];
+    const QModelIndex top = idx.internalPointer() ? idx.parent() : idx;
+    oldPaths.push_back(impl->FileList[top.row()].filePath());
+  }
+
+  impl->Append(info);
+
+  QHash<QString, int> rows;
+  for (int i = 0; !oldIndexes.isEmpty() && i < impl->FileList.size(); ++i)
+  {
+    rows.insert(impl->FileList[i].filePath(), i);
+  }
+  QModelIndexList newIndexes;
+  for (int i = 0; i < oldIndexes.size(); ++i)
+  {
+    const QModelIndex& idx = oldIndexes[i];
+    const int row = rows.value(oldPaths[i], -1);
+    if (row == -1)
+    {
+      newIndexes.push_back(QModelIndex());
+    }
+    else if (idx.internalPointer())
+    {
+      newIndexes.push_back(this->createIndex(idx.row(), idx.column(), &impl->FileList[row]));
+    }
+    else
+    {
+      newIndexes.push_back(this->createIndex(row, idx.column()));
+    }
+  }
+  this->changePersistentIndexList(oldIndexes, newIndexes);
+  emit this->layoutChanged();
+}
+
 QString pqFileDialogModel::getCurrentPath()
 {
   return this->Implementation->CurrentPath;
@@ -713,7 +838,7 @@ bool pqFileDialogModel::mkdir(const QString& dirName)
   this->beginResetModel();
   QString cPath = this->Implementation->cleanPath(this->getCurrentPath());
   vtkPVFileInformation* info;
-  info = this->Implementation->GetData(true, cPath, false);
+  info = this->Implementation->GetListing(cPath, 0);
   this->Implementation->Update(cPath, info);
   this->endResetModel();
 
@@ -747,7 +872,7 @@ bool pqFileDialogModel::rmdir(const QString& dirName)
   this->beginResetModel();
   QString cPath = this->Implementation->cleanPath(this->getCurrentPath());
   vtkPVFileInformation* info;
-  info = this->Implementation->GetData(true, cPath, false);
+  info = this->Implementation->GetListing(cPath, 0);
   this->Implementation->Update(cPath, info);
   this->endResetModel();
 
@@ -800,7 +925,7 @@ bool pqFileDialogModel::rename(const QString& oldname, const QString& newname)
 
   this->beginResetModel();
   QString cPath = this->Implementation->cleanPath(this->getCurrentPath());
-  info = this->Implementation->GetData(true, cPath, false);
+  info = this->Implementation->GetListing(cPath, 0);
   this->Implementation->Update(cPath, info);
   this->endResetModel();
 
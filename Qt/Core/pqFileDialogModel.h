@@ -179,6 +179,21 @@ public:
   * returns flags for item
   */
   Qt::ItemFlags flags(const QModelIndex& idx) const override;
+  /**
+  * returns whether the listing of the current path has entries left to query
+  */
+  bool canFetchMore(const QModelIndex& p) const override;
+  /**
+  * queries the next page of the listing of the current path
+  */
+  void fetchMore(const QModelIndex& p) override;
+
+private slots:
+  /**
+  * queries the pages of the listing of the current path not queried yet,
+  * one page per event loop iteration.
+  */
+  void fetchRemainingPages();
 
 private:
   class pqImplementation;
@@ -54,15 +54,26 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <sys/time.h>
 
+// Tasks need OpenMP 3.0
+#if defined(_OPENMP) && _OPENMP >= 200805
+#include <omp.h>
+#define HALO_FINDER_TASKS
+#endif
+
 using namespace std;
 
 namespace cosmotk {
 
+// Ranges of the k-d tree with fewer particles are processed by the task that
+// reaches them rather than by new tasks
+static const int taskGrain = 4096;
+
 /****************************************************************************/
 CosmoHaloFinder::CosmoHaloFinder()
 {
 
   nmin = 1;
+  parent = 0;
 }
 
 /****************************************************************************/
@@ -303,6 +314,10 @@ void CosmoHaloFinder::Finding()
   for (int i = 0; i < npart; i++)
     seq[i] = i;
 
+#ifdef HALO_FINDER_TASKS
+#pragma omp parallel
+#pragma omp single
+#endif
   Reorder(seq.begin(), seq.end(), dataX);
 
 #ifdef DEBUG
@@ -322,6 +337,10 @@ void CosmoHaloFinder::Finding()
   lbound = new POSVEL_T[npart];
   ubound = new POSVEL_T[npart];
   POSVEL_T lb1[numDataDims], ub1[numDataDims];
+#ifdef HALO_FINDER_TASKS
+#pragma omp parallel
+#pragma omp single
+#endif
   ComputeLU(0, npart, dataX, lb1, ub1);
 
 #ifdef DEBUG
@@ -344,6 +363,35 @@ void CosmoHaloFinder::Finding()
     nextp[i] = -1;
   }
 
+#ifdef HALO_FINDER_TASKS
+  if (nmin < 2 && omp_get_max_threads() > 1) {
+    parent = new std::atomic<int>[npart];
+#pragma omp parallel for
+    for (int i=0; i<npart; i++)
+      parent[i] = i;
+
+#pragma omp parallel
+#pragma omp single
+    myFOFConcurrent(0, npart, dataX);
+
+    // the root of every particle is the lowest particle of its halo
+#pragma omp parallel for
+    for (int i=0; i<npart; i++)
+      ht[i] = findRoot(i);
+
+    delete [] parent;
+    parent = 0;
+
+    // chain the particles of every halo by increasing index
+    for (int i=0; i<npart; i++)
+      halo[i] = -1;
+    for (int i=npart-1; i>=0; i--) {
+      nextp[i] = halo[ht[i]];
+      halo[ht[i]] = i;
+    }
+  }
+  else
+#endif
   myFOF(0, npart, dataX);
 
 #ifdef DEBUG
@@ -377,8 +425,14 @@ void CosmoHaloFinder::Reorder(
 
     nth_element(first, middle, last, kdCompare(data[axis]));
 
+#ifdef HALO_FINDER_TASKS
+#pragma omp task if (length > taskGrain)
+#endif
     Reorder(first, middle, (axis+1) % numDataDims);
     Reorder(middle, last, (axis+1) % numDataDims);
+#ifdef HALO_FINDER_TASKS
+#pragma omp taskwait
+#endif
 }
 
 /****************************************************************************/
@@ -438,8 +492,14 @@ void CosmoHaloFinder::ComputeLU(
 
   // non-base cases
 
+#ifdef HALO_FINDER_TASKS
+#pragma omp task shared(lb1, ub1) if (len > taskGrain)
+#endif
   ComputeLU(first, middle, (axis + 1) % numDataDims, lb1, ub1);
   ComputeLU(middle,  last, (axis + 1) % numDataDims, lb2, ub2);
+#ifdef HALO_FINDER_TASKS
+#pragma omp taskwait
+#endif
 
   // compute LU at the bottom-up pass
   lbound[middle] = min(lb1[useDim], lb2[useDim]);
@@ -622,4 +682,161 @@ void CosmoHaloFinder::Merge(
   return;
 }
 
+/****************************************************************************/
+void CosmoHaloFinder::myFOFConcurrent(
+                        int first,
+                        int last,
+                        int dataFlag)
+{
+  int len = last - first;
+
+  // base case
+  if (len == 1)
+    return;
+
+  // divide
+  int middle = first + len/2;
+
+#ifdef HALO_FINDER_TASKS
+#pragma omp task if (len > taskGrain)
+#endif
+  myFOFConcurrent(first, middle, (dataFlag+1) % numDataDims);
+  myFOFConcurrent(middle,  last, (dataFlag+1) % numDataDims);
+#ifdef HALO_FINDER_TASKS
+#pragma omp taskwait
+#endif
+
+  // recursive merge, once both halves are merged so that most of the pairs
+  // already in the same halo are skipped
+  MergeConcurrent(first, middle, middle, last, dataFlag);
+}
+
+/****************************************************************************/
+void CosmoHaloFinder::MergeConcurrent(
+                        int first1, int last1,
+                        int first2, int last2,
+                        int dataFlag)
+{
+  int len1 = last1 - first1;
+  int len2 = last2 - first2;
+
+  // base cases, see Merge()
+  if (len1 == 1 || len2 == 1) {
+    for (int i=0; i<len1; i++)
+    for (int j=0; j<len2; j++) {
+      int ii = seq[first1+i];
+      int jj = seq[first2+j];
+
+      // fast exit
+      if (findRoot(ii) == findRoot(jj))
+        continue;
+
+      if (areFriends(ii, jj))
+        unite(ii, jj);
+    } // (i,j)-loop
+
+    return;
+  }
+
+  // non-base case
+
+  // pruning?
+  int middle1 = first1 + len1/2;
+  int middle2 = first2 + len2/2;
+
+  POSVEL_T lL = lbound[middle1];
+  POSVEL_T uL = ubound[middle1];
+  POSVEL_T lR = lbound[middle2];
+  POSVEL_T uR = ubound[middle2];
+
+  POSVEL_T dL = uL - lL;
+  POSVEL_T dR = uR - lR;
+  POSVEL_T dc = max(uL,uR) - min(lL,lR);
+
+  POSVEL_T dist = dc - dL - dR;
+  if (periodic)
+    dist = min(dist, np-dc);
+
+  if (dist >= bb)
+    return;
+
+  // continue merging
+
+  // move to the next axis
+  dataFlag = (dataFlag + 1) % numDataDims;
+
+#ifdef HALO_FINDER_TASKS
+  bool spawn = len1 + len2 > taskGrain;
+#pragma omp task if (spawn)
+#endif
+  MergeConcurrent(first1, middle1,  first2, middle2, dataFlag);
+#ifdef HALO_FINDER_TASKS
+#pragma omp task if (spawn)
+#endif
+  MergeConcurrent(first1, middle1, middle2,   last2, dataFlag);
+#ifdef HALO_FINDER_TASKS
+#pragma omp task if (spawn)
+#endif
+  MergeConcurrent(middle1,  last1,  first2, middle2, dataFlag);
+  MergeConcurrent(middle1,  last1, middle2,   last2, dataFlag);
+#ifdef HALO_FINDER_TASKS
+#pragma omp taskwait
+#endif
+}
+
+/****************************************************************************/
+int CosmoHaloFinder::findRoot(int i)
+{
+  // path halving, concurrent updates only ever point particles to one of
+  // their ancestors
+  while (true) {
+    int p = parent[i];
+    if (p == i)
+      return i;
+
+    int gp = parent[p];
+    if (gp != p)
+      parent[i].compare_exchange_weak(p, gp);
+    i = gp;
+  }
+}
+
+/****************************************************************************/
+void CosmoHaloFinder::unite(int i, int j)
+{
+  // the root with the larger index is attached to the other one, so that
+  // roots stay the lowest particle of their halo
+  while (true) {
+    i = findRoot(i);
+    j = findRoot(j);
+    if (i == j)
+      return;
+
+    int newHaloId = min(i, j);
+    int oldHaloId = max(i, j);
+    if (parent[oldHaloId].compare_exchange_strong(oldHaloId, newHaloId))
+      return;
+  }
+}
+
+/****************************************************************************/
+bool CosmoHaloFinder::areFriends(int ii, int jj)
+{
+  POSVEL_T xdist = fabs(data[dataX][jj] - data[dataX][ii]);
+  POSVEL_T ydist = fabs(data[dataY][jj] - data[dataY][ii]);
+  POSVEL_T zdist = fabs(data[dataZ][jj] - data[dataZ][ii]);
+
+  if (periodic) {
+    xdist = min(xdist, np-xdist);
+    ydist = min(ydist, np-ydist);
+    zdist = min(zdist, np-zdist);
+  }
+
+  if ((xdist<bb) && (ydist<bb) && (zdist<bb)) {
+    POSVEL_T dist = xdist*xdist + ydist*ydist + zdist*zdist;
+    return dist < bb*bb;
+  }
+  return false;
+}
+
 } // END namespace cosmotk
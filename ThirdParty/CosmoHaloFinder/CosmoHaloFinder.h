@@ -102,10 +102,21 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // particle is constantly altered so that each particle knows what halo it
 // is part of, and that halo tag is the id of the lowest particle in the halo.
 //
+// When OpenMP is available, Reorder() and ComputeLU() recurse into the two
+// halves of the tree as parallel tasks. If moreover nmin < 2, the halos do
+// not depend on the order in which pairs are merged, so myFOF() and Merge()
+// also run as tasks and unite particles in a concurrent union-find forest
+// (roots are the lowest particle index, as for the halo tags) instead of
+// splicing the linked lists. The lists are built afterwards, each starting at
+// the lowest particle of the halo and following increasing indices. With
+// nmin >= 2 the neighbor counts depend on the merge order, so the serial
+// merge is used.
+//
 
 #ifndef CosmoHaloFinder_h
 #define CosmoHaloFinder_h
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -232,6 +243,15 @@ private:
   // Recurses through the k-d tree merging particles to create halos
   void myFOF(int, int, int);
   void Merge(int, int, int, int, int);
+
+  // Same as myFOF and Merge for nmin < 2, merging halos concurrently in the
+  // union-find forest stored in parent
+  std::atomic<int>* parent;
+  void myFOFConcurrent(int, int, int);
+  void MergeConcurrent(int, int, int, int, int);
+  int findRoot(int);
+  void unite(int, int);
+  bool areFriends(int, int);
 };
 
 } // END cosmotk namespace
@@ -56,10 +56,55 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "GenericIO.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 using namespace gio;
 
 namespace cosmotk {
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Kahan summations over contiguous data, in the same order and with the
+// same precision as the linked list walks they replace
+//
+/////////////////////////////////////////////////////////////////////////
+
+static POSVEL_T kahanSum(const POSVEL_T* data, int count)
+{
+  if (count == 0)
+    return 0.0;
+
+  POSVEL_T dataSum = data[0];
+  POSVEL_T dataRem = 0.0;
+  for (int i = 1; i < count; i++) {
+    POSVEL_T v = data[i] - dataRem;
+    POSVEL_T w = dataSum + v;
+    dataRem = (w - dataSum) - v;
+    dataSum = w;
+  }
+  return dataSum;
+}
+
+static POSVEL_T kahanSum2(const POSVEL_T* data1, const POSVEL_T* data2,
+                          int count)
+{
+  if (count == 0)
+    return 0.0;
+
+  POSVEL_T dataSum = data1[0] * data2[0];
+  POSVEL_T dataRem = 0.0;
+  for (int i = 1; i < count; i++) {
+    POSVEL_T v = (data1[i] * data2[i]) - dataRem;
+    POSVEL_T w = dataSum + v;
+    dataRem = (w - dataSum) - v;
+    dataSum = w;
+  }
+  return dataSum;
+}
+
 /////////////////////////////////////////////////////////////////////////
 //
 // FOFHaloProperties uses the results of the CosmoHaloFinder to locate the
@@ -72,6 +117,21 @@ FOFHaloProperties::FOFHaloProperties()
   // Get the number of processors and rank of this processor
   this->numProc = Partition::getNumProc();
   this->myProc = Partition::getMyProc();
+
+  this->particleCount = 0;
+  this->xx = this->yy = this->zz = 0;
+  this->vx = this->vy = this->vz = 0;
+  this->mass = 0;
+  this->pot = 0;
+  this->tag = 0;
+  this->mask = 0;
+  this->status = 0;
+
+  this->numberOfHalos = 0;
+  this->halos = 0;
+  this->haloCount = 0;
+  this->haloList = 0;
+  this->membersGathered = false;
 }
 
 FOFHaloProperties::~FOFHaloProperties()
@@ -94,6 +154,81 @@ void FOFHaloProperties::setHalos(
   this->halos = haloStartIndex;
   this->haloCount = haloParticleCount;
   this->haloList = nextParticleIndex;
+
+  this->buildHaloMembers();
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Flatten the linked list of every halo into a compressed membership where
+// the particles of halo h are haloMembers[haloOffsets[h]] up to
+// haloMembers[haloOffsets[h+1]], in linked list order
+//
+/////////////////////////////////////////////////////////////////////////
+
+void FOFHaloProperties::buildHaloMembers()
+{
+  this->haloOffsets.resize(this->numberOfHalos + 1);
+  this->haloOffsets[0] = 0;
+  for (int halo = 0; halo < this->numberOfHalos; halo++)
+    this->haloOffsets[halo + 1] =
+      this->haloOffsets[halo] + this->haloCount[halo];
+  this->haloMembers.resize(this->haloOffsets[this->numberOfHalos]);
+
+  int* members = this->haloMembers.empty() ? 0 : &this->haloMembers[0];
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for (int halo = 0; halo < this->numberOfHalos; halo++) {
+    int p = this->halos[halo];
+    for (int i = this->haloOffsets[halo]; i < this->haloOffsets[halo + 1];
+         i++) {
+      members[i] = p;
+      p = this->haloList[p];
+    }
+  }
+
+  this->membersGathered = false;
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Copy the particle data of all halo members so that every halo is
+// contiguous. Done once, on the first property calculation
+//
+/////////////////////////////////////////////////////////////////////////
+
+void FOFHaloProperties::gatherMembers()
+{
+  if (this->membersGathered)
+    return;
+
+  int count = (int) this->haloMembers.size();
+  this->memberXX.resize(count);
+  this->memberYY.resize(count);
+  this->memberZZ.resize(count);
+  this->memberVX.resize(count);
+  this->memberVY.resize(count);
+  this->memberVZ.resize(count);
+  this->memberMass.resize(count);
+  this->memberPot.resize(this->pot ? count : 0);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < count; i++) {
+    int p = this->haloMembers[i];
+    this->memberXX[i] = this->xx[p];
+    this->memberYY[i] = this->yy[p];
+    this->memberZZ[i] = this->zz[p];
+    this->memberVX[i] = this->vx[p];
+    this->memberVY[i] = this->vy[p];
+    this->memberVZ[i] = this->vz[p];
+    this->memberMass[i] = this->mass[p];
+    if (this->pot)
+      this->memberPot[i] = this->pot[p];
+  }
+  this->membersGathered = true;
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -150,6 +285,7 @@ void FOFHaloProperties::setParticles(long count,
   this->tag = id;
   this->mask = maskData;
   this->status = state;
+  this->membersGathered = false;
 }
 
 void FOFHaloProperties::setParticles(long count,
@@ -172,7 +308,11 @@ void FOFHaloProperties::setParticles(long count,
   this->vy = yVel;
   this->vz = zVel;
   this->mass = pmass;
+  this->pot = 0;
   this->tag = id;
+  this->mask = 0;
+  this->status = 0;
+  this->membersGathered = false;
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -184,27 +324,26 @@ void FOFHaloProperties::setParticles(long count,
 
 void FOFHaloProperties::FOFHaloCenterMinimumPotential(vector<int>* haloCenter)
 {
-  for (int halo = 0; halo < this->numberOfHalos; halo++) {
+  this->gatherMembers();
 
-    // First particle in halo
-    int p = this->halos[halo];
-    POTENTIAL_T minPotential = this->pot[p];
-    int centerIndex = p;
+  size_t first = haloCenter->size();
+  haloCenter->resize(first + this->numberOfHalos);
 
-    // Next particle
-    p = this->haloList[p];
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for (int halo = 0; halo < this->numberOfHalos; halo++) {
+    int begin = this->haloOffsets[halo];
+    int end = this->haloOffsets[halo + 1];
 
     // Search for minimum
-    while (p != -1) {
-      if (minPotential > this->pot[p]) {
-        minPotential = this->pot[p];
-        centerIndex = p;
-      }
-      p = this->haloList[p];
-    }
+    int centerIndex = begin;
+    for (int i = begin + 1; i < end; i++)
+      if (this->memberPot[centerIndex] > this->memberPot[i])
+        centerIndex = i;
 
     // Save the minimum potential index for this halo
-    (*haloCenter).push_back(centerIndex);
+    (*haloCenter)[first + halo] = this->haloMembers[centerIndex];
   }
 }
 
@@ -222,13 +361,19 @@ void FOFHaloProperties::FOFHaloCenterMinimumPotential(vector<int>* haloCenter)
 void FOFHaloProperties::FOFHaloMass(
                         vector<POSVEL_T>* haloMass)
 {
-  POSVEL_T lmass;
-  double mKahan;
+  this->gatherMembers();
+
+  size_t first = haloMass->size();
+  haloMass->resize(first + this->numberOfHalos);
 
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
   for (int halo = 0; halo < this->numberOfHalos; halo++) {
-    mKahan = KahanSummation(halo, this->mass);
-    lmass = (POSVEL_T) mKahan;
-    (*haloMass).push_back(lmass);
+    int begin = this->haloOffsets[halo];
+    int count = this->haloOffsets[halo + 1] - begin;
+    double mKahan = kahanSum(this->memberMass.data() + begin, count);
+    (*haloMass)[first + halo] = (POSVEL_T) mKahan;
   }
 }
 
@@ -248,24 +393,30 @@ void FOFHaloProperties::FOFCenterOfMass(
                         vector<POSVEL_T>* yCenterOfMass,
                         vector<POSVEL_T>* zCenterOfMass)
 {
-  POSVEL_T xCofMass, yCofMass, zCofMass;
-  double xKahan, yKahan, zKahan;
+  this->gatherMembers();
 
-  for (int halo = 0; halo < this->numberOfHalos; halo++) {
+  size_t first = xCenterOfMass->size();
+  xCenterOfMass->resize(first + this->numberOfHalos);
+  yCenterOfMass->resize(first + this->numberOfHalos);
+  zCenterOfMass->resize(first + this->numberOfHalos);
 
-    double totalMass = KahanSummation(halo, this->mass);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for (int halo = 0; halo < this->numberOfHalos; halo++) {
+    int begin = this->haloOffsets[halo];
+    int count = this->haloOffsets[halo + 1] - begin;
+    const POSVEL_T* hmass = this->memberMass.data() + begin;
 
-    xKahan = KahanSummation2(halo, this->xx, this->mass);
-    yKahan = KahanSummation2(halo, this->yy, this->mass);
-    zKahan = KahanSummation2(halo, this->zz, this->mass);
+    double totalMass = kahanSum(hmass, count);
 
-    xCofMass = (POSVEL_T) (xKahan / totalMass);
-    yCofMass = (POSVEL_T) (yKahan / totalMass);
-    zCofMass = (POSVEL_T) (zKahan / totalMass);
+    double xKahan = kahanSum2(this->memberXX.data() + begin, hmass, count);
+    double yKahan = kahanSum2(this->memberYY.data() + begin, hmass, count);
+    double zKahan = kahanSum2(this->memberZZ.data() + begin, hmass, count);
 
-    (*xCenterOfMass).push_back(xCofMass);
-    (*yCenterOfMass).push_back(yCofMass);
-    (*zCenterOfMass).push_back(zCofMass);
+    (*xCenterOfMass)[first + halo] = (POSVEL_T) (xKahan / totalMass);
+    (*yCenterOfMass)[first + halo] = (POSVEL_T) (yKahan / totalMass);
+    (*zCenterOfMass)[first + halo] = (POSVEL_T) (zKahan / totalMass);
   }
 }
 
@@ -286,21 +437,27 @@ void FOFHaloProperties::FOFPosition(
                         vector<POSVEL_T>* yMeanPos,
                         vector<POSVEL_T>* zMeanPos)
 {
-  POSVEL_T xMean, yMean, zMean;
-  double xKahan, yKahan, zKahan;
+  this->gatherMembers();
+
+  size_t first = xMeanPos->size();
+  xMeanPos->resize(first + this->numberOfHalos);
+  yMeanPos->resize(first + this->numberOfHalos);
+  zMeanPos->resize(first + this->numberOfHalos);
 
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
   for (int halo = 0; halo < this->numberOfHalos; halo++) {
-    xKahan = KahanSummation(halo, this->xx);
-    yKahan = KahanSummation(halo, this->yy);
-    zKahan = KahanSummation(halo, this->zz);
+    int begin = this->haloOffsets[halo];
+    int count = this->haloOffsets[halo + 1] - begin;
 
-    xMean = (POSVEL_T) (xKahan / this->haloCount[halo]);
-    yMean = (POSVEL_T) (yKahan / this->haloCount[halo]);
-    zMean = (POSVEL_T) (zKahan / this->haloCount[halo]);
+    double xKahan = kahanSum(this->memberXX.data() + begin, count);
+    double yKahan = kahanSum(this->memberYY.data() + begin, count);
+    double zKahan = kahanSum(this->memberZZ.data() + begin, count);
 
-    (*xMeanPos).push_back(xMean);
-    (*yMeanPos).push_back(yMean);
-    (*zMeanPos).push_back(zMean);
+    (*xMeanPos)[first + halo] = (POSVEL_T) (xKahan / this->haloCount[halo]);
+    (*yMeanPos)[first + halo] = (POSVEL_T) (yKahan / this->haloCount[halo]);
+    (*zMeanPos)[first + halo] = (POSVEL_T) (zKahan / this->haloCount[halo]);
   }
 }
 
@@ -320,21 +477,27 @@ void FOFHaloProperties::FOFVelocity(
                         vector<POSVEL_T>* yMeanVel,
                         vector<POSVEL_T>* zMeanVel)
 {
-  POSVEL_T xMean, yMean, zMean;
-  double xKahan, yKahan, zKahan;
+  this->gatherMembers();
 
+  size_t first = xMeanVel->size();
+  xMeanVel->resize(first + this->numberOfHalos);
+  yMeanVel->resize(first + this->numberOfHalos);
+  zMeanVel->resize(first + this->numberOfHalos);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
   for (int halo = 0; halo < this->numberOfHalos; halo++) {
-    xKahan = KahanSummation(halo, this->vx);
-    yKahan = KahanSummation(halo, this->vy);
-    zKahan = KahanSummation(halo, this->vz);
+    int begin = this->haloOffsets[halo];
+    int count = this->haloOffsets[halo + 1] - begin;
 
-    xMean = (POSVEL_T) (xKahan / this->haloCount[halo]);
-    yMean = (POSVEL_T) (yKahan / this->haloCount[halo]);
-    zMean = (POSVEL_T) (zKahan / this->haloCount[halo]);
+    double xKahan = kahanSum(this->memberVX.data() + begin, count);
+    double yKahan = kahanSum(this->memberVY.data() + begin, count);
+    double zKahan = kahanSum(this->memberVZ.data() + begin, count);
 
-    (*xMeanVel).push_back(xMean);
-    (*yMeanVel).push_back(yMean);
-    (*zMeanVel).push_back(zMean);
+    (*xMeanVel)[first + halo] = (POSVEL_T) (xKahan / this->haloCount[halo]);
+    (*yMeanVel)[first + halo] = (POSVEL_T) (yKahan / this->haloCount[halo]);
+    (*zMeanVel)[first + halo] = (POSVEL_T) (zKahan / this->haloCount[halo]);
   }
 }
 
@@ -357,17 +520,23 @@ void FOFHaloProperties::FOFVelocityDispersion(
                         vector<POSVEL_T>* zAvgVel,
                         vector<POSVEL_T>* velDisp)
 {
-  for (int halo = 0; halo < this->numberOfHalos; halo++) {
+  this->gatherMembers();
 
-    // First particle in the halo
-    int p = this->halos[halo];
+  size_t first = velDisp->size();
+  velDisp->resize(first + this->numberOfHalos);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for (int halo = 0; halo < this->numberOfHalos; halo++) {
+    int begin = this->haloOffsets[halo];
+    int end = this->haloOffsets[halo + 1];
     POSVEL_T particleDot = 0.0;
 
     // Iterate over all particles in the halo collecting dot products
-    while (p != -1) {
-      particleDot += dotProduct(this->vx[p], this->vy[p], this->vz[p]);
-      p = this->haloList[p];
-    }
+    for (int i = begin; i < end; i++)
+      particleDot += dotProduct(this->memberVX[i], this->memberVY[i],
+                                this->memberVZ[i]);
 
     // Average of all the dot products
     particleDot /= this->haloCount[halo];
@@ -380,7 +549,7 @@ void FOFHaloProperties::FOFVelocityDispersion(
     POSVEL_T vDispersion = (POSVEL_T)sqrt((particleDot - haloDot) / 3.0);
 
     // Save onto supplied vector
-    velDisp->push_back(vDispersion);
+    (*velDisp)[first + halo] = vDispersion;
   }
 }
 
@@ -408,21 +577,17 @@ POSVEL_T FOFHaloProperties::KahanSummation(int halo, POSVEL_T* data)
   POSVEL_T dataSum, dataRem, v, w;
 
   // First particle in halo and first step in Kahan summation
-  int p = this->halos[halo];
-  dataSum = data[p];
+  const int* member = &this->haloMembers[this->haloOffsets[halo]];
+  const int* last = &this->haloMembers[0] + this->haloOffsets[halo + 1];
+  dataSum = data[*member];
   dataRem = 0.0;
 
-  // Next particle
-  p = this->haloList[p];
-
   // Remaining steps in Kahan summation
-  while (p != -1) {
-    v = data[p] - dataRem;
+  for (++member; member < last; ++member) {
+    v = data[*member] - dataRem;
     w = dataSum + v;
     dataRem = (w - dataSum) - v;
     dataSum = w;
-
-    p = this->haloList[p];
   }
   return dataSum;
 }
@@ -440,21 +605,17 @@ POSVEL_T FOFHaloProperties::KahanSummation2(int halo,
   POSVEL_T dataSum, dataRem, v, w;
 
   // First particle in halo and first step in Kahan summation
-  int p = this->halos[halo];
-  dataSum = data1[p] * data2[p];
+  const int* member = &this->haloMembers[this->haloOffsets[halo]];
+  const int* last = &this->haloMembers[0] + this->haloOffsets[halo + 1];
+  dataSum = data1[*member] * data2[*member];
   dataRem = 0.0;
 
-  // Next particle
-  p = this->haloList[p];
-
   // Remaining steps in Kahan summation
-  while (p != -1) {
-    v = (data1[p] * data2[p]) - dataRem;
+  for (++member; member < last; ++member) {
+    v = (data1[*member] * data2[*member]) - dataRem;
     w = dataSum + v;
     dataRem = (w - dataSum) - v;
     dataSum = w;
-
-    p = this->haloList[p];
   }
   return dataSum;
 }
@@ -470,25 +631,25 @@ POSVEL_T FOFHaloProperties::incrementalMean(int halo, POSVEL_T* data)
   double dataMean, dataRem, diff, value, v, w;
 
   // First particle in halo and first step in incremental mean
-  int p = this->halos[halo];
-  dataMean = data[p];
+  const int* member = &this->haloMembers[this->haloOffsets[halo]];
+  const int* last = &this->haloMembers[0] + this->haloOffsets[halo + 1];
+  dataMean = data[*member];
   dataRem = 0.0;
   int count = 1;
 
   // Next particle
-  p = this->haloList[p];
+  ++member;
   count++;
 
   // Remaining steps in incremental mean
-  while (p != -1) {
-    diff = data[p] - dataMean;
+  for (; member < last; ++member) {
+    diff = data[*member] - dataMean;
     value = diff / count;
     v = value - dataRem;
     w = dataMean + v;
     dataRem = (w - dataMean) - v;
     dataMean = w;
 
-    p = this->haloList[p];
     count++;
   }
   return (POSVEL_T) dataMean;
@@ -583,14 +744,14 @@ void FOFHaloProperties::extractLocation(
                                 POSVEL_T* zLocHalo,
                                 ID_T* id)
 {
-  int p = this->halos[halo];
+  const int* member = &this->haloMembers[this->haloOffsets[halo]];
   for (int i = 0; i < this->haloCount[halo]; i++) {
+    int p = member[i];
     xLocHalo[i] = this->xx[p];
     yLocHalo[i] = this->yy[p];
     zLocHalo[i] = this->zz[p];
     id[i] = this->tag[p];
     actualIndx[i] = p;
-    p = this->haloList[p];
   }
 }
 
@@ -614,8 +775,9 @@ void FOFHaloProperties::extractInformation(
                                 ID_T* id)
 {
   // WARNING: This routine must be thread safe!
-  int p = this->halos[halo];
+  const int* member = &this->haloMembers[this->haloOffsets[halo]];
   for (int i = 0; i < this->haloCount[halo]; i++) {
+    int p = member[i];
     xLocHalo[i] = this->xx[p];
     yLocHalo[i] = this->yy[p];
     zLocHalo[i] = this->zz[p];
@@ -625,7 +787,6 @@ void FOFHaloProperties::extractInformation(
     massHalo[i] = this->mass[p];
     id[i] = this->tag[p];
     actualIndx[i] = p;
-    p = this->haloList[p];
   }
 }
 
@@ -638,12 +799,12 @@ void FOFHaloProperties::extractInformation(
 
 void FOFHaloProperties::printLocations(int halo)
 {
-  int p = this->halos[halo];
+  const int* member = &this->haloMembers[this->haloOffsets[halo]];
   for (int i = 0; i < this->haloCount[halo]; i++) {
+    int p = member[i];
     cout << "FOF INFO " << this->myProc << " " << halo
          << " INDEX " << p << " TAG " << this->tag[p] << " LOCATION "
          << this->xx[p] << " " << this->yy[p] << " " << this->zz[p] << endl;
-    p = this->haloList[p];
   }
 }
 
@@ -661,8 +822,9 @@ void FOFHaloProperties::printBoundingBox(int halo)
     maxBox[dim] = 0.0;
   }
 
-  int p = this->halos[halo];
+  const int* member = &this->haloMembers[this->haloOffsets[halo]];
   for (int i = 0; i < this->haloCount[halo]; i++) {
+    int p = member[i];
 
     if (minBox[0] > this->xx[p])
       minBox[0] = this->xx[p];
@@ -678,8 +840,6 @@ void FOFHaloProperties::printBoundingBox(int halo)
       minBox[2] = this->zz[p];
     if (maxBox[2] < this->zz[p])
       maxBox[2] = this->zz[p];
-
-    p = this->haloList[p];
   }
   cout << "FOF BOUNDING BOX " << this->myProc << " " << halo << ": "
          << minBox[0] << ":" << maxBox[0] << "  "
@@ -47,6 +47,14 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // FOFHaloProperties takes data from CosmoHaloFinderP about individual halos
 // and data from all particles and calculates properties.
 //
+// The linked list of particles of every halo is flattened once into a
+// compressed halo membership (the particle indices of each halo stored
+// contiguously), and the particle data of the halos is gathered in that order
+// the first time a property is computed, so that the per halo reductions
+// stream through contiguous memory. Halos are processed in parallel when
+// OpenMP is available. Particles are visited in the order of the linked list
+// so the properties are identical to a serial walk of the list.
+//
 
 #ifndef FOFHaloProperties_h
 #define FOFHaloProperties_h
@@ -175,6 +183,12 @@ public:
   void printBoundingBox(int haloIndex);
 
 private:
+  // Flatten the halo linked lists into haloOffsets/haloMembers
+  void buildHaloMembers();
+
+  // Gather the particle data of all halo members in haloMembers order
+  void gatherMembers();
+
   int    myProc;                // My processor number
   int    numProc;               // Total number of processors
 
@@ -204,6 +218,21 @@ private:
   int* halos;                   // First particle index into haloList
   int* haloCount;               // Size of each halo
   int* haloList;                // Indices of next particle in halo
+
+  // Compressed halo membership built from the linked lists
+  vector<int> haloOffsets;      // Start of each halo in haloMembers, and end
+  vector<int> haloMembers;      // Particle indices of all halos, halo by halo
+
+  // Particle data of the halo members, in haloMembers order
+  bool membersGathered;         // Whether the following match the particles
+  vector<POSVEL_T> memberXX;
+  vector<POSVEL_T> memberYY;
+  vector<POSVEL_T> memberZZ;
+  vector<POSVEL_T> memberVX;
+  vector<POSVEL_T> memberVY;
+  vector<POSVEL_T> memberVZ;
+  vector<POSVEL_T> memberMass;
+  vector<POTENTIAL_T> memberPot; // Empty when there is no potential
 };
 
 } // END namespace cosmotk
@@ -24,6 +24,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPNGWriter.h"
 #include "vtkPVRenderView.h"
+#include "vtkPVView.h"
 #include "vtkPointData.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderWindowInteractor.h"
@@ -38,10 +39,16 @@
 #include "vtkWebGLExporter.h"
 #include "vtkWebGLObject.h"
 #include "vtkWebInteractionEvent.h"
+#include "vtkZLibDataCompressor.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+#include <vtksys/MD5.h>
 
 class vtkPVWebApplication::vtkInternals
 {
@@ -50,18 +57,41 @@ public:
   {
   public:
     vtkSmartPointer<vtkUnsignedCharArray> Data;
+    vtkSmartPointer<vtkUnsignedCharArray> InteractiveData;
     bool NeedsRender;
+    bool InteractiveNeedsRender;
+    bool NeedsRefinement;
     bool HasImagesBeingProcessed;
     vtkObject* ViewPointer;
     unsigned long ObserverId;
+    double LastEncodeTime;
+    vtkIdType LastEncodedSize;
+    vtkIdType NumberOfDroppedFrames;
+    // When the last image was handed to the encoder thread, and whether its
+    // output is yet to be collected.
+    double EncodeStartTime;
+    bool EncodePending;
     ImageCacheValueType()
       : NeedsRender(true)
+      , InteractiveNeedsRender(true)
+      , NeedsRefinement(false)
       , HasImagesBeingProcessed(false)
       , ViewPointer(NULL)
       , ObserverId(0)
+      , LastEncodeTime(0.0)
+      , LastEncodedSize(0)
+      , NumberOfDroppedFrames(0)
+      , EncodeStartTime(0.0)
+      , EncodePending(false)
     {
     }
 
+    void Invalidate()
+    {
+      this->NeedsRender = true;
+      this->InteractiveNeedsRender = true;
+    }
+
     void SetListener(vtkObject* view)
     {
       if (this->ViewPointer == view)
@@ -92,11 +122,57 @@ public:
       }
     }
 
-    void ViewEventListener(vtkObject*, unsigned long, void*) { this->NeedsRender = true; }
+    void ViewEventListener(vtkObject*, unsigned long, void*) { this->Invalidate(); }
   };
   typedef std::map<void*, ImageCacheValueType> ImageCacheType;
   ImageCacheType ImageCache;
 
+  // Fetch the most recent image encoded for a view. The statistics are only
+  // updated once the output of the last image pushed has been collected, so
+  // that they describe that image and not a previous one.
+  void CollectEncodedImage(vtkTypeUInt32 key, ImageCacheValueType& value)
+  {
+    bool latest = this->Encoder->GetLatestOutput(key, value.Data);
+    value.HasImagesBeingProcessed = !latest;
+    if (latest && value.EncodePending)
+    {
+      value.EncodePending = false;
+      value.LastEncodeTime = (vtkTimerLog::GetUniversalTime() - value.EncodeStartTime) * 1000.0;
+      value.LastEncodedSize = value.Data ? value.Data->GetDataSize() : 0;
+    }
+  }
+
+  // Encode an image on the calling thread, as asked by ImageCompression.
+  static vtkSmartPointer<vtkUnsignedCharArray> EncodeImage(
+    vtkImageData* image, int compression, int quality)
+  {
+    vtkSmartPointer<vtkUnsignedCharArray> result;
+    if (compression == vtkPVWebApplication::COMPRESSION_NONE)
+    {
+      // raw pixels, as captured.
+      result = vtkSmartPointer<vtkUnsignedCharArray>::New();
+      result->DeepCopy(image->GetPointData()->GetScalars());
+    }
+    else if (compression == vtkPVWebApplication::COMPRESSION_PNG)
+    {
+      vtkNew<vtkPNGWriter> writer;
+      writer->WriteToMemoryOn();
+      writer->SetInputData(image);
+      writer->Write();
+      result = writer->GetResult();
+    }
+    else
+    {
+      vtkNew<vtkJPEGWriter> writer;
+      writer->WriteToMemoryOn();
+      writer->SetInputData(image);
+      writer->SetQuality(quality);
+      writer->Write();
+      result = writer->GetResult();
+    }
+    return result;
+  }
+
   typedef std::map<void*, unsigned int> ButtonStatesType;
   ButtonStatesType ButtonStates;
 
@@ -108,6 +184,11 @@ public:
   public:
     int ObjIndex;
     std::map<int, std::string> BinaryParts;
+    // MD5 of the raw content of each part, and the MTime and part sizes of
+    // the object they were computed for.
+    std::map<int, std::string> PartHashes;
+    std::map<int, int> PartSizes;
+    vtkMTimeType MTime;
   };
   // map for <vtkWebGLExporter, <webgl-objID, WebGLObjCacheValue> >
   typedef std::map<std::string, WebGLObjCacheValue> WebGLObjId2IndexMap;
@@ -115,6 +196,41 @@ public:
   // map for <vtkSMViewProxy, vtkWebGLExporter>
   std::map<vtkSMViewProxy*, vtkSmartPointer<vtkWebGLExporter> > ViewWebGLMap;
   std::string LastAllWebGLBinaryObjects;
+  std::string LastWebGLSceneDelta;
+
+  static std::string ComputeHash(const unsigned char* data, size_t size)
+  {
+    char hash[33];
+    vtksysMD5* md5 = vtksysMD5_New();
+    vtksysMD5_Initialize(md5);
+    vtksysMD5_Append(md5, data, static_cast<int>(size));
+    vtksysMD5_FinalizeHex(md5, hash);
+    vtksysMD5_Delete(md5);
+    hash[32] = '\0';
+    return std::string(hash);
+  }
+
+  static std::string EncodeBinaryPart(vtkWebGLObject* obj, int part, bool compress)
+  {
+    const unsigned char* data = obj->GetBinaryData(part);
+    size_t size = static_cast<size_t>(obj->GetBinarySize(part));
+    std::vector<unsigned char> compressed;
+    if (compress && size > 0)
+    {
+      vtkNew<vtkZLibDataCompressor> compressor;
+      compressed.resize(compressor->GetMaximumCompressionSpace(size));
+      size = compressor->Compress(data, size, &compressed[0], compressed.size());
+      data = &compressed[0];
+    }
+
+    // Manage Base64
+    vtkNew<vtkBase64Utilities> base64;
+    unsigned char* output = new unsigned char[size * 2];
+    int outputSize = base64->Encode(data, static_cast<unsigned long>(size), output, false);
+    std::string result(reinterpret_cast<const char*>(output), outputSize);
+    delete[] output;
+    return result;
+  }
 };
 
 vtkStandardNewMacro(vtkPVWebApplication);
@@ -122,6 +238,8 @@ vtkStandardNewMacro(vtkPVWebApplication);
 vtkPVWebApplication::vtkPVWebApplication()
   : ImageEncoding(ENCODING_BASE64)
   , ImageCompression(COMPRESSION_JPEG)
+  , InteractiveImageReductionFactor(2)
+  , CompressWebGLBinaryData(false)
   , Internals(new vtkPVWebApplication::vtkInternals())
 {
 }
@@ -140,17 +258,121 @@ bool vtkPVWebApplication::GetHasImagesBeingProcessed(vtkSMViewProxy* view)
   return value.HasImagesBeingProcessed;
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVWebApplication::GetNeedsRefinement(vtkSMViewProxy* view)
+{
+  return this->Internals->ImageCache[view].NeedsRefinement;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVWebApplication::GetIsInteracting(vtkSMViewProxy* view)
+{
+  return this->Internals->ButtonStates[view] != 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVWebApplication::GetLastEncodeTime(vtkSMViewProxy* view)
+{
+  return this->Internals->ImageCache[view].LastEncodeTime;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVWebApplication::GetLastEncodedSize(vtkSMViewProxy* view)
+{
+  return this->Internals->ImageCache[view].LastEncodedSize;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVWebApplication::GetNumberOfDroppedFrames(vtkSMViewProxy* view)
+{
+  return this->Internals->ImageCache[view].NumberOfDroppedFrames;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVWebApplication::DropFrame(vtkSMViewProxy* view)
+{
+  this->Internals->ImageCache[view].NumberOfDroppedFrames++;
+}
+
 //----------------------------------------------------------------------------
 vtkUnsignedCharArray* vtkPVWebApplication::InteractiveRender(vtkSMViewProxy* view, int quality)
 {
-  // for now, just do the same as StillRender().
-  return this->StillRender(view, quality);
+  if (!view)
+  {
+    vtkErrorMacro("No view specified.");
+    return NULL;
+  }
+
+  vtkInternals::ImageCacheValueType& value = this->Internals->ImageCache[view];
+  value.SetListener(view);
+
+  if (value.InteractiveNeedsRender == false && value.InteractiveData != NULL &&
+    view->GetNeedsUpdate() == false)
+  {
+    return value.InteractiveData;
+  }
+
+  // Render the frame at the reduced size, rather than downsampling a full
+  // size one, and let the view use its interactive (LOD) rendering for it.
+  // Both are set on the view itself: the window layout carries the reduced
+  // size to the render server, and the proxy properties are left untouched.
+  vtkPVView* pvView = vtkPVView::SafeDownCast(view->GetClientSideView());
+  vtkPVRenderView* renderView = vtkPVRenderView::SafeDownCast(pvView);
+  const int factor = this->InteractiveImageReductionFactor;
+  int viewSize[2] = { 0, 0 };
+  const bool reduce = factor > 1 && pvView != NULL;
+  if (reduce)
+  {
+    pvView->GetSize(viewSize);
+    pvView->SetSize(std::max(viewSize[0] / factor, 1), std::max(viewSize[1] / factor, 1));
+  }
+  bool useInteractiveRendering = false;
+  if (renderView)
+  {
+    useInteractiveRendering = renderView->GetUseInteractiveRenderingForScreenshots();
+    renderView->SetUseInteractiveRenderingForScreenshots(true);
+  }
+
+  vtkSmartPointer<vtkImageData> image;
+  image.TakeReference(view->CaptureWindow(1));
+
+  if (reduce)
+  {
+    pvView->SetSize(viewSize[0], viewSize[1]);
+  }
+  if (renderView)
+  {
+    renderView->SetUseInteractiveRenderingForScreenshots(useInteractiveRendering);
+  }
+
+  // report the size of the view, which the client maps its events to.
+  image->GetDimensions(this->LastStillRenderImageSize);
+  if (reduce)
+  {
+    this->LastStillRenderImageSize[0] = viewSize[0];
+    this->LastStillRenderImageSize[1] = viewSize[1];
+  }
+
+  // encode in place: the image is small and an interactive frame is only
+  // useful if it is delivered right away, so don't queue it behind others in
+  // the encoder. The result is never base64 encoded, it is meant to be sent as
+  // binary.
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  value.InteractiveData = vtkInternals::EncodeImage(image, this->ImageCompression, quality);
+  timer->StopTimer();
+
+  value.InteractiveNeedsRender = false;
+  value.NeedsRefinement = true;
+  value.LastEncodeTime = timer->GetElapsedTime() * 1000.0;
+  value.LastEncodedSize = value.InteractiveData ? value.InteractiveData->GetDataSize() : 0;
+  return value.InteractiveData;
 }
 
 //----------------------------------------------------------------------------
 void vtkPVWebApplication::InvalidateCache(vtkSMViewProxy* view)
 {
-  this->Internals->ImageCache[view].NeedsRender = true;
+  this->Internals->ImageCache[view].Invalidate();
 }
 
 //----------------------------------------------------------------------------
@@ -167,13 +389,14 @@ vtkUnsignedCharArray* vtkPVWebApplication::StillRender(vtkSMViewProxy* view, int
   vtkInternals::ImageCacheValueType& value = this->Internals->ImageCache[view];
   value.SetListener(view);
 
-  if (value.NeedsRender == false && value.Data != NULL && view->GetNeedsUpdate() == false)
+  // after interactive frames, always render again at full quality.
+  if (value.NeedsRender == false && value.NeedsRefinement == false && value.Data != NULL &&
+    view->GetNeedsUpdate() == false)
   {
     // cout <<  "Reusing cache" << endl;
     if (doThread)
     {
-      bool latest = this->Internals->Encoder->GetLatestOutput(view->GetGlobalID(), value.Data);
-      value.HasImagesBeingProcessed = !latest;
+      this->Internals->CollectEncodedImage(view->GetGlobalID(), value);
     }
     else
     {
@@ -199,6 +422,10 @@ vtkUnsignedCharArray* vtkPVWebApplication::StillRender(vtkSMViewProxy* view, int
 
   if (doThread || this->ImageEncoding)
   {
+    // the image is encoded on the encoder's thread: its statistics are
+    // recorded when its output is collected, here or by a later call.
+    value.EncodeStartTime = vtkTimerLog::GetUniversalTime();
+    value.EncodePending = true;
     this->Internals->Encoder->PushAndTakeReference(
       view->GetGlobalID(), image, quality, this->ImageEncoding);
     assert(image == NULL);
@@ -211,20 +438,21 @@ vtkUnsignedCharArray* vtkPVWebApplication::StillRender(vtkSMViewProxy* view, int
       // cout << "Done Flushing" << endl;
     }
 
-    bool latest = this->Internals->Encoder->GetLatestOutput(view->GetGlobalID(), value.Data);
-    value.HasImagesBeingProcessed = !latest;
+    this->Internals->CollectEncodedImage(view->GetGlobalID(), value);
   }
   else
   {
-    vtkNew<vtkJPEGWriter> writer;
-    writer->WriteToMemoryOn();
-    writer->SetInputData(image);
-    writer->SetQuality(quality);
-    writer->Write();
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
     // smart pointer does the right thing, even if Data was null
-    value.Data = writer->GetResult();
+    value.Data = vtkInternals::EncodeImage(image, this->ImageCompression, quality);
+    image->Delete();
+    timer->StopTimer();
+    value.LastEncodeTime = timer->GetElapsedTime() * 1000.0;
+    value.LastEncodedSize = value.Data ? value.Data->GetDataSize() : 0;
   }
   value.NeedsRender = false;
+  value.NeedsRefinement = false;
   return value.Data;
 }
 
@@ -255,6 +483,19 @@ vtkUnsignedCharArray* vtkPVWebApplication::StillRenderToBuffer(
   return NULL;
 }
 
+//----------------------------------------------------------------------------
+vtkUnsignedCharArray* vtkPVWebApplication::InteractiveRenderToBuffer(
+  vtkSMViewProxy* view, unsigned long time, int quality)
+{
+  vtkUnsignedCharArray* array = this->InteractiveRender(view, quality);
+  if (array && array->GetMTime() != time)
+  {
+    this->LastStillRenderToMTime = array->GetMTime();
+    return array;
+  }
+  return NULL;
+}
+
 //----------------------------------------------------------------------------
 bool vtkPVWebApplication::HandleInteractionEvent(
   vtkSMViewProxy* view, vtkWebInteractionEvent* event)
@@ -322,7 +563,9 @@ bool vtkPVWebApplication::HandleInteractionEvent(
   this->Internals->ButtonStates[view] = event->GetButtons();
 
   bool needs_render = (changed_buttons != 0 || event->GetButtons());
-  this->Internals->ImageCache[view].NeedsRender = needs_render;
+  vtkInternals::ImageCacheValueType& value = this->Internals->ImageCache[view];
+  value.NeedsRender = needs_render;
+  value.InteractiveNeedsRender = needs_render;
   return needs_render;
 }
 
@@ -357,17 +600,49 @@ const char* vtkPVWebApplication::GetWebGLSceneMetaData(vtkSMViewProxy* view)
   vtkWebGLExporter* webglExporter = this->Internals->ViewWebGLMap[view];
   webglExporter->parseScene(renWin->GetRenderers(), view->GetGlobalIDAsString(), VTK_PARSEALL);
 
+  // objects that were not modified keep their hashes, and parts whose content
+  // did not change keep their encoded data.
+  const vtkInternals::WebGLObjId2IndexMap& previousMap =
+    this->Internals->WebGLExporterObjIdMap[webglExporter];
   vtkInternals::WebGLObjId2IndexMap webglMap;
   for (int i = 0; i < webglExporter->GetNumberOfObjects(); ++i)
   {
     vtkWebGLObject* wObj = webglExporter->GetWebGLObject(i);
     if (wObj && wObj->isVisible())
     {
+      vtkInternals::WebGLObjId2IndexMap::const_iterator previous = previousMap.find(wObj->GetId());
       vtkInternals::WebGLObjCacheValue val;
       val.ObjIndex = i;
+      val.MTime = wObj->GetMTime();
+      bool unmodified = previous != previousMap.end() && previous->second.MTime == val.MTime &&
+        static_cast<int>(previous->second.PartSizes.size()) == wObj->GetNumberOfParts();
       for (int j = 0; j < wObj->GetNumberOfParts(); ++j)
       {
+        val.PartSizes[j] = wObj->GetBinarySize(j);
+        unmodified = unmodified && previous->second.PartSizes.find(j)->second == val.PartSizes[j];
+      }
+      if (unmodified)
+      {
+        val.PartHashes = previous->second.PartHashes;
+        val.BinaryParts = previous->second.BinaryParts;
+        webglMap[wObj->GetId()] = val;
+        continue;
+      }
+      for (int j = 0; j < wObj->GetNumberOfParts(); ++j)
+      {
+        const std::string hash = vtkInternals::ComputeHash(
+          wObj->GetBinaryData(j), static_cast<size_t>(val.PartSizes[j]));
+        val.PartHashes[j] = hash;
         val.BinaryParts[j] = "";
+        if (previous != previousMap.end())
+        {
+          std::map<int, std::string>::const_iterator previousHash =
+            previous->second.PartHashes.find(j);
+          if (previousHash != previous->second.PartHashes.end() && previousHash->second == hash)
+          {
+            val.BinaryParts[j] = previous->second.BinaryParts.find(j)->second;
+          }
+        }
       }
       webglMap[wObj->GetId()] = val;
     }
@@ -415,13 +690,8 @@ const char* vtkPVWebApplication::GetWebGLBinaryData(vtkSMViewProxy* view, const
         vtkWebGLObject* obj = webglExporter->GetWebGLObject(cachedVal->ObjIndex);
         if (obj && obj->isVisible())
         {
-          // Manage Base64
-          vtkNew<vtkBase64Utilities> base64;
-          unsigned char* output = new unsigned char[obj->GetBinarySize(part) * 2];
-          int size =
-            base64->Encode(obj->GetBinaryData(part), obj->GetBinarySize(part), output, false);
-          cachedVal->BinaryParts[part] = std::string((const char*)output, size);
-          delete[] output;
+          cachedVal->BinaryParts[part] =
+            vtkInternals::EncodeBinaryPart(obj, part, this->CompressWebGLBinaryData);
         }
       }
       return cachedVal->BinaryParts[part].c_str();
@@ -430,10 +700,95 @@ const char* vtkPVWebApplication::GetWebGLBinaryData(vtkSMViewProxy* view, const
 
   return NULL;
 }
+
+//----------------------------------------------------------------------------
+const char* vtkPVWebApplication::GetWebGLSceneDelta(
+  vtkSMViewProxy* view, const char* knownHashes)
+{
+  if (!view)
+  {
+    vtkErrorMacro("No view specified.");
+    return NULL;
+  }
+  if (this->Internals->ViewWebGLMap.find(view) == this->Internals->ViewWebGLMap.end())
+  {
+    if (this->GetWebGLSceneMetaData(view) == NULL)
+    {
+      vtkErrorMacro("Failed to generate WebGL MetaData for: " << view);
+      return NULL;
+    }
+  }
+
+  vtkWebGLExporter* webglExporter = this->Internals->ViewWebGLMap[view];
+  const vtkInternals::WebGLObjId2IndexMap& webglMap =
+    this->Internals->WebGLExporterObjIdMap[webglExporter];
+
+  std::set<std::string> known;
+  std::istringstream knownStream(knownHashes ? knownHashes : "");
+  std::string hash;
+  while (knownStream >> hash)
+  {
+    known.insert(hash);
+  }
+
+  std::ostringstream json;
+  json << "{\"Parts\": [";
+  const char* separator = "";
+  vtkInternals::WebGLObjId2IndexMap::const_iterator objIter;
+  for (objIter = webglMap.begin(); objIter != webglMap.end(); ++objIter)
+  {
+    std::map<int, std::string>::const_iterator partIter;
+    for (partIter = objIter->second.PartHashes.begin();
+         partIter != objIter->second.PartHashes.end(); ++partIter)
+    {
+      const bool changed = known.find(partIter->second) == known.end();
+      json << separator << "{\"id\": \"" << objIter->first << "\", \"part\": " << partIter->first
+           << ", \"hash\": \"" << partIter->second
+           << "\", \"changed\": " << (changed ? "true" : "false") << "}";
+      separator = ", ";
+    }
+  }
+  json << "], \"Compressed\": " << (this->CompressWebGLBinaryData ? "true" : "false") << "}";
+
+  this->Internals->LastWebGLSceneDelta = json.str();
+  return this->Internals->LastWebGLSceneDelta.c_str();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVWebApplication::SetCompressWebGLBinaryData(bool val)
+{
+  if (this->CompressWebGLBinaryData == val)
+  {
+    return;
+  }
+  this->CompressWebGLBinaryData = val;
+
+  // the cached data was encoded with the previous setting.
+  std::map<vtkWebGLExporter*, vtkInternals::WebGLObjId2IndexMap>::iterator exporterIter;
+  for (exporterIter = this->Internals->WebGLExporterObjIdMap.begin();
+       exporterIter != this->Internals->WebGLExporterObjIdMap.end(); ++exporterIter)
+  {
+    vtkInternals::WebGLObjId2IndexMap::iterator objIter;
+    for (objIter = exporterIter->second.begin(); objIter != exporterIter->second.end(); ++objIter)
+    {
+      std::map<int, std::string>::iterator partIter;
+      for (partIter = objIter->second.BinaryParts.begin();
+           partIter != objIter->second.BinaryParts.end(); ++partIter)
+      {
+        partIter->second.clear();
+      }
+    }
+  }
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVWebApplication::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "ImageEncoding: " << this->ImageEncoding << endl;
   os << indent << "ImageCompression: " << this->ImageCompression << endl;
+  os << indent << "InteractiveImageReductionFactor: " << this->InteractiveImageReductionFactor
+     << endl;
+  os << indent << "CompressWebGLBinaryData: " << this->CompressWebGLBinaryData << endl;
 }
@@ -19,6 +19,15 @@
  * vtkPVWebApplication defines the core interface for a ParaViewWeb application.
  * This exposes methods that make it easier to manage views and rendered images
  * from views.
+ *
+ * While the camera is being moved, InteractiveRender() produces cheaper
+ * frames: the view is rendered with its interactive (LOD) settings at a size
+ * reduced by InteractiveImageReductionFactor, and the image is compressed as
+ * set by ImageCompression, at the requested (lower) quality, without any
+ * base64 encoding, so that it can be sent as a binary message. The next StillRender() then
+ * always renders a full quality frame to refine the view, see
+ * GetNeedsRefinement(). Per view statistics about the last encoded frame and
+ * the frames dropped by the delivery layer are kept as well.
 */
 
 #ifndef vtkPVWebApplication_h
@@ -53,7 +62,9 @@ public:
 
   //@{
   /**
-   * Set the compression to be used for rendered images.
+   * Set the compression to be used for the images encoded on the calling
+   * thread, i.e. those of InteractiveRender(). COMPRESSION_NONE returns the
+   * raw pixels.
    */
   enum
   {
@@ -65,6 +76,15 @@ public:
   vtkGetMacro(ImageCompression, int);
   //@}
 
+  //@{
+  /**
+   * Set the factor by which the size of the view is reduced in each direction
+   * for the images rendered by InteractiveRender(). Default is 2.
+   */
+  vtkSetClampMacro(InteractiveImageReductionFactor, int, 1, 16);
+  vtkGetMacro(InteractiveImageReductionFactor, int);
+  //@}
+
   //@{
   /**
    * Render a view and obtain the rendered image.
@@ -74,6 +94,38 @@ public:
   const char* StillRenderToString(vtkSMViewProxy* view, unsigned long time = 0, int quality = 100);
   vtkUnsignedCharArray* StillRenderToBuffer(
     vtkSMViewProxy* view, unsigned long time = 0, int quality = 100);
+  vtkUnsignedCharArray* InteractiveRenderToBuffer(
+    vtkSMViewProxy* view, unsigned long time = 0, int quality = 50);
+  //@}
+
+  /**
+   * Returns true when the last image produced for the view came from
+   * InteractiveRender(), i.e. a full quality frame is still owed to the
+   * client.
+   */
+  bool GetNeedsRefinement(vtkSMViewProxy*);
+
+  /**
+   * Returns true while a mouse button is held down in the view, as reported
+   * by HandleInteractionEvent().
+   */
+  bool GetIsInteracting(vtkSMViewProxy*);
+
+  //@{
+  /**
+   * Statistics about the images of a view. GetLastEncodeTime() returns the
+   * time, in milliseconds, it took to encode the last image and
+   * GetLastEncodedSize() its size in bytes. For images encoded on the
+   * encoder's thread, the time runs until their output is collected, and
+   * both are only updated then. DropFrame() is meant to
+   * be called by the delivery layer when it skips a frame because the
+   * connection is still busy, GetNumberOfDroppedFrames() returns how many
+   * frames were skipped so far.
+   */
+  double GetLastEncodeTime(vtkSMViewProxy*);
+  vtkIdType GetLastEncodedSize(vtkSMViewProxy*);
+  vtkIdType GetNumberOfDroppedFrames(vtkSMViewProxy*);
+  void DropFrame(vtkSMViewProxy*);
   //@}
 
   /**
@@ -96,7 +148,8 @@ public:
 
   //@{
   /**
-   * Return the MTime of the last array exported by StillRenderToString, StillRenderToBuffer.
+   * Return the MTime of the last array exported by StillRenderToString, StillRenderToBuffer
+   * or InteractiveRenderToBuffer.
    */
   vtkGetMacro(LastStillRenderToMTime, vtkMTimeType);
   //@}
@@ -114,6 +167,31 @@ public:
    */
   const char* GetWebGLBinaryData(vtkSMViewProxy* view, const char* id, int partIndex);
 
+  /**
+   * Return, in JSON format, how the scene parsed by the last
+   * GetWebGLSceneMetaData() call differs from the data a client already has.
+   * knownHashes lists, separated by white spaces, the MD5 hashes of the parts
+   * the client holds. Every part of every visible object is identified by the
+   * object id and the part index, and carries the MD5 hash of its content:
+   * `{"Parts": [{"id": ..., "part": ..., "hash": ..., "changed": ...}, ...],
+   *   "Compressed": ...}`
+   * Only the parts flagged as changed, i.e. whose hash is not known, need to
+   * be fetched with GetWebGLBinaryData(). Objects not listed were removed
+   * from the scene. Since the delta only depends on the hashes sent, each
+   * client gets the delta from its own data.
+   */
+  const char* GetWebGLSceneDelta(vtkSMViewProxy* view, const char* knownHashes);
+
+  //@{
+  /**
+   * When set, the binary data returned by GetWebGLBinaryData() is zlib
+   * compressed before being base64 encoded. Off by default.
+   */
+  void SetCompressWebGLBinaryData(bool);
+  vtkGetMacro(CompressWebGLBinaryData, bool);
+  vtkBooleanMacro(CompressWebGLBinaryData, bool);
+  //@}
+
   //@{
   /**
    * Return the size of the last image exported.
@@ -127,6 +205,8 @@ protected:
 
   int ImageEncoding;
   int ImageCompression;
+  int InteractiveImageReductionFactor;
+  bool CompressWebGLBinaryData;
   vtkMTimeType LastStillRenderToMTime;
   int LastStillRenderImageSize[3];
 
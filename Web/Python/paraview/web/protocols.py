@@ -5,7 +5,7 @@ very specific web application.
 
 from __future__ import absolute_import, division, print_function
 
-import os, sys, types, inspect, traceback, logging, re, json, fnmatch, time
+import os, sys, types, inspect, traceback, logging, re, json, fnmatch, time, base64
 
 # import Twisted reactor for later callback
 from twisted.internet import reactor
@@ -395,6 +395,25 @@ class ParaViewWebPublishImageDelivery(ParaViewWebProtocol, vtk_protocols.vtkWebP
         # PVW init called second so Application is initialized properly.
         vtk_protocols.vtkWebPublishImageDelivery.__init__(self, decode)
         ParaViewWebProtocol.__init__(self)
+        self.pendingPushes = {}
+
+    def pushRender(self, vId, ignoreAnimation = False):
+        """
+        Coalesce pushes: while a push for the view is already scheduled, e.g.
+        because mouse events come in faster than frames can be produced, any
+        further request is dropped instead of queuing stale frames.
+        """
+        if vId in self.pendingPushes:
+            view = self.getView(vId)
+            if view:
+                self.getApplication().DropFrame(view.SMProxy)
+            return
+
+        def doPush():
+            del self.pendingPushes[vId]
+            vtk_protocols.vtkWebPublishImageDelivery.pushRender(self, vId, ignoreAnimation)
+
+        self.pendingPushes[vId] = reactor.callLater(0, doPush)
 
     @exportRpc("viewport.image.push")
     def stillRender(self, options):
@@ -419,7 +438,13 @@ class ParaViewWebPublishImageDelivery(ParaViewWebProtocol, vtk_protocols.vtkWebP
             localTime = options["localTime"]
         reply = {}
         app = self.getApplication()
-        if self.decode:
+        # while the camera moves, send reduced frames; a full quality frame
+        # follows once the interaction stops.
+        interactive = options.get("interactive", app.GetIsInteracting(view.SMProxy))
+        if interactive:
+            stillRender = app.InteractiveRenderToBuffer
+            quality = options.get("interactiveQuality", min(quality, 50))
+        elif self.decode:
             stillRender = app.StillRenderToString
         else:
             stillRender = app.StillRenderToBuffer
@@ -442,10 +467,24 @@ class ParaViewWebPublishImageDelivery(ParaViewWebProtocol, vtk_protocols.vtkWebP
         reply["mtime"] = app.GetLastStillRenderToMTime()
         reply["size"] = view.ViewSize[0:2]
         reply["memsize"] = reply_image.GetDataSize() if reply_image else 0
-        reply["format"] = "jpeg;base64" if self.decode else "jpeg"
+        imageFormat = "jpeg"
+        if interactive:
+            # interactive frames are compressed as set on the application.
+            imageFormat = { 0: "rgb", 1: "png" }.get(app.GetImageCompression(), "jpeg")
+        reply["format"] = imageFormat + ";base64" if self.decode else imageFormat
         reply["global_id"] = view.GetGlobalIDAsString()
         reply["localTime"] = localTime
-        if self.decode:
+        reply["interactive"] = interactive
+        reply["stats"] = {
+            "encodeTime": app.GetLastEncodeTime(view.SMProxy),
+            "bytes": app.GetLastEncodedSize(view.SMProxy),
+            "droppedFrames": app.GetNumberOfDroppedFrames(view.SMProxy)
+        }
+        if self.decode and interactive:
+            # interactive frames are never base64 encoded by the application.
+            reply["image"] = base64.b64encode(memoryview(reply_image).tobytes()).decode('ascii') \
+                if reply_image else None
+        elif self.decode:
             reply["image"] = reply_image
         else:
             # Convert the vtkUnsignedCharArray into a bytes object, required by Autobahn websockets
@@ -484,6 +523,27 @@ class ParaViewWebViewPortGeometryDelivery(ParaViewWebProtocol):
         data = self.getApplication().GetWebGLBinaryData(view.SMProxy, str(object_id), part-1)
         return data
 
+    # RpcName: getSceneDelta => viewport.webgl.delta
+    @exportRpc("viewport.webgl.delta")
+    def getSceneDelta(self, view_id, known_hashes=[]):
+        """
+        RPC callback to get the scene meta data along with the data of the
+        parts whose hash is not in known_hashes, the hashes of the parts the
+        client already holds. The client is expected to reuse the data of the
+        other parts, keyed on their hash.
+        """
+        view = self.getView(view_id)
+        app = self.getApplication()
+        metaData = json.loads(app.GetWebGLSceneMetaData(view.SMProxy))
+        delta = json.loads(app.GetWebGLSceneDelta(view.SMProxy, " ".join(known_hashes)))
+        data = {}
+        for part in delta['Parts']:
+            if part['changed'] and part['hash'] not in data:
+                data[part['hash']] = app.GetWebGLBinaryData(view.SMProxy, str(part['id']), part['part'])
+        delta['MetaData'] = metaData
+        delta['Data'] = data
+        return delta
+
     # RpcName: getCachedWebGLData => viewport.webgl.cached.data
     @exportRpc("viewport.webgl.cached.data")
     def getCachedWebGLData(self, sha):
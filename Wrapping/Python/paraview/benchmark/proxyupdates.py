@@ -0,0 +1,96 @@
+'''
+proxyupdates measures the throughput of the server manager proxy layer: how
+many proxies can be created per second and how many property updates
+(vtkSMProxy::UpdateVTKObjects() calls pushing a single modified property) can
+be done per second, for proxies with few and many properties.
+
+Everything runs in the builtin session, so it mostly measures the client side
+cost of building and pushing proxy states. Run it with pvpython:
+
+::
+
+    pvpython -m paraview.benchmark.proxyupdates -n 200 -u 5000
+'''
+
+from __future__ import absolute_import, print_function
+
+import time
+
+from paraview import servermanager
+from vtk.vtkPVServerManagerCore import vtkSMPropertyHelper
+
+# (group, name, property updated, values the property cycles through)
+PROXIES = [
+    ('sources', 'SphereSource', 'Radius', [0.5, 1.0]),
+    ('representations', 'GeometryRepresentation', 'Opacity', [0.5, 1.0]),
+    ('views', 'RenderView', 'OrientationAxesVisibility', [0, 1]),
+]
+
+
+def time_creation(pxm, group, name, count):
+    '''Returns the number of proxies created (and their VTK objects) per
+    second.'''
+    proxies = []
+    start = time.time()
+    for i in range(count):
+        proxy = pxm.NewProxy(group, name)
+        proxy.UnRegister(None)
+        proxy.UpdateVTKObjects()
+        proxies.append(proxy)
+    elapsed = time.time() - start
+    return count / max(elapsed, 1e-9)
+
+
+def time_updates(pxm, group, name, pname, values, count):
+    '''Returns the number of single property updates pushed per second, along
+    with the number of properties of the proxy.'''
+    proxy = pxm.NewProxy(group, name)
+    proxy.UnRegister(None)
+    proxy.UpdateVTKObjects()
+    helper = vtkSMPropertyHelper(proxy, pname)
+    start = time.time()
+    for i in range(count):
+        helper.Set(values[i % len(values)])
+        proxy.UpdateVTKObjects()
+    elapsed = time.time() - start
+
+    numProperties = 0
+    iter = proxy.NewPropertyIterator()
+    iter.UnRegister(None)
+    iter.Begin()
+    while not iter.IsAtEnd():
+        numProperties += 1
+        iter.Next()
+    return count / max(elapsed, 1e-9), numProperties
+
+
+def run(num_proxies=100, num_updates=1000):
+    if not servermanager.ActiveConnection:
+        servermanager.Connect()
+    pxm = servermanager.ProxyManager().SMProxyManager
+
+    results = []
+    for group, name, pname, values in PROXIES:
+        created = time_creation(pxm, group, name, num_proxies)
+        updated, numProperties = time_updates(pxm, group, name, pname, values, num_updates)
+        print('%s (%d properties): %.1f proxies/sec, %.1f updates/sec' %
+              (name, numProperties, created, updated))
+        results.append((name, numProperties, created, updated))
+    return results
+
+
+def main(argv):
+    import argparse
+    parser = argparse.ArgumentParser(
+        description='Benchmark proxy creation and property update throughput')
+    parser.add_argument('-n', '--proxies', default=100, type=int,
+                        help='Number of proxies created per proxy type')
+    parser.add_argument('-u', '--updates', default=1000, type=int,
+                        help='Number of property updates per proxy type')
+
+    args = parser.parse_args(argv)
+    run(num_proxies=args.proxies, num_updates=args.updates)
+
+if __name__ == "__main__":
+    import sys
+    main(sys.argv[1:])
@@ -0,0 +1,129 @@
+'''
+webgldelta replays an animation and measures the number of bytes the WebGL
+geometry delivery of ParaViewWeb would send for each frame, both when the whole
+scene is sent and when only the parts reported as changed by
+vtkPVWebApplication::GetWebGLSceneDelta() are sent.
+
+Without a state file, the animation is a row of spheres of which only the first
+one changes between frames, i.e. the typical dashboard where one representation
+out of many is updated per timestep. With a state file, the animation scene of
+the state is replayed over its timesteps.
+
+Everything runs locally, nothing is sent over the network. Run it with pvpython:
+
+::
+
+    pvpython -m paraview.benchmark.webgldelta -f 20
+    pvpython -m paraview.benchmark.webgldelta -s mystate.pvsm
+'''
+
+from __future__ import absolute_import, print_function
+
+import json
+
+from paraview.simple import *
+from vtk.vtkParaViewWebCore import vtkPVWebApplication
+
+
+def build_dashboard(num_sources, view):
+    '''Shows num_sources spheres side by side and returns a function that
+    updates the scene for a given frame.'''
+    spheres = []
+    for i in range(num_sources):
+        sphere = Sphere(Center=[2.0 * i, 0, 0], ThetaResolution=64, PhiResolution=64)
+        Show(sphere, view)
+        spheres.append(sphere)
+    ResetCamera(view)
+
+    def update(frame):
+        spheres[0].Radius = 0.5 + 0.4 * (frame % 2)
+    return update
+
+
+def replay_state(state_file):
+    '''Loads the state file and returns the number of frames and a function
+    that updates the scene for a given frame.'''
+    LoadState(state_file)
+    scene = GetAnimationScene()
+    times = list(GetTimeKeeper().TimestepValues) or [scene.AnimationTime]
+
+    def update(frame):
+        scene.AnimationTime = times[frame]
+    return len(times), update
+
+
+def measure_full(app, view, metaData):
+    '''Bytes sent when every part of every object is sent.'''
+    size = len(metaData)
+    for obj in json.loads(metaData)['Objects']:
+        for part in range(obj['parts']):
+            data = app.GetWebGLBinaryData(view.SMProxy, str(obj['id']), part)
+            size += len(data) if data else 0
+    return size
+
+
+def measure_delta(app, view, metaData, cache):
+    '''Bytes sent when only the parts with hashes unknown to the client are
+    sent. cache holds the hashes the client has seen so far, which it sends
+    along with the request.'''
+    known = ' '.join(cache)
+    delta = app.GetWebGLSceneDelta(view.SMProxy, known)
+    size = len(known) + len(metaData) + len(delta)
+    for part in json.loads(delta)['Parts']:
+        if not part['changed'] or part['hash'] in cache:
+            continue
+        data = app.GetWebGLBinaryData(view.SMProxy, str(part['id']), part['part'])
+        size += len(data) if data else 0
+        cache.add(part['hash'])
+    return size
+
+
+def run(num_frames=10, num_sources=8, state_file=None, compress=False):
+    app = vtkPVWebApplication()
+    app.SetCompressWebGLBinaryData(compress)
+
+    if state_file:
+        num_frames, update = replay_state(state_file)
+        view = GetActiveView()
+    else:
+        view = CreateRenderView()
+        update = build_dashboard(num_sources, view)
+
+    cache = set()
+    full_total = 0
+    delta_total = 0
+    for frame in range(num_frames):
+        update(frame)
+        Render(view)
+        metaData = app.GetWebGLSceneMetaData(view.SMProxy)
+        full = measure_full(app, view, metaData)
+        delta = measure_delta(app, view, metaData, cache)
+        full_total += full
+        delta_total += delta
+        print('Frame %d: full %d bytes, delta %d bytes' % (frame, full, delta))
+
+    print('Total: full %d bytes, delta %d bytes (%.1f%%)' %
+          (full_total, delta_total, 100.0 * delta_total / max(full_total, 1)))
+    return full_total, delta_total
+
+
+def main(argv):
+    import argparse
+    parser = argparse.ArgumentParser(
+        description='Benchmark bytes sent by ParaViewWeb WebGL scene deltas')
+    parser.add_argument('-f', '--frames', default=10, type=int,
+                        help='Number of frames, ignored with a state file')
+    parser.add_argument('-n', '--sources', default=8, type=int,
+                        help='Number of spheres shown, ignored with a state file')
+    parser.add_argument('-s', '--state', type=str,
+                        help='State file whose animation is replayed')
+    parser.add_argument('-z', '--compress', action='store_true',
+                        help='Compress the binary data')
+
+    args = parser.parse_args(argv)
+    run(num_frames=args.frames, num_sources=args.sources,
+        state_file=args.state, compress=args.compress)
+
+if __name__ == "__main__":
+    import sys
+    main(sys.argv[1:])